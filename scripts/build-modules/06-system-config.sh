@@ -90,6 +90,9 @@ DEBIAN_FRONTEND=noninteractive apt-get install -y -qq kbd 2>&1 | grep -v "^Get:\
 apt-get install -y -qq --no-install-recommends libasound2t64 2>/dev/null || \
 apt-get install -y -qq --no-install-recommends libasound2 2>/dev/null || true
 
+# libjpeg-turbo for MJPEG capture sources
+apt-get install -y -qq --no-install-recommends libjpeg-turbo8 2>/dev/null || true
+
 # Try to install v4l2 tools with different package names
 apt-get install -y -qq --no-install-recommends v4l-utils 2>/dev/null || \
 apt-get install -y -qq --no-install-recommends v4l2-tools 2>/dev/null || \
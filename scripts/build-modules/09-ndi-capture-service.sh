@@ -39,6 +39,20 @@ echo "BUILD_SCRIPT_VERSION_PLACEHOLDER" > /etc/media-bridge/build-script-version
 cat > /etc/media-bridge/config << EOFCONFIG
 DEVICE="/dev/video0"
 NDI_NAME="USB Capture"
+# Capture profile: ultra-low-latency, balanced or 4K-throughput
+CAPTURE_PROFILE="balanced"
+# Asynchronous NDI send follows the profile; uncomment to force it off
+#CAPTURE_ASYNC_SEND="0"
+# Threads for striped frame conversion (0 = one per core, 1 = single thread)
+#CAPTURE_CONVERT_THREADS="0"
+# Mode selection: score (resolution x fps vs conversion cost), native or priority
+CAPTURE_FORMAT_POLICY="score"
+# Prefer 10-bit capture formats (v210, Y210, P010) for HDR sources: 1 or 0
+CAPTURE_10BIT="0"
+# Embedded audio: auto (ALSA card of the capture stick), none, or an ALSA PCM (hw:2,0)
+CAPTURE_AUDIO="auto"
+# Per-frame capture/send timestamps in NDI metadata (latency stats on ndi-display): 1 or 0
+CAPTURE_TIMING_METADATA="1"
 EOFCONFIG
 
 # NDI runner script
@@ -93,10 +107,10 @@ check_time_sync
 while true; do
     echo "[$(date '+%Y-%m-%d %H:%M:%S')] Starting NDI Capture: $DEVICE -> $NDI_NAME"
     if [ -w /var/log/media-bridge ]; then
-        LD_LIBRARY_PATH=/usr/local/lib /opt/media-bridge/ndi-capture "$DEVICE" "$NDI_NAME" 2>&1 | tee -a /var/log/media-bridge/ndi-capture.log
+        LD_LIBRARY_PATH=/usr/local/lib /opt/media-bridge/ndi-capture --config /etc/media-bridge/config "$DEVICE" "$NDI_NAME" 2>&1 | tee -a /var/log/media-bridge/ndi-capture.log
         echo "[$(date '+%Y-%m-%d %H:%M:%S')] NDI Capture exited, restarting in 5 seconds..." | tee -a /var/log/media-bridge/ndi-capture.log
     else
-        LD_LIBRARY_PATH=/usr/local/lib /opt/media-bridge/ndi-capture "$DEVICE" "$NDI_NAME" 2>&1
+        LD_LIBRARY_PATH=/usr/local/lib /opt/media-bridge/ndi-capture --config /etc/media-bridge/config "$DEVICE" "$NDI_NAME" 2>&1
         echo "[$(date '+%Y-%m-%d %H:%M:%S')] NDI Capture exited, restarting in 5 seconds..."
     fi
     sleep 5
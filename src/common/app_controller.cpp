@@ -1,11 +1,14 @@
 #include "app_controller.h"
 #include "logger.h"
+#include "frame_timing.h"
 #include "version.h"
 #include <sstream>
 #include <iomanip>
 
 #ifdef __linux__
 #include "linux/v4l2/v4l2_capture.h"
+#include "linux/v4l2/v4l2_hotplug_monitor.h"
+#include "linux/alsa/alsa_audio_capture.h"
 #endif
 
 namespace ndi_bridge {
@@ -19,6 +22,9 @@ constexpr uint32_t FOURCC_UYVY = 0x59565955;  // 'UYVY'
 constexpr uint32_t FOURCC_YUY2 = 0x32595559;  // 'YUY2'
 constexpr uint32_t FOURCC_YUYV = 0x56595559;  // 'YUYV' - same as YUY2
 constexpr uint32_t FOURCC_NV12 = 0x3231564E;  // 'NV12'
+constexpr uint32_t FOURCC_I420 = 0x30323449;  // 'I420'
+constexpr uint32_t FOURCC_YV12 = 0x32315659;  // 'YV12'
+constexpr uint32_t FOURCC_P216 = 0x36313250;  // 'P216'
 constexpr uint32_t FOURCC_BGRA = 0x41524742;  // 'BGRA'
 constexpr uint32_t FOURCC_BGRX = 0x58524742;  // 'BGRX'
 
@@ -41,6 +47,11 @@ AppController::AppController(const Config& config)
 
 AppController::~AppController() {
     stop();
+#ifdef __linux__
+    if (hotplug_monitor_) {
+        hotplug_monitor_->stop();
+    }
+#endif
 }
 
 void AppController::setCaptureDevice(std::unique_ptr<ICaptureDevice> capture) {
@@ -54,6 +65,11 @@ void AppController::setCaptureDevice(std::unique_ptr<ICaptureDevice> capture) {
     capture_device_ = std::move(capture);
 }
 
+void AppController::setCaptureDeviceFactory(CaptureDeviceFactory factory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capture_factory_ = std::move(factory);
+}
+
 void AppController::setStatusCallback(StatusCallback callback) {
     std::lock_guard<std::mutex> lock(mutex_);
     status_callback_ = std::move(callback);
@@ -203,7 +219,7 @@ void AppController::runLoop() {
             
             // Wait for condition or timeout every second to check capture health
             cv_.wait_for(lock, std::chrono::seconds(1), [this] { 
-                return stop_requested_ || restart_requested_ || 
+                return stop_requested_ || restart_requested_ || audio_failed_ ||
                        (capture_device_ && capture_device_->hasError());
             });
             
@@ -235,6 +251,12 @@ void AppController::runLoop() {
                 break;
             }
             
+            if (audio_failed_.exchange(false)) {
+                lock.unlock();
+                restartAudioCapture();
+                continue;
+            }
+            
             if (capture_device_ && capture_device_->hasError()) {
                 lock.unlock();
                 reportError("Capture device error detected", true);
@@ -250,8 +272,8 @@ void AppController::runLoop() {
         shutdown();
         
         // Add delay before restart if it was an error
-        if ((restart_requested_ || (capture_device_ && capture_device_->hasError())) && config_.retry_delay_ms > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(config_.retry_delay_ms));
+        if (restart_requested_ || (capture_device_ && capture_device_->hasError())) {
+            waitBeforeRetry();
         }
         
         restart_requested_ = false;
@@ -275,13 +297,14 @@ bool AppController::initialize() {
         reportError("Failed to initialize NDI sender", false);
         return false;
     }
+    ndi_sender_->setTimingMetadata(config_.timing_metadata);
     
     // v1.6.3: Set capture callbacks BEFORE starting capture
     // This ensures the callbacks are ready when frames start arriving
     capture_device_->setFrameCallback(
         [this](const void* data, size_t size, int64_t timestamp, 
                const ICaptureDevice::VideoFormat& format) {
-            onFrameReceived(data, size, timestamp, format);
+            return onFrameReceived(data, size, timestamp, format);
         }
     );
     
@@ -289,12 +312,24 @@ bool AppController::initialize() {
         [this](const std::string& error) { onCaptureError(error); }
     );
     
+    // Frames NDI still reads asynchronously come back before buffers are reclaimed
+    capture_device_->setFlushCallback([this]() {
+        if (ndi_sender_) {
+            ndi_sender_->flush();
+        }
+    });
+    
     // Start capture AFTER callbacks are set
-    if (!capture_device_->startCapture(config_.device_name)) {
+    if (!capture_device_->startCapture(resolveCaptureDeviceName())) {
         reportError("Failed to start capture device", false);
         return false;
     }
     
+    // Watch for unplug/replug from now on (bus path survives restarts)
+    startHotplugMonitor();
+    
+    startAudioCapture();
+    
     reportStatus("All components initialized successfully");
     return true;
 }
@@ -302,6 +337,14 @@ bool AppController::initialize() {
 void AppController::shutdown() {
     reportStatus("Shutting down components");
     
+#ifdef __linux__
+    // Audio sends through ndi_sender_, so it goes before the sender
+    if (audio_capture_) {
+        audio_capture_->stop();
+        audio_capture_.reset();
+    }
+#endif
+    
     // Stop capture first
     if (capture_device_) {
         capture_device_->stopCapture();
@@ -310,12 +353,18 @@ void AppController::shutdown() {
         // The capture device must be recreated to get fresh file descriptors
         if (retry_count_ > 0) {
             // We're in a recovery scenario - recreate the capture device
-            // For now, we only support V4L2 on Linux
-            #ifdef __linux__
-            capture_device_.reset();
-            capture_device_ = std::make_unique<v4l2::V4L2Capture>();
-            reportStatus("Recreated capture device for recovery");
-            #endif
+            // with the same settings it was originally created with
+            if (capture_factory_) {
+                capture_device_.reset();
+                capture_device_ = capture_factory_();
+                reportStatus("Recreated capture device for recovery");
+            } else {
+                #ifdef __linux__
+                capture_device_.reset();
+                capture_device_ = std::make_unique<v4l2::V4L2Capture>();
+                reportStatus("Recreated capture device for recovery");
+                #endif
+            }
         }
     }
     
@@ -328,13 +377,16 @@ void AppController::shutdown() {
     reportStatus("Components shut down");
 }
 
-void AppController::onFrameReceived(const void* frame_data, size_t frame_size,
+bool AppController::onFrameReceived(const void* frame_data, size_t frame_size,
                                    int64_t timestamp, const ICaptureDevice::VideoFormat& format) {
     frames_captured_++;
     
     if (!ndi_sender_ || !ndi_sender_->isReady()) {
         frames_dropped_++;
-        return;
+        if (format.release) {
+            format.release();
+        }
+        return false;
     }
     
     // Prepare frame info for NDI
@@ -347,9 +399,17 @@ void AppController::onFrameReceived(const void* frame_data, size_t frame_size,
     frame_info.timestamp_ns = timestamp;
     frame_info.fps_numerator = format.fps_numerator;    // Pass frame rate to NDI
     frame_info.fps_denominator = format.fps_denominator;  // Pass frame rate to NDI
+    frame_info.chroma_offset = format.chroma_offset > 0 ? format.chroma_offset : 0;
+    frame_info.chroma_stride = format.chroma_stride > 0 ? format.chroma_stride : 0;
+    frame_info.release = format.release;  // NdiSender calls it exactly once
+    // Sources without a driver clock are stamped on arrival
+    frame_info.sequence = format.sequence >= 0 ? static_cast<uint64_t>(format.sequence) : frames_captured_.load();
+    frame_info.capture_realtime_ns = format.capture_realtime_ns > 0 ? format.capture_realtime_ns
+                                                                    : FrameTiming::realtimeNs();
     
     // Send frame
-    if (ndi_sender_->sendFrame(frame_info)) {
+    bool sent = ndi_sender_->sendFrame(frame_info);
+    if (sent) {
         frames_sent_++;
     } else {
         frames_dropped_++;
@@ -365,6 +425,8 @@ void AppController::onFrameReceived(const void* frame_data, size_t frame_size,
            << (frames_dropped_ * 100.0 / frames_captured_) << "%)";
         reportStatus(ss.str());
     }
+    
+    return sent;
 }
 
 void AppController::onCaptureError(const std::string& error) {
@@ -391,15 +453,18 @@ void AppController::reportStatus(const std::string& status) {
 void AppController::reportError(const std::string& error, bool recoverable) {
     auto now = std::chrono::steady_clock::now();
     
-    // Rate limit error messages
-    if (error == last_error_message_ && 
-        now - last_error_time_ < ERROR_COOLDOWN_PERIOD) {
-        return;
+    // Rate limit error messages (main, capture and audio threads report)
+    {
+        std::lock_guard<std::mutex> error_lock(error_mutex_);
+        if (error == last_error_message_ && 
+            now - last_error_time_ < ERROR_COOLDOWN_PERIOD) {
+            return;
+        }
+        
+        last_error_message_ = error;
+        last_error_time_ = now;
     }
     
-    last_error_message_ = error;
-    last_error_time_ = now;
-    
     Logger::error(error);
     
     std::lock_guard<std::mutex> lock(mutex_);
@@ -429,12 +494,140 @@ bool AppController::attemptRecovery() {
     ss << ")";
     reportStatus(ss.str());
     
-    // Wait before retry
-    std::this_thread::sleep_for(std::chrono::milliseconds(config_.retry_delay_ms));
+    // Wait before retry (or until the device is plugged back in)
+    waitBeforeRetry();
     
     return !stop_requested_;
 }
 
+void AppController::waitBeforeRetry() {
+#ifdef __linux__
+    if (hotplug_monitor_ && hotplug_monitor_->isWatching() &&
+        (device_unplugged_ || !hotplug_monitor_->isPresent())) {
+        reportStatus("Waiting for capture device to reappear");
+        auto wait_start = std::chrono::steady_clock::now();
+        auto deadline = wait_start + std::chrono::milliseconds(config_.retry_delay_ms);
+        
+        // Short slices so stop() is not held up; a replug on another port
+        // is still picked up by the regular retry once the delay runs out
+        while (!stop_requested_ && std::chrono::steady_clock::now() < deadline) {
+            if (hotplug_monitor_->waitForDevice(100)) {
+                device_unplugged_ = false;
+                auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - wait_start).count();
+                reportStatus("Capture device is back after " + std::to_string(waited) + "ms");
+                return;
+            }
+        }
+        return;
+    }
+#endif
+    
+    if (config_.retry_delay_ms > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config_.retry_delay_ms));
+    }
+}
+
+void AppController::startHotplugMonitor() {
+#ifdef __linux__
+    // Only V4L2 devices have a bus path to watch
+    if (hotplug_monitor_ || !dynamic_cast<v4l2::V4L2Capture*>(capture_device_.get())) {
+        return;
+    }
+    
+    std::string device_path = config_.device_name;
+    if (device_path.empty()) {
+        auto devices = v4l2::V4L2DeviceEnumerator::enumerateDevices();
+        if (!devices.empty()) {
+            device_path = devices[0].path;
+        }
+    } else if (device_path.compare(0, 5, "/dev/") != 0) {
+        device_path = v4l2::V4L2DeviceEnumerator::findDeviceByName(device_path);
+    }
+    
+    hotplug_monitor_ = std::make_unique<v4l2::HotplugMonitor>();
+    if (device_path.empty() || !hotplug_monitor_->start(device_path)) {
+        reportStatus("Hot-plug monitor unavailable, using timed retries");
+        return;
+    }
+    
+    hotplug_monitor_->setRemovedCallback([this]() {
+        // Restart right away instead of waiting for DQBUF errors or the watchdog
+        device_unplugged_ = true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        restart_requested_ = true;
+        cv_.notify_all();
+    });
+#endif
+}
+
+std::string AppController::resolveCaptureDeviceName() const {
+#ifdef __linux__
+    // A replugged device may come back under a different /dev/videoN
+    if (hotplug_monitor_ && hotplug_monitor_->isWatching() &&
+        config_.device_name.compare(0, 5, "/dev/") == 0) {
+        std::string node = hotplug_monitor_->getDeviceNode();
+        if (!node.empty() && node != config_.device_name) {
+            Logger::info("Capture device now at " + node + " (configured " + config_.device_name + ")");
+            return node;
+        }
+    }
+#endif
+    return config_.device_name;
+}
+
+void AppController::startAudioCapture() {
+#ifdef __linux__
+    if (config_.audio_device.empty()) {
+        return;
+    }
+    
+    alsa::AlsaAudioCapture::Config audio_config;
+    audio_config.device = config_.audio_device;
+    audio_failed_ = false;
+    audio_capture_ = std::make_unique<alsa::AlsaAudioCapture>(audio_config);
+    audio_capture_->setErrorCallback(
+        [this](const std::string& error) {
+            // Capture thread: the run loop restarts audio
+            reportError("Audio capture error: " + error, true);
+            audio_failed_ = true;
+            cv_.notify_all();
+        }
+    );
+    audio_capture_->setAudioCallback(
+        [this](const int16_t* samples, int channels, int frames, int sample_rate, int64_t timestamp_ns) {
+            NdiSender::AudioInfo audio;
+            audio.data = samples;
+            audio.channels = channels;
+            audio.samples = frames;
+            audio.sample_rate = sample_rate;
+            audio.timestamp_ns = timestamp_ns;
+            ndi_sender_->sendAudio(audio);
+        }
+    );
+    
+    if (!audio_capture_->start(resolveCaptureDeviceName())) {
+        Logger::warning("Audio capture unavailable (" + audio_capture_->getLastError() +
+                       "), sending video only");
+        audio_capture_.reset();
+        return;
+    }
+    
+    reportStatus("Audio capture started on " + audio_capture_->getDeviceName());
+#endif
+}
+
+void AppController::restartAudioCapture() {
+#ifdef __linux__
+    reportStatus("Restarting audio capture");
+    if (audio_capture_) {
+        audio_capture_->stop();
+        audio_capture_.reset();
+    }
+    startAudioCapture();
+#endif
+}
+
 uint32_t AppController::getFourCC(const ICaptureDevice::VideoFormat& format) const {
     // Map common format names to FourCC codes
     if (format.pixel_format == "UYVY" || format.pixel_format == "UYVY") {
@@ -443,6 +636,12 @@ uint32_t AppController::getFourCC(const ICaptureDevice::VideoFormat& format) con
         return FOURCC_YUYV;  // YUYV will be converted to UYVY in NDI sender
     } else if (format.pixel_format == "NV12") {
         return FOURCC_NV12;
+    } else if (format.pixel_format == "I420" || format.pixel_format == "YU12") {
+        return FOURCC_I420;
+    } else if (format.pixel_format == "YV12") {
+        return FOURCC_YV12;
+    } else if (format.pixel_format == "P216") {
+        return FOURCC_P216;
     } else if (format.pixel_format == "BGRA") {
         return FOURCC_BGRA;
     } else if (format.pixel_format == "BGRX" || format.pixel_format == "BGR0") {
@@ -14,6 +14,15 @@
 
 namespace ndi_bridge {
 
+#ifdef __linux__
+namespace v4l2 {
+class HotplugMonitor;
+}
+namespace alsa {
+class AlsaAudioCapture;
+}
+#endif
+
 /**
  * @brief Application controller that coordinates capture and NDI sending
  * 
@@ -32,9 +41,11 @@ public:
         std::string device_name;      // Capture device name (empty for default)
         std::string ndi_name;         // NDI sender name
         bool auto_retry = true;       // Auto-retry on errors
-        int retry_delay_ms = 5000;    // Delay between retries
+        int retry_delay_ms = 5000;    // Delay between retries (cut short by hot-plug)
         int max_retries = -1;         // Max retries (-1 for infinite)
         bool verbose = false;         // Verbose logging
+        std::string audio_device;     // Audio input: "" = none, "auto" = next to video, or ALSA PCM
+        bool timing_metadata = true;  // Capture/send timestamps in each frame's NDI metadata
     };
 
     /**
@@ -47,6 +58,11 @@ public:
      */
     using ErrorCallback = std::function<void(const std::string& error, bool recoverable)>;
 
+    /**
+     * @brief Factory used to recreate the capture device during recovery
+     */
+    using CaptureDeviceFactory = std::function<std::unique_ptr<ICaptureDevice>()>;
+
     /**
      * @brief Constructor
      * @param config Application configuration
@@ -68,6 +84,14 @@ public:
      */
     void setCaptureDevice(std::unique_ptr<ICaptureDevice> capture);
 
+    /**
+     * @brief Set the factory used to recreate the capture device on recovery
+     * @param factory Factory returning a fresh, unstarted capture device
+     * 
+     * Without a factory a default V4L2 capture device is recreated.
+     */
+    void setCaptureDeviceFactory(CaptureDeviceFactory factory);
+
     /**
      * @brief Set status callback
      * @param callback Callback for status updates
@@ -155,8 +179,9 @@ private:
      * @param frame_size Frame size in bytes
      * @param timestamp Timestamp
      * @param format Frame format
+     * @return true if the frame was sent to NDI
      */
-    void onFrameReceived(const void* frame_data, size_t frame_size,
+    bool onFrameReceived(const void* frame_data, size_t frame_size,
                         int64_t timestamp, const ICaptureDevice::VideoFormat& format);
 
     /**
@@ -190,6 +215,34 @@ private:
      */
     bool attemptRecovery();
 
+    /**
+     * @brief Wait before re-initializing after an error
+     *
+     * Returns as soon as the hot-plug monitor sees the device again, or
+     * after retry_delay_ms if the device never went away.
+     */
+    void waitBeforeRetry();
+
+    /**
+     * @brief Start watching the capture device for unplug/replug
+     */
+    void startHotplugMonitor();
+
+    /**
+     * @brief Device to open: the configured one, or its new node after replug
+     */
+    std::string resolveCaptureDeviceName() const;
+
+    /**
+     * @brief Start audio capture if configured (failure keeps video running)
+     */
+    void startAudioCapture();
+
+    /**
+     * @brief Restart audio capture after it stopped on an error (video keeps running)
+     */
+    void restartAudioCapture();
+
     /**
      * @brief Get FourCC code from format
      * @param format Video format
@@ -206,12 +259,14 @@ private:
     
     // Components
     std::unique_ptr<ICaptureDevice> capture_device_;
+    CaptureDeviceFactory capture_factory_;
     std::unique_ptr<NdiSender> ndi_sender_;
     
     // State
     std::atomic<bool> running_{false};
     std::atomic<bool> stop_requested_{false};
     std::atomic<bool> restart_requested_{false};
+    std::atomic<bool> audio_failed_{false};     // Audio capture stopped on an error
     std::atomic<int> retry_count_{0};
     
     // Statistics
@@ -224,9 +279,19 @@ private:
     mutable std::mutex mutex_;
     std::condition_variable cv_;
     
-    // Error handling
+    // Error handling (error_mutex_)
+    std::mutex error_mutex_;
     std::chrono::steady_clock::time_point last_error_time_;
     std::string last_error_message_;
+
+#ifdef __linux__
+    // Hot-plug monitor for the capture device (uevent netlink)
+    std::unique_ptr<v4l2::HotplugMonitor> hotplug_monitor_;
+    std::atomic<bool> device_unplugged_{false};
+    
+    // Embedded audio (ALSA), recreated with the rest of the pipeline
+    std::unique_ptr<alsa::AlsaAudioCapture> audio_capture_;
+#endif
 };
 
 } // namespace ndi_bridge
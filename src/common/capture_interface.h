@@ -15,7 +15,7 @@ namespace ndi_bridge {
  * This abstract interface defines the contract for video capture devices
  * used in the Media Bridge application.
  * 
- * Version: 1.0.1
+ * Version: 1.3.0
  */
 class ICaptureDevice {
 public:
@@ -37,6 +37,12 @@ public:
         std::string pixel_format;  // e.g., "UYVY", "YUY2", "NV12", "BGRA"
         uint32_t fps_numerator;
         uint32_t fps_denominator;
+        int dmabuf_fd = -1;        // Per-frame exported dma-buf fd (-1 if not available)
+        int chroma_offset = 0;     // Planar 4:2:0: bytes from data to the first chroma plane (0 = stride * height)
+        int chroma_stride = 0;     // Planar 4:2:0: chroma line pitch (0 = stride for NV12, stride / 2 for I420/YV12)
+        std::function<void()> release;  // Deferred release of data (empty = valid for the callback only)
+        int64_t sequence = -1;          // Driver frame sequence (-1 = not provided)
+        int64_t capture_realtime_ns = 0;  // Capture time on CLOCK_REALTIME (0 = not provided)
     };
 
     /**
@@ -45,8 +51,18 @@ public:
      * @param size Frame size in bytes
      * @param timestamp Frame timestamp in nanoseconds
      * @param format Video format information
+     * @return true if the frame was delivered downstream, false if it was
+     *         dropped there (counted by the capture device as a sink drop)
+     *
+     * When format.dmabuf_fd is valid it refers to the same memory as data and
+     * stays owned by the capture device; dup() it to keep it past the callback.
+     *
+     * When format.release is set, data stays valid after the callback returns
+     * and the device will not reuse the buffer until release is called. The
+     * consumer must call it exactly once (from any thread), also when the
+     * frame is dropped.
      */
-    using FrameCallback = std::function<void(const void* data, size_t size, 
+    using FrameCallback = std::function<bool(const void* data, size_t size, 
                                            int64_t timestamp, const VideoFormat& format)>;
 
     /**
@@ -55,6 +71,15 @@ public:
      */
     using ErrorCallback = std::function<void(const std::string& error)>;
 
+    /**
+     * @brief Flush callback function type
+     *
+     * Called by the device when it needs every frame handed out with a
+     * release back (stop, source change). The consumer must release them
+     * before returning.
+     */
+    using FlushCallback = std::function<void()>;
+
     virtual ~ICaptureDevice() = default;
     
     /**
@@ -93,6 +118,14 @@ public:
      */
     virtual void setErrorCallback(ErrorCallback callback) = 0;
     
+    /**
+     * @brief Set flush callback
+     * @param callback Function to call before the device reclaims buffers
+     *
+     * Only devices that hand out frames with a release use it.
+     */
+    virtual void setFlushCallback(FlushCallback callback) { (void)callback; }
+    
     /**
      * @brief Check if device has encountered an error
      * @return true if device has error
@@ -11,8 +11,10 @@ FrameQueue::FrameQueue(size_t capacity, size_t frame_size)
     // Allocate frame metadata array
     frames_ = std::make_unique<Frame[]>(capacity);
     
-    // Allocate contiguous memory pool for all frame data
-    data_pool_ = std::make_unique<uint8_t[]>(capacity * frame_size);
+    // Allocate contiguous memory pool for all frame data (none for reference queues)
+    if (frame_size > 0) {
+        data_pool_ = std::make_unique<uint8_t[]>(capacity * frame_size);
+    }
     
     Logger::debug("FrameQueue: Created with capacity " + std::to_string(capacity) + 
                  ", frame size " + std::to_string(frame_size) + " bytes");
@@ -38,8 +40,8 @@ bool FrameQueue::tryPush(const Frame& frame) {
     slot = frame;
     
     // Copy frame data to our buffer pool
-    void* dest = getDataPtr(current_tail);
-    if (frame.data && frame.size > 0) {
+    if (frame_size_ > 0 && frame.data && frame.size > 0) {
+        void* dest = getDataPtr(current_tail);
         size_t copy_size = std::min(frame.size, frame_size_);
         memcpy(dest, frame.data, copy_size);
         slot.data = dest;
@@ -41,7 +41,9 @@ public:
     /**
      * @brief Construct frame queue with specified capacity
      * @param capacity Maximum number of frames in queue
-     * @param frame_size Maximum size of each frame in bytes
+     * @param frame_size Maximum size of each frame in bytes, or 0 for a
+     *                   reference queue that passes frame.data through
+     *                   without copying (producer keeps the memory alive)
      */
     explicit FrameQueue(size_t capacity, size_t frame_size);
     
@@ -52,7 +54,8 @@ public:
      * @param frame Frame to push
      * @return true if successful, false if queue is full
      * 
-     * Note: This copies the frame data to internal buffer
+     * Note: This copies the frame data to internal buffer unless the
+     * queue was created with frame_size 0
      */
     bool tryPush(const Frame& frame);
     
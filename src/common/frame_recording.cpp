@@ -0,0 +1,372 @@
+// frame_recording.cpp
+#include "frame_recording.h"
+#include "logger.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace ndi_bridge {
+
+static_assert(sizeof(FrameRecordHeader) == 128, "FrameRecordHeader layout changed");
+static_assert(sizeof(FrameRecordIndexEntry) == 32, "FrameRecordIndexEntry layout changed");
+
+namespace {
+
+constexpr uint64_t kIndexOffset = 4096;
+constexpr uint64_t kFrameAlignment = 64;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool pwriteAll(int fd, const void* data, size_t size, uint64_t offset) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+// FrameRecorder
+
+FrameRecorder::FrameRecorder()
+    : fd_(-1)
+    , event_fd_(-1)
+    , data_end_(0)
+    , staging_(nullptr)
+    , staging_size_(0) {
+    memset(&header_, 0, sizeof(header_));
+}
+
+FrameRecorder::~FrameRecorder() {
+    stop();
+}
+
+bool FrameRecorder::start(const std::string& path, const Format& format,
+                          uint32_t max_frames, uint32_t staging_slots) {
+    if (running_) {
+        return true;
+    }
+    if (format.max_frame_size == 0 || max_frames == 0 || staging_slots == 0) {
+        Logger::error("FrameRecorder: Invalid recording parameters");
+        return false;
+    }
+
+    path_ = path;
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        Logger::error("FrameRecorder: Cannot create " + path + ": " + strerror(errno));
+        return false;
+    }
+
+    // Staging slots are touched now so submit() never page-faults
+    size_t slot_size = alignUp(format.max_frame_size, kFrameAlignment);
+    staging_size_ = slot_size * staging_slots;
+    void* staging = mmap(nullptr, staging_size_, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (staging == MAP_FAILED || event_fd_ < 0) {
+        Logger::error("FrameRecorder: Cannot allocate staging buffers: " + std::string(strerror(errno)));
+        if (staging != MAP_FAILED) {
+            munmap(staging, staging_size_);
+        }
+        if (event_fd_ >= 0) {
+            ::close(event_fd_);
+            event_fd_ = -1;
+        }
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    staging_ = static_cast<uint8_t*>(staging);
+
+    slots_.assign(staging_slots, Slot());
+    free_slots_ = std::make_unique<BufferIndexQueue>(staging_slots + 1);
+    filled_slots_ = std::make_unique<BufferIndexQueue>(staging_slots + 1);
+    for (uint32_t i = 0; i < staging_slots; i++) {
+        slots_[i].data = staging_ + i * slot_size;
+        free_slots_->tryPush(i);
+    }
+
+    memset(&header_, 0, sizeof(header_));
+    memcpy(header_.magic, kFrameRecordMagic, sizeof(header_.magic));
+    header_.version = kFrameRecordVersion;
+    header_.header_size = sizeof(FrameRecordHeader);
+    header_.width = format.width;
+    header_.height = format.height;
+    header_.pixelformat = format.pixelformat;
+    header_.bytesperline = format.bytesperline;
+    header_.fps_numerator = format.fps_numerator;
+    header_.fps_denominator = format.fps_denominator;
+    header_.frame_count = 0;
+    header_.index_capacity = max_frames;
+    header_.index_offset = kIndexOffset;
+    header_.data_offset = alignUp(kIndexOffset + uint64_t(max_frames) * sizeof(FrameRecordIndexEntry), 4096);
+    data_end_ = header_.data_offset;
+
+    if (!writeHeader()) {
+        Logger::error("FrameRecorder: Cannot write " + path + ": " + strerror(errno));
+        stop();
+        return false;
+    }
+
+    frames_recorded_ = 0;
+    frames_skipped_ = 0;
+    full_ = false;
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&FrameRecorder::writerThread, this);
+
+    Logger::info("FrameRecorder: Recording to " + path + " (up to " + std::to_string(max_frames) +
+                 " frames, " + std::to_string(staging_slots) + " staging slots)");
+    return true;
+}
+
+void FrameRecorder::stop() {
+    if (running_) {
+        running_ = false;
+        uint64_t one = 1;
+        if (write(event_fd_, &one, sizeof(one)) < 0) {
+            Logger::debug("FrameRecorder: Wakeup failed: " + std::string(strerror(errno)));
+        }
+        if (thread_ && thread_->joinable()) {
+            thread_->join();
+        }
+        thread_.reset();
+
+        // Header last, so a finished file is distinguishable from a cut one
+        writeHeader();
+        if (ftruncate(fd_, static_cast<off_t>(data_end_)) < 0) {
+            Logger::warning("FrameRecorder: Cannot trim " + path_ + ": " + strerror(errno));
+        }
+        Logger::info("FrameRecorder: Closed " + path_ + " with " + std::to_string(header_.frame_count) +
+                     " frames (" + std::to_string(frames_skipped_.load()) + " skipped)");
+    }
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (event_fd_ >= 0) {
+        ::close(event_fd_);
+        event_fd_ = -1;
+    }
+    if (staging_) {
+        munmap(staging_, staging_size_);
+        staging_ = nullptr;
+    }
+    slots_.clear();
+    free_slots_.reset();
+    filled_slots_.reset();
+}
+
+bool FrameRecorder::submit(const void* data, size_t size, int64_t timestamp_ns,
+                           uint32_t sequence, uint32_t flags) {
+    if (!running_ || full_) {
+        return false;
+    }
+
+    uint32_t index = 0;
+    if (!free_slots_->tryPop(index)) {
+        // Disk is behind - never wait on the live path
+        frames_skipped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot& slot = slots_[index];
+    size_t slot_capacity = staging_size_ / slots_.size();
+    slot.size = size < slot_capacity ? size : slot_capacity;
+    memcpy(slot.data, data, slot.size);
+    slot.timestamp_ns = timestamp_ns;
+    slot.sequence = sequence;
+    slot.flags = flags;
+
+    filled_slots_->tryPush(index);
+    uint64_t one = 1;
+    if (write(event_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        Logger::debug("FrameRecorder: Wakeup failed: " + std::string(strerror(errno)));
+    }
+    return true;
+}
+
+void FrameRecorder::writerThread() {
+    struct pollfd pfd;
+    pfd.fd = event_fd_;
+    pfd.events = POLLIN;
+
+    while (true) {
+        bool stopping = !running_;
+
+        uint32_t index = 0;
+        while (filled_slots_->tryPop(index)) {
+            if (!full_ && !writeFrame(slots_[index])) {
+                Logger::error("FrameRecorder: Write to " + path_ + " failed: " + strerror(errno) +
+                              ", recording stopped");
+                full_ = true;
+            }
+            free_slots_->tryPush(index);
+        }
+
+        if (stopping) {
+            break;
+        }
+
+        int ret = poll(&pfd, 1, -1);
+        if (ret > 0 && (pfd.revents & POLLIN)) {
+            uint64_t count;
+            if (read(event_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                Logger::debug("FrameRecorder: Event read failed: " + std::string(strerror(errno)));
+            }
+        }
+    }
+}
+
+bool FrameRecorder::writeFrame(const Slot& slot) {
+    if (header_.frame_count >= header_.index_capacity) {
+        if (!full_.exchange(true)) {
+            Logger::info("FrameRecorder: " + path_ + " is full (" +
+                         std::to_string(header_.index_capacity) + " frames)");
+        }
+        return true;
+    }
+
+    FrameRecordIndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.offset = data_end_;
+    entry.size = static_cast<uint32_t>(slot.size);
+    entry.sequence = slot.sequence;
+    entry.timestamp_ns = slot.timestamp_ns;
+    entry.flags = slot.flags;
+
+    // Payload before index, so every indexed frame is complete on disk
+    uint64_t entry_offset = header_.index_offset + uint64_t(header_.frame_count) * sizeof(entry);
+    if (!pwriteAll(fd_, slot.data, slot.size, entry.offset) ||
+        !pwriteAll(fd_, &entry, sizeof(entry), entry_offset)) {
+        return false;
+    }
+
+    data_end_ = alignUp(entry.offset + slot.size, kFrameAlignment);
+    header_.frame_count++;
+    frames_recorded_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FrameRecorder::writeHeader() {
+    return pwriteAll(fd_, &header_, sizeof(header_), 0);
+}
+
+// FrameRecordReader
+
+FrameRecordReader::FrameRecordReader()
+    : map_(nullptr)
+    , map_size_(0)
+    , header_(nullptr)
+    , index_(nullptr)
+    , frame_count_(0) {
+}
+
+FrameRecordReader::~FrameRecordReader() {
+    close();
+}
+
+bool FrameRecordReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        last_error_ = "Cannot open " + path + ": " + strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<uint64_t>(st.st_size) < kIndexOffset) {
+        last_error_ = path + " is not a frame recording";
+        ::close(fd);
+        return false;
+    }
+
+    map_size_ = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        last_error_ = "Cannot map " + path + ": " + strerror(errno);
+        map_size_ = 0;
+        return false;
+    }
+    map_ = static_cast<const uint8_t*>(map);
+    header_ = reinterpret_cast<const FrameRecordHeader*>(map_);
+
+    if (memcmp(header_->magic, kFrameRecordMagic, sizeof(header_->magic)) != 0 ||
+        header_->version != kFrameRecordVersion ||
+        header_->index_offset + uint64_t(header_->index_capacity) * sizeof(FrameRecordIndexEntry) > map_size_) {
+        last_error_ = path + " is not a version " + std::to_string(kFrameRecordVersion) + " frame recording";
+        close();
+        return false;
+    }
+    index_ = reinterpret_cast<const FrameRecordIndexEntry*>(map_ + header_->index_offset);
+
+    // A cut recording has a stale count: trust index entries whose payload exists
+    uint32_t count = header_->frame_count;
+    if (count == 0) {
+        while (count < header_->index_capacity && index_[count].size > 0) {
+            count++;
+        }
+    }
+    while (count > 0 && index_[count - 1].offset + index_[count - 1].size > map_size_) {
+        count--;
+    }
+    frame_count_ = count;
+
+    if (frame_count_ == 0) {
+        last_error_ = path + " contains no frames";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FrameRecordReader::close() {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), map_size_);
+    }
+    map_ = nullptr;
+    map_size_ = 0;
+    header_ = nullptr;
+    index_ = nullptr;
+    frame_count_ = 0;
+}
+
+void FrameRecordReader::prefetch() const {
+    if (map_) {
+        madvise(const_cast<uint8_t*>(map_), map_size_, MADV_WILLNEED);
+    }
+}
+
+FrameRecordReader::Frame FrameRecordReader::frame(uint32_t index) const {
+    Frame frame;
+    if (index >= frame_count_) {
+        return frame;
+    }
+    const FrameRecordIndexEntry& entry = index_[index];
+    frame.data = map_ + entry.offset;
+    frame.size = entry.size;
+    frame.timestamp_ns = entry.timestamp_ns;
+    frame.sequence = entry.sequence;
+    frame.flags = entry.flags;
+    return frame;
+}
+
+} // namespace ndi_bridge
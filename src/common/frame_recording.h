@@ -0,0 +1,190 @@
+// frame_recording.h
+#pragma once
+
+#include "frame_queue.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ndi_bridge {
+
+/**
+ * Raw frame recording container (.mbrec)
+ *
+ * Layout, all little-endian, offsets from the start of the file:
+ *   0       FrameRecordHeader (one page)
+ *   4096    FrameRecordIndexEntry[index_capacity]
+ *   data    Frame payloads exactly as the driver filled them, each at a
+ *           64-byte aligned offset (bytesperline padding preserved)
+ *
+ * The file is written with pwrite() and read back through one read-only
+ * mmap, so replay hands the callback pointers straight into the page cache.
+ */
+constexpr char kFrameRecordMagic[8] = {'M', 'B', 'R', 'E', 'C', 'v', '1', '\0'};
+constexpr uint32_t kFrameRecordVersion = 1;
+
+struct FrameRecordHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pixelformat;       // V4L2 fourcc
+    uint32_t bytesperline;
+    uint32_t fps_numerator;
+    uint32_t fps_denominator;
+    uint32_t frame_count;
+    uint32_t index_capacity;
+    uint64_t index_offset;
+    uint64_t data_offset;
+    uint8_t reserved[64];
+};
+
+struct FrameRecordIndexEntry {
+    uint64_t offset;
+    uint32_t size;
+    uint32_t sequence;          // v4l2_buffer.sequence
+    int64_t timestamp_ns;       // v4l2_buffer.timestamp (CLOCK_MONOTONIC)
+    uint32_t flags;             // v4l2_buffer.flags
+    uint32_t reserved;
+};
+
+/**
+ * @brief Records frames to a .mbrec file without blocking the capture path
+ *
+ * submit() copies the frame into a preallocated staging slot and wakes the
+ * writer thread; the file I/O happens there. When all slots are busy the
+ * frame is skipped for the recording (counted) rather than waiting, so a
+ * slow disk never reaches the live path. Call submit() after the frame has
+ * been handed downstream so the copy is not part of capture-to-send latency.
+ *
+ * Version: 1.0.0
+ */
+class FrameRecorder {
+public:
+    struct Format {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t pixelformat = 0;
+        uint32_t bytesperline = 0;
+        uint32_t max_frame_size = 0;    // sizeimage, staging slot size
+        uint32_t fps_numerator = 0;
+        uint32_t fps_denominator = 1;
+    };
+
+    FrameRecorder();
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    /**
+     * @brief Create the file and start the writer thread
+     * @param path Output file (replaced)
+     * @param format Stream format, fixed for the whole recording
+     * @param max_frames Index capacity; recording stops when it is full
+     * @param staging_slots Frames that may wait for the disk
+     */
+    bool start(const std::string& path, const Format& format,
+               uint32_t max_frames, uint32_t staging_slots = 8);
+
+    /**
+     * @brief Flush pending frames, finalize the header and close the file
+     */
+    void stop();
+
+    bool isRecording() const { return running_.load(); }
+
+    /**
+     * @brief Queue one frame (capture or send thread, never blocks)
+     * @return false if the frame was not recorded
+     */
+    bool submit(const void* data, size_t size, int64_t timestamp_ns,
+                uint32_t sequence, uint32_t flags);
+
+    uint64_t getFramesRecorded() const { return frames_recorded_.load(); }
+    uint64_t getFramesSkipped() const { return frames_skipped_.load(); }
+    const std::string& getPath() const { return path_; }
+
+private:
+    struct Slot {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        int64_t timestamp_ns = 0;
+        uint32_t sequence = 0;
+        uint32_t flags = 0;
+    };
+
+    void writerThread();
+    bool writeFrame(const Slot& slot);
+    bool writeHeader();
+
+    std::string path_;
+    int fd_;
+    int event_fd_;
+    FrameRecordHeader header_;
+    uint64_t data_end_;
+
+    uint8_t* staging_;          // One anonymous mapping, prefaulted
+    size_t staging_size_;
+    std::vector<Slot> slots_;
+    std::unique_ptr<BufferIndexQueue> free_slots_;
+    std::unique_ptr<BufferIndexQueue> filled_slots_;
+
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> full_{false};
+    std::atomic<uint64_t> frames_recorded_{0};
+    std::atomic<uint64_t> frames_skipped_{0};
+};
+
+/**
+ * @brief Read-only view of a .mbrec file
+ *
+ * Maps the whole file once; frame() returns pointers into the mapping that
+ * stay valid until close(). A recording cut short (no final header update)
+ * still opens with the frames whose payload made it to disk.
+ */
+class FrameRecordReader {
+public:
+    struct Frame {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        int64_t timestamp_ns = 0;
+        uint32_t sequence = 0;
+        uint32_t flags = 0;
+    };
+
+    FrameRecordReader();
+    ~FrameRecordReader();
+
+    FrameRecordReader(const FrameRecordReader&) = delete;
+    FrameRecordReader& operator=(const FrameRecordReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    /**
+     * @brief Ask the kernel to read the whole file ahead (fast replay)
+     */
+    void prefetch() const;
+
+    const FrameRecordHeader& getHeader() const { return *header_; }
+    uint32_t getFrameCount() const { return frame_count_; }
+    Frame frame(uint32_t index) const;
+
+    const std::string& getLastError() const { return last_error_; }
+
+private:
+    const uint8_t* map_;
+    size_t map_size_;
+    const FrameRecordHeader* header_;
+    const FrameRecordIndexEntry* index_;
+    uint32_t frame_count_;
+    std::string last_error_;
+};
+
+} // namespace ndi_bridge
@@ -0,0 +1,111 @@
+// frame_scaler.cpp
+#include "frame_scaler.h"
+#include <cstring>
+
+namespace ndi_bridge {
+
+namespace {
+
+// Line buffers of the thread running a band: blended source line and its
+// BGRA conversion
+struct LineScratch {
+    std::vector<uint8_t> blended;
+    std::vector<uint8_t> bgra;
+};
+
+LineScratch& lineScratch() {
+    thread_local LineScratch scratch;
+    return scratch;
+}
+
+} // anonymous namespace
+
+FrameScaler::FrameScaler(const PixelKernels& kernels, StripeExecutor* stripes)
+    : kernels_(kernels), stripes_(stripes) {
+}
+
+void FrameScaler::buildAxis(Axis& axis, int src_size, int dst_size) {
+    if (axis.src_size == src_size && axis.dst_size == dst_size) {
+        return;
+    }
+    axis.src_size = src_size;
+    axis.dst_size = dst_size;
+    axis.first.resize(dst_size);
+    axis.second.resize(dst_size);
+    axis.weight.resize(dst_size);
+
+    for (int i = 0; i < dst_size; i++) {
+        // Centre of output sample i in source samples, 16.16 fixed point
+        int64_t pos = ((2 * static_cast<int64_t>(i) + 1) * src_size << 16) / (2 * static_cast<int64_t>(dst_size)) -
+                      (1 << 15);
+        if (pos < 0) {
+            pos = 0;
+        }
+        int first = static_cast<int>(pos >> 16);
+        int weight = static_cast<int>((pos >> 8) & 0xFF);
+        if (first >= src_size - 1) {
+            first = src_size - 1;
+            weight = 0;
+        }
+        axis.first[i] = first;
+        axis.second[i] = weight ? first + 1 : first;
+        axis.weight[i] = static_cast<uint16_t>(weight);
+    }
+}
+
+bool FrameScaler::scale(const uint8_t* src, int src_width, int src_height, int src_stride, Format format,
+                        uint8_t* dst, int dst_pitch, int dst_width, int dst_height) {
+    if (src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0) {
+        return false;
+    }
+    buildAxis(columns_, src_width, dst_width);
+    buildAxis(rows_, src_height, dst_height);
+
+    const bool uyvy = format == Format::UYVY;
+    const bool same_width = src_width == dst_width;
+    const size_t src_bytes = static_cast<size_t>(src_width) * (uyvy ? 2 : 4);
+    const size_t bgra_bytes = static_cast<size_t>(src_width) * 4;
+
+    auto scale_rows = [&](int row_begin, int row_end) {
+        LineScratch& scratch = lineScratch();
+        scratch.blended.resize(src_bytes);
+        scratch.bgra.resize(bgra_bytes);
+
+        for (int y = row_begin; y < row_end; y++) {
+            uint8_t* out = dst + static_cast<size_t>(y) * dst_pitch;
+
+            // Vertical: between the two source lines, or the one it lands on
+            const uint8_t* line = src + static_cast<size_t>(rows_.first[y]) * src_stride;
+            if (rows_.weight[y]) {
+                const uint8_t* next = src + static_cast<size_t>(rows_.second[y]) * src_stride;
+                kernels_.blend_lines.fn(line, next, scratch.blended.data(), src_bytes, rows_.weight[y]);
+                line = scratch.blended.data();
+            }
+
+            // Colour: straight into the output when there is nothing to resample
+            if (uyvy) {
+                uint8_t* bgra = same_width ? out : scratch.bgra.data();
+                kernels_.uyvy_to_bgra.fn(line, bgra, src_width);
+                line = bgra;
+            }
+
+            // Horizontal
+            if (!same_width) {
+                kernels_.scale_bgra.fn(line, out, columns_.first.data(), columns_.second.data(),
+                                       columns_.weight.data(), dst_width);
+            } else if (line != out) {
+                std::memcpy(out, line, bgra_bytes);
+            }
+        }
+    };
+
+    if (stripes_) {
+        // Two source lines read, one output line written
+        stripes_->run(row_cost_, dst_height, src_bytes * 2 + static_cast<size_t>(dst_width) * 4, scale_rows);
+    } else {
+        scale_rows(0, dst_height);
+    }
+    return true;
+}
+
+} // namespace ndi_bridge
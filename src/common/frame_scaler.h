@@ -0,0 +1,84 @@
+// frame_scaler.h
+#pragma once
+
+#include "pixel_kernels.h"
+#include "stripe_executor.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ndi_bridge {
+
+/**
+ * @brief Bilinear frame scaler with fused UYVY -> XRGB conversion
+ *
+ * Software fallback for displays without a scaling plane. Source
+ * coordinates and 8-bit weights of every output column and row are
+ * computed once per source/output size (pixel centres aligned) and kept
+ * until the size changes, so the per-pixel work is table lookups and the
+ * PixelKernels blend_lines / scale_bgra kernels.
+ *
+ * Each output row blends its two source rows (skipped when it falls on
+ * one), converts UYVY to BGRA (BT.601, as the rest of the pipeline) and
+ * resamples horizontally into the destination, all while the line is
+ * in cache. At the source width the resample is left out. With a
+ * StripeExecutor, output rows are scaled in bands across cores.
+ *
+ * Bilinear only: downscaling by more than 2x aliases. The fourth output
+ * byte is 255, except that BGRA lines at the source width are copied as
+ * they are (XRGB8888 ignores it).
+ *
+ * Version: 1.0.0
+ */
+class FrameScaler {
+public:
+    enum class Format {
+        BGRA,
+        UYVY    // Width even
+    };
+
+    /**
+     * @param kernels Line kernels (benchmarks pass a capped set)
+     * @param stripes Executor for row bands (nullptr = single thread)
+     */
+    explicit FrameScaler(const PixelKernels& kernels = PixelKernels::active(),
+                         StripeExecutor* stripes = nullptr);
+
+    /**
+     * @brief Scale and convert one frame to XRGB8888 / BGRA
+     * @param src Source frame
+     * @param src_width Source width in pixels
+     * @param src_height Source height
+     * @param src_stride Source line pitch in bytes
+     * @param format Source pixel format
+     * @param dst Top-left output pixel
+     * @param dst_pitch Output line pitch in bytes
+     * @param dst_width Output width in pixels
+     * @param dst_height Output height
+     * @return false if a dimension is not positive
+     */
+    bool scale(const uint8_t* src, int src_width, int src_height, int src_stride, Format format,
+               uint8_t* dst, int dst_pitch, int dst_width, int dst_height);
+
+    CpuIsa getKernelIsa() const { return kernels_.scale_bgra.isa; }
+
+private:
+    // Source sample pair and weight of one output column or row
+    struct Axis {
+        int src_size = 0;
+        int dst_size = 0;
+        std::vector<int32_t> first;
+        std::vector<int32_t> second;
+        std::vector<uint16_t> weight;   // Of the second, 0-255
+    };
+
+    static void buildAxis(Axis& axis, int src_size, int dst_size);
+
+    PixelKernels kernels_;
+    StripeExecutor* stripes_;
+    StripeExecutor::RowCost row_cost_;
+    Axis columns_;
+    Axis rows_;
+};
+
+} // namespace ndi_bridge
@@ -0,0 +1,88 @@
+// frame_timing.cpp
+#include "frame_timing.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+namespace ndi_bridge {
+
+namespace {
+
+constexpr char kElement[] = "<ndi_bridge_timing ";
+
+int64_t clockNs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Value of name="..." inside the element, false if absent or not a number
+bool attribute(const char* element, const char* end, const char* name, int64_t& value) {
+    size_t name_len = std::strlen(name);
+    for (const char* p = element; p + name_len + 2 < end; p++) {
+        if (std::strncmp(p, name, name_len) == 0 && p[name_len] == '=' && p[name_len + 1] == '"' &&
+            (p == element || p[-1] == ' ')) {
+            char* number_end = nullptr;
+            long long parsed = std::strtoll(p + name_len + 2, &number_end, 10);
+            if (number_end == p + name_len + 2 || *number_end != '"') {
+                return false;
+            }
+            value = parsed;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+bool FrameTiming::toXml(char* out, size_t size) const {
+    int written = std::snprintf(out, size,
+                                "<ndi_bridge_timing seq=\"%" PRIu64 "\" capture=\"%" PRId64
+                                "\" send=\"%" PRId64 "\"/>",
+                                sequence, capture_ns, send_ns);
+    return written > 0 && static_cast<size_t>(written) < size;
+}
+
+bool FrameTiming::fromXml(const char* xml, FrameTiming& timing) {
+    if (!xml) {
+        return false;
+    }
+    const char* element = std::strstr(xml, kElement);
+    if (!element) {
+        return false;
+    }
+    const char* end = std::strchr(element, '>');
+    if (!end) {
+        return false;
+    }
+
+    int64_t sequence = 0;
+    FrameTiming parsed;
+    if (!attribute(element, end, "seq", sequence) ||
+        !attribute(element, end, "capture", parsed.capture_ns) ||
+        !attribute(element, end, "send", parsed.send_ns)) {
+        return false;
+    }
+    parsed.sequence = static_cast<uint64_t>(sequence);
+    timing = parsed;
+    return true;
+}
+
+int64_t FrameTiming::realtimeNs() {
+    return clockNs(CLOCK_REALTIME);
+}
+
+int64_t FrameTiming::monotonicNs() {
+    return clockNs(CLOCK_MONOTONIC);
+}
+
+int64_t FrameTiming::monotonicToRealtime(int64_t monotonic_ns) {
+    // Offset read back to back; follows PTP/NTP steps as they happen
+    int64_t offset = clockNs(CLOCK_REALTIME) - clockNs(CLOCK_MONOTONIC);
+    return monotonic_ns + offset;
+}
+
+} // namespace ndi_bridge
@@ -0,0 +1,51 @@
+// frame_timing.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ndi_bridge {
+
+/**
+ * @brief Per-frame timing carried from capture to display in NDI metadata
+ *
+ * ndi-capture attaches it to every video frame as
+ *   <ndi_bridge_timing seq="1234" capture="..." send="..."/>
+ * with both times in nanoseconds on CLOCK_REALTIME, the clock the
+ * time-sync module disciplines with PTP (NTP as fallback). ndi-display
+ * stamps receive and scanout on the same clock, so with synced hosts the
+ * differences are capture -> wire -> receive -> scanout latencies.
+ *
+ * Version: 1.0.0
+ */
+struct FrameTiming {
+    static constexpr size_t kMaxXmlSize = 128;   // Formatted size incl. NUL
+
+    uint64_t sequence = 0;     // Capture sequence number
+    int64_t capture_ns = 0;    // Driver capture timestamp (realtime)
+    int64_t send_ns = 0;       // Handed to NDI (realtime)
+
+    /**
+     * @brief Format as NDI metadata XML
+     * @param out Buffer of at least kMaxXmlSize bytes
+     * @return false if the buffer is too small
+     */
+    bool toXml(char* out, size_t size) const;
+
+    /**
+     * @brief Parse a frame's metadata
+     * @param xml NDI p_metadata (may be nullptr or hold other elements)
+     * @return false if no ndi_bridge_timing element was found
+     */
+    static bool fromXml(const char* xml, FrameTiming& timing);
+
+    static int64_t realtimeNs();
+    static int64_t monotonicNs();
+
+    /**
+     * @brief Map a CLOCK_MONOTONIC time (V4L2, DRM events) to realtime
+     */
+    static int64_t monotonicToRealtime(int64_t monotonic_ns);
+};
+
+} // namespace ndi_bridge
@@ -0,0 +1,67 @@
+// latency_histogram.cpp
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace ndi_bridge {
+
+LatencyHistogram::LatencyHistogram()
+    : buckets_(kBucketCount + 1, 0) {
+}
+
+void LatencyHistogram::add(int64_t latency_ns) {
+    if (latency_ns < 0) {
+        negative_++;
+        return;
+    }
+    int64_t bucket = std::min<int64_t>(latency_ns / kBucketNs, kBucketCount);
+    buckets_[static_cast<size_t>(bucket)]++;
+    count_++;
+    sum_ns_ += latency_ns;
+    max_ns_ = std::max(max_ns_, latency_ns);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    negative_ = 0;
+    sum_ns_ = 0;
+    max_ns_ = 0;
+}
+
+double LatencyHistogram::percentileMs(double percentile) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(count_ * std::min(100.0, std::max(0.0, percentile)) / 100.0));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min((i + 1) * kBucketNs, max_ns_) / 1e6;
+        }
+    }
+    return maxMs();   // Overflow bucket
+}
+
+double LatencyHistogram::meanMs() const {
+    return count_ ? static_cast<double>(sum_ns_) / count_ / 1e6 : 0.0;
+}
+
+std::string LatencyHistogram::summary() const {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "p50 " << percentileMs(50) << " ms, p95 " << percentileMs(95)
+       << " ms, p99 " << percentileMs(99) << " ms, max " << maxMs() << " ms ("
+       << count_ << " samples";
+    if (negative_ > 0) {
+        ss << ", " << negative_ << " negative";
+    }
+    ss << ")";
+    return ss.str();
+}
+
+} // namespace ndi_bridge
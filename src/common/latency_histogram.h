@@ -0,0 +1,56 @@
+// latency_histogram.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ndi_bridge {
+
+/**
+ * @brief Fixed-bucket latency histogram with percentile readout
+ *
+ * 0.1 ms buckets up to 250 ms plus one overflow bucket, so percentiles are
+ * exact to the bucket without keeping samples. Negative samples (hosts'
+ * clocks out of sync) are counted separately and left out. Not thread
+ * safe; owned by the thread that records.
+ *
+ * Version: 1.0.0
+ */
+class LatencyHistogram {
+public:
+    static constexpr int64_t kBucketNs = 100000;   // 0.1 ms
+    static constexpr int kBucketCount = 2500;      // 250 ms
+
+    LatencyHistogram();
+
+    void add(int64_t latency_ns);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t negativeCount() const { return negative_; }
+
+    /**
+     * @brief Upper edge of the bucket holding the percentile, in ms
+     * @param percentile 0-100
+     * @return 0 when empty
+     */
+    double percentileMs(double percentile) const;
+
+    double meanMs() const;
+    double maxMs() const { return max_ns_ / 1e6; }
+
+    /**
+     * @brief "p50 12.3 ms, p95 ..., p99 ..., max ... (n samples)"
+     */
+    std::string summary() const;
+
+private:
+    std::vector<uint32_t> buckets_;   // kBucketCount + overflow
+    uint64_t count_ = 0;
+    uint64_t negative_ = 0;
+    int64_t sum_ns_ = 0;
+    int64_t max_ns_ = 0;
+};
+
+} // namespace ndi_bridge
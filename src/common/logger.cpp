@@ -95,8 +95,10 @@ std::string Logger::getCurrentTimestamp() {
     localtime_s(&timeinfo, &time_t);
     ss << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S");
 #else
-    // Use localtime on other platforms
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    // localtime_r: capture threads format local time concurrently
+    struct tm timeinfo;
+    localtime_r(&time_t, &timeinfo);
+    ss << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S");
 #endif
     
     // Add milliseconds
@@ -1,14 +1,10 @@
 #include "ndi_sender.h"
 #include "logger.h"
+#include "pixel_kernels.h"
 #include "version.h"
 #include <Processing.NDI.Lib.h>
 #include <chrono>
 #include <cstring>
-#include <immintrin.h>  // For AVX2
-
-#ifdef _MSC_VER
-#include <intrin.h>  // For __cpuid on Windows
-#endif
 
 namespace ndi_bridge {
 
@@ -22,27 +18,23 @@ constexpr int CONNECTION_CHECK_TIMEOUT_MS = 5000;
 // Custom FourCC for YUYV (not in NDI SDK)
 constexpr uint32_t FOURCC_YUYV = 0x56595559;  // 'YUYV'
 
-// CPU feature detection helper
-static bool detectAVX2Support() {
-#if defined(__GNUC__) || defined(__clang__)
-    // GCC/Clang
-    return __builtin_cpu_supports("avx2");
-#elif defined(_MSC_VER)
-    // MSVC
-    int cpuInfo[4];
-    __cpuid(cpuInfo, 0);
-    int nIds = cpuInfo[0];
-    
-    if (nIds >= 7) {
-        __cpuidex(cpuInfo, 7, 0);
-        return (cpuInfo[1] & (1 << 5)) != 0;  // AVX2 bit
-    }
-    return false;
-#else
-    // Unknown compiler - assume no AVX2
-    return false;
-#endif
-}
+// Releases a frame on scope exit unless NDI kept it for an async send
+class ReleaseGuard {
+public:
+    explicit ReleaseGuard(const std::function<void()>& release)
+        : release_(release ? &release : nullptr) {}
+    ~ReleaseGuard() {
+        if (release_) {
+            (*release_)();
+        }
+    }
+    ReleaseGuard(const ReleaseGuard&) = delete;
+    ReleaseGuard& operator=(const ReleaseGuard&) = delete;
+    void dismiss() { release_ = nullptr; }
+
+private:
+    const std::function<void()>* release_;
+};
 
 NdiSender::NdiSender(const std::string& sender_name, ErrorCallback error_callback)
     : sender_name_(sender_name)
@@ -53,27 +45,35 @@ NdiSender::~NdiSender() {
     shutdown();
 }
 
-NdiSender::NdiSender(NdiSender&& other) noexcept
-    : sender_name_(std::move(other.sender_name_))
-    , error_callback_(std::move(other.error_callback_))
-    , initialized_(other.initialized_.load())
-    , frames_sent_(other.frames_sent_.load())
-    , ndi_send_instance_(other.ndi_send_instance_)
-    , yuyv_to_uyvy_buffer_(std::move(other.yuyv_to_uyvy_buffer_)) {
-    other.ndi_send_instance_ = nullptr;
-    other.initialized_ = false;
+NdiSender::NdiSender(NdiSender&& other) noexcept {
+    *this = std::move(other);
 }
 
 NdiSender& NdiSender::operator=(NdiSender&& other) noexcept {
     if (this != &other) {
         shutdown();
         
+        // Finish the frame in flight while its sender still owns the
+        // instance; nothing then points into other's buffers or metadata
+        other.flush();
+        
         sender_name_ = std::move(other.sender_name_);
         error_callback_ = std::move(other.error_callback_);
         initialized_ = other.initialized_.load();
         frames_sent_ = other.frames_sent_.load();
+        audio_samples_sent_ = other.audio_samples_sent_.load();
         ndi_send_instance_ = other.ndi_send_instance_;
+        yuyv_conversion_logged_ = other.yuyv_conversion_logged_;
         yuyv_to_uyvy_buffer_ = std::move(other.yuyv_to_uyvy_buffer_);
+        yuyv_cost_ = other.yuyv_cost_;
+        timing_metadata_ = other.timing_metadata_.load();
+        timing_slot_ = other.timing_slot_;
+        planar_repack_logged_ = other.planar_repack_logged_;
+        planar_buffer_ = std::move(other.planar_buffer_);
+        async_spare_buffer_ = std::move(other.async_spare_buffer_);
+        async_logged_ = other.async_logged_;
+        audio_buffer_ = std::move(other.audio_buffer_);
+        audio_logged_ = other.audio_logged_;
         
         other.ndi_send_instance_ = nullptr;
         other.initialized_ = false;
@@ -103,12 +103,6 @@ bool NdiSender::initialize() {
         return false;
     }
 
-    // Check CPU features for optimization
-    has_avx2_ = detectAVX2Support();
-    if (has_avx2_) {
-        Logger::info("NDI sender: AVX2 support detected for YUV conversions");
-    }
-
     initialized_ = true;
     Logger::info("NDI sender initialized successfully (clock_video=false for low latency)");
     return true;
@@ -122,11 +116,16 @@ void NdiSender::shutdown() {
     }
 
     Logger::info("Shutting down NDI sender");
+    flush();
     cleanup();
     initialized_ = false;
 }
 
 bool NdiSender::sendFrame(const FrameInfo& frame) {
+    // Every path that does not leave the frame with NDI gives it back
+    ReleaseGuard release_guard(frame.release);
+    const bool async = static_cast<bool>(frame.release);
+    
     if (!initialized_) {
         reportError("NDI sender not initialized");
         return false;
@@ -137,6 +136,9 @@ bool NdiSender::sendFrame(const FrameInfo& frame) {
         return false;
     }
 
+    // Serializes conversion buffers and the frame in flight with flush()
+    std::unique_lock<std::mutex> send_lock(send_mutex_);
+
     // Create NDI video frame
     NDIlib_video_frame_v2_t ndi_frame;
     ndi_frame.xres = frame.width;
@@ -148,41 +150,63 @@ bool NdiSender::sendFrame(const FrameInfo& frame) {
         // YUYV to UYVY requires swapping Y and U/V bytes
         size_t buffer_size = frame.width * frame.height * 2;
         
-        // Ensure buffer is allocated
-        if (yuyv_to_uyvy_buffer_.size() < buffer_size) {
-            yuyv_to_uyvy_buffer_.resize(buffer_size);
+        // Ensure buffer is allocated (and not the one NDI is still reading)
+        std::vector<uint8_t>& target = writableBuffer(yuyv_to_uyvy_buffer_);
+        if (target.size() < buffer_size) {
+            target.resize(buffer_size);
         }
         
         // Time the conversion
         auto conv_start = std::chrono::high_resolution_clock::now();
         
-        // Convert YUYV to UYVY with optimized byte swap
+        // Convert YUYV to UYVY with the SIMD byte swap, in row bands across cores
+        const PixelKernels& kernels = PixelKernels::active();
         const uint8_t* src = static_cast<const uint8_t*>(frame.data);
-        uint8_t* dst = yuyv_to_uyvy_buffer_.data();
-        
-        if (has_avx2_ && frame.width % 16 == 0) {
-            // AVX2 optimized conversion (process 32 pixels at once)
-            convertYUYVtoUYVY_AVX2(src, dst, frame.width, frame.height);
-        } else {
-            // Scalar conversion
-            convertYUYVtoUYVY_Scalar(src, dst, frame.width, frame.height);
-        }
+        uint8_t* dst = target.data();
+        const size_t row_bytes = static_cast<size_t>(frame.width) * 2;
+        const size_t src_stride = frame.stride ? frame.stride : row_bytes;
+        StripeExecutor::shared().run(yuyv_cost_, static_cast<int>(frame.height), row_bytes * 2,
+                                     [&](int row_begin, int row_end) {
+            for (int y = row_begin; y < row_end; ++y) {
+                kernels.swap_pairs.fn(src + y * src_stride, dst + y * row_bytes, row_bytes);
+            }
+        });
         
         auto conv_end = std::chrono::high_resolution_clock::now();
         double conv_us = std::chrono::duration<double, std::micro>(conv_end - conv_start).count();
         
-        ndi_frame.p_data = yuyv_to_uyvy_buffer_.data();
+        ndi_frame.p_data = target.data();
         ndi_frame.line_stride_in_bytes = frame.width * 2;
         ndi_frame.FourCC = NDIlib_FourCC_type_UYVY;
         
         // Log once for performance tracking with timing
         if (!yuyv_conversion_logged_) {
-            Logger::info("NDI sender: Using direct YUYV->UYVY conversion (zero-copy optimization)");
+            Logger::info(std::string("NDI sender: Using direct YUYV->UYVY conversion (") +
+                        PixelKernels::isaName(kernels.swap_pairs.isa) + ")");
             Logger::info("  Conversion time: " + std::to_string(conv_us) + "µs for " + 
                         std::to_string(frame.width) + "x" + std::to_string(frame.height) + 
                         " (" + std::to_string(conv_us * 1000.0 / (frame.width * frame.height)) + "ns/pixel)");
             yuyv_conversion_logged_ = true;
         }
+    } else if (frame.fourcc == NDIlib_FourCC_type_NV12 || frame.fourcc == NDIlib_FourCC_type_I420 ||
+               frame.fourcc == NDIlib_FourCC_type_YV12) {
+        // Planar 4:2:0: NDI takes a single pointer and expects the chroma
+        // plane(s) right after stride * height luma bytes
+        bool semi_planar = frame.fourcc == NDIlib_FourCC_type_NV12;
+        uint32_t expected_offset = frame.stride * frame.height;
+        uint32_t expected_chroma_stride = semi_planar ? frame.stride : frame.stride / 2;
+        uint32_t chroma_offset = frame.chroma_offset ? frame.chroma_offset : expected_offset;
+        uint32_t chroma_stride = frame.chroma_stride ? frame.chroma_stride : expected_chroma_stride;
+        
+        if (chroma_offset == expected_offset && chroma_stride == expected_chroma_stride &&
+            (semi_planar || frame.stride % 2 == 0)) {
+            ndi_frame.p_data = const_cast<uint8_t*>(static_cast<const uint8_t*>(frame.data));
+            ndi_frame.line_stride_in_bytes = frame.stride;
+        } else {
+            ndi_frame.p_data = const_cast<uint8_t*>(repackPlanar420(frame, chroma_offset, chroma_stride));
+            ndi_frame.line_stride_in_bytes = frame.width;
+        }
+        ndi_frame.FourCC = static_cast<NDIlib_FourCC_video_type_e>(frame.fourcc);
     } else {
         // Direct passthrough for other formats
         ndi_frame.p_data = const_cast<uint8_t*>(static_cast<const uint8_t*>(frame.data));
@@ -193,6 +217,10 @@ bool NdiSender::sendFrame(const FrameInfo& frame) {
             case NDIlib_FourCC_type_UYVY:
                 ndi_frame.FourCC = NDIlib_FourCC_type_UYVY;
                 break;
+            case NDIlib_FourCC_type_P216:
+                // 16-bit semi-planar 4:2:2; CbCr plane follows stride * height bytes
+                ndi_frame.FourCC = NDIlib_FourCC_type_P216;
+                break;
             case NDIlib_FourCC_type_BGRA:
                 ndi_frame.FourCC = NDIlib_FourCC_type_BGRA;
                 break;
@@ -217,13 +245,49 @@ bool NdiSender::sendFrame(const FrameInfo& frame) {
     ndi_frame.picture_aspect_ratio = static_cast<float>(frame.width) / frame.height;
     ndi_frame.frame_format_type = NDIlib_frame_format_type_progressive;
     ndi_frame.p_metadata = nullptr;
+    if (timing_metadata_ && frame.capture_realtime_ns > 0) {
+        FrameTiming timing;
+        timing.sequence = frame.sequence;
+        timing.capture_ns = frame.capture_realtime_ns;
+        timing.send_ns = FrameTiming::realtimeNs();
+        char* xml = timing_xml_[timing_slot_];
+        if (timing.toXml(xml, sizeof(timing_xml_[0]))) {
+            ndi_frame.p_metadata = xml;
+            timing_slot_ ^= 1;
+        }
+    }
 
     // Send the frame with timing
     auto send_start = std::chrono::high_resolution_clock::now();
-    NDIlib_send_send_video_v2(ndi_send_instance_, &ndi_frame);
+    if (async) {
+        NDIlib_send_send_video_async_v2(ndi_send_instance_, &ndi_frame);
+    } else {
+        NDIlib_send_send_video_v2(ndi_send_instance_, &ndi_frame);
+    }
     auto send_end = std::chrono::high_resolution_clock::now();
     double send_us = std::chrono::duration<double, std::micro>(send_end - send_start).count();
     
+    // Either call returns only once NDI is done with the previous async frame
+    std::function<void()> previous_release;
+    previous_release.swap(async_release_);
+    async_data_ = nullptr;
+    if (async) {
+        async_data_ = ndi_frame.p_data;
+        if (ndi_frame.p_data == frame.data) {
+            // Passed through: the capture buffer stays with NDI until the next send
+            async_release_ = frame.release;
+            release_guard.dismiss();
+        }
+        if (!async_logged_) {
+            Logger::info("NDI sender: Asynchronous send, capture buffers released when NDI is done");
+            async_logged_ = true;
+        }
+    }
+    send_lock.unlock();
+    if (previous_release) {
+        previous_release();
+    }
+    
     frames_sent_++;
     
     // Log detailed timing every 600 frames (10 seconds at 60fps)
@@ -234,69 +298,117 @@ bool NdiSender::sendFrame(const FrameInfo& frame) {
     return true;
 }
 
-void NdiSender::convertYUYVtoUYVY_Scalar(const uint8_t* src, uint8_t* dst, int width, int height) {
-    // YUYV format: Y0 U0 Y1 V0 | Y2 U2 Y3 V2 | ...
-    // UYVY format: U0 Y0 V0 Y1 | U2 Y2 V2 Y3 | ...
-    size_t pixel_pairs = (width * height) / 2;
-    
-    for (size_t i = 0; i < pixel_pairs; ++i) {
-        // Read YUYV
-        uint8_t y0 = src[0];
-        uint8_t u  = src[1];
-        uint8_t y1 = src[2];
-        uint8_t v  = src[3];
-        
-        // Write UYVY
-        dst[0] = u;
-        dst[1] = y0;
-        dst[2] = v;
-        dst[3] = y1;
-        
-        src += 4;
-        dst += 4;
+void NdiSender::flush() {
+    std::function<void()> release;
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        if (!async_data_) {
+            return;
+        }
+        // A NULL frame waits until NDI no longer reads the last async one
+        NDIlib_send_send_video_async_v2(ndi_send_instance_, nullptr);
+        async_data_ = nullptr;
+        release.swap(async_release_);
+    }
+    if (release) {
+        release();
+    }
+}
+
+std::vector<uint8_t>& NdiSender::writableBuffer(std::vector<uint8_t>& buffer) {
+    if (async_data_ && async_data_ == buffer.data()) {
+        buffer.swap(async_spare_buffer_);
+    }
+    return buffer;
+}
+
+bool NdiSender::sendAudio(const AudioInfo& audio) {
+    if (!initialized_) {
+        return false;
+    }
+
+    if (!audio.data || audio.channels <= 0 || audio.samples <= 0 || audio.sample_rate <= 0) {
+        reportError("Invalid audio data");
+        return false;
+    }
+
+    // Interleaved S16 -> planar float, one channel after the other
+    size_t total = static_cast<size_t>(audio.channels) * audio.samples;
+    if (audio_buffer_.size() < total) {
+        audio_buffer_.resize(total);
+    }
+    const float scale = 1.0f / 32768.0f;
+    for (int ch = 0; ch < audio.channels; ++ch) {
+        float* dst = audio_buffer_.data() + static_cast<size_t>(ch) * audio.samples;
+        const int16_t* src = audio.data + ch;
+        for (int i = 0; i < audio.samples; ++i) {
+            dst[i] = src[static_cast<size_t>(i) * audio.channels] * scale;
+        }
+    }
+
+    NDIlib_audio_frame_v3_t ndi_audio;
+    ndi_audio.sample_rate = audio.sample_rate;
+    ndi_audio.no_channels = audio.channels;
+    ndi_audio.no_samples = audio.samples;
+    ndi_audio.timecode = audio.timestamp_ns / 100;  // Same 100ns units as video
+    ndi_audio.FourCC = NDIlib_FourCC_audio_type_FLTP;
+    ndi_audio.p_data = reinterpret_cast<uint8_t*>(audio_buffer_.data());
+    ndi_audio.channel_stride_in_bytes = audio.samples * static_cast<int>(sizeof(float));
+    ndi_audio.p_metadata = nullptr;
+    ndi_audio.timestamp = 0;
+
+    NDIlib_send_send_audio_v3(ndi_send_instance_, &ndi_audio);
+    audio_samples_sent_ += audio.samples;
+
+    if (!audio_logged_) {
+        Logger::info("NDI sender: Sending audio, " + std::to_string(audio.channels) + " ch @ " +
+                    std::to_string(audio.sample_rate) + " Hz, " + std::to_string(audio.samples) +
+                    " samples per block");
+        audio_logged_ = true;
     }
+
+    return true;
 }
 
-void NdiSender::convertYUYVtoUYVY_AVX2(const uint8_t* src, uint8_t* dst, int width, int height) {
-    // Process 32 pixels (64 bytes) at a time
-    size_t total_bytes = width * height * 2;
-    size_t avx_bytes = (total_bytes / 64) * 64;
+const uint8_t* NdiSender::repackPlanar420(const FrameInfo& frame, uint32_t chroma_offset,
+                                          uint32_t chroma_stride) {
+    const uint8_t* src = static_cast<const uint8_t*>(frame.data);
+    bool semi_planar = frame.fourcc == NDIlib_FourCC_type_NV12;
+    uint32_t chroma_rows = (frame.height + 1) / 2;
+    uint32_t chroma_bytes = semi_planar ? frame.width : frame.width / 2;
+    size_t luma_size = static_cast<size_t>(frame.width) * frame.height;
+    size_t plane_size = static_cast<size_t>(chroma_bytes) * chroma_rows;
+    size_t required = luma_size + (semi_planar ? plane_size : plane_size * 2);
     
-    // Shuffle mask to convert YUYV to UYVY
-    // YUYV: Y0 U0 Y1 V0 Y2 U2 Y3 V2 ... (indices 0,1,2,3,4,5,6,7...)
-    // UYVY: U0 Y0 V0 Y1 U2 Y2 V2 Y3 ... (indices 1,0,3,2,5,4,7,6...)
-    const __m256i shuffle_mask = _mm256_setr_epi8(
-        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
-        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14
-    );
+    std::vector<uint8_t>& target = writableBuffer(planar_buffer_);
+    if (target.size() < required) {
+        target.resize(required);
+    }
     
-    size_t i = 0;
-    for (; i < avx_bytes; i += 64) {
-        // Load 64 bytes (32 pixels in YUYV format)
-        __m256i data0 = _mm256_loadu_si256((__m256i*)(src + i));
-        __m256i data1 = _mm256_loadu_si256((__m256i*)(src + i + 32));
-        
-        // Shuffle to convert YUYV to UYVY
-        __m256i result0 = _mm256_shuffle_epi8(data0, shuffle_mask);
-        __m256i result1 = _mm256_shuffle_epi8(data1, shuffle_mask);
-        
-        // Store results
-        _mm256_storeu_si256((__m256i*)(dst + i), result0);
-        _mm256_storeu_si256((__m256i*)(dst + i + 32), result1);
+    uint8_t* dst = target.data();
+    for (uint32_t y = 0; y < frame.height; ++y) {
+        std::memcpy(dst + y * frame.width, src + static_cast<size_t>(y) * frame.stride, frame.width);
     }
     
-    // Handle remaining bytes with scalar code
-    for (; i < total_bytes; i += 4) {
-        uint8_t y0 = src[i];
-        uint8_t u  = src[i + 1];
-        uint8_t y1 = src[i + 2];
-        uint8_t v  = src[i + 3];
-        
-        dst[i] = u;
-        dst[i + 1] = y0;
-        dst[i + 2] = v;
-        dst[i + 3] = y1;
+    // I420/YV12: the second chroma plane follows the first one
+    uint32_t planes = semi_planar ? 1 : 2;
+    for (uint32_t p = 0; p < planes; ++p) {
+        const uint8_t* chroma_src = src + chroma_offset + static_cast<size_t>(p) * chroma_stride * chroma_rows;
+        uint8_t* chroma_dst = dst + luma_size + p * plane_size;
+        for (uint32_t y = 0; y < chroma_rows; ++y) {
+            std::memcpy(chroma_dst + y * chroma_bytes, chroma_src + static_cast<size_t>(y) * chroma_stride,
+                        chroma_bytes);
+        }
     }
+    
+    if (!planar_repack_logged_) {
+        Logger::info("NDI sender: Repacking planar 4:2:0 frames (chroma offset " +
+                    std::to_string(chroma_offset) + ", chroma stride " + std::to_string(chroma_stride) +
+                    ", NDI expects " + std::to_string(frame.stride * frame.height) + ")");
+        planar_repack_logged_ = true;
+    }
+    
+    return dst;
 }
 
 bool NdiSender::isReady() const {
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "frame_timing.h"
+#include "stripe_executor.h"
+
 #include <string>
 #include <memory>
 #include <cstdint>
@@ -21,7 +24,9 @@ namespace ndi_bridge {
  * It handles NDI library initialization, sender creation, and frame sending with
  * proper format handling.
  * 
- * Version: 1.4.0 - Added zero-copy YUYV support with AVX2 optimization
+ * Version: 1.11.1 - Moves finish the async send in flight first
+ * 
+ * Version: 1.11.0 - Per-frame capture/send timestamps in NDI metadata
  */
 class NdiSender {
 public:
@@ -37,6 +42,27 @@ public:
         int64_t timestamp_ns;  // Timestamp in nanoseconds
         uint32_t fps_numerator;  // Frame rate numerator
         uint32_t fps_denominator;  // Frame rate denominator
+        // Planar 4:2:0 only: first chroma plane offset from data and its
+        // pitch (0 = contiguous layout NDI expects). I420/YV12 second
+        // chroma plane follows the first one directly.
+        uint32_t chroma_offset = 0;
+        uint32_t chroma_stride = 0;
+        // Capture buffer release; when set the frame is sent asynchronously
+        // and released once NDI no longer reads it
+        std::function<void()> release;
+        uint64_t sequence = 0;              // Capture sequence number
+        int64_t capture_realtime_ns = 0;    // Capture time on CLOCK_REALTIME (0 = unknown)
+    };
+
+    /**
+     * @brief Audio block information
+     */
+    struct AudioInfo {
+        const int16_t* data;   // Interleaved S16 samples (channels * samples)
+        int channels;
+        int samples;           // Samples per channel
+        int sample_rate;
+        int64_t timestamp_ns;  // Capture time of the first sample, video clock
     };
 
     /**
@@ -82,10 +108,46 @@ public:
      * @return true if frame was sent successfully
      * 
      * Note: YUYV format will be automatically converted to UYVY
-     * using optimized AVX2 instructions when available.
+     * with the PixelKernels byte swap (SSE4/AVX2/AVX-512). NV12, I420 and
+     * YV12 are passed through; only a chroma plane that is not where NDI
+     * expects it (padded height, odd pitch) costs a repack. P216 is
+     * passed through for 10-bit sources.
+     *
+     * Frames with a release go out with NDIlib_send_send_video_async_v2:
+     * the call returns while NDI still compresses the frame, which stays in
+     * use until the next send or flush(). Its release is called then, or
+     * right away when the frame was converted into an internal buffer or
+     * could not be sent.
      */
     bool sendFrame(const FrameInfo& frame);
 
+    /**
+     * @brief Attach FrameTiming metadata to each video frame
+     *
+     * Frames carry their sequence, capture time and the time they were
+     * handed to NDI so receivers can measure end-to-end latency. Frames
+     * without a capture time go out without metadata.
+     */
+    void setTimingMetadata(bool enabled) { timing_metadata_ = enabled; }
+
+    /**
+     * @brief Finish the asynchronous send in flight and release its frame
+     *
+     * No-op when nothing is in flight.
+     */
+    void flush();
+
+    /**
+     * @brief Send a block of audio
+     * @param audio Interleaved 16-bit samples and their timestamp
+     * @return true if the block was sent
+     *
+     * Converted to planar float (NDI's native audio format) and sent with
+     * a timecode on the same clock as the video frames. May be called from
+     * an audio thread while video frames are sent from another.
+     */
+    bool sendAudio(const AudioInfo& audio);
+
     /**
      * @brief Check if the sender is initialized and ready
      * @return true if ready to send frames
@@ -110,6 +172,11 @@ public:
      */
     uint64_t getFramesSent() const { return frames_sent_; }
 
+    /**
+     * @brief Get total audio samples (per channel) sent
+     */
+    uint64_t getAudioSamplesSent() const { return audio_samples_sent_; }
+
     /**
      * @brief Check if NDI runtime is available
      * @return true if NDI runtime is installed and available
@@ -147,14 +214,19 @@ private:
     void reportError(const std::string& error);
 
     /**
-     * @brief Convert YUYV to UYVY format (scalar version)
+     * @brief Copy a planar 4:2:0 frame into the contiguous layout NDI reads
+     * @return Tightly packed frame (stride = width)
      */
-    void convertYUYVtoUYVY_Scalar(const uint8_t* src, uint8_t* dst, int width, int height);
+    const uint8_t* repackPlanar420(const FrameInfo& frame, uint32_t chroma_offset,
+                                   uint32_t chroma_stride);
 
     /**
-     * @brief Convert YUYV to UYVY format (AVX2 optimized version)
+     * @brief Conversion target that NDI is not reading asynchronously
+     *
+     * Swaps in the spare buffer when buffer holds the frame in flight.
+     * Called with send_mutex_ held.
      */
-    void convertYUYVtoUYVY_AVX2(const uint8_t* src, uint8_t* dst, int width, int height);
+    std::vector<uint8_t>& writableBuffer(std::vector<uint8_t>& buffer);
 
     // Member variables
     std::string sender_name_;
@@ -162,14 +234,34 @@ private:
     mutable std::mutex mutex_;
     std::atomic<bool> initialized_{false};
     std::atomic<uint64_t> frames_sent_{0};
+    std::atomic<uint64_t> audio_samples_sent_{0};
     
     // NDI handles
     NDIlib_send_instance_t ndi_send_instance_{nullptr};
     
     // Optimization support
-    bool has_avx2_{false};
     bool yuyv_conversion_logged_{false};
     std::vector<uint8_t> yuyv_to_uyvy_buffer_;
+    StripeExecutor::RowCost yuyv_cost_;
+    
+    // Timing metadata; NDI reads an async frame's metadata until the next
+    // send, so consecutive frames alternate between two buffers
+    std::atomic<bool> timing_metadata_{false};
+    char timing_xml_[2][FrameTiming::kMaxXmlSize] = {};
+    int timing_slot_ = 0;
+    bool planar_repack_logged_{false};
+    std::vector<uint8_t> planar_buffer_;
+    
+    // Asynchronous send: the frame NDI may still read (send_mutex_)
+    std::mutex send_mutex_;
+    const void* async_data_{nullptr};
+    std::function<void()> async_release_;
+    std::vector<uint8_t> async_spare_buffer_;
+    bool async_logged_{false};
+    
+    // Planar float audio, only touched by the audio thread
+    std::vector<float> audio_buffer_;
+    bool audio_logged_{false};
     
     // NDI library management
     static std::mutex lib_mutex_;
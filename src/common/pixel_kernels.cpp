@@ -0,0 +1,319 @@
+// pixel_kernels.cpp
+// Scalar kernels and runtime selection; built for baseline x86-64
+#include "pixel_kernels.h"
+#include "pixel_kernels_impl.h"
+#include "logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace ndi_bridge {
+
+namespace kernels {
+
+namespace {
+
+// v210 packs 6 pixels into 16 bytes
+constexpr int kV210GroupPixels = 6;
+constexpr int kV210GroupBytes = 16;
+
+inline uint8_t clamp8(int value) {
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// ITU-R BT.601 limited range, 8-bit fixed point; the SIMD variants do the
+// same integer math so every tier produces identical frames
+inline void yuvToBgra(int y, int u, int v, uint8_t* dst) {
+    int c = y - 16;
+    int d = u - 128;
+    int e = v - 128;
+    dst[0] = clamp8((298 * c + 516 * d + 128) >> 8);
+    dst[1] = clamp8((298 * c - 100 * d - 208 * e + 128) >> 8);
+    dst[2] = clamp8((298 * c + 409 * e + 128) >> 8);
+    dst[3] = 255;
+}
+
+// 10-bit field to MSB-aligned 16-bit sample
+inline uint16_t field(uint32_t word, int shift) {
+    return static_cast<uint16_t>(((word >> shift) & 0x3FF) << 6);
+}
+
+inline uint32_t readLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // anonymous namespace
+
+void swapPairsScalar(const uint8_t* src, uint8_t* dst, size_t begin, size_t bytes) {
+    // Eight bytes (four pixels) per step
+    size_t i = begin;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, src + i, sizeof(v));
+        v = ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+        std::memcpy(dst + i, &v, sizeof(v));
+    }
+    for (; i + 2 <= bytes; i += 2) {
+        uint8_t t = src[i];
+        dst[i] = src[i + 1];
+        dst[i + 1] = t;
+    }
+}
+
+void yuyvToBgraScalar(const uint8_t* src, uint8_t* dst, int begin, int width) {
+    // Y0 U0 Y1 V0
+    for (int x = begin; x + 2 <= width; x += 2) {
+        const uint8_t* p = src + static_cast<size_t>(x) * 2;
+        yuvToBgra(p[0], p[1], p[3], dst + static_cast<size_t>(x) * 4);
+        yuvToBgra(p[2], p[1], p[3], dst + static_cast<size_t>(x) * 4 + 4);
+    }
+}
+
+void uyvyToBgraScalar(const uint8_t* src, uint8_t* dst, int begin, int width) {
+    // U0 Y0 V0 Y1
+    for (int x = begin; x + 2 <= width; x += 2) {
+        const uint8_t* p = src + static_cast<size_t>(x) * 2;
+        yuvToBgra(p[1], p[0], p[2], dst + static_cast<size_t>(x) * 4);
+        yuvToBgra(p[3], p[0], p[2], dst + static_cast<size_t>(x) * 4 + 4);
+    }
+}
+
+void nv12ToBgraScalar(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; x++) {
+        const uint8_t* chroma = uv + (x / 2) * 2;
+        yuvToBgra(y[x], chroma[0], chroma[1], dst + static_cast<size_t>(x) * 4);
+    }
+}
+
+void v210ToP216Scalar(const uint8_t* src, uint16_t* y, uint16_t* uv, int begin, int width) {
+    src += static_cast<size_t>(begin / kV210GroupPixels) * kV210GroupBytes;
+
+    for (int x = begin; x < width; x += kV210GroupPixels, src += kV210GroupBytes) {
+        uint32_t w0 = readLE32(src);
+        uint32_t w1 = readLE32(src + 4);
+        uint32_t w2 = readLE32(src + 8);
+        uint32_t w3 = readLE32(src + 12);
+
+        // w0 = Cb0 Y0 Cr0, w1 = Y1 Cb1 Y2, w2 = Cr1 Y3 Cb2, w3 = Y4 Cr2 Y5
+        const uint16_t luma[kV210GroupPixels] = {
+            field(w0, 10), field(w1, 0), field(w1, 20), field(w2, 10), field(w3, 0), field(w3, 20)
+        };
+        const uint16_t chroma[kV210GroupPixels] = {
+            field(w0, 0), field(w0, 20), field(w1, 10), field(w2, 0), field(w2, 20), field(w3, 10)
+        };
+
+        int count = std::min(kV210GroupPixels, width - x);
+        for (int i = 0; i < count; i++) {
+            y[x + i] = luma[i];
+            uv[x + i] = chroma[i];
+        }
+    }
+}
+
+void y210ToP216Scalar(const uint8_t* src, uint16_t* y, uint16_t* uv, int begin, int width) {
+    const uint16_t* samples = reinterpret_cast<const uint16_t*>(src);
+    for (int x = begin; x < width; x++) {
+        y[x] = samples[x * 2];
+        uv[x] = samples[x * 2 + 1];
+    }
+}
+
+void blendLinesScalar(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t begin, size_t bytes, int weight) {
+    const int inverse = 256 - weight;
+    for (size_t i = begin; i < bytes; i++) {
+        dst[i] = static_cast<uint8_t>((a[i] * inverse + b[i] * weight + 128) >> 8);
+    }
+}
+
+void scaleBgraScalar(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+                     const uint16_t* wx, int begin, int width) {
+    for (int x = begin; x < width; x++) {
+        const uint8_t* p0 = src + static_cast<size_t>(x0[x]) * 4;
+        const uint8_t* p1 = src + static_cast<size_t>(x1[x]) * 4;
+        const int weight = wx[x];
+        const int inverse = 256 - weight;
+        uint8_t* out = dst + static_cast<size_t>(x) * 4;
+        out[0] = static_cast<uint8_t>((p0[0] * inverse + p1[0] * weight + 128) >> 8);
+        out[1] = static_cast<uint8_t>((p0[1] * inverse + p1[1] * weight + 128) >> 8);
+        out[2] = static_cast<uint8_t>((p0[2] * inverse + p1[2] * weight + 128) >> 8);
+        out[3] = 255;
+    }
+}
+
+} // namespace kernels
+
+namespace {
+
+constexpr int kTierCount = 4;
+
+// Per kernel, the variant of each tier (nullptr = none at that tier)
+template <typename Fn>
+struct Variants {
+    Fn by_tier[kTierCount];
+};
+
+void swapPairs(const uint8_t* src, uint8_t* dst, size_t bytes) {
+    kernels::swapPairsScalar(src, dst, 0, bytes);
+}
+void yuyvToBgra(const uint8_t* src, uint8_t* dst, int width) {
+    kernels::yuyvToBgraScalar(src, dst, 0, width);
+}
+void uyvyToBgra(const uint8_t* src, uint8_t* dst, int width) {
+    kernels::uyvyToBgraScalar(src, dst, 0, width);
+}
+void nv12ToBgra(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width) {
+    kernels::nv12ToBgraScalar(y, uv, dst, 0, width);
+}
+void v210ToP216(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    kernels::v210ToP216Scalar(src, y, uv, 0, width);
+}
+void y210ToP216(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    kernels::y210ToP216Scalar(src, y, uv, 0, width);
+}
+void blendLines(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t bytes, int weight) {
+    kernels::blendLinesScalar(a, b, dst, 0, bytes, weight);
+}
+void scaleBgra(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+               const uint16_t* wx, int width) {
+    kernels::scaleBgraScalar(src, dst, x0, x1, wx, 0, width);
+}
+
+const Variants<PixelKernels::SwapPairsFn> kSwapPairs = {
+    {swapPairs, kernels::swapPairsSSE4, kernels::swapPairsAVX2, kernels::swapPairsAVX512}};
+const Variants<PixelKernels::PackedToBgraFn> kYuyvToBgra = {
+    {yuyvToBgra, kernels::yuyvToBgraSSE4, kernels::yuyvToBgraAVX2, kernels::yuyvToBgraAVX512}};
+const Variants<PixelKernels::PackedToBgraFn> kUyvyToBgra = {
+    {uyvyToBgra, kernels::uyvyToBgraSSE4, kernels::uyvyToBgraAVX2, kernels::uyvyToBgraAVX512}};
+const Variants<PixelKernels::Nv12ToBgraFn> kNv12ToBgra = {
+    {nv12ToBgra, kernels::nv12ToBgraSSE4, kernels::nv12ToBgraAVX2, kernels::nv12ToBgraAVX512}};
+const Variants<PixelKernels::ToP216Fn> kV210ToP216 = {
+    {v210ToP216, kernels::v210ToP216SSE4, kernels::v210ToP216AVX2, kernels::v210ToP216AVX512}};
+const Variants<PixelKernels::ToP216Fn> kY210ToP216 = {
+    {y210ToP216, kernels::y210ToP216SSE4, kernels::y210ToP216AVX2, kernels::y210ToP216AVX512}};
+// Bound by memory and gathers at display sizes; no AVX-512 variants
+const Variants<PixelKernels::BlendLinesFn> kBlendLines = {
+    {blendLines, kernels::blendLinesSSE4, kernels::blendLinesAVX2, nullptr}};
+const Variants<PixelKernels::ScaleBgraFn> kScaleBgra = {
+    {scaleBgra, kernels::scaleBgraSSE4, kernels::scaleBgraAVX2, nullptr}};
+
+template <typename Fn>
+PixelKernels::Kernel<Fn> pick(const Variants<Fn>& variants, CpuIsa ceiling) {
+    PixelKernels::Kernel<Fn> kernel;
+    for (int tier = static_cast<int>(ceiling); tier >= 0; tier--) {
+        if (variants.by_tier[tier]) {
+            kernel.fn = variants.by_tier[tier];
+            kernel.isa = static_cast<CpuIsa>(tier);
+            break;
+        }
+    }
+    return kernel;
+}
+
+// -1 = no override; set before active() makes its selection
+std::atomic<int> g_isa_override{-1};
+std::atomic<bool> g_selected{false};
+
+PixelKernels selectActive() {
+    g_selected = true;
+
+    const CpuIsa detected = PixelKernels::detectIsa();
+    CpuIsa ceiling = detected;
+    int override_tier = g_isa_override.load();
+    if (override_tier >= 0) {
+        ceiling = static_cast<CpuIsa>(override_tier);
+    } else if (const char* env = std::getenv("NDI_BRIDGE_ISA")) {
+        CpuIsa parsed;
+        if (PixelKernels::isaFromString(env, parsed)) {
+            ceiling = parsed;
+        } else {
+            Logger::warning("Ignoring NDI_BRIDGE_ISA=" + std::string(env) +
+                            " (expected scalar, sse4, avx2 or avx512)");
+        }
+    }
+
+    PixelKernels kernels = PixelKernels::forIsa(ceiling);
+    std::string message = "Pixel kernels: " + std::string(PixelKernels::isaName(kernels.isa));
+    if (kernels.isa != detected) {
+        message += " (capped, CPU supports " + std::string(PixelKernels::isaName(detected)) + ")";
+    }
+    Logger::info(message);
+    return kernels;
+}
+
+} // anonymous namespace
+
+const PixelKernels& PixelKernels::active() {
+    static const PixelKernels kernels = selectActive();
+    return kernels;
+}
+
+PixelKernels PixelKernels::forIsa(CpuIsa ceiling) {
+    PixelKernels kernels;
+    kernels.isa = std::min(ceiling, detectIsa());
+    kernels.swap_pairs = pick(kSwapPairs, kernels.isa);
+    kernels.yuyv_to_bgra = pick(kYuyvToBgra, kernels.isa);
+    kernels.uyvy_to_bgra = pick(kUyvyToBgra, kernels.isa);
+    kernels.nv12_to_bgra = pick(kNv12ToBgra, kernels.isa);
+    kernels.v210_to_p216 = pick(kV210ToP216, kernels.isa);
+    kernels.y210_to_p216 = pick(kY210ToP216, kernels.isa);
+    kernels.blend_lines = pick(kBlendLines, kernels.isa);
+    kernels.scale_bgra = pick(kScaleBgra, kernels.isa);
+    return kernels;
+}
+
+CpuIsa PixelKernels::detectIsa() {
+    // __builtin_cpu_supports also checks that the OS saves the wider registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return CpuIsa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return CpuIsa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return CpuIsa::SSE4;
+    }
+    return CpuIsa::Scalar;
+}
+
+bool PixelKernels::setIsaOverride(CpuIsa ceiling) {
+    g_isa_override = static_cast<int>(ceiling);
+    return !g_selected;
+}
+
+const char* PixelKernels::isaName(CpuIsa isa) {
+    switch (isa) {
+        case CpuIsa::SSE4:
+            return "SSE4";
+        case CpuIsa::AVX2:
+            return "AVX2";
+        case CpuIsa::AVX512:
+            return "AVX-512";
+        case CpuIsa::Scalar:
+        default:
+            return "scalar";
+    }
+}
+
+bool PixelKernels::isaFromString(const std::string& name, CpuIsa& isa) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "scalar") {
+        isa = CpuIsa::Scalar;
+    } else if (lower == "sse4" || lower == "sse4.1") {
+        isa = CpuIsa::SSE4;
+    } else if (lower == "avx2") {
+        isa = CpuIsa::AVX2;
+    } else if (lower == "avx512" || lower == "avx-512") {
+        isa = CpuIsa::AVX512;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace ndi_bridge
@@ -0,0 +1,103 @@
+// pixel_kernels.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ndi_bridge {
+
+/**
+ * @brief Instruction set tiers the pixel kernels are built for
+ */
+enum class CpuIsa {
+    Scalar,   // Plain C++, any x86-64
+    SSE4,     // SSE4.1 (older Celerons and Atoms)
+    AVX2,     // AVX2 (N100 and most parts since Haswell)
+    AVX512    // AVX-512 F + BW (Xeon lab machines)
+};
+
+/**
+ * @brief Pixel kernels selected once for the CPU they run on
+ *
+ * Every SIMD variant lives in its own translation unit
+ * (pixel_kernels_<isa>.cpp) and carries a target attribute, so the rest of
+ * the binary is built for baseline x86-64 and never reaches an instruction
+ * the CPU lacks. For each kernel the table holds the best variant at or
+ * below the selected tier.
+ *
+ * The tier comes from cpuid. NDI_BRIDGE_ISA (scalar, sse4, avx2, avx512)
+ * or setIsaOverride() caps it, e.g. to benchmark the Celeron path on an
+ * N100; a cap above what the CPU supports is ignored.
+ *
+ * Kernels work on one line; callers handle strides and rows. The SIMD
+ * variants are bit-exact with the scalar ones. A kernel may have no
+ * variant at some tier (blend_lines and scale_bgra stop at AVX2); the
+ * next lower one is used there.
+ *
+ * Version: 1.1.0
+ */
+struct PixelKernels {
+    template <typename Fn>
+    struct Kernel {
+        Fn fn = nullptr;
+        CpuIsa isa = CpuIsa::Scalar;   // Tier of the selected variant
+    };
+
+    // Swap the bytes of each 16-bit pair (YUYV <-> UYVY); dst may be src
+    using SwapPairsFn = void (*)(const uint8_t* src, uint8_t* dst, size_t bytes);
+    // Packed 4:2:2 line to BGRA, BT.601 limited range (width even)
+    using PackedToBgraFn = void (*)(const uint8_t* src, uint8_t* dst, int width);
+    // NV12 luma line plus its interleaved chroma line to BGRA (width even)
+    using Nv12ToBgraFn = void (*)(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width);
+    // 10-bit 4:2:2 line to a P216 luma and CbCr line (width even)
+    using ToP216Fn = void (*)(const uint8_t* src, uint16_t* y, uint16_t* uv, int width);
+    // Blend two lines byte by byte, (a * (256 - weight) + b * weight + 128) >> 8
+    // with weight 0-255; dst may be a
+    using BlendLinesFn = void (*)(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t bytes, int weight);
+    // Resample a BGRA line: dst pixel i blends src pixels x0[i] and x1[i]
+    // by wx[i] / 256 (0-255) per channel; alpha is set to 255
+    using ScaleBgraFn = void (*)(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+                                 const uint16_t* wx, int width);
+
+    CpuIsa isa = CpuIsa::Scalar;   // Tier the table was selected for
+    Kernel<SwapPairsFn> swap_pairs;
+    Kernel<PackedToBgraFn> yuyv_to_bgra;
+    Kernel<PackedToBgraFn> uyvy_to_bgra;
+    Kernel<Nv12ToBgraFn> nv12_to_bgra;
+    Kernel<ToP216Fn> v210_to_p216;
+    Kernel<ToP216Fn> y210_to_p216;
+    Kernel<BlendLinesFn> blend_lines;
+    Kernel<ScaleBgraFn> scale_bgra;
+
+    /**
+     * @brief Kernels of this process, selected and logged on first use
+     */
+    static const PixelKernels& active();
+
+    /**
+     * @brief Kernels capped at a tier (benchmark comparisons)
+     * @param ceiling Highest tier to use; clamped to what the CPU supports
+     */
+    static PixelKernels forIsa(CpuIsa ceiling);
+
+    /**
+     * @brief Highest tier the CPU supports
+     */
+    static CpuIsa detectIsa();
+
+    /**
+     * @brief Cap the tier active() selects (takes precedence over NDI_BRIDGE_ISA)
+     * @return false if active() already made its selection
+     */
+    static bool setIsaOverride(CpuIsa ceiling);
+
+    static const char* isaName(CpuIsa isa);
+
+    /**
+     * @brief Parse "scalar", "sse4", "avx2" or "avx512" (case-insensitive)
+     */
+    static bool isaFromString(const std::string& name, CpuIsa& isa);
+};
+
+} // namespace ndi_bridge
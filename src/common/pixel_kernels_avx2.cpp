@@ -0,0 +1,252 @@
+// pixel_kernels_avx2.cpp
+// AVX2 variants; every function carries the target attribute so the unit
+// builds without -m flags and is only entered after PixelKernels checked cpuid
+#include "pixel_kernels_impl.h"
+#include <immintrin.h>
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+namespace ndi_bridge {
+namespace kernels {
+
+namespace {
+
+// Two 16-bit coefficients for _mm256_madd_epi16: lo * even + hi * odd
+constexpr int pairOf(int lo, int hi) {
+    return static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(hi)) << 16) |
+                            static_cast<uint16_t>(lo));
+}
+
+// BT.601 for 16 pixels, 8 per 128-bit lane; y, u, v hold 16-bit samples.
+// Matches yuvToBgra() in pixel_kernels.cpp bit for bit.
+AVX2_TARGET inline void storeBgra16(__m256i y, __m256i u, __m256i v, uint8_t* dst) {
+    const __m256i c = _mm256_sub_epi16(y, _mm256_set1_epi16(16));
+    const __m256i d = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+    const __m256i e = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+    const __m256i round = _mm256_set1_epi32(128);
+    const __m256i k_r = _mm256_set1_epi32(pairOf(298, 409));
+    const __m256i k_b = _mm256_set1_epi32(pairOf(298, 516));
+    const __m256i k_g_cd = _mm256_set1_epi32(pairOf(298, -100));
+    const __m256i k_g_e = _mm256_set1_epi32(pairOf(-208, 128));   // 128 * 1 is the rounding term
+    const __m256i one = _mm256_set1_epi16(1);
+
+    __m256i ce_lo = _mm256_unpacklo_epi16(c, e), ce_hi = _mm256_unpackhi_epi16(c, e);
+    __m256i cd_lo = _mm256_unpacklo_epi16(c, d), cd_hi = _mm256_unpackhi_epi16(c, d);
+    __m256i e1_lo = _mm256_unpacklo_epi16(e, one), e1_hi = _mm256_unpackhi_epi16(e, one);
+
+    __m256i r = _mm256_packs_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(ce_lo, k_r), round), 8),
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(ce_hi, k_r), round), 8));
+    __m256i b = _mm256_packs_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_lo, k_b), round), 8),
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_hi, k_b), round), 8));
+    __m256i g = _mm256_packs_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_lo, k_g_cd), _mm256_madd_epi16(e1_lo, k_g_e)), 8),
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(cd_hi, k_g_cd), _mm256_madd_epi16(e1_hi, k_g_e)), 8));
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max8 = _mm256_set1_epi16(255);
+    r = _mm256_min_epi16(_mm256_max_epi16(r, zero), max8);
+    g = _mm256_min_epi16(_mm256_max_epi16(g, zero), max8);
+    b = _mm256_min_epi16(_mm256_max_epi16(b, zero), max8);
+
+    // Per lane: lo = pixels 0-3, hi = pixels 4-7; put the lanes back in order
+    __m256i bg = _mm256_or_si256(b, _mm256_slli_epi16(g, 8));
+    __m256i ra = _mm256_or_si256(r, _mm256_set1_epi16(static_cast<short>(0xFF00)));
+    __m256i lo = _mm256_unpacklo_epi16(bg, ra);
+    __m256i hi = _mm256_unpackhi_epi16(bg, ra);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+// 16 packed 4:2:2 pixels; the per-lane masks pick Y, U and V out as 16-bit samples
+AVX2_TARGET inline void packedToBgra(const uint8_t* src, uint8_t* dst, int width,
+                                     __m128i y_mask, __m128i u_mask, __m128i v_mask,
+                                     void (*tail)(const uint8_t*, uint8_t*, int, int)) {
+    const __m256i y_sel = _mm256_broadcastsi128_si256(y_mask);
+    const __m256i u_sel = _mm256_broadcastsi128_si256(u_mask);
+    const __m256i v_sel = _mm256_broadcastsi128_si256(v_mask);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + static_cast<size_t>(x) * 2));
+        storeBgra16(_mm256_shuffle_epi8(in, y_sel), _mm256_shuffle_epi8(in, u_sel),
+                    _mm256_shuffle_epi8(in, v_sel), dst + static_cast<size_t>(x) * 4);
+    }
+    tail(src, dst, x, width);
+}
+
+} // anonymous namespace
+
+AVX2_TARGET void swapPairsAVX2(const uint8_t* src, uint8_t* dst, size_t bytes) {
+    // 64 bytes (32 pixels) per iteration
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        a = _mm256_or_si256(_mm256_slli_epi16(a, 8), _mm256_srli_epi16(a, 8));
+        b = _mm256_or_si256(_mm256_slli_epi16(b, 8), _mm256_srli_epi16(b, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), b);
+    }
+    swapPairsScalar(src, dst, i, bytes);
+}
+
+AVX2_TARGET void yuyvToBgraAVX2(const uint8_t* src, uint8_t* dst, int width) {
+    // Y0 U0 Y1 V0
+    packedToBgra(src, dst, width,
+                 _mm_setr_epi8(0, -1, 2, -1, 4, -1, 6, -1, 8, -1, 10, -1, 12, -1, 14, -1),
+                 _mm_setr_epi8(1, -1, 1, -1, 5, -1, 5, -1, 9, -1, 9, -1, 13, -1, 13, -1),
+                 _mm_setr_epi8(3, -1, 3, -1, 7, -1, 7, -1, 11, -1, 11, -1, 15, -1, 15, -1),
+                 yuyvToBgraScalar);
+}
+
+AVX2_TARGET void uyvyToBgraAVX2(const uint8_t* src, uint8_t* dst, int width) {
+    // U0 Y0 V0 Y1
+    packedToBgra(src, dst, width,
+                 _mm_setr_epi8(1, -1, 3, -1, 5, -1, 7, -1, 9, -1, 11, -1, 13, -1, 15, -1),
+                 _mm_setr_epi8(0, -1, 0, -1, 4, -1, 4, -1, 8, -1, 8, -1, 12, -1, 12, -1),
+                 _mm_setr_epi8(2, -1, 2, -1, 6, -1, 6, -1, 10, -1, 10, -1, 14, -1, 14, -1),
+                 uyvyToBgraScalar);
+}
+
+AVX2_TARGET void nv12ToBgraAVX2(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width) {
+    // Per lane: 8 luma bytes in the low half, their 4 CbCr pairs in the high half
+    const __m256i y_mask = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, -1, 1, -1, 2, -1, 3, -1, 4, -1, 5, -1, 6, -1, 7, -1));
+    const __m256i u_mask = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(8, -1, 8, -1, 10, -1, 10, -1, 12, -1, 12, -1, 14, -1, 14, -1));
+    const __m256i v_mask = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(9, -1, 9, -1, 11, -1, 11, -1, 13, -1, 13, -1, 15, -1, 15, -1));
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        __m128i chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x));
+        // Quadwords Y0 Y1 C0 C1 -> Y0 C0 | Y1 C1
+        __m256i in = _mm256_permute4x64_epi64(_mm256_set_m128i(chroma, luma), 0xD8);
+        storeBgra16(_mm256_shuffle_epi8(in, y_mask), _mm256_shuffle_epi8(in, u_mask),
+                    _mm256_shuffle_epi8(in, v_mask), dst + static_cast<size_t>(x) * 4);
+    }
+    nv12ToBgraScalar(y, uv, dst, x, width);
+}
+
+AVX2_TARGET void v210ToP216AVX2(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    // Per 128-bit lane (one v210 group, words w0..w3) the three 10-bit
+    // fields are split into s0 (bits 0-9), s1 (10-19) and s2 (20-29).
+    // c holds s0/s1 as 16-bit pairs, s2 sits in the even 16-bit slots:
+    //   Y  = c1 c2 s2[2] c5 c6 s2[6]      (Y0 Y1 Y2 Y3 Y4 Y5)
+    //   UV = c0 s2[0] c3 c4 s2[4] c7      (Cb0 Cr0 Cb1 Cr1 Cb2 Cr2)
+    const __m256i mask10 = _mm256_set1_epi32(0x3FF);
+    const __m256i y_from_c = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(2, 3, 4, 5, -1, -1, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1));
+    const __m256i y_from_s2 = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(-1, -1, -1, -1, 4, 5, -1, -1, -1, -1, 12, 13, -1, -1, -1, -1));
+    const __m256i uv_from_c = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, 1, -1, -1, 6, 7, 8, 9, -1, -1, 14, 15, -1, -1, -1, -1));
+    const __m256i uv_from_s2 = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(-1, -1, 0, 1, -1, -1, -1, -1, 8, 9, -1, -1, -1, -1, -1, -1));
+
+    // 12 pixels per iteration; the second 16-byte store of each plane
+    // spills 2 samples past them, so keep 2 pixels of headroom
+    int x = 0;
+    for (; x + 14 <= width; x += 12) {
+        const uint8_t* groups = src + static_cast<size_t>(x / 6) * 16;
+        __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(groups));
+
+        __m256i s0 = _mm256_slli_epi32(_mm256_and_si256(words, mask10), 6);
+        __m256i s1 = _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(words, 10), mask10), 6);
+        __m256i s2 = _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(words, 20), mask10), 6);
+
+        __m256i c = _mm256_or_si256(s0, _mm256_slli_epi32(s1, 16));
+        __m256i luma = _mm256_or_si256(_mm256_shuffle_epi8(c, y_from_c), _mm256_shuffle_epi8(s2, y_from_s2));
+        __m256i chroma = _mm256_or_si256(_mm256_shuffle_epi8(c, uv_from_c), _mm256_shuffle_epi8(s2, uv_from_s2));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x), _mm256_castsi256_si128(luma));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x + 6), _mm256_extracti128_si256(luma, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x), _mm256_castsi256_si128(chroma));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x + 6), _mm256_extracti128_si256(chroma, 1));
+    }
+    v210ToP216Scalar(src, y, uv, x, width);
+}
+
+AVX2_TARGET void y210ToP216AVX2(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    // Per lane: even 16-bit samples (Y) to the low 8 bytes, odd (CbCr) to the high 8
+    const __m256i split = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15));
+
+    // 16 pixels (64 input bytes) per iteration
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m256i* in = reinterpret_cast<const __m256i*>(src + static_cast<size_t>(x) * 4);
+        __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256(in), split);
+        __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256(in + 1), split);
+
+        // Gather the Y quadwords into the low lane and CbCr into the high lane
+        a = _mm256_permute4x64_epi64(a, 0xD8);
+        b = _mm256_permute4x64_epi64(b, 0xD8);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y + x), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + x), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    y210ToP216Scalar(src, y, uv, x, width);
+}
+
+AVX2_TARGET void blendLinesAVX2(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t bytes, int weight) {
+    // 32 bytes per iteration; unpack and pack both work per lane, so the
+    // byte order comes back unchanged
+    const __m256i w = _mm256_set1_epi16(static_cast<short>(weight));
+    const __m256i inverse = _mm256_set1_epi16(static_cast<short>(256 - weight));
+    const __m256i round = _mm256_set1_epi16(128);
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i lo = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(va, zero), inverse),
+                             _mm256_mullo_epi16(_mm256_unpacklo_epi8(vb, zero), w)), round);
+        __m256i hi = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(va, zero), inverse),
+                             _mm256_mullo_epi16(_mm256_unpackhi_epi8(vb, zero), w)), round);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8)));
+    }
+    blendLinesScalar(a, b, dst, i, bytes, weight);
+}
+
+AVX2_TARGET void scaleBgraAVX2(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+                               const uint16_t* wx, int width) {
+    // 8 pixels per iteration, both neighbours gathered. B/R and G/A are
+    // blended as 16-bit pairs in place, so the weight only has to be
+    // doubled up within each pixel.
+    const __m256i low_bytes = _mm256_set1_epi16(0x00FF);
+    const __m256i full = _mm256_set1_epi16(256);
+    const __m256i round = _mm256_set1_epi16(128);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    const int* pixels = reinterpret_cast<const int*>(src);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i p0 = _mm256_i32gather_epi32(pixels, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x0 + x)), 4);
+        __m256i p1 = _mm256_i32gather_epi32(pixels, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x1 + x)), 4);
+        __m256i w = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wx + x)));
+        w = _mm256_or_si256(w, _mm256_slli_epi32(w, 16));
+        __m256i inverse = _mm256_sub_epi16(full, w);
+
+        __m256i even = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(p0, low_bytes), inverse),
+                             _mm256_mullo_epi16(_mm256_and_si256(p1, low_bytes), w)), round);
+        __m256i odd = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p0, 8), inverse),
+                             _mm256_mullo_epi16(_mm256_srli_epi16(p1, 8), w)), round);
+        __m256i out = _mm256_or_si256(_mm256_srli_epi16(even, 8), _mm256_andnot_si256(low_bytes, odd));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + static_cast<size_t>(x) * 4),
+                            _mm256_or_si256(out, alpha));
+    }
+    scaleBgraScalar(src, dst, x0, x1, wx, x, width);
+}
+
+} // namespace kernels
+} // namespace ndi_bridge
@@ -0,0 +1,218 @@
+// pixel_kernels_avx512.cpp
+// AVX-512 (F + BW) variants; every function carries the target attribute so
+// the unit builds without -m flags and is only entered after PixelKernels
+// checked cpuid
+#include "pixel_kernels_impl.h"
+
+// GCC 12's AVX-512 headers trip -Wmaybe-uninitialized on their own
+// placeholder operands (GCC bug 105593)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#define AVX512_TARGET __attribute__((target("avx512f,avx512bw")))
+
+namespace ndi_bridge {
+namespace kernels {
+
+namespace {
+
+// Two 16-bit coefficients for _mm512_madd_epi16: lo * even + hi * odd
+constexpr int pairOf(int lo, int hi) {
+    return static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(hi)) << 16) |
+                            static_cast<uint16_t>(lo));
+}
+
+// Permutation tables (plain arrays, loaded inside the kernels)
+alignas(64) const uint64_t kBgraLow[8] = {0, 1, 8, 9, 2, 3, 10, 11};
+alignas(64) const uint64_t kBgraHigh[8] = {4, 5, 12, 13, 6, 7, 14, 15};
+alignas(64) const uint64_t kNv12Interleave[8] = {0, 8, 1, 9, 2, 10, 3, 11};
+alignas(64) const uint16_t kEvenWords[32] = {
+    0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+    32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62};
+alignas(64) const uint16_t kOddWords[32] = {
+    1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31,
+    33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63};
+// v210: the 6 valid words of each lane, packed to the front
+alignas(64) const uint16_t kV210Compact[32] = {
+    0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, 16, 17, 18, 19,
+    20, 21, 24, 25, 26, 27, 28, 29, 0, 0, 0, 0, 0, 0, 0, 0};
+
+AVX512_TARGET inline __m512i loadTable(const void* table) {
+    return _mm512_load_si512(table);
+}
+
+// BT.601 for 32 pixels, 8 per 128-bit lane; y, u, v hold 16-bit samples.
+// Matches yuvToBgra() in pixel_kernels.cpp bit for bit.
+AVX512_TARGET inline void storeBgra32(__m512i y, __m512i u, __m512i v, uint8_t* dst) {
+    const __m512i c = _mm512_sub_epi16(y, _mm512_set1_epi16(16));
+    const __m512i d = _mm512_sub_epi16(u, _mm512_set1_epi16(128));
+    const __m512i e = _mm512_sub_epi16(v, _mm512_set1_epi16(128));
+    const __m512i round = _mm512_set1_epi32(128);
+    const __m512i k_r = _mm512_set1_epi32(pairOf(298, 409));
+    const __m512i k_b = _mm512_set1_epi32(pairOf(298, 516));
+    const __m512i k_g_cd = _mm512_set1_epi32(pairOf(298, -100));
+    const __m512i k_g_e = _mm512_set1_epi32(pairOf(-208, 128));   // 128 * 1 is the rounding term
+    const __m512i one = _mm512_set1_epi16(1);
+
+    __m512i ce_lo = _mm512_unpacklo_epi16(c, e), ce_hi = _mm512_unpackhi_epi16(c, e);
+    __m512i cd_lo = _mm512_unpacklo_epi16(c, d), cd_hi = _mm512_unpackhi_epi16(c, d);
+    __m512i e1_lo = _mm512_unpacklo_epi16(e, one), e1_hi = _mm512_unpackhi_epi16(e, one);
+
+    __m512i r = _mm512_packs_epi32(
+        _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(ce_lo, k_r), round), 8),
+        _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(ce_hi, k_r), round), 8));
+    __m512i b = _mm512_packs_epi32(
+        _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(cd_lo, k_b), round), 8),
+        _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(cd_hi, k_b), round), 8));
+    __m512i g = _mm512_packs_epi32(
+        _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(cd_lo, k_g_cd), _mm512_madd_epi16(e1_lo, k_g_e)), 8),
+        _mm512_srai_epi32(_mm512_add_epi32(_mm512_madd_epi16(cd_hi, k_g_cd), _mm512_madd_epi16(e1_hi, k_g_e)), 8));
+
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i max8 = _mm512_set1_epi16(255);
+    r = _mm512_min_epi16(_mm512_max_epi16(r, zero), max8);
+    g = _mm512_min_epi16(_mm512_max_epi16(g, zero), max8);
+    b = _mm512_min_epi16(_mm512_max_epi16(b, zero), max8);
+
+    // Per lane: lo = pixels 0-3, hi = pixels 4-7; interleave the lanes back in order
+    __m512i bg = _mm512_or_si512(b, _mm512_slli_epi16(g, 8));
+    __m512i ra = _mm512_or_si512(r, _mm512_set1_epi16(static_cast<short>(0xFF00)));
+    __m512i lo = _mm512_unpacklo_epi16(bg, ra);
+    __m512i hi = _mm512_unpackhi_epi16(bg, ra);
+    _mm512_storeu_si512(dst, _mm512_permutex2var_epi64(lo, loadTable(kBgraLow), hi));
+    _mm512_storeu_si512(dst + 64, _mm512_permutex2var_epi64(lo, loadTable(kBgraHigh), hi));
+}
+
+// 32 packed 4:2:2 pixels; the per-lane masks pick Y, U and V out as 16-bit samples
+AVX512_TARGET inline void packedToBgra(const uint8_t* src, uint8_t* dst, int width,
+                                       __m128i y_mask, __m128i u_mask, __m128i v_mask,
+                                       void (*tail)(const uint8_t*, uint8_t*, int, int)) {
+    const __m512i y_sel = _mm512_broadcast_i32x4(y_mask);
+    const __m512i u_sel = _mm512_broadcast_i32x4(u_mask);
+    const __m512i v_sel = _mm512_broadcast_i32x4(v_mask);
+
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m512i in = _mm512_loadu_si512(src + static_cast<size_t>(x) * 2);
+        storeBgra32(_mm512_shuffle_epi8(in, y_sel), _mm512_shuffle_epi8(in, u_sel),
+                    _mm512_shuffle_epi8(in, v_sel), dst + static_cast<size_t>(x) * 4);
+    }
+    tail(src, dst, x, width);
+}
+
+} // anonymous namespace
+
+AVX512_TARGET void swapPairsAVX512(const uint8_t* src, uint8_t* dst, size_t bytes) {
+    // 128 bytes (64 pixels) per iteration
+    size_t i = 0;
+    for (; i + 128 <= bytes; i += 128) {
+        __m512i a = _mm512_loadu_si512(src + i);
+        __m512i b = _mm512_loadu_si512(src + i + 64);
+        a = _mm512_or_si512(_mm512_slli_epi16(a, 8), _mm512_srli_epi16(a, 8));
+        b = _mm512_or_si512(_mm512_slli_epi16(b, 8), _mm512_srli_epi16(b, 8));
+        _mm512_storeu_si512(dst + i, a);
+        _mm512_storeu_si512(dst + i + 64, b);
+    }
+    swapPairsScalar(src, dst, i, bytes);
+}
+
+AVX512_TARGET void yuyvToBgraAVX512(const uint8_t* src, uint8_t* dst, int width) {
+    // Y0 U0 Y1 V0
+    packedToBgra(src, dst, width,
+                 _mm_setr_epi8(0, -1, 2, -1, 4, -1, 6, -1, 8, -1, 10, -1, 12, -1, 14, -1),
+                 _mm_setr_epi8(1, -1, 1, -1, 5, -1, 5, -1, 9, -1, 9, -1, 13, -1, 13, -1),
+                 _mm_setr_epi8(3, -1, 3, -1, 7, -1, 7, -1, 11, -1, 11, -1, 15, -1, 15, -1),
+                 yuyvToBgraScalar);
+}
+
+AVX512_TARGET void uyvyToBgraAVX512(const uint8_t* src, uint8_t* dst, int width) {
+    // U0 Y0 V0 Y1
+    packedToBgra(src, dst, width,
+                 _mm_setr_epi8(1, -1, 3, -1, 5, -1, 7, -1, 9, -1, 11, -1, 13, -1, 15, -1),
+                 _mm_setr_epi8(0, -1, 0, -1, 4, -1, 4, -1, 8, -1, 8, -1, 12, -1, 12, -1),
+                 _mm_setr_epi8(2, -1, 2, -1, 6, -1, 6, -1, 10, -1, 10, -1, 14, -1, 14, -1),
+                 uyvyToBgraScalar);
+}
+
+AVX512_TARGET void nv12ToBgraAVX512(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width) {
+    // Per lane: 8 luma bytes in the low half, their 4 CbCr pairs in the high half
+    const __m512i y_mask = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(0, -1, 1, -1, 2, -1, 3, -1, 4, -1, 5, -1, 6, -1, 7, -1));
+    const __m512i u_mask = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(8, -1, 8, -1, 10, -1, 10, -1, 12, -1, 12, -1, 14, -1, 14, -1));
+    const __m512i v_mask = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(9, -1, 9, -1, 11, -1, 11, -1, 13, -1, 13, -1, 15, -1, 15, -1));
+    const __m512i interleave = loadTable(kNv12Interleave);
+
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        // 32 bytes of each line; quadwords Y0..Y3, C0..C3 -> Y0 C0 | Y1 C1 | Y2 C2 | Y3 C3
+        __m512i luma = _mm512_maskz_loadu_epi64(0x0F, y + x);
+        __m512i chroma = _mm512_maskz_loadu_epi64(0x0F, uv + x);
+        __m512i in = _mm512_permutex2var_epi64(luma, interleave, chroma);
+        storeBgra32(_mm512_shuffle_epi8(in, y_mask), _mm512_shuffle_epi8(in, u_mask),
+                    _mm512_shuffle_epi8(in, v_mask), dst + static_cast<size_t>(x) * 4);
+    }
+    nv12ToBgraScalar(y, uv, dst, x, width);
+}
+
+AVX512_TARGET void v210ToP216AVX512(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    // Same field split as the SSE4/AVX2 kernels, one v210 group per lane;
+    // the 6 valid samples of each lane are then packed together and
+    // written with a masked store, so no headroom is needed
+    const __m512i mask10 = _mm512_set1_epi32(0x3FF);
+    const __m512i y_from_c = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(2, 3, 4, 5, -1, -1, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1));
+    const __m512i y_from_s2 = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(-1, -1, -1, -1, 4, 5, -1, -1, -1, -1, 12, 13, -1, -1, -1, -1));
+    const __m512i uv_from_c = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(0, 1, -1, -1, 6, 7, 8, 9, -1, -1, 14, 15, -1, -1, -1, -1));
+    const __m512i uv_from_s2 = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(-1, -1, 0, 1, -1, -1, -1, -1, 8, 9, -1, -1, -1, -1, -1, -1));
+    const __m512i compact = loadTable(kV210Compact);
+    const __mmask32 store_mask = 0x00FFFFFF;   // 24 samples
+
+    // 24 pixels (4 groups) per iteration
+    int x = 0;
+    for (; x + 24 <= width; x += 24) {
+        __m512i words = _mm512_loadu_si512(src + static_cast<size_t>(x / 6) * 16);
+
+        __m512i s0 = _mm512_slli_epi32(_mm512_and_si512(words, mask10), 6);
+        __m512i s1 = _mm512_slli_epi32(_mm512_and_si512(_mm512_srli_epi32(words, 10), mask10), 6);
+        __m512i s2 = _mm512_slli_epi32(_mm512_and_si512(_mm512_srli_epi32(words, 20), mask10), 6);
+
+        __m512i c = _mm512_or_si512(s0, _mm512_slli_epi32(s1, 16));
+        __m512i luma = _mm512_or_si512(_mm512_shuffle_epi8(c, y_from_c), _mm512_shuffle_epi8(s2, y_from_s2));
+        __m512i chroma = _mm512_or_si512(_mm512_shuffle_epi8(c, uv_from_c), _mm512_shuffle_epi8(s2, uv_from_s2));
+
+        _mm512_mask_storeu_epi16(y + x, store_mask, _mm512_permutexvar_epi16(compact, luma));
+        _mm512_mask_storeu_epi16(uv + x, store_mask, _mm512_permutexvar_epi16(compact, chroma));
+    }
+    v210ToP216Scalar(src, y, uv, x, width);
+}
+
+AVX512_TARGET void y210ToP216AVX512(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    const __m512i even = loadTable(kEvenWords);
+    const __m512i odd = loadTable(kOddWords);
+
+    // 32 pixels (128 input bytes) per iteration
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        const uint8_t* in = src + static_cast<size_t>(x) * 4;
+        __m512i a = _mm512_loadu_si512(in);
+        __m512i b = _mm512_loadu_si512(in + 64);
+        _mm512_storeu_si512(y + x, _mm512_permutex2var_epi16(a, even, b));
+        _mm512_storeu_si512(uv + x, _mm512_permutex2var_epi16(a, odd, b));
+    }
+    y210ToP216Scalar(src, y, uv, x, width);
+}
+
+} // namespace kernels
+} // namespace ndi_bridge
@@ -0,0 +1,56 @@
+// pixel_kernels_impl.h
+// Shared by the pixel_kernels*.cpp translation units only. Declarations
+// only: anything inline here would be compiled into each ISA's unit and
+// could be merged across them by the linker.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ndi_bridge {
+namespace kernels {
+
+// Scalar kernels from byte / pixel `begin` to the end of the line; the
+// SIMD variants finish their lines with them (v210: begin multiple of 6)
+void swapPairsScalar(const uint8_t* src, uint8_t* dst, size_t begin, size_t bytes);
+void yuyvToBgraScalar(const uint8_t* src, uint8_t* dst, int begin, int width);
+void uyvyToBgraScalar(const uint8_t* src, uint8_t* dst, int begin, int width);
+void nv12ToBgraScalar(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int begin, int width);
+void v210ToP216Scalar(const uint8_t* src, uint16_t* y, uint16_t* uv, int begin, int width);
+void y210ToP216Scalar(const uint8_t* src, uint16_t* y, uint16_t* uv, int begin, int width);
+void blendLinesScalar(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t begin, size_t bytes, int weight);
+void scaleBgraScalar(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+                     const uint16_t* wx, int begin, int width);
+
+// pixel_kernels_sse4.cpp
+void swapPairsSSE4(const uint8_t* src, uint8_t* dst, size_t bytes);
+void yuyvToBgraSSE4(const uint8_t* src, uint8_t* dst, int width);
+void uyvyToBgraSSE4(const uint8_t* src, uint8_t* dst, int width);
+void nv12ToBgraSSE4(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width);
+void v210ToP216SSE4(const uint8_t* src, uint16_t* y, uint16_t* uv, int width);
+void y210ToP216SSE4(const uint8_t* src, uint16_t* y, uint16_t* uv, int width);
+void blendLinesSSE4(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t bytes, int weight);
+void scaleBgraSSE4(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+                   const uint16_t* wx, int width);
+
+// pixel_kernels_avx2.cpp
+void swapPairsAVX2(const uint8_t* src, uint8_t* dst, size_t bytes);
+void yuyvToBgraAVX2(const uint8_t* src, uint8_t* dst, int width);
+void uyvyToBgraAVX2(const uint8_t* src, uint8_t* dst, int width);
+void nv12ToBgraAVX2(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width);
+void v210ToP216AVX2(const uint8_t* src, uint16_t* y, uint16_t* uv, int width);
+void y210ToP216AVX2(const uint8_t* src, uint16_t* y, uint16_t* uv, int width);
+void blendLinesAVX2(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t bytes, int weight);
+void scaleBgraAVX2(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+                   const uint16_t* wx, int width);
+
+// pixel_kernels_avx512.cpp
+void swapPairsAVX512(const uint8_t* src, uint8_t* dst, size_t bytes);
+void yuyvToBgraAVX512(const uint8_t* src, uint8_t* dst, int width);
+void uyvyToBgraAVX512(const uint8_t* src, uint8_t* dst, int width);
+void nv12ToBgraAVX512(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width);
+void v210ToP216AVX512(const uint8_t* src, uint16_t* y, uint16_t* uv, int width);
+void y210ToP216AVX512(const uint8_t* src, uint16_t* y, uint16_t* uv, int width);
+
+} // namespace kernels
+} // namespace ndi_bridge
@@ -0,0 +1,217 @@
+// pixel_kernels_sse4.cpp
+// SSE4.1 variants; every function carries the target attribute so the unit
+// builds without -m flags and is only entered after PixelKernels checked cpuid
+#include "pixel_kernels_impl.h"
+#include <immintrin.h>
+
+#define SSE4_TARGET __attribute__((target("sse4.1")))
+
+namespace ndi_bridge {
+namespace kernels {
+
+namespace {
+
+// Two 16-bit coefficients for _mm_madd_epi16: lo * even + hi * odd
+constexpr int pairOf(int lo, int hi) {
+    return static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(hi)) << 16) |
+                            static_cast<uint16_t>(lo));
+}
+
+// BT.601 for 8 pixels; y, u, v hold 16-bit samples. Matches yuvToBgra()
+// in pixel_kernels.cpp bit for bit.
+SSE4_TARGET inline void storeBgra8(__m128i y, __m128i u, __m128i v, uint8_t* dst) {
+    const __m128i c = _mm_sub_epi16(y, _mm_set1_epi16(16));
+    const __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    const __m128i round = _mm_set1_epi32(128);
+    const __m128i k_r = _mm_set1_epi32(pairOf(298, 409));
+    const __m128i k_b = _mm_set1_epi32(pairOf(298, 516));
+    const __m128i k_g_cd = _mm_set1_epi32(pairOf(298, -100));
+    const __m128i k_g_e = _mm_set1_epi32(pairOf(-208, 128));   // 128 * 1 is the rounding term
+    const __m128i one = _mm_set1_epi16(1);
+
+    __m128i ce_lo = _mm_unpacklo_epi16(c, e), ce_hi = _mm_unpackhi_epi16(c, e);
+    __m128i cd_lo = _mm_unpacklo_epi16(c, d), cd_hi = _mm_unpackhi_epi16(c, d);
+    __m128i e1_lo = _mm_unpacklo_epi16(e, one), e1_hi = _mm_unpackhi_epi16(e, one);
+
+    __m128i r = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_lo, k_r), round), 8),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_hi, k_r), round), 8));
+    __m128i b = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, k_b), round), 8),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, k_b), round), 8));
+    __m128i g = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, k_g_cd), _mm_madd_epi16(e1_lo, k_g_e)), 8),
+        _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, k_g_cd), _mm_madd_epi16(e1_hi, k_g_e)), 8));
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max8 = _mm_set1_epi16(255);
+    r = _mm_min_epi16(_mm_max_epi16(r, zero), max8);
+    g = _mm_min_epi16(_mm_max_epi16(g, zero), max8);
+    b = _mm_min_epi16(_mm_max_epi16(b, zero), max8);
+
+    __m128i bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+    __m128i ra = _mm_or_si128(r, _mm_set1_epi16(static_cast<short>(0xFF00)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(bg, ra));
+}
+
+// 8 packed 4:2:2 pixels; the masks pick Y, U and V out as 16-bit samples
+SSE4_TARGET inline void packedToBgra(const uint8_t* src, uint8_t* dst, int width,
+                                     __m128i y_mask, __m128i u_mask, __m128i v_mask,
+                                     void (*tail)(const uint8_t*, uint8_t*, int, int)) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + static_cast<size_t>(x) * 2));
+        storeBgra8(_mm_shuffle_epi8(in, y_mask), _mm_shuffle_epi8(in, u_mask),
+                   _mm_shuffle_epi8(in, v_mask), dst + static_cast<size_t>(x) * 4);
+    }
+    tail(src, dst, x, width);
+}
+
+} // anonymous namespace
+
+SSE4_TARGET void swapPairsSSE4(const uint8_t* src, uint8_t* dst, size_t bytes) {
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+        b = _mm_or_si128(_mm_slli_epi16(b, 8), _mm_srli_epi16(b, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), b);
+    }
+    swapPairsScalar(src, dst, i, bytes);
+}
+
+SSE4_TARGET void yuyvToBgraSSE4(const uint8_t* src, uint8_t* dst, int width) {
+    // Y0 U0 Y1 V0
+    packedToBgra(src, dst, width,
+                 _mm_setr_epi8(0, -1, 2, -1, 4, -1, 6, -1, 8, -1, 10, -1, 12, -1, 14, -1),
+                 _mm_setr_epi8(1, -1, 1, -1, 5, -1, 5, -1, 9, -1, 9, -1, 13, -1, 13, -1),
+                 _mm_setr_epi8(3, -1, 3, -1, 7, -1, 7, -1, 11, -1, 11, -1, 15, -1, 15, -1),
+                 yuyvToBgraScalar);
+}
+
+SSE4_TARGET void uyvyToBgraSSE4(const uint8_t* src, uint8_t* dst, int width) {
+    // U0 Y0 V0 Y1
+    packedToBgra(src, dst, width,
+                 _mm_setr_epi8(1, -1, 3, -1, 5, -1, 7, -1, 9, -1, 11, -1, 13, -1, 15, -1),
+                 _mm_setr_epi8(0, -1, 0, -1, 4, -1, 4, -1, 8, -1, 8, -1, 12, -1, 12, -1),
+                 _mm_setr_epi8(2, -1, 2, -1, 6, -1, 6, -1, 10, -1, 10, -1, 14, -1, 14, -1),
+                 uyvyToBgraScalar);
+}
+
+SSE4_TARGET void nv12ToBgraSSE4(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width) {
+    // 8 luma bytes in the low half, their 4 CbCr pairs in the high half
+    const __m128i y_mask = _mm_setr_epi8(0, -1, 1, -1, 2, -1, 3, -1, 4, -1, 5, -1, 6, -1, 7, -1);
+    const __m128i u_mask = _mm_setr_epi8(8, -1, 8, -1, 10, -1, 10, -1, 12, -1, 12, -1, 14, -1, 14, -1);
+    const __m128i v_mask = _mm_setr_epi8(9, -1, 9, -1, 11, -1, 11, -1, 13, -1, 13, -1, 15, -1, 15, -1);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i in = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)),
+                                        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv + x)));
+        storeBgra8(_mm_shuffle_epi8(in, y_mask), _mm_shuffle_epi8(in, u_mask),
+                   _mm_shuffle_epi8(in, v_mask), dst + static_cast<size_t>(x) * 4);
+    }
+    nv12ToBgraScalar(y, uv, dst, x, width);
+}
+
+SSE4_TARGET void v210ToP216SSE4(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    // One v210 group (words w0..w3) per iteration, split into the 10-bit
+    // fields s0 (bits 0-9), s1 (10-19) and s2 (20-29). c holds s0/s1 as
+    // 16-bit pairs, s2 sits in the even 16-bit slots:
+    //   Y  = c1 c2 s2[2] c5 c6 s2[6]      (Y0 Y1 Y2 Y3 Y4 Y5)
+    //   UV = c0 s2[0] c3 c4 s2[4] c7      (Cb0 Cr0 Cb1 Cr1 Cb2 Cr2)
+    const __m128i mask10 = _mm_set1_epi32(0x3FF);
+    const __m128i y_from_c = _mm_setr_epi8(2, 3, 4, 5, -1, -1, 10, 11, 12, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i y_from_s2 = _mm_setr_epi8(-1, -1, -1, -1, 4, 5, -1, -1, -1, -1, 12, 13, -1, -1, -1, -1);
+    const __m128i uv_from_c = _mm_setr_epi8(0, 1, -1, -1, 6, 7, 8, 9, -1, -1, 14, 15, -1, -1, -1, -1);
+    const __m128i uv_from_s2 = _mm_setr_epi8(-1, -1, 0, 1, -1, -1, -1, -1, 8, 9, -1, -1, -1, -1, -1, -1);
+
+    // The 16-byte stores spill 2 samples past the group; keep 2 pixels of headroom
+    int x = 0;
+    for (; x + 8 <= width; x += 6) {
+        __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + static_cast<size_t>(x / 6) * 16));
+
+        __m128i s0 = _mm_slli_epi32(_mm_and_si128(words, mask10), 6);
+        __m128i s1 = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(words, 10), mask10), 6);
+        __m128i s2 = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(words, 20), mask10), 6);
+
+        __m128i c = _mm_or_si128(s0, _mm_slli_epi32(s1, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x),
+                         _mm_or_si128(_mm_shuffle_epi8(c, y_from_c), _mm_shuffle_epi8(s2, y_from_s2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x),
+                         _mm_or_si128(_mm_shuffle_epi8(c, uv_from_c), _mm_shuffle_epi8(s2, uv_from_s2)));
+    }
+    v210ToP216Scalar(src, y, uv, x, width);
+}
+
+SSE4_TARGET void y210ToP216SSE4(const uint8_t* src, uint16_t* y, uint16_t* uv, int width) {
+    // Even 16-bit samples (Y) to the low 8 bytes, odd (CbCr) to the high 8
+    const __m128i split = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+
+    // 8 pixels (32 input bytes) per iteration
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(src + static_cast<size_t>(x) * 4);
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(in), split);
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(in + 1), split);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x), _mm_unpacklo_epi64(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x), _mm_unpackhi_epi64(a, b));
+    }
+    y210ToP216Scalar(src, y, uv, x, width);
+}
+
+SSE4_TARGET void blendLinesSSE4(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t bytes, int weight) {
+    // 16 bytes per iteration; every product stays within 16 bits
+    const __m128i w = _mm_set1_epi16(static_cast<short>(weight));
+    const __m128i inverse = _mm_set1_epi16(static_cast<short>(256 - weight));
+    const __m128i round = _mm_set1_epi16(128);
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(va, zero), inverse),
+                                                 _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), w)), round);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(va, zero), inverse),
+                                                 _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), w)), round);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+    blendLinesScalar(a, b, dst, i, bytes, weight);
+}
+
+SSE4_TARGET void scaleBgraSSE4(const uint8_t* src, uint8_t* dst, const int32_t* x0, const int32_t* x1,
+                               const uint16_t* wx, int width) {
+    // 4 pixels per iteration. B/R and G/A are blended as 16-bit pairs in
+    // place, so the weight only has to be doubled up within each pixel.
+    const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+    const __m128i full = _mm_set1_epi16(256);
+    const __m128i round = _mm_set1_epi16(128);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const int32_t* pixels = reinterpret_cast<const int32_t*>(src);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i p0 = _mm_setr_epi32(pixels[x0[x]], pixels[x0[x + 1]], pixels[x0[x + 2]], pixels[x0[x + 3]]);
+        __m128i p1 = _mm_setr_epi32(pixels[x1[x]], pixels[x1[x + 1]], pixels[x1[x + 2]], pixels[x1[x + 3]]);
+        __m128i w = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(wx + x)));
+        w = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+        __m128i inverse = _mm_sub_epi16(full, w);
+
+        __m128i even = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(p0, low_bytes), inverse),
+                                                   _mm_mullo_epi16(_mm_and_si128(p1, low_bytes), w)), round);
+        __m128i odd = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(p0, 8), inverse),
+                                                  _mm_mullo_epi16(_mm_srli_epi16(p1, 8), w)), round);
+        __m128i out = _mm_or_si128(_mm_srli_epi16(even, 8), _mm_andnot_si128(low_bytes, odd));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + static_cast<size_t>(x) * 4), _mm_or_si128(out, alpha));
+    }
+    scaleBgraScalar(src, dst, x0, x1, wx, x, width);
+}
+
+} // namespace kernels
+} // namespace ndi_bridge
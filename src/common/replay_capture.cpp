@@ -0,0 +1,220 @@
+// replay_capture.cpp
+#include "replay_capture.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <time.h>
+
+namespace ndi_bridge {
+
+namespace {
+
+// Gaps longer than this (a paused recording) are replayed as this
+constexpr int64_t kMaxReplayGapNs = 1000000000LL;
+
+int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void sleepUntil(int64_t target_ns) {
+    struct timespec ts;
+    ts.tv_sec = target_ns / 1000000000LL;
+    ts.tv_nsec = target_ns % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+} // anonymous namespace
+
+ReplayCapture::ReplayCapture(const Config& config)
+    : config_(config) {
+}
+
+ReplayCapture::~ReplayCapture() {
+    stopCapture();
+}
+
+std::vector<ICaptureDevice::DeviceInfo> ReplayCapture::enumerateDevices() {
+    DeviceInfo info;
+    info.id = config_.path;
+    info.name = "Replay of " + config_.path;
+    return {info};
+}
+
+bool ReplayCapture::startCapture(const std::string& device_name) {
+    if (capturing_) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_.clear();
+        has_error_ = false;
+    }
+
+    if (!reader_.open(config_.path)) {
+        setError(reader_.getLastError());
+        return false;
+    }
+    if (config_.fast) {
+        reader_.prefetch();
+    }
+
+    const FrameRecordHeader& header = reader_.getHeader();
+    char fourcc[5] = {0};
+    fourcc[0] = (header.pixelformat >> 0) & 0xFF;
+    fourcc[1] = (header.pixelformat >> 8) & 0xFF;
+    fourcc[2] = (header.pixelformat >> 16) & 0xFF;
+    fourcc[3] = (header.pixelformat >> 24) & 0xFF;
+
+    format_.width = static_cast<int>(header.width);
+    format_.height = static_cast<int>(header.height);
+    format_.stride = static_cast<int>(header.bytesperline);
+    format_.pixel_format = fourcc;
+    format_.fps_numerator = header.fps_numerator > 0 ? header.fps_numerator : 30;
+    format_.fps_denominator = header.fps_denominator > 0 ? header.fps_denominator : 1;
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_ = Stats();
+    }
+
+    should_stop_ = false;
+    capturing_ = true;
+    thread_ = std::make_unique<std::thread>(&ReplayCapture::replayThread, this);
+
+    Logger::info("ReplayCapture: Playing " + config_.path + ": " + std::to_string(reader_.getFrameCount()) +
+                 " frames " + std::to_string(header.width) + "x" + std::to_string(header.height) + " " +
+                 format_.pixel_format + " stride " + std::to_string(header.bytesperline) +
+                 (config_.fast ? ", as fast as possible" : ", original timing"));
+    return true;
+}
+
+void ReplayCapture::stopCapture() {
+    if (!capturing_) {
+        return;
+    }
+
+    should_stop_ = true;
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+    capturing_ = false;
+
+    Stats stats = getStats();
+    double fps = stats.elapsed_s > 0.0 ? stats.frames_replayed / stats.elapsed_s : 0.0;
+    Logger::info("ReplayCapture: Stopped after " + std::to_string(stats.frames_replayed) + " frames (" +
+                 std::to_string(stats.loops) + " loops, " + std::to_string(stats.sink_dropped) +
+                 " dropped downstream) in " + std::to_string(stats.elapsed_s) + "s, " +
+                 std::to_string(fps) + " fps");
+    reader_.close();
+}
+
+bool ReplayCapture::isCapturing() const {
+    return capturing_;
+}
+
+void ReplayCapture::setFrameCallback(FrameCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    frame_callback_ = callback;
+}
+
+void ReplayCapture::setErrorCallback(ErrorCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    error_callback_ = callback;
+}
+
+bool ReplayCapture::hasError() const {
+    return has_error_.load();
+}
+
+std::string ReplayCapture::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+ReplayCapture::Stats ReplayCapture::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void ReplayCapture::replayThread() {
+    const uint32_t frame_count = reader_.getFrameCount();
+    const int64_t nominal_interval_ns = 1000000000LL * format_.fps_denominator / format_.fps_numerator;
+    const int64_t start_ns = monotonicNs();
+
+    // Position on the replay clock; advances by the recorded deltas
+    int64_t replay_ns = start_ns;
+    int64_t previous_ts = reader_.frame(0).timestamp_ns;
+    uint32_t index = 0;
+
+    while (!should_stop_) {
+        FrameRecordReader::Frame frame = reader_.frame(index);
+
+        if (!config_.fast) {
+            int64_t delta = frame.timestamp_ns - previous_ts;
+            if (index == 0) {
+                delta = 0;
+            } else if (delta <= 0 || delta > kMaxReplayGapNs) {
+                // Untimestamped or paused recording
+                delta = delta <= 0 ? nominal_interval_ns : kMaxReplayGapNs;
+            }
+            replay_ns += delta;
+            sleepUntil(replay_ns);
+        }
+        previous_ts = frame.timestamp_ns;
+
+        int64_t timestamp_ns = config_.fast ? monotonicNs() : replay_ns;
+        bool delivered = true;
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            if (frame_callback_) {
+                delivered = frame_callback_(frame.data, frame.size, timestamp_ns, format_);
+            }
+        }
+
+        bool wrapped = false;
+        if (++index >= frame_count) {
+            index = 0;
+            wrapped = true;
+            // One nominal frame between the last and the first frame
+            replay_ns += nominal_interval_ns;
+        }
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_replayed++;
+        if (!delivered) {
+            stats_.sink_dropped++;
+        }
+        if (wrapped) {
+            stats_.loops++;
+        }
+        stats_.elapsed_s = (monotonicNs() - start_ns) / 1e9;
+    }
+}
+
+void ReplayCapture::setError(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = error;
+        has_error_ = true;
+    }
+
+    Logger::error("ReplayCapture Error: " + error);
+
+    ErrorCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = error_callback_;
+    }
+
+    if (callback) {
+        callback(error);
+    }
+}
+
+} // namespace ndi_bridge
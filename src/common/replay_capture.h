@@ -0,0 +1,81 @@
+// replay_capture.h
+#pragma once
+
+#include "capture_interface.h"
+#include "frame_recording.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ndi_bridge {
+
+/**
+ * @brief Plays a .mbrec recording back as a capture device
+ *
+ * Frames are delivered straight from the read-only mapping of the file
+ * (no copy), with the recorded stride, so odd bytesperline values and
+ * bursty USB delivery reproduce exactly. Timing is either the original
+ * inter-frame spacing from the V4L2 timestamps or as fast as the
+ * downstream path accepts frames, for throughput comparisons between
+ * builds on the same input. Playback loops.
+ *
+ * Selected with `ndi-capture --replay FILE [--replay-fast]`.
+ *
+ * Version: 1.0.0
+ */
+class ReplayCapture : public ICaptureDevice {
+public:
+    struct Config {
+        std::string path;
+        bool fast = false;      // Ignore recorded timing
+    };
+
+    struct Stats {
+        uint64_t frames_replayed = 0;
+        uint64_t loops = 0;
+        uint64_t sink_dropped = 0;
+        double elapsed_s = 0.0;
+    };
+
+    explicit ReplayCapture(const Config& config);
+    ~ReplayCapture() override;
+
+    // ICaptureDevice
+    std::vector<DeviceInfo> enumerateDevices() override;
+    bool startCapture(const std::string& device_name = "") override;
+    void stopCapture() override;
+    bool isCapturing() const override;
+    void setFrameCallback(FrameCallback callback) override;
+    void setErrorCallback(ErrorCallback callback) override;
+    bool hasError() const override;
+    std::string getLastError() const override;
+
+    Stats getStats() const;
+
+private:
+    void replayThread();
+    void setError(const std::string& error);
+
+    Config config_;
+    FrameRecordReader reader_;
+    VideoFormat format_;
+
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> capturing_{false};
+    std::atomic<bool> should_stop_{false};
+
+    mutable std::mutex callback_mutex_;
+    FrameCallback frame_callback_;
+    ErrorCallback error_callback_;
+
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+    std::atomic<bool> has_error_{false};
+
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+};
+
+} // namespace ndi_bridge
@@ -0,0 +1,189 @@
+// stripe_executor.cpp
+#include "stripe_executor.h"
+#include "pipeline_thread_pool.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace ndi_bridge {
+
+namespace {
+
+// Weight of the newest frame in the per-row cost average
+constexpr double kCostAlpha = 0.25;
+
+std::mutex g_shared_mutex;
+StripeExecutor::Config g_shared_config;
+bool g_shared_created = false;
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+StripeExecutor::StripeExecutor() : StripeExecutor(Config()) {
+}
+
+StripeExecutor::StripeExecutor(const Config& config) {
+    int threads = config.threads;
+    if (threads <= 0) {
+        threads = std::min(PipelineThreadPool::getCpuCoreCount(), kMaxThreads);
+    }
+    thread_count_ = std::max(1, std::min(threads, kMaxThreads));
+    if (thread_count_ < 2) {
+        return;
+    }
+
+    pool_ = std::make_unique<PipelineThreadPool>();
+    for (int i = 1; i < thread_count_; i++) {
+        int core = -1;
+        if (!config.cpu_cores.empty()) {
+            core = config.cpu_cores[(i - 1) % config.cpu_cores.size()];
+        }
+        pool_->createThread("stripe-" + std::to_string(i), [this]() { workerThread(); }, core);
+    }
+}
+
+StripeExecutor::~StripeExecutor() {
+    if (!pool_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    pool_->stopAll();
+    pool_->waitAll();
+}
+
+StripeExecutor& StripeExecutor::shared() {
+    // Never destroyed: the workers park until exit, and converters in other
+    // static objects may still run during shutdown
+    static StripeExecutor* executor = []() {
+        Config config;
+        {
+            std::lock_guard<std::mutex> lock(g_shared_mutex);
+            g_shared_created = true;
+            config = g_shared_config;
+        }
+        auto* created = new StripeExecutor(config);
+        int threads = created->getThreadCount();
+        Logger::info("Striped conversion: " + std::to_string(threads) +
+                     (threads == 1 ? " thread" : " threads"));
+        return created;
+    }();
+    return *executor;
+}
+
+bool StripeExecutor::configureShared(const Config& config) {
+    std::lock_guard<std::mutex> lock(g_shared_mutex);
+    if (g_shared_created) {
+        return false;
+    }
+    g_shared_config = config;
+    return true;
+}
+
+int StripeExecutor::planBands(const RowCost& cost, int rows, size_t row_bytes) const {
+    // The first frame runs inline to measure what a row costs
+    if (thread_count_ < 2 || rows < 2 * kMinBandRows || cost.ns_per_row <= 0.0) {
+        return rows;
+    }
+    if (cost.ns_per_row * rows < kMinParallelUs * 1000.0) {
+        return rows;
+    }
+
+    // Cache-sized bands, but no fewer than one per thread and none shorter
+    // than kMinBandUs
+    int share_rows = (rows + thread_count_ - 1) / thread_count_;
+    int cache_rows = static_cast<int>(kBandBytes / std::max<size_t>(row_bytes, 1));
+    int time_rows = static_cast<int>(std::ceil(kMinBandUs * 1000.0 / cost.ns_per_row));
+    return std::max({std::min(cache_rows, share_rows), time_rows, kMinBandRows});
+}
+
+void StripeExecutor::run(RowCost& cost, int rows, size_t row_bytes, const RowFunc& fn) {
+    if (rows <= 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> running(run_mutex_, std::try_to_lock);
+    int band_rows = running.owns_lock() ? planBands(cost, rows, row_bytes) : rows;
+    int bands = (rows + band_rows - 1) / band_rows;
+
+    int64_t busy_ns;
+    if (bands < 2) {
+        int64_t start = nowNs();
+        fn(0, rows);
+        busy_ns = nowNs() - start;
+        bands = 1;
+    } else {
+        job_ = &fn;
+        job_rows_ = rows;
+        band_rows_ = band_rows;
+        band_count_ = bands;
+        busy_ns_ = 0;
+        runBands();
+        job_ = nullptr;
+        busy_ns = busy_ns_.load();
+    }
+
+    // Summed band time, so the estimate does not drop as threads are added
+    double ns_per_row = static_cast<double>(busy_ns) / rows;
+    cost.ns_per_row = cost.ns_per_row <= 0.0
+        ? ns_per_row
+        : (1.0 - kCostAlpha) * cost.ns_per_row + kCostAlpha * ns_per_row;
+    cost.bands = bands;
+}
+
+void StripeExecutor::runBands() {
+    next_band_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_workers_ = thread_count_ - 1;
+        generation_++;
+    }
+    work_cv_.notify_all();
+
+    // The calling thread takes bands too
+    int band;
+    while ((band = next_band_.fetch_add(1)) < band_count_) {
+        int64_t start = nowNs();
+        (*job_)(band * band_rows_, std::min(job_rows_, (band + 1) * band_rows_));
+        busy_ns_ += nowNs() - start;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return busy_workers_ == 0; });
+}
+
+void StripeExecutor::workerThread() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this, seen]() { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        int band;
+        while ((band = next_band_.fetch_add(1)) < band_count_) {
+            int64_t start = nowNs();
+            (*job_)(band * band_rows_, std::min(job_rows_, (band + 1) * band_rows_));
+            busy_ns_ += nowNs() - start;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_workers_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+} // namespace ndi_bridge
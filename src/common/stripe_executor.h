@@ -0,0 +1,118 @@
+// stripe_executor.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ndi_bridge {
+
+class PipelineThreadPool;
+
+/**
+ * @brief Runs row-independent frame work as horizontal bands on several cores
+ *
+ * Pixel conversions touch each row on its own, so a frame can be cut into
+ * bands that run in parallel and are joined before the frame moves on. The
+ * workers are persistent PipelineThreadPool threads (optionally pinned to
+ * cores) parked between frames; the calling thread takes bands too.
+ *
+ * A band is sized so the bytes it reads and writes stay within kBandBytes
+ * (L2 resident while converted) and so it runs at least kMinBandUs, below
+ * which the handoff costs more than the split saves. The per-row time is a
+ * moving average kept in a RowCost per conversion, so a 1080p byte swap and
+ * a 4K BGRA conversion each settle on their own band count. Work measured
+ * under kMinParallelUs per frame runs inline.
+ *
+ * run() is not reentrant: a caller that finds the workers busy with
+ * another frame converts its own frame inline rather than waiting.
+ *
+ * Version: 1.0.0
+ */
+class StripeExecutor {
+public:
+    // Converts rows [row_begin, row_end); bands may run concurrently
+    using RowFunc = std::function<void(int row_begin, int row_end)>;
+
+    static constexpr int kMaxThreads = 4;                 // N100 core count
+    static constexpr size_t kBandBytes = 256 * 1024;      // Read + written per band
+    static constexpr int kMinBandRows = 8;
+    static constexpr int64_t kMinBandUs = 50;
+    static constexpr int64_t kMinParallelUs = 300;
+
+    struct Config {
+        int threads = 0;              // Including the caller; 0 = one per core up to kMaxThreads
+        std::vector<int> cpu_cores;   // Worker cores, used in turn (empty = no affinity)
+    };
+
+    /**
+     * @brief Measured cost of one conversion, kept by its owner across frames
+     */
+    struct RowCost {
+        double ns_per_row = 0.0;   // Moving average, single-thread equivalent
+        int bands = 0;             // Bands used by the last run
+    };
+
+    StripeExecutor();
+    explicit StripeExecutor(const Config& config);
+    ~StripeExecutor();
+
+    /**
+     * @brief Run fn over rows [0, rows) and return once every band is done
+     * @param cost Cost estimate of this conversion, updated from the run
+     * @param rows Row count
+     * @param row_bytes Bytes one row reads plus writes
+     * @param fn Row function
+     */
+    void run(RowCost& cost, int rows, size_t row_bytes, const RowFunc& fn);
+
+    /**
+     * @brief Threads that take bands, the caller included
+     */
+    int getThreadCount() const { return thread_count_; }
+
+    /**
+     * @brief Process-wide executor, created on first use
+     */
+    static StripeExecutor& shared();
+
+    /**
+     * @brief Set the configuration shared() is created with
+     * @return false if shared() already exists (the call has no effect)
+     */
+    static bool configureShared(const Config& config);
+
+private:
+    StripeExecutor(const StripeExecutor&) = delete;
+    StripeExecutor& operator=(const StripeExecutor&) = delete;
+
+    int planBands(const RowCost& cost, int rows, size_t row_bytes) const;
+    void runBands();
+    void workerThread();
+
+    int thread_count_ = 1;
+    std::unique_ptr<PipelineThreadPool> pool_;
+
+    // Current frame; written by run() before the generation bump
+    const RowFunc* job_ = nullptr;
+    int job_rows_ = 0;
+    int band_rows_ = 0;
+    int band_count_ = 0;
+    std::atomic<int> next_band_{0};
+    std::atomic<int64_t> busy_ns_{0};
+
+    std::mutex run_mutex_;   // One frame at a time
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    int busy_workers_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace ndi_bridge
@@ -0,0 +1,519 @@
+// synthetic_capture.cpp
+#include "synthetic_capture.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <time.h>
+
+namespace ndi_bridge {
+
+namespace {
+
+// 3x5 glyphs, one row per entry, bit 2 = left column
+struct Glyph {
+    char c;
+    uint8_t rows[5];
+};
+
+const Glyph kFont[] = {
+    {'0', {7, 5, 5, 5, 7}}, {'1', {2, 6, 2, 2, 7}}, {'2', {7, 1, 7, 4, 7}},
+    {'3', {7, 1, 7, 1, 7}}, {'4', {5, 5, 7, 1, 1}}, {'5', {7, 4, 7, 1, 7}},
+    {'6', {7, 4, 7, 5, 7}}, {'7', {7, 1, 1, 1, 1}}, {'8', {7, 5, 7, 5, 7}},
+    {'9', {7, 5, 7, 1, 7}}, {':', {0, 2, 0, 2, 0}}, {'.', {0, 0, 0, 0, 2}},
+    {'#', {5, 7, 5, 7, 5}}, {' ', {0, 0, 0, 0, 0}}
+};
+
+const uint8_t* findGlyph(char c) {
+    for (const auto& glyph : kFont) {
+        if (glyph.c == c) {
+            return glyph.rows;
+        }
+    }
+    return nullptr;
+}
+
+// BT.709 limited range, 75% bars
+const uint8_t kBars[7][3] = {
+    {180, 128, 128},  // White
+    {168,  44, 136},  // Yellow
+    {145, 147,  44},  // Cyan
+    {133,  63,  52},  // Green
+    { 63, 193, 204},  // Magenta
+    { 51, 109, 212},  // Red
+    { 28, 212, 120}   // Blue
+};
+
+const uint8_t kWhite[3] = {235, 128, 128};
+const uint8_t kBlack[3] = {16, 128, 128};
+
+int64_t timespecToNs(const struct timespec& ts) {
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+struct timespec nsToTimespec(int64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    return ts;
+}
+
+// Triangle wave so moving elements bounce between 0 and range
+int bounce(uint64_t step, int range) {
+    if (range <= 0) {
+        return 0;
+    }
+    int pos = static_cast<int>(step % static_cast<uint64_t>(2 * range));
+    return pos > range ? 2 * range - pos : pos;
+}
+
+} // anonymous namespace
+
+SyntheticCapture::SyntheticCapture()
+    : SyntheticCapture(Config()) {
+}
+
+SyntheticCapture::SyntheticCapture(const Config& config)
+    : config_(config) {
+    format_.width = config_.width;
+    format_.height = config_.height;
+    format_.stride = config_.pixel_format == "NV12" ? config_.width : config_.width * 2;
+    format_.pixel_format = config_.pixel_format;
+    format_.fps_numerator = config_.fps_numerator;
+    format_.fps_denominator = config_.fps_denominator;
+}
+
+SyntheticCapture::~SyntheticCapture() {
+    stopCapture();
+}
+
+bool SyntheticCapture::parseSpec(const std::string& spec, Config& config) {
+    Config parsed = config;
+    std::string rest = spec;
+
+    size_t colon = rest.find(':');
+    if (colon != std::string::npos) {
+        parsed.pixel_format = rest.substr(colon + 1);
+        rest = rest.substr(0, colon);
+    }
+
+    size_t at = rest.find('@');
+    if (at != std::string::npos) {
+        std::string fps_text = rest.substr(at + 1);
+        rest = rest.substr(0, at);
+
+        double fps = 0.0;
+        try {
+            size_t pos = 0;
+            fps = std::stod(fps_text, &pos);
+            if (pos != fps_text.size()) {
+                return false;
+            }
+        } catch (...) {
+            return false;
+        }
+        if (fps < 1.0 || fps > 240.0) {
+            return false;
+        }
+
+        // NTSC rates are N*1000/1001
+        double ntsc = fps * 1001.0 / 1000.0;
+        if (std::fabs(fps - std::round(fps)) > 1e-6 && std::fabs(ntsc - std::round(ntsc)) < 0.01) {
+            parsed.fps_numerator = static_cast<uint32_t>(std::round(ntsc)) * 1000;
+            parsed.fps_denominator = 1001;
+        } else {
+            uint32_t num = static_cast<uint32_t>(std::round(fps * 1000.0));
+            uint32_t den = 1000;
+            uint32_t g = std::gcd(num, den);
+            parsed.fps_numerator = num / g;
+            parsed.fps_denominator = den / g;
+        }
+    }
+
+    if (!rest.empty()) {
+        size_t x = rest.find('x');
+        if (x == std::string::npos) {
+            return false;
+        }
+        try {
+            size_t pos = 0;
+            parsed.width = std::stoi(rest.substr(0, x), &pos);
+            if (pos != x) {
+                return false;
+            }
+            std::string height_text = rest.substr(x + 1);
+            parsed.height = std::stoi(height_text, &pos);
+            if (pos != height_text.size()) {
+                return false;
+            }
+        } catch (...) {
+            return false;
+        }
+    }
+
+    // 4:2:x chroma needs even dimensions; the burned-in text needs some room
+    if (parsed.width < 128 || parsed.height < 72 || parsed.width > 7680 || parsed.height > 4320 ||
+        (parsed.width & 1) || (parsed.height & 1)) {
+        return false;
+    }
+    if (parsed.pixel_format != "UYVY" && parsed.pixel_format != "YUYV" &&
+        parsed.pixel_format != "NV12") {
+        return false;
+    }
+
+    config = parsed;
+    return true;
+}
+
+std::vector<ICaptureDevice::DeviceInfo> SyntheticCapture::enumerateDevices() {
+    DeviceInfo info;
+    info.id = "synthetic";
+    info.name = "Synthetic test pattern " + std::to_string(config_.width) + "x" +
+                std::to_string(config_.height) + " " + config_.pixel_format;
+    return {info};
+}
+
+bool SyntheticCapture::startCapture(const std::string& device_name) {
+    if (capturing_) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_.clear();
+        has_error_ = false;
+    }
+
+    if (config_.fps_numerator == 0 || config_.fps_denominator == 0) {
+        setError("Invalid frame rate");
+        return false;
+    }
+
+    // Everything is allocated and drawn once, before the first frame
+    size_t size = frameSize();
+    background_.assign(size, 0);
+    drawBackground(background_.data());
+
+    buffers_.clear();
+    buffers_.resize(std::max(2u, config_.buffer_count));
+    for (auto& buffer : buffers_) {
+        buffer.data = background_;
+        buffer.dirty.reserve(8);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_ = Stats();
+    }
+
+    should_stop_ = false;
+    capturing_ = true;
+    thread_ = std::make_unique<std::thread>(&SyntheticCapture::generatorThread, this);
+
+    Logger::info("SyntheticCapture: Generating " + std::to_string(config_.width) + "x" +
+                 std::to_string(config_.height) + " " + config_.pixel_format + " @ " +
+                 std::to_string(config_.fps_numerator) + "/" +
+                 std::to_string(config_.fps_denominator) + " fps from " +
+                 std::to_string(buffers_.size()) + " preallocated buffers");
+    return true;
+}
+
+void SyntheticCapture::stopCapture() {
+    if (!capturing_) {
+        return;
+    }
+
+    should_stop_ = true;
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+    capturing_ = false;
+
+    Stats stats = getStats();
+    Logger::info("SyntheticCapture: Stopped after " + std::to_string(stats.frames_generated) +
+                 " frames (" + std::to_string(stats.frames_late) + " late, " +
+                 std::to_string(stats.sink_dropped) + " dropped downstream)");
+}
+
+bool SyntheticCapture::isCapturing() const {
+    return capturing_;
+}
+
+void SyntheticCapture::setFrameCallback(FrameCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    frame_callback_ = callback;
+}
+
+void SyntheticCapture::setErrorCallback(ErrorCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    error_callback_ = callback;
+}
+
+bool SyntheticCapture::hasError() const {
+    return has_error_.load();
+}
+
+std::string SyntheticCapture::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+SyntheticCapture::Stats SyntheticCapture::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+size_t SyntheticCapture::frameSize() const {
+    size_t pixels = static_cast<size_t>(config_.width) * config_.height;
+    return config_.pixel_format == "NV12" ? pixels * 3 / 2 : pixels * 2;
+}
+
+void SyntheticCapture::generatorThread() {
+    const int64_t interval_ns = 1000000000LL * config_.fps_denominator / config_.fps_numerator;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    int64_t next_ns = timespecToNs(ts);
+
+    uint64_t frame_number = 0;
+    size_t index = 0;
+
+    while (!should_stop_) {
+        Buffer& buffer = buffers_[index];
+        index = (index + 1) % buffers_.size();
+
+        auto render_start = std::chrono::steady_clock::now();
+        renderFrame(buffer, frame_number);
+        double render_us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - render_start).count();
+
+        // Stamped with the slot time, as a driver stamps the capture time
+        bool delivered = true;
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            if (frame_callback_) {
+                delivered = frame_callback_(buffer.data.data(), buffer.data.size(), next_ns, format_);
+            }
+        }
+
+        frame_number++;
+        next_ns += interval_ns;
+
+        // Overran by whole frames: skip the slots so cadence and counter stay on time
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        int64_t now_ns = timespecToNs(ts);
+        uint64_t skipped = 0;
+        if (now_ns > next_ns + interval_ns) {
+            skipped = static_cast<uint64_t>((now_ns - next_ns) / interval_ns);
+            next_ns += static_cast<int64_t>(skipped) * interval_ns;
+            frame_number += skipped;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.frames_generated++;
+            stats_.frames_late += skipped;
+            if (!delivered) {
+                stats_.sink_dropped++;
+            }
+            stats_.avg_render_us = stats_.frames_generated == 1 ? render_us :
+                                   0.95 * stats_.avg_render_us + 0.05 * render_us;
+            stats_.max_render_us = std::max(stats_.max_render_us, render_us);
+        }
+
+        struct timespec deadline = nsToTimespec(next_ns);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR &&
+               !should_stop_) {
+        }
+    }
+}
+
+void SyntheticCapture::renderFrame(Buffer& buffer, uint64_t frame_number) {
+    uint8_t* frame = buffer.data.data();
+    const int width = config_.width;
+    const int height = config_.height;
+    const int bars_height = height * 2 / 3;
+
+    // Undo what was drawn into this buffer the last time it was used
+    for (const auto& rect : buffer.dirty) {
+        restoreRect(frame, rect);
+    }
+    buffer.dirty.clear();
+
+    // Bouncing box over the bars
+    int box = (height / 8) & ~1;
+    Yuv white{kWhite[0], kWhite[1], kWhite[2]};
+    Rect box_rect{bounce(frame_number * std::max(2, width / 240), width - box),
+                  bounce(frame_number * std::max(2, height / 180), bars_height - box),
+                  box, box};
+    fillRect(frame, box_rect, white);
+    buffer.dirty.push_back(box_rect);
+
+    // Sweep line: one step per frame makes every dropped frame visible
+    int step = std::max(2, (width / 480) & ~1);
+    Rect sweep{static_cast<int>((frame_number * step) % width), 0, step, height};
+    fillRect(frame, sweep, white);
+    buffer.dirty.push_back(sweep);
+
+    // Burned-in frame counter and wall-clock time
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    struct tm local;
+    localtime_r(&now.tv_sec, &local);
+    char text[48];
+    snprintf(text, sizeof(text), "#%08llu %02d:%02d:%02d.%03ld",
+             static_cast<unsigned long long>(frame_number),
+             local.tm_hour, local.tm_min, local.tm_sec, now.tv_nsec / 1000000L);
+
+    int scale = std::max(2, (height / 108) & ~1);
+    drawText(buffer, scale * 2, bars_height + scale * 2, scale, text);
+}
+
+void SyntheticCapture::drawBackground(uint8_t* frame) const {
+    const int width = config_.width;
+    const int height = config_.height;
+    const int bars_height = height * 2 / 3;
+
+    for (int i = 0; i < 7; i++) {
+        int x0 = (width * i / 7) & ~1;
+        int x1 = (width * (i + 1) / 7) & ~1;
+        fillRect(frame, Rect{x0, 0, x1 - x0, bars_height}, Yuv{kBars[i][0], kBars[i][1], kBars[i][2]});
+    }
+
+    // Luma ramp below the bars (banding shows up quickly in a bad conversion)
+    for (int x = 0; x < width; x += 2) {
+        uint8_t y = static_cast<uint8_t>(16 + (219 * x) / std::max(1, width - 2));
+        fillRect(frame, Rect{x, bars_height, 2, height - bars_height}, Yuv{y, 128, 128});
+    }
+}
+
+void SyntheticCapture::fillRect(uint8_t* frame, Rect rect, const Yuv& color) const {
+    const int width = config_.width;
+    const int height = config_.height;
+
+    // Clip and align to the 2x2 chroma grid
+    int x0 = std::max(0, rect.x) & ~1;
+    int y0 = std::max(0, rect.y) & ~1;
+    int x1 = std::min(width, (rect.x + rect.w + 1) & ~1);
+    int y1 = std::min(height, (rect.y + rect.h + 1) & ~1);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    if (config_.pixel_format == "NV12") {
+        uint8_t* uv_plane = frame + static_cast<size_t>(width) * height;
+        for (int y = y0; y < y1; y++) {
+            memset(frame + static_cast<size_t>(y) * width + x0, color.y, x1 - x0);
+        }
+        for (int y = y0 / 2; y < y1 / 2; y++) {
+            uint8_t* uv = uv_plane + static_cast<size_t>(y) * width;
+            for (int x = x0; x < x1; x += 2) {
+                uv[x] = color.u;
+                uv[x + 1] = color.v;
+            }
+        }
+        return;
+    }
+
+    // Packed 4:2:2 macropixel
+    uint8_t pattern[4];
+    if (config_.pixel_format == "YUYV") {
+        pattern[0] = color.y; pattern[1] = color.u; pattern[2] = color.y; pattern[3] = color.v;
+    } else {
+        pattern[0] = color.u; pattern[1] = color.y; pattern[2] = color.v; pattern[3] = color.y;
+    }
+
+    size_t stride = static_cast<size_t>(width) * 2;
+    for (int y = y0; y < y1; y++) {
+        uint8_t* row = frame + y * stride;
+        for (int x = x0; x < x1; x += 2) {
+            memcpy(row + x * 2, pattern, 4);
+        }
+    }
+}
+
+void SyntheticCapture::restoreRect(uint8_t* frame, const Rect& rect) const {
+    const int width = config_.width;
+    const int height = config_.height;
+    const uint8_t* bg = background_.data();
+
+    int x0 = std::max(0, rect.x) & ~1;
+    int y0 = std::max(0, rect.y) & ~1;
+    int x1 = std::min(width, (rect.x + rect.w + 1) & ~1);
+    int y1 = std::min(height, (rect.y + rect.h + 1) & ~1);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    if (config_.pixel_format == "NV12") {
+        size_t luma_size = static_cast<size_t>(width) * height;
+        for (int y = y0; y < y1; y++) {
+            size_t offset = static_cast<size_t>(y) * width + x0;
+            memcpy(frame + offset, bg + offset, x1 - x0);
+        }
+        for (int y = y0 / 2; y < y1 / 2; y++) {
+            size_t offset = luma_size + static_cast<size_t>(y) * width + x0;
+            memcpy(frame + offset, bg + offset, x1 - x0);
+        }
+        return;
+    }
+
+    size_t stride = static_cast<size_t>(width) * 2;
+    for (int y = y0; y < y1; y++) {
+        size_t offset = y * stride + x0 * 2;
+        memcpy(frame + offset, bg + offset, (x1 - x0) * 2);
+    }
+}
+
+void SyntheticCapture::drawText(Buffer& buffer, int x, int y, int scale, const std::string& text) {
+    uint8_t* frame = buffer.data.data();
+    Yuv white{kWhite[0], kWhite[1], kWhite[2]};
+    Yuv black{kBlack[0], kBlack[1], kBlack[2]};
+
+    // Glyphs are 3x5 cells on a 4x6 pitch, on a black box
+    Rect box{x - scale, y - scale, static_cast<int>(text.size()) * 4 * scale + scale, 7 * scale};
+    fillRect(frame, box, black);
+    buffer.dirty.push_back(box);
+
+    for (size_t i = 0; i < text.size(); i++) {
+        const uint8_t* rows = findGlyph(text[i]);
+        if (!rows) {
+            continue;
+        }
+        int gx = x + static_cast<int>(i) * 4 * scale;
+        for (int row = 0; row < 5; row++) {
+            for (int col = 0; col < 3; col++) {
+                if (rows[row] & (4 >> col)) {
+                    fillRect(frame, Rect{gx + col * scale, y + row * scale, scale, scale}, white);
+                }
+            }
+        }
+    }
+}
+
+void SyntheticCapture::setError(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = error;
+        has_error_ = true;
+    }
+
+    Logger::error("SyntheticCapture Error: " + error);
+
+    ErrorCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = error_callback_;
+    }
+
+    if (callback) {
+        callback(error);
+    }
+}
+
+} // namespace ndi_bridge
@@ -0,0 +1,119 @@
+// synthetic_capture.h
+#pragma once
+
+#include "capture_interface.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ndi_bridge {
+
+/**
+ * @brief Test-pattern capture device (no hardware required)
+ *
+ * Generates 75% colour bars with a bouncing box, a sweep line that moves
+ * one step per frame and a burned-in frame counter and wall-clock time, in
+ * UYVY, YUYV or NV12. Frames are rendered into preallocated buffers (only
+ * the regions drawn into a buffer last time are restored) and handed out
+ * through the normal FrameCallback on an absolute CLOCK_MONOTONIC schedule,
+ * so the AppController/NdiSender path can be load-tested on any Linux box.
+ *
+ * Selected with `ndi-capture --synthetic WIDTHxHEIGHT@FPS:FORMAT`.
+ *
+ * Version: 1.0.0
+ */
+class SyntheticCapture : public ICaptureDevice {
+public:
+    struct Config {
+        int width = 1920;
+        int height = 1080;
+        uint32_t fps_numerator = 60;
+        uint32_t fps_denominator = 1;
+        std::string pixel_format = "UYVY";  // UYVY, YUYV or NV12
+        unsigned int buffer_count = 4;      // Ring of preallocated frames
+    };
+
+    struct Stats {
+        uint64_t frames_generated = 0;
+        uint64_t frames_late = 0;       // Schedule slots skipped because rendering/sending overran
+        uint64_t sink_dropped = 0;      // Callback reported the frame as not delivered
+        double avg_render_us = 0.0;
+        double max_render_us = 0.0;
+    };
+
+    SyntheticCapture();
+    explicit SyntheticCapture(const Config& config);
+    ~SyntheticCapture() override;
+
+    /**
+     * @brief Parse "WIDTHxHEIGHT[@FPS][:FORMAT]" (e.g. "1280x720@50:NV12")
+     *
+     * FPS may be fractional; 59.94 and 29.97 map to 60000/1001 and
+     * 30000/1001. Missing parts keep the values already in config.
+     *
+     * @return false on a malformed spec or unsupported format
+     */
+    static bool parseSpec(const std::string& spec, Config& config);
+
+    // ICaptureDevice
+    std::vector<DeviceInfo> enumerateDevices() override;
+    bool startCapture(const std::string& device_name = "") override;
+    void stopCapture() override;
+    bool isCapturing() const override;
+    void setFrameCallback(FrameCallback callback) override;
+    void setErrorCallback(ErrorCallback callback) override;
+    bool hasError() const override;
+    std::string getLastError() const override;
+
+    Stats getStats() const;
+    const Config& getConfig() const { return config_; }
+
+private:
+    struct Rect {
+        int x, y, w, h;
+    };
+
+    struct Yuv {
+        uint8_t y, u, v;
+    };
+
+    struct Buffer {
+        std::vector<uint8_t> data;
+        std::vector<Rect> dirty;  // Regions drawn over the background
+    };
+
+    void generatorThread();
+    void renderFrame(Buffer& buffer, uint64_t frame_number);
+    void drawBackground(uint8_t* frame) const;
+    void restoreRect(uint8_t* frame, const Rect& rect) const;
+    void fillRect(uint8_t* frame, Rect rect, const Yuv& color) const;
+    void drawText(Buffer& buffer, int x, int y, int scale, const std::string& text);
+    size_t frameSize() const;
+    void setError(const std::string& error);
+
+    Config config_;
+    VideoFormat format_;
+
+    std::vector<Buffer> buffers_;
+    std::vector<uint8_t> background_;  // Bars template the dirty regions are restored from
+
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> capturing_{false};
+    std::atomic<bool> should_stop_{false};
+
+    mutable std::mutex callback_mutex_;
+    FrameCallback frame_callback_;
+    ErrorCallback error_callback_;
+
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+    std::atomic<bool> has_error_{false};
+
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+};
+
+} // namespace ndi_bridge
@@ -28,6 +28,14 @@ enum class PixelFormat {
     NV12     // YUV 4:2:0 planar
 };
 
+// Frame presentation counters
+struct DisplayStats {
+    uint64_t frames_flipped = 0;   // Reached the screen
+    uint64_t frames_late = 0;      // Flipped one or more vblanks after due
+    uint64_t frames_skipped = 0;   // Dropped; the previous flip was still pending
+    uint64_t frames_torn = 0;      // Shown without vblank sync (fallback path)
+};
+
 class DisplayOutput {
 public:
     DisplayOutput();
@@ -61,6 +69,23 @@ public:
     // Clear display (show black)
     virtual void clearDisplay() = 0;
     
+    // Whether frames in this format reach the display engine without
+    // CPU colour conversion (e.g. UYVY on a YUV plane); valid once open
+    virtual bool canScanOut(PixelFormat format) const { return false; }
+    
+    // Presentation counters since the display was opened
+    virtual DisplayStats getStats() const { return DisplayStats(); }
+    
+    // CLOCK_MONOTONIC time the last displayed frame reached scanout
+    // (page-flip event or commit), 0 if the output cannot tell
+    virtual int64_t getLastScanoutNs() const { return 0; }
+    
+    // Another output on the same display device, for multi-head: it
+    // shares the device's resources and takes a display the others have
+    // not opened. Call initialize() on it as usual. nullptr if the
+    // output cannot share its device.
+    virtual std::unique_ptr<DisplayOutput> createSibling() { return nullptr; }
+    
 protected:
     int current_display_id_ = -1;
 };
@@ -0,0 +1,293 @@
+#include "drm_atomic_engine.h"
+#include "../common/frame_timing.h"
+#include "../common/logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ndi_bridge {
+namespace display {
+
+namespace {
+
+// A flip event this overdue is taken as lost (e.g. connector unplugged)
+constexpr int64_t kLostFlipNs = 100000000;
+
+// Property ID by name, 0 if the object has no such property
+uint32_t findProperty(int fd, uint32_t object_id, uint32_t object_type, const char* name,
+                      drmModePropertyRes** keep = nullptr) {
+    drmModeObjectProperties* props = drmModeObjectGetProperties(fd, object_id, object_type);
+    if (!props) return 0;
+
+    uint32_t id = 0;
+    for (uint32_t i = 0; i < props->count_props && !id; i++) {
+        drmModePropertyRes* prop = drmModeGetProperty(fd, props->props[i]);
+        if (!prop) continue;
+        if (strcmp(prop->name, name) == 0) {
+            id = prop->prop_id;
+            if (keep) {
+                *keep = prop;
+                prop = nullptr;
+            }
+        }
+        if (prop) drmModeFreeProperty(prop);
+    }
+    drmModeFreeObjectProperties(props);
+    return id;
+}
+
+bool findEnumValue(const drmModePropertyRes* prop, const char* name, uint64_t& value) {
+    for (int i = 0; i < prop->count_enums; i++) {
+        if (strcmp(prop->enums[i].name, name) == 0) {
+            value = prop->enums[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+DrmAtomicEngine::~DrmAtomicEngine() {
+    shutdown();
+}
+
+bool DrmAtomicEngine::initialize(DrmDevice& device, uint32_t crtc_id, uint32_t refresh_hz,
+                                 int front_buffer) {
+    shutdown();
+
+    device_ = &device;
+    drm_fd_ = device.fd();
+    crtc_id_ = crtc_id;
+    frame_ns_ = 1000000000LL / (refresh_hz ? refresh_hz : 60);
+
+    request_ = drmModeAtomicAlloc();
+    if (!request_) {
+        Logger::error("Failed to allocate atomic request");
+        return false;
+    }
+
+    front_ = front_buffer;
+    pending_ = -1;
+    ready_ = -1;
+    last_vblank_ns_ = 0;
+    pending_scanout_ns_ = 0;
+    flips_ = 0;
+    flips_late_ = 0;
+    skipped_ = 0;
+
+    handler_id_ = device_->addFlipHandler(this);
+    return true;
+}
+
+void DrmAtomicEngine::shutdown() {
+    // Flips still in flight are dropped by the device from here on
+    if (device_) {
+        device_->removeFlipHandler(this);
+        device_ = nullptr;
+    }
+    if (request_) {
+        drmModeAtomicFree(request_);
+        request_ = nullptr;
+    }
+    planes_.clear();
+    drm_fd_ = -1;
+    crtc_id_ = 0;
+}
+
+bool DrmAtomicEngine::addPlane(uint32_t plane_id) {
+    if (hasPlane(plane_id)) {
+        return true;
+    }
+
+    PlaneProps p;
+    const uint32_t type = DRM_MODE_OBJECT_PLANE;
+    p.fb_id = findProperty(drm_fd_, plane_id, type, "FB_ID");
+    p.crtc_id = findProperty(drm_fd_, plane_id, type, "CRTC_ID");
+    p.src_x = findProperty(drm_fd_, plane_id, type, "SRC_X");
+    p.src_y = findProperty(drm_fd_, plane_id, type, "SRC_Y");
+    p.src_w = findProperty(drm_fd_, plane_id, type, "SRC_W");
+    p.src_h = findProperty(drm_fd_, plane_id, type, "SRC_H");
+    p.crtc_x = findProperty(drm_fd_, plane_id, type, "CRTC_X");
+    p.crtc_y = findProperty(drm_fd_, plane_id, type, "CRTC_Y");
+    p.crtc_w = findProperty(drm_fd_, plane_id, type, "CRTC_W");
+    p.crtc_h = findProperty(drm_fd_, plane_id, type, "CRTC_H");
+
+    if (!p.fb_id || !p.crtc_id || !p.src_x || !p.src_y || !p.src_w || !p.src_h ||
+        !p.crtc_x || !p.crtc_y || !p.crtc_w || !p.crtc_h) {
+        Logger::warning("Plane " + std::to_string(plane_id) + " lacks atomic properties");
+        return false;
+    }
+
+    // YUV colour properties are optional; the driver default applies without them
+    drmModePropertyRes* prop = nullptr;
+    if (findProperty(drm_fd_, plane_id, type, "COLOR_ENCODING", &prop) && prop) {
+        if (findEnumValue(prop, "ITU-R BT.601 YCbCr", p.encoding_bt601) &&
+            findEnumValue(prop, "ITU-R BT.709 YCbCr", p.encoding_bt709)) {
+            p.color_encoding = prop->prop_id;
+        }
+        drmModeFreeProperty(prop);
+    }
+    prop = nullptr;
+    if (findProperty(drm_fd_, plane_id, type, "COLOR_RANGE", &prop) && prop) {
+        if (findEnumValue(prop, "YCbCr limited range", p.range_limited)) {
+            p.color_range = prop->prop_id;
+        }
+        drmModeFreeProperty(prop);
+    }
+
+    planes_[plane_id] = p;
+    return true;
+}
+
+int DrmAtomicEngine::acquireBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    expireLostFlipLocked();
+
+    for (int i = 0; i < kBufferCount; i++) {
+        if (i != front_ && i != pending_ && i != ready_) {
+            return i;
+        }
+    }
+    // Screen, vblank and mailbox all taken: the frame about to be written
+    // supersedes the ready one
+    int buffer = ready_;
+    ready_ = -1;
+    skipped_++;
+    return buffer;
+}
+
+bool DrmAtomicEngine::present(int buffer, const PlaneState& state, uint32_t disable_plane_id) {
+    if (!request_ || !hasPlane(state.plane_id) || buffer < 0 || buffer >= kBufferCount) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    expireLostFlipLocked();
+
+    if (pending_ < 0) {
+        return commitLocked(buffer, state, disable_plane_id);
+    }
+
+    // Flip in flight: wait in the mailbox, newest frame wins
+    if (ready_ >= 0) {
+        skipped_++;
+        // A plane the replaced frame was taking down still has to go
+        if (!disable_plane_id && ready_disable_ != state.plane_id) {
+            disable_plane_id = ready_disable_;
+        }
+    }
+    ready_ = buffer;
+    ready_state_ = state;
+    ready_disable_ = disable_plane_id;
+    return true;
+}
+
+int64_t DrmAtomicEngine::expectedScanoutNs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A frame in the mailbox goes out on the vblank after the pending one
+    return ready_ >= 0 ? pending_scanout_ns_ + frame_ns_ : pending_scanout_ns_;
+}
+
+bool DrmAtomicEngine::commitLocked(int buffer, const PlaneState& state, uint32_t disable_plane_id) {
+    const PlaneProps& p = planes_.at(state.plane_id);
+    drmModeAtomicSetCursor(request_, 0);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.fb_id, state.fb_id);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.crtc_id, crtc_id_);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.src_x, 0);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.src_y, 0);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.src_w, static_cast<uint64_t>(state.src_width) << 16);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.src_h, static_cast<uint64_t>(state.src_height) << 16);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.crtc_x, state.crtc_x);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.crtc_y, state.crtc_y);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.crtc_w, state.crtc_width);
+    drmModeAtomicAddProperty(request_, state.plane_id, p.crtc_h, state.crtc_height);
+    if (state.yuv && p.color_encoding) {
+        drmModeAtomicAddProperty(request_, state.plane_id, p.color_encoding,
+                                 state.yuv_bt709 ? p.encoding_bt709 : p.encoding_bt601);
+    }
+    if (state.yuv && p.color_range) {
+        drmModeAtomicAddProperty(request_, state.plane_id, p.color_range, p.range_limited);
+    }
+
+    auto other = planes_.find(disable_plane_id);
+    if (disable_plane_id && disable_plane_id != state.plane_id && other != planes_.end()) {
+        drmModeAtomicAddProperty(request_, disable_plane_id, other->second.fb_id, 0);
+        drmModeAtomicAddProperty(request_, disable_plane_id, other->second.crtc_id, 0);
+    }
+
+    const uint32_t sequence = commit_seq_ + 1;
+    if (drmModeAtomicCommit(drm_fd_, request_,
+                            DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT,
+                            DrmDevice::flipUserData(handler_id_, sequence)) < 0) {
+        return false;
+    }
+
+    // Due on the first vblank after now, on the cadence of the last flip
+    int64_t now = FrameTiming::monotonicNs();
+    commit_seq_ = sequence;
+    pending_seq_ = sequence;
+    pending_ = buffer;
+    commit_ns_ = now;
+    if (last_vblank_ns_ > 0 && last_vblank_ns_ <= now) {
+        int64_t periods = (now - last_vblank_ns_ + frame_ns_ - 1) / frame_ns_;
+        pending_scanout_ns_ = last_vblank_ns_ + std::max<int64_t>(periods, 1) * frame_ns_;
+    } else {
+        pending_scanout_ns_ = now;
+    }
+    return true;
+}
+
+void DrmAtomicEngine::expireLostFlipLocked() {
+    if (pending_ < 0 || FrameTiming::monotonicNs() - commit_ns_ < kLostFlipNs) {
+        return;
+    }
+    // The event never came; don't let the display stall on it
+    Logger::warning("Page flip event lost - resuming commits");
+    flips_late_++;
+    front_ = pending_;
+    pending_ = -1;
+
+    if (ready_ >= 0) {
+        int buffer = ready_;
+        ready_ = -1;
+        if (!commitLocked(buffer, ready_state_, ready_disable_)) {
+            skipped_++;
+        }
+    }
+}
+
+DisplayStats DrmAtomicEngine::getStats() const {
+    DisplayStats stats;
+    stats.frames_flipped = flips_;
+    stats.frames_late = flips_late_;
+    stats.frames_skipped = skipped_;
+    return stats;
+}
+
+void DrmAtomicEngine::onFlip(int64_t vblank_ns, uint32_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ < 0 || sequence != pending_seq_) {
+        return;   // Late event of a commit written off as lost
+    }
+
+    // More than a refresh and a half after the commit: a vblank was missed
+    if (vblank_ns - commit_ns_ > frame_ns_ + frame_ns_ / 2) {
+        flips_late_++;
+    }
+    flips_++;
+    last_vblank_ns_ = vblank_ns;
+    front_ = pending_;
+    pending_ = -1;
+
+    // Newest frame waiting in the mailbox goes out on the next vblank
+    if (ready_ >= 0) {
+        int buffer = ready_;
+        ready_ = -1;
+        if (!commitLocked(buffer, ready_state_, ready_disable_)) {
+            skipped_++;
+        }
+    }
+}
+
+} // namespace display
+} // namespace ndi_bridge
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "display_output.h"
+#include "drm_device.h"
+#include <xf86drmMode.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace ndi_bridge {
+namespace display {
+
+// Atomic KMS commits for one CRTC with non-blocking page flips.
+//
+// Property IDs of each plane are looked up once; a frame is one
+// DRM_MODE_ATOMIC_NONBLOCK commit with a page-flip event, so the caller
+// returns straight away and never waits for vblank. Flip events come from
+// the DrmDevice event thread (shared by all heads); the engine keeps the
+// vblank clock and counts flips that landed late.
+//
+// Frames are presented mailbox style from a pool of kBufferCount buffers:
+// one on screen, one committed and waiting for its vblank, and one
+// ready. A frame presented while a flip is pending becomes the ready one,
+// replacing (skipping) an older ready frame, and is committed from the
+// flip event. Scanout always gets the newest complete frame, one refresh
+// after it was presented at most, and the receive side never blocks.
+//
+// A flip whose event is 100 ms overdue is written off as lost. Commits
+// are numbered, and an event arriving late for a written-off commit is
+// ignored rather than taken for the flip of the one after it.
+class DrmAtomicEngine : private DrmDevice::FlipHandler {
+public:
+    // Where a framebuffer goes on screen
+    struct PlaneState {
+        uint32_t plane_id = 0;
+        uint32_t fb_id = 0;
+        int src_width = 0;           // Framebuffer region shown
+        int src_height = 0;
+        int crtc_x = 0;              // Destination rectangle
+        int crtc_y = 0;
+        int crtc_width = 0;
+        int crtc_height = 0;
+        bool yuv_bt709 = false;      // COLOR_ENCODING for YUV framebuffers
+        bool yuv = false;
+    };
+
+    static constexpr int kBufferCount = 3;
+
+    DrmAtomicEngine() = default;
+    ~DrmAtomicEngine() override;
+
+    // Allocate the request and take flip events from the device
+    // @param front_buffer Buffer the CRTC shows now
+    bool initialize(DrmDevice& device, uint32_t crtc_id, uint32_t refresh_hz, int front_buffer);
+    void shutdown();
+
+    // Cache a plane's properties; false if it lacks one a commit needs
+    bool addPlane(uint32_t plane_id);
+    bool hasPlane(uint32_t plane_id) const { return planes_.count(plane_id) != 0; }
+
+    // Buffer the next frame may be written into: neither on screen nor
+    // committed. With all three in use the ready frame is given up.
+    int acquireBuffer();
+
+    // Show a written buffer on a plane, optionally taking another plane
+    // off the CRTC in the same commit; committed now if no flip is
+    // pending, otherwise at the next flip. False if the kernel rejected
+    // an immediate commit.
+    bool present(int buffer, const PlaneState& state, uint32_t disable_plane_id = 0);
+
+    // CLOCK_MONOTONIC vblank the last presented frame is due on
+    int64_t expectedScanoutNs() const;
+
+    // Flips, late flips and skipped frames since initialize(); a lost
+    // flip event counts late
+    DisplayStats getStats() const;
+
+private:
+    struct PlaneProps {
+        uint32_t fb_id = 0;
+        uint32_t crtc_id = 0;
+        uint32_t src_x = 0, src_y = 0, src_w = 0, src_h = 0;
+        uint32_t crtc_x = 0, crtc_y = 0, crtc_w = 0, crtc_h = 0;
+        uint32_t color_encoding = 0;     // Optional
+        uint32_t color_range = 0;        // Optional
+        uint64_t encoding_bt601 = 0;
+        uint64_t encoding_bt709 = 0;
+        uint64_t range_limited = 0;
+    };
+
+    void onFlip(int64_t vblank_ns, uint32_t sequence) override;
+    bool commitLocked(int buffer, const PlaneState& state, uint32_t disable_plane_id);
+    void expireLostFlipLocked();
+
+    DrmDevice* device_ = nullptr;
+    uint32_t handler_id_ = 0;                // For the flip user data
+    int drm_fd_ = -1;
+    uint32_t crtc_id_ = 0;
+    int64_t frame_ns_ = 16666667;            // Refresh period
+    std::map<uint32_t, PlaneProps> planes_;
+    drmModeAtomicReq* request_ = nullptr;   // Reused for every commit
+
+    // Mailbox; buffer indices, -1 = none. Guarded by mutex_.
+    mutable std::mutex mutex_;
+    int front_ = -1;
+    int pending_ = -1;
+    int ready_ = -1;
+    PlaneState ready_state_;
+    uint32_t ready_disable_ = 0;
+    uint32_t commit_seq_ = 0;                // Number of the last commit
+    uint32_t pending_seq_ = 0;               // Number of the pending commit
+    int64_t commit_ns_ = 0;                  // Monotonic time of the pending commit
+    int64_t pending_scanout_ns_ = 0;         // Vblank the pending commit is due on
+    int64_t last_vblank_ns_ = 0;
+
+    std::atomic<uint64_t> flips_{0};
+    std::atomic<uint64_t> flips_late_{0};
+    std::atomic<uint64_t> skipped_{0};
+};
+
+} // namespace display
+} // namespace ndi_bridge
@@ -0,0 +1,189 @@
+#include "drm_device.h"
+#include "../common/logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <xf86drm.h>
+#include <drm/drm.h>
+
+namespace ndi_bridge {
+namespace display {
+
+namespace {
+
+// Device whose events the calling thread is dispatching; drmHandleEvent
+// callbacks only get the commit's user data
+thread_local DrmDevice* t_dispatching = nullptr;
+
+} // anonymous namespace
+
+std::shared_ptr<DrmDevice> DrmDevice::open() {
+    std::shared_ptr<DrmDevice> device(new DrmDevice());
+
+    // First card that opens and can allocate dumb buffers (a render-only
+    // card0 must not hide the display controller on card1)
+    const char* devices[] = {"/dev/dri/card0", "/dev/dri/card1"};
+    for (const char* dev : devices) {
+        int fd = ::open(dev, O_RDWR | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        uint64_t has_dumb = 0;
+        if (drmGetCap(fd, DRM_CAP_DUMB_BUFFER, &has_dumb) < 0 || !has_dumb) {
+            Logger::warning("DRM device " + std::string(dev) + " does not support dumb buffers");
+            close(fd);
+            continue;
+        }
+        device->fd_ = fd;
+        Logger::info("Opened DRM device: " + std::string(dev));
+        break;
+    }
+
+    if (device->fd_ < 0) {
+        Logger::error("Failed to open a DRM device with dumb buffers");
+        return nullptr;
+    }
+    const int fd = device->fd_;
+
+    // Become DRM master (required for mode setting)
+    if (drmSetMaster(fd) < 0) {
+        // Try the ioctl directly if the function is not available
+        if (ioctl(fd, DRM_IOCTL_SET_MASTER, 0) < 0) {
+            Logger::warning("Could not become DRM master - mode setting may fail");
+            // Don't fail here as we might still work in some cases
+        } else {
+            Logger::info("Became DRM master via ioctl");
+        }
+    } else {
+        Logger::info("Became DRM master");
+    }
+
+    // Check for universal planes (required for scaling)
+    if (drmSetClientCap(fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1) < 0) {
+        Logger::warning("Universal planes not supported - hardware scaling may not work");
+    } else {
+        device->has_universal_planes_ = true;
+        Logger::info("Universal planes enabled for hardware scaling");
+    }
+
+    // Enable atomic mode setting if available (better for Intel GPUs)
+    if (drmSetClientCap(fd, DRM_CLIENT_CAP_ATOMIC, 1) == 0) {
+        device->has_atomic_ = true;
+        Logger::info("Atomic mode setting enabled");
+    } else {
+        Logger::info("Using legacy mode setting");
+    }
+
+    // Get resources
+    device->resources_ = drmModeGetResources(fd);
+    if (!device->resources_) {
+        Logger::error("Failed to get DRM resources");
+        return nullptr;
+    }
+
+    // Get plane resources for hardware scaling
+    device->plane_resources_ = drmModeGetPlaneResources(fd);
+    if (device->plane_resources_ && device->plane_resources_->count_planes > 0) {
+        Logger::info("Found " + std::to_string(device->plane_resources_->count_planes) +
+                    " planes for hardware scaling");
+    } else {
+        Logger::warning("No planes found - hardware scaling not available");
+    }
+
+    return device;
+}
+
+DrmDevice::~DrmDevice() {
+    if (running_.exchange(false) && event_thread_.joinable()) {
+        event_thread_.join();
+    }
+
+    if (plane_resources_) {
+        drmModeFreePlaneResources(plane_resources_);
+    }
+    if (resources_) {
+        drmModeFreeResources(resources_);
+    }
+    if (fd_ >= 0) {
+        // Drop DRM master before closing
+        drmDropMaster(fd_);
+        close(fd_);
+    }
+}
+
+bool DrmDevice::claim(uint32_t object_id, const void* owner) {
+    std::lock_guard<std::mutex> lock(claim_mutex_);
+    auto it = claims_.find(object_id);
+    if (it != claims_.end()) {
+        return it->second == owner;
+    }
+    claims_[object_id] = owner;
+    return true;
+}
+
+bool DrmDevice::isClaimedByOther(uint32_t object_id, const void* owner) const {
+    std::lock_guard<std::mutex> lock(claim_mutex_);
+    auto it = claims_.find(object_id);
+    return it != claims_.end() && it->second != owner;
+}
+
+void DrmDevice::releaseAll(const void* owner) {
+    std::lock_guard<std::mutex> lock(claim_mutex_);
+    for (auto it = claims_.begin(); it != claims_.end();) {
+        it = it->second == owner ? claims_.erase(it) : std::next(it);
+    }
+}
+
+uint32_t DrmDevice::addFlipHandler(FlipHandler* handler) {
+    std::lock_guard<std::mutex> lock(handler_mutex_);
+    for (const auto& entry : handlers_) {
+        if (entry.second == handler) {
+            return entry.first;
+        }
+    }
+    uint32_t id = next_handler_id_++;
+    handlers_[id] = handler;
+    if (!running_.exchange(true)) {
+        event_thread_ = std::thread(&DrmDevice::eventThread, this);
+    }
+    return id;
+}
+
+void DrmDevice::removeFlipHandler(FlipHandler* handler) {
+    std::lock_guard<std::mutex> lock(handler_mutex_);
+    for (auto it = handlers_.begin(); it != handlers_.end();) {
+        it = it->second == handler ? handlers_.erase(it) : std::next(it);
+    }
+}
+
+void DrmDevice::dispatchFlip(void* user_data, int64_t vblank_ns) {
+    // handler_mutex_ is held by eventThread()
+    const uint64_t data = reinterpret_cast<uintptr_t>(user_data);
+    auto it = handlers_.find(static_cast<uint32_t>(data >> 32));
+    if (it != handlers_.end()) {
+        it->second->onFlip(vblank_ns, static_cast<uint32_t>(data));
+    }
+}
+
+void DrmDevice::eventThread() {
+    t_dispatching = this;
+    drmEventContext evctx = {};
+    evctx.version = DRM_EVENT_CONTEXT_VERSION;
+    evctx.page_flip_handler = [](int, unsigned int, unsigned int tv_sec,
+                                 unsigned int tv_usec, void* user_data) {
+        t_dispatching->dispatchFlip(user_data, tv_sec * 1000000000LL + tv_usec * 1000LL);
+    };
+
+    while (running_.load(std::memory_order_acquire)) {
+        struct pollfd pfd = {fd_, POLLIN, 0};
+        int ret = poll(&pfd, 1, 100);   // Timeout only to notice shutdown
+        if (ret > 0 && (pfd.revents & POLLIN)) {
+            std::lock_guard<std::mutex> lock(handler_mutex_);
+            drmHandleEvent(fd_, &evctx);
+        }
+    }
+}
+
+} // namespace display
+} // namespace ndi_bridge
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <xf86drmMode.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ndi_bridge {
+namespace display {
+
+// The DRM card, shared by every display output of the process.
+//
+// Opened once: DRM master, client caps and the connector, CRTC and plane
+// resources are set up for all outputs, so a multi-head process does the
+// master dance and resource scan one time. Outputs claim the connector,
+// CRTC and planes they drive; a claim held by another output is refused,
+// so two heads never program the same object.
+//
+// Page-flip events of all outputs arrive on the one fd. A single thread
+// reads them and passes each to the FlipHandler whose id is in the
+// commit's user data, provided it is still registered - a flip that
+// completes after its output went away is dropped. Ids are never reused,
+// and the user data also carries the handler's sequence number of the
+// commit, so a handler can tell a late event of an old commit apart.
+class DrmDevice {
+public:
+    class FlipHandler {
+    public:
+        virtual ~FlipHandler() = default;
+        // Event thread; vblank time on CLOCK_MONOTONIC, sequence as
+        // given to flipUserData()
+        virtual void onFlip(int64_t vblank_ns, uint32_t sequence) = 0;
+    };
+
+    ~DrmDevice();
+
+    // First card that opens and has dumb buffers, nullptr if none
+    static std::shared_ptr<DrmDevice> open();
+
+    int fd() const { return fd_; }
+    drmModeRes* resources() const { return resources_; }
+    drmModePlaneRes* planeResources() const { return plane_resources_; }   // May be nullptr
+    bool hasUniversalPlanes() const { return has_universal_planes_; }
+    bool hasAtomic() const { return has_atomic_; }
+
+    // Claim a mode object (connector, CRTC, plane) for an output; true
+    // if it was free or already the owner's
+    bool claim(uint32_t object_id, const void* owner);
+    bool isClaimedByOther(uint32_t object_id, const void* owner) const;
+    void releaseAll(const void* owner);
+
+    // Flip events go to registered handlers only; removal waits for a
+    // running dispatch to finish
+    // @return Id for flipUserData(), the same while registered
+    uint32_t addFlipHandler(FlipHandler* handler);
+    void removeFlipHandler(FlipHandler* handler);
+
+    // Page-flip / atomic commit user data: handler id and the handler's
+    // sequence number of the commit
+    static void* flipUserData(uint32_t handler_id, uint32_t sequence) {
+        static_assert(sizeof(void*) >= 8, "flip user data packs two 32-bit values");
+        return reinterpret_cast<void*>(static_cast<uintptr_t>(handler_id) << 32 | sequence);
+    }
+
+private:
+    DrmDevice() = default;
+
+    void eventThread();
+    void dispatchFlip(void* user_data, int64_t vblank_ns);
+
+    int fd_ = -1;
+    drmModeRes* resources_ = nullptr;
+    drmModePlaneRes* plane_resources_ = nullptr;
+    bool has_universal_planes_ = false;
+    bool has_atomic_ = false;
+
+    mutable std::mutex claim_mutex_;
+    std::map<uint32_t, const void*> claims_;
+
+    std::mutex handler_mutex_;              // Held while dispatching
+    std::map<uint32_t, FlipHandler*> handlers_;
+    uint32_t next_handler_id_ = 1;
+    std::thread event_thread_;              // Started with the first handler
+    std::atomic<bool> running_{false};
+};
+
+} // namespace display
+} // namespace ndi_bridge
@@ -1,22 +1,30 @@
 #include "display_output.h"
+#include "drm_atomic_engine.h"
+#include "drm_device.h"
 #include "../common/logger.h"
+#include "../common/stripe_executor.h"
+#include "../common/frame_scaler.h"
+#include "../common/frame_timing.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <xf86drm.h>
 #include <xf86drmMode.h>
 #include <drm_fourcc.h>
 #include <sys/mman.h>
-#include <sys/select.h>
-#include <sys/ioctl.h>
 #include <drm/drm.h>
 
 namespace ndi_bridge {
 namespace display {
 
-// Hardware-accelerated DRM display with plane scaling
-class DRMHWScaleDisplayOutput : public DisplayOutput {
+// Hardware-accelerated DRM display with plane scaling. Outputs made with
+// createSibling() share the DrmDevice and drive further connectors.
+class DRMHWScaleDisplayOutput : public DisplayOutput, private DrmDevice::FlipHandler {
 public:
     DRMHWScaleDisplayOutput() = default;
     ~DRMHWScaleDisplayOutput() override {
@@ -24,77 +32,19 @@ public:
     }
     
     bool initialize() override {
-        // Open DRM device
-        const char* devices[] = {"/dev/dri/card0", "/dev/dri/card1"};
-        for (const char* dev : devices) {
-            drm_fd_ = open(dev, O_RDWR | O_CLOEXEC);
-            if (drm_fd_ >= 0) {
-                Logger::info("Opened DRM device: " + std::string(dev));
-                break;
-            }
-        }
-        
-        if (drm_fd_ < 0) {
-            Logger::error("Failed to open DRM device");
-            return false;
-        }
-        
-        // Become DRM master (required for mode setting)
-        if (drmSetMaster(drm_fd_) < 0) {
-            // Try the ioctl directly if the function is not available
-            if (ioctl(drm_fd_, DRM_IOCTL_SET_MASTER, 0) < 0) {
-                Logger::warning("Could not become DRM master - mode setting may fail");
-                // Don't fail here as we might still work in some cases
-            } else {
-                Logger::info("Became DRM master via ioctl");
+        // A sibling arrives with the device of the output it came from
+        if (!device_) {
+            device_ = DrmDevice::open();
+            if (!device_) {
+                return false;
             }
-        } else {
-            Logger::info("Became DRM master");
-        }
-        
-        // Check for required capabilities
-        uint64_t has_dumb;
-        if (drmGetCap(drm_fd_, DRM_CAP_DUMB_BUFFER, &has_dumb) < 0 || !has_dumb) {
-            Logger::error("DRM device does not support dumb buffers");
-            close(drm_fd_);
-            drm_fd_ = -1;
-            return false;
-        }
-        
-        // Check for universal planes (required for scaling)
-        if (drmSetClientCap(drm_fd_, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1) < 0) {
-            Logger::warning("Universal planes not supported - hardware scaling may not work");
-            has_universal_planes_ = false;
-        } else {
-            has_universal_planes_ = true;
-            Logger::info("Universal planes enabled for hardware scaling");
-        }
-        
-        // Enable atomic mode setting if available (better for Intel GPUs)
-        if (drmSetClientCap(drm_fd_, DRM_CLIENT_CAP_ATOMIC, 1) == 0) {
-            has_atomic_ = true;
-            Logger::info("Atomic mode setting enabled");
-        } else {
-            has_atomic_ = false;
-            Logger::info("Using legacy mode setting");
-        }
-        
-        // Get resources
-        resources_ = drmModeGetResources(drm_fd_);
-        if (!resources_) {
-            Logger::error("Failed to get DRM resources");
-            close(drm_fd_);
-            drm_fd_ = -1;
-            return false;
         }
         
-        // Get plane resources for hardware scaling
-        plane_resources_ = drmModeGetPlaneResources(drm_fd_);
-        if (plane_resources_ && plane_resources_->count_planes > 0) {
-            Logger::info("Found " + std::to_string(plane_resources_->count_planes) + " planes for hardware scaling");
-        } else {
-            Logger::warning("No planes found - hardware scaling not available");
-        }
+        drm_fd_ = device_->fd();
+        resources_ = device_->resources();
+        plane_resources_ = device_->planeResources();
+        has_universal_planes_ = device_->hasUniversalPlanes();
+        has_atomic_ = device_->hasAtomic();
         
         // Find available displays
         findDisplays();
@@ -105,22 +55,20 @@ public:
     void shutdown() override {
         closeDisplay();
         
-        if (plane_resources_) {
-            drmModeFreePlaneResources(plane_resources_);
-            plane_resources_ = nullptr;
-        }
-        
-        if (resources_) {
-            drmModeFreeResources(resources_);
-            resources_ = nullptr;
-        }
-        
-        if (drm_fd_ >= 0) {
-            // Drop DRM master before closing
-            drmDropMaster(drm_fd_);
-            close(drm_fd_);
-            drm_fd_ = -1;
+        // The card closes with the last output using it
+        plane_resources_ = nullptr;
+        resources_ = nullptr;
+        drm_fd_ = -1;
+        device_.reset();
+    }
+    
+    std::unique_ptr<DisplayOutput> createSibling() override {
+        if (!device_) {
+            return nullptr;
         }
+        auto sibling = std::make_unique<DRMHWScaleDisplayOutput>();
+        sibling->device_ = device_;
+        return sibling;
     }
     
     std::vector<DisplayInfo> getDisplays() override {
@@ -138,10 +86,18 @@ public:
         current_display_id_ = display_id;
         auto& disp = displays_[display_id];
         
+        // Another head of this process may be driving it
+        if (!device_->claim(disp.connector_id, this)) {
+            Logger::error("Display " + std::to_string(display_id) + " is already open");
+            current_display_id_ = -1;
+            return false;
+        }
+        
         // Find connector
         connector_ = drmModeGetConnector(drm_fd_, disp.connector_id);
         if (!connector_ || connector_->connection != DRM_MODE_CONNECTED) {
             Logger::error("Display not connected");
+            closeDisplay();
             return false;
         }
         
@@ -160,18 +116,18 @@ public:
         
         if (!encoder_) {
             Logger::error("No encoder found");
-            drmModeFreeConnector(connector_);
-            connector_ = nullptr;
+            closeDisplay();
             return false;
         }
         
-        // Find CRTC
+        // Find CRTC, skipping those other heads drive
         crtc_id_ = 0;
-        if (encoder_->crtc_id) {
+        if (encoder_->crtc_id && device_->claim(encoder_->crtc_id, this)) {
             crtc_id_ = encoder_->crtc_id;
         } else {
             for (int i = 0; i < resources_->count_crtcs; i++) {
-                if (encoder_->possible_crtcs & (1 << i)) {
+                if ((encoder_->possible_crtcs & (1 << i)) &&
+                    device_->claim(resources_->crtcs[i], this)) {
                     crtc_id_ = resources_->crtcs[i];
                     break;
                 }
@@ -180,10 +136,7 @@ public:
         
         if (!crtc_id_) {
             Logger::error("No CRTC found");
-            drmModeFreeEncoder(encoder_);
-            drmModeFreeConnector(connector_);
-            encoder_ = nullptr;
-            connector_ = nullptr;
+            closeDisplay();
             return false;
         }
         
@@ -205,7 +158,7 @@ public:
         
         if (!mode_) {
             Logger::error("No mode found");
-            cleanup();
+            closeDisplay();
             return false;
         }
         
@@ -220,11 +173,12 @@ public:
         // Find a plane that can be used with this CRTC for scaling
         if (plane_resources_ && has_universal_planes_) {
             findScalingPlane();
+            findYuvPlane();
         }
         
-        // Create framebuffers for double buffering
+        // Create framebuffers for triple buffering
         if (!createFramebuffers()) {
-            cleanup();
+            closeDisplay();
             return false;
         }
         
@@ -233,10 +187,12 @@ public:
         if (drmModeSetCrtc(drm_fd_, crtc_id_, fb_[current_fb_].fb_id, 0, 0,
                           &connector_->connector_id, 1, mode_) < 0) {
             Logger::error("Failed to set mode");
-            cleanup();
+            closeDisplay();
             return false;
         }
         
+        flip_handler_id_ = device_->addFlipHandler(this);
+        setupAtomic();
         return true;
     }
     
@@ -262,14 +218,26 @@ public:
             return false;
         }
         
-        // Get next framebuffer
-        int next_fb = current_fb_ ^ 1;
+        // Next framebuffer: with atomic commits one neither on screen nor
+        // waiting for vblank, so this never waits
+        int next_fb = use_atomic_ ? atomic_.acquireBuffer()
+                                  : (current_fb_ + 1) % kBufferCount;
         auto& fb = fb_[next_fb];
         
         if (!fb.map) {
             return false;
         }
         
+        // UYVY straight to a YUV plane; the display engine converts and scales
+        if (format == PixelFormat::UYVY && yuv_plane_id_) {
+            if (displayFrameOnYuvPlane(data, width, height, stride, next_fb)) {
+                return true;
+            }
+        }
+        if (!use_atomic_) {
+            disableYuvPlane();   // Atomic commits take it down with the next frame
+        }
+        
         // Check if we can use hardware scaling
         if (plane_id_ && has_universal_planes_) {
             // Use hardware plane scaling
@@ -280,8 +248,25 @@ public:
         }
     }
     
+    bool canScanOut(PixelFormat format) const override {
+        return format == PixelFormat::UYVY && yuv_plane_id_ != 0;
+    }
+    
+    int64_t getLastScanoutNs() const override {
+        return last_scanout_ns_.load();
+    }
+    
+    DisplayStats getStats() const override {
+        DisplayStats stats = use_atomic_ ? atomic_.getStats() : DisplayStats();
+        if (!use_atomic_) {
+            stats.frames_flipped = legacy_flips_;
+        }
+        stats.frames_torn = frames_torn_;
+        return stats;
+    }
+    
     void clearDisplay() override {
-        for (int i = 0; i < 2; i++) {
+        for (int i = 0; i < kBufferCount; i++) {
             if (fb_[i].map) {
                 memset(fb_[i].map, 0, fb_[i].size);
             }
@@ -298,8 +283,21 @@ private:
     drmModeModeInfo* mode_ = nullptr;
     uint32_t crtc_id_ = 0;
     uint32_t plane_id_ = 0;
+    uint32_t yuv_plane_id_ = 0;          // Plane scanning out UYVY, 0 = none
+    bool yuv_plane_active_ = false;      // Showing the last frame
+    uint32_t color_encoding_prop_ = 0;   // Plane COLOR_ENCODING / COLOR_RANGE
+    uint32_t color_range_prop_ = 0;
+    uint64_t encoding_bt601_ = 0;
+    uint64_t encoding_bt709_ = 0;
+    uint64_t range_limited_ = 0;
+    int yuv_encoding_height_ = 0;        // Frame height the encoding was set for
     bool has_universal_planes_ = false;
     bool has_atomic_ = false;
+    bool use_atomic_ = false;            // Frames go out as atomic commits
+    uint32_t primary_plane_id_ = 0;
+    DrmAtomicEngine atomic_;
+    uint64_t legacy_flips_ = 0;          // Frames shown by legacy calls
+    uint64_t frames_torn_ = 0;
     
     std::vector<DisplayInfo> displays_;
     
@@ -311,11 +309,33 @@ private:
         uint32_t pitch = 0;
         uint32_t width = 0;
         uint32_t height = 0;
+        uint32_t format = DRM_FORMAT_XRGB8888;
     };
     
-    Framebuffer fb_[2]; // Double buffering
-    Framebuffer source_fb_[2]; // Source framebuffers at original resolution for HW scaling
-    int current_fb_ = 0;
+    static constexpr int kBufferCount = DrmAtomicEngine::kBufferCount;
+    Framebuffer fb_[kBufferCount]; // Triple buffering (mailbox with atomic commits)
+    Framebuffer source_fb_[kBufferCount]; // Source framebuffers at original resolution for HW scaling
+    int current_fb_ = 0;           // Last presented
+    FrameScaler scaler_{PixelKernels::active(), &StripeExecutor::shared()};   // Software scaling / conversion
+    StripeExecutor::RowCost yuv_copy_cost_;  // UYVY copy to the YUV plane
+    std::atomic<int64_t> last_scanout_ns_{0};   // Monotonic; flip event, commit or due vblank
+    std::shared_ptr<DrmDevice> device_;
+    std::mutex legacy_flip_mutex_;           // Legacy page flip completion
+    std::condition_variable legacy_flip_cv_;
+    bool legacy_flip_done_ = false;
+    uint32_t legacy_flip_seq_ = 0;           // Number of the last page flip
+    uint32_t flip_handler_id_ = 0;
+    
+    // Legacy page flip done (device event thread)
+    void onFlip(int64_t vblank_ns, uint32_t sequence) override {
+        std::lock_guard<std::mutex> lock(legacy_flip_mutex_);
+        if (sequence != legacy_flip_seq_) {
+            return;   // Flip whose wait already timed out
+        }
+        last_scanout_ns_ = vblank_ns;
+        legacy_flip_done_ = true;
+        legacy_flip_cv_.notify_all();
+    }
     
     void findDisplays() {
         displays_.clear();
@@ -372,8 +392,9 @@ private:
             drmModePlane* plane = drmModeGetPlane(drm_fd_, plane_resources_->planes[i]);
             if (!plane) continue;
             
-            // Check if plane can be used with our CRTC
-            if (!(plane->possible_crtcs & (1 << getCrtcIndex()))) {
+            // Check if plane can be used with our CRTC (and no other head has it)
+            if (!(plane->possible_crtcs & (1 << getCrtcIndex())) ||
+                device_->isClaimedByOther(plane->plane_id, this)) {
                 drmModeFreePlane(plane);
                 continue;
             }
@@ -401,7 +422,7 @@ private:
                     }
                 }
                 
-                if (supports_scaling) {
+                if (supports_scaling && device_->claim(plane->plane_id, this)) {
                     plane_id_ = plane->plane_id;
                     Logger::info("Found plane " + std::to_string(plane_id_) + " with scaling support");
                     drmModeFreeObjectProperties(props);
@@ -431,7 +452,7 @@ private:
     
     bool createFramebuffers() {
         // Create display framebuffers at display resolution
-        for (int i = 0; i < 2; i++) {
+        for (int i = 0; i < kBufferCount; i++) {
             struct drm_mode_create_dumb create_req = {};  // Zero-initialize
             create_req.width = mode_->hdisplay;
             create_req.height = mode_->vdisplay;
@@ -523,11 +544,13 @@ private:
         return true;
     }
     
-    bool createSourceFramebuffer(int width, int height, int index) {
+    bool createSourceFramebuffer(int width, int height, int index,
+                                 uint32_t format = DRM_FORMAT_XRGB8888) {
         // Create source framebuffer at NDI stream resolution
         if (source_fb_[index].width == (uint32_t)width && 
-            source_fb_[index].height == (uint32_t)height) {
-            return true; // Already created at this resolution
+            source_fb_[index].height == (uint32_t)height &&
+            source_fb_[index].format == format) {
+            return true; // Already created at this resolution and format
         }
         
         // Clean up old buffer if exists
@@ -550,7 +573,7 @@ private:
         struct drm_mode_create_dumb create_req = {};
         create_req.width = width;
         create_req.height = height;
-        create_req.bpp = 32;
+        create_req.bpp = (format == DRM_FORMAT_UYVY) ? 16 : 32;
         
         if (drmIoctl(drm_fd_, DRM_IOCTL_MODE_CREATE_DUMB, &create_req) < 0) {
             Logger::error("Failed to create source dumb buffer");
@@ -562,12 +585,24 @@ private:
         source_fb_[index].size = create_req.size;
         source_fb_[index].width = width;
         source_fb_[index].height = height;
+        source_fb_[index].format = format;
         
-        if (drmModeAddFB(drm_fd_, width, height, 24, 32,
-                        source_fb_[index].pitch, source_fb_[index].handle, 
-                        &source_fb_[index].fb_id) < 0) {
-            Logger::error("Failed to create source framebuffer");
-            return false;
+        if (format == DRM_FORMAT_XRGB8888) {
+            if (drmModeAddFB(drm_fd_, width, height, 24, 32,
+                            source_fb_[index].pitch, source_fb_[index].handle, 
+                            &source_fb_[index].fb_id) < 0) {
+                Logger::error("Failed to create source framebuffer");
+                return false;
+            }
+        } else {
+            uint32_t handles[4] = {source_fb_[index].handle};
+            uint32_t pitches[4] = {source_fb_[index].pitch};
+            uint32_t offsets[4] = {0};
+            if (drmModeAddFB2(drm_fd_, width, height, format, handles, pitches, offsets,
+                             &source_fb_[index].fb_id, 0) < 0) {
+                Logger::error("Failed to create source framebuffer");
+                return false;
+            }
         }
         
         struct drm_mode_map_dumb map_req = {};
@@ -591,6 +626,256 @@ private:
         return true;
     }
     
+    // Enum value of a property by name, false if the property lacks it
+    bool findEnumValue(drmModePropertyRes* prop, const char* name, uint64_t& value) {
+        for (int i = 0; i < prop->count_enums; i++) {
+            if (strcmp(prop->enums[i].name, name) == 0) {
+                value = prop->enums[i].value;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Whether a plane can show a format on our CRTC
+    bool planeScansOut(uint32_t plane_id, uint32_t format) {
+        drmModePlane* plane = drmModeGetPlane(drm_fd_, plane_id);
+        if (!plane) return false;
+        
+        bool found = false;
+        if (plane->possible_crtcs & (1 << getCrtcIndex())) {
+            for (uint32_t f = 0; f < plane->count_formats && !found; f++) {
+                found = plane->formats[f] == format;
+            }
+        }
+        drmModeFreePlane(plane);
+        return found;
+    }
+    
+    void findYuvPlane() {
+        yuv_plane_id_ = 0;
+        color_encoding_prop_ = 0;
+        color_range_prop_ = 0;
+        
+        // Prefer the scaling plane so RGB and YUV frames share one plane
+        if (plane_id_ && planeScansOut(plane_id_, DRM_FORMAT_UYVY)) {
+            yuv_plane_id_ = plane_id_;
+        }
+        for (uint32_t i = 0; i < plane_resources_->count_planes && !yuv_plane_id_; i++) {
+            uint32_t id = plane_resources_->planes[i];
+            if (!device_->isClaimedByOther(id, this) && planeScansOut(id, DRM_FORMAT_UYVY) &&
+                device_->claim(id, this)) {
+                yuv_plane_id_ = id;
+            }
+        }
+        
+        if (!yuv_plane_id_) {
+            Logger::info("No plane scans out UYVY - frames will be converted to XRGB");
+            return;
+        }
+        
+        // BT.601/709 limited range; without the properties the driver default applies
+        drmModeObjectProperties* props = drmModeObjectGetProperties(
+            drm_fd_, yuv_plane_id_, DRM_MODE_OBJECT_PLANE);
+        if (props) {
+            for (uint32_t j = 0; j < props->count_props; j++) {
+                drmModePropertyRes* prop = drmModeGetProperty(drm_fd_, props->props[j]);
+                if (!prop) continue;
+                if (strcmp(prop->name, "COLOR_ENCODING") == 0 &&
+                    findEnumValue(prop, "ITU-R BT.601 YCbCr", encoding_bt601_) &&
+                    findEnumValue(prop, "ITU-R BT.709 YCbCr", encoding_bt709_)) {
+                    color_encoding_prop_ = prop->prop_id;
+                } else if (strcmp(prop->name, "COLOR_RANGE") == 0 &&
+                           findEnumValue(prop, "YCbCr limited range", range_limited_)) {
+                    color_range_prop_ = prop->prop_id;
+                }
+                drmModeFreeProperty(prop);
+            }
+            drmModeFreeObjectProperties(props);
+        }
+        
+        Logger::info("Plane " + std::to_string(yuv_plane_id_) + " scans out UYVY" +
+                    (color_encoding_prop_ ? " (BT.601/709 selectable)" : ""));
+    }
+    
+    void setYuvColorProperties(int height) {
+        if (height == yuv_encoding_height_) {
+            return;
+        }
+        yuv_encoding_height_ = height;
+        
+        // NDI uses BT.601 for SD and BT.709 above it, limited range
+        if (color_encoding_prop_) {
+            drmModeObjectSetProperty(drm_fd_, yuv_plane_id_, DRM_MODE_OBJECT_PLANE,
+                                     color_encoding_prop_,
+                                     height > 576 ? encoding_bt709_ : encoding_bt601_);
+        }
+        if (color_range_prop_) {
+            drmModeObjectSetProperty(drm_fd_, yuv_plane_id_, DRM_MODE_OBJECT_PLANE,
+                                     color_range_prop_, range_limited_);
+        }
+    }
+    
+    bool displayFrameOnYuvPlane(const uint8_t* data, int width, int height,
+                                int stride, int next_fb) {
+        if (!createSourceFramebuffer(width, height, next_fb, DRM_FORMAT_UYVY)) {
+            Logger::warning("UYVY framebuffer not available - converting frames to XRGB");
+            yuv_plane_id_ = 0;
+            return false;
+        }
+        
+        auto& src_fb = source_fb_[next_fb];
+        
+        // Plain row copy, no colour conversion
+        size_t row_bytes = static_cast<size_t>(width) * 2;
+        StripeExecutor::shared().run(yuv_copy_cost_, height, row_bytes * 2,
+                                     [&](int row_begin, int row_end) {
+            for (int y = row_begin; y < row_end; y++) {
+                memcpy(src_fb.map + static_cast<size_t>(y) * src_fb.pitch,
+                       data + static_cast<size_t>(y) * stride, row_bytes);
+            }
+        });
+        
+        if (!use_atomic_) {
+            setYuvColorProperties(height);   // Atomic commits carry them
+        }
+        
+        // Letterbox to preserve aspect ratio
+        float src_aspect = (float)width / height;
+        float dst_aspect = (float)mode_->hdisplay / mode_->vdisplay;
+        
+        int scaled_width, scaled_height;
+        int x_offset = 0, y_offset = 0;
+        
+        if (src_aspect > dst_aspect) {
+            scaled_width = mode_->hdisplay;
+            scaled_height = mode_->hdisplay / src_aspect;
+            y_offset = (mode_->vdisplay - scaled_height) / 2;
+        } else {
+            scaled_height = mode_->vdisplay;
+            scaled_width = mode_->vdisplay * src_aspect;
+            x_offset = (mode_->hdisplay - scaled_width) / 2;
+        }
+        
+        if (!showOnPlane(next_fb, yuv_plane_id_, src_fb.fb_id, width, height,
+                         x_offset, y_offset, scaled_width, scaled_height, true)) {
+            Logger::warning("UYVY plane scanout failed - converting frames to XRGB");
+            yuv_plane_id_ = 0;
+            yuv_plane_active_ = false;
+            return false;
+        }
+        yuv_plane_active_ = true;
+        
+        current_fb_ = next_fb;
+        return true;
+    }
+    
+    // Show buffer slot's framebuffer on a plane: presented to the atomic
+    // mailbox, or drmModeSetPlane (which waits for vblank) without atomic
+    bool showOnPlane(int buffer, uint32_t plane_id, uint32_t fb_id, int src_width, int src_height,
+                     int x, int y, int width, int height, bool yuv = false) {
+        if (use_atomic_) {
+            DrmAtomicEngine::PlaneState state;
+            state.plane_id = plane_id;
+            state.fb_id = fb_id;
+            state.src_width = src_width;
+            state.src_height = src_height;
+            state.crtc_x = x;
+            state.crtc_y = y;
+            state.crtc_width = width;
+            state.crtc_height = height;
+            state.yuv = yuv;
+            state.yuv_bt709 = src_height > 576;
+            
+            // An overlay YUV plane goes down in the commit that moves on
+            uint32_t disable = (yuv_plane_active_ && yuv_plane_id_ != plane_id) ? yuv_plane_id_ : 0;
+            if (!atomic_.present(buffer, state, disable)) {
+                return false;
+            }
+            if (disable) {
+                yuv_plane_active_ = false;
+            }
+            last_scanout_ns_ = atomic_.expectedScanoutNs();
+            return true;
+        }
+        
+        if (drmModeSetPlane(drm_fd_, plane_id, crtc_id_, fb_id, 0,
+                           x, y, width, height,                              // Destination (CRTC)
+                           0, 0, src_width << 16, src_height << 16) < 0) {   // Source (FB)
+            return false;
+        }
+        // SetPlane has no flip event; the commit is the closest scanout time
+        last_scanout_ns_ = FrameTiming::monotonicNs();
+        legacy_flips_++;
+        return true;
+    }
+    
+    uint32_t findPrimaryPlane() {
+        for (uint32_t i = 0; i < plane_resources_->count_planes; i++) {
+            uint32_t id = plane_resources_->planes[i];
+            drmModePlane* plane = drmModeGetPlane(drm_fd_, id);
+            if (!plane) continue;
+            bool usable = (plane->possible_crtcs & (1 << getCrtcIndex())) != 0;
+            drmModeFreePlane(plane);
+            if (!usable) continue;
+            
+            drmModeObjectProperties* props = drmModeObjectGetProperties(
+                drm_fd_, id, DRM_MODE_OBJECT_PLANE);
+            if (!props) continue;
+            bool primary = false;
+            for (uint32_t j = 0; j < props->count_props; j++) {
+                drmModePropertyRes* prop = drmModeGetProperty(drm_fd_, props->props[j]);
+                if (!prop) continue;
+                if (strcmp(prop->name, "type") == 0 &&
+                    props->prop_values[j] == DRM_PLANE_TYPE_PRIMARY) {
+                    primary = true;
+                }
+                drmModeFreeProperty(prop);
+            }
+            drmModeFreeObjectProperties(props);
+            if (primary && device_->claim(id, this)) {
+                return id;
+            }
+        }
+        return 0;
+    }
+    
+    // Switch frame presentation to atomic commits when every plane in use
+    // has the properties; otherwise the legacy calls stay
+    void setupAtomic() {
+        if (!has_atomic_ || !plane_resources_) {
+            return;
+        }
+        
+        primary_plane_id_ = findPrimaryPlane();
+        bool ok = primary_plane_id_ &&
+                  atomic_.initialize(*device_, crtc_id_, mode_->vrefresh, current_fb_) &&
+                  atomic_.addPlane(primary_plane_id_) &&
+                  (!plane_id_ || atomic_.addPlane(plane_id_)) &&
+                  (!yuv_plane_id_ || atomic_.addPlane(yuv_plane_id_));
+        if (!ok) {
+            Logger::warning("Atomic commits unavailable - using legacy page flips");
+            atomic_.shutdown();
+            primary_plane_id_ = 0;
+            return;
+        }
+        
+        use_atomic_ = true;
+        Logger::info("Atomic commits with non-blocking page flips");
+    }
+    
+    // Take an overlay YUV plane down before RGB frames go to another plane
+    void disableYuvPlane() {
+        if (!yuv_plane_active_) {
+            return;
+        }
+        yuv_plane_active_ = false;
+        if (yuv_plane_id_ && yuv_plane_id_ != plane_id_) {
+            drmModeSetPlane(drm_fd_, yuv_plane_id_, crtc_id_, 0, 0,
+                           0, 0, 0, 0, 0, 0, 0, 0);
+        }
+    }
+    
     bool displayFrameWithHWScaling(const uint8_t* data, int width, int height,
                                    PixelFormat format, int stride, int next_fb) {
         // Create source framebuffer at NDI resolution
@@ -623,9 +908,8 @@ private:
         }
         
         // Use DRM plane to scale and display the source framebuffer
-        if (drmModeSetPlane(drm_fd_, plane_id_, crtc_id_, src_fb.fb_id, 0,
-                           x_offset, y_offset, scaled_width, scaled_height,  // Destination (CRTC)
-                           0, 0, width << 16, height << 16) < 0) {          // Source (FB)
+        if (!showOnPlane(next_fb, plane_id_, src_fb.fb_id, width, height,
+                         x_offset, y_offset, scaled_width, scaled_height)) {
             Logger::error("Hardware scaling failed, falling back to software");
             return displayFrameWithSWScaling(data, width, height, format, stride, next_fb);
         }
@@ -638,9 +922,6 @@ private:
                                    PixelFormat format, int stride, int next_fb) {
         auto& fb = fb_[next_fb];
         
-        // Clear framebuffer first (for letterboxing)
-        memset(fb.map, 0, fb.size);
-        
         // Calculate scaling to fit display while preserving aspect ratio
         float src_aspect = (float)width / height;
         float dst_aspect = (float)mode_->hdisplay / mode_->vdisplay;
@@ -658,90 +939,91 @@ private:
             x_offset = (mode_->hdisplay - scaled_width) / 2;
         }
         
+        // Clear the letterbox bars only; the picture overwrites the rest
+        clearOutside(fb, x_offset, y_offset, scaled_width, scaled_height);
+        
         // Software scaling with format conversion
         convertToFramebuffer(data, width, height, format, stride,
                            fb.map + (y_offset * fb.pitch) + (x_offset * 4),
                            fb.pitch, scaled_width, scaled_height);
         
-        // Page flip to display the new frame
+        // Non-blocking flip of the primary plane
+        if (use_atomic_) {
+            if (!showOnPlane(next_fb, primary_plane_id_, fb.fb_id, mode_->hdisplay, mode_->vdisplay,
+                             0, 0, mode_->hdisplay, mode_->vdisplay)) {
+                drmModeSetCrtc(drm_fd_, crtc_id_, fb.fb_id, 0, 0,
+                              &connector_->connector_id, 1, mode_);
+                last_scanout_ns_ = FrameTiming::monotonicNs();
+                frames_torn_++;
+            }
+            current_fb_ = next_fb;
+            return true;
+        }
+        
+        // Page flip to display the new frame; the flip event carries the
+        // vblank time it took effect (CLOCK_MONOTONIC)
+        last_scanout_ns_ = 0;
+        legacy_flips_++;
+        uint32_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(legacy_flip_mutex_);
+            legacy_flip_done_ = false;
+            sequence = ++legacy_flip_seq_;
+        }
         if (drmModePageFlip(drm_fd_, crtc_id_, fb.fb_id, 
-                           DRM_MODE_PAGE_FLIP_EVENT, nullptr) < 0) {
+                           DRM_MODE_PAGE_FLIP_EVENT, DrmDevice::flipUserData(flip_handler_id_, sequence)) < 0) {
             drmModeSetCrtc(drm_fd_, crtc_id_, fb.fb_id, 0, 0,
                           &connector_->connector_id, 1, mode_);
+            last_scanout_ns_ = FrameTiming::monotonicNs();
+            frames_torn_++;
         } else {
-            drmEventContext evctx = {};
-            evctx.version = DRM_EVENT_CONTEXT_VERSION;
-            evctx.page_flip_handler = [](int, unsigned int, unsigned int, 
-                                        unsigned int, void*) {};
-            
-            fd_set fds;
-            FD_ZERO(&fds);
-            FD_SET(drm_fd_, &fds);
-            
-            struct timeval tv = {0, 16667}; // ~60fps timeout
-            if (select(drm_fd_ + 1, &fds, nullptr, nullptr, &tv) > 0) {
-                drmHandleEvent(drm_fd_, &evctx);
-            }
+            // The device's event thread reads the event (the fd is shared
+            // with the other heads); wait up to a 60 Hz refresh for it
+            std::unique_lock<std::mutex> lock(legacy_flip_mutex_);
+            legacy_flip_cv_.wait_for(lock, std::chrono::microseconds(16667),
+                                     [this] { return legacy_flip_done_; });
         }
         
         current_fb_ = next_fb;
         return true;
     }
     
+    void clearOutside(Framebuffer& fb, int x, int y, int width, int height) {
+        const size_t row_bytes = static_cast<size_t>(fb.width) * 4;
+        for (uint32_t row = 0; row < fb.height; row++) {
+            uint8_t* line = fb.map + static_cast<size_t>(row) * fb.pitch;
+            if (static_cast<int>(row) < y || static_cast<int>(row) >= y + height) {
+                memset(line, 0, row_bytes);
+                continue;
+            }
+            memset(line, 0, static_cast<size_t>(x) * 4);
+            size_t right = static_cast<size_t>(x + width) * 4;
+            if (right < row_bytes) {
+                memset(line + right, 0, row_bytes - right);
+            }
+        }
+    }
+    
     void convertToFramebuffer(const uint8_t* src_data, int src_width, int src_height,
                              PixelFormat format, int src_stride,
                              uint8_t* dst_data, int dst_pitch, 
                              int dst_width, int dst_height) {
-        // Simple bilinear scaling with format conversion
-        for (int dst_y = 0; dst_y < dst_height; dst_y++) {
-            int src_y = (dst_y * src_height) / dst_height;
-            if (src_y >= src_height) src_y = src_height - 1;
-            
-            uint8_t* dst_row = dst_data + (dst_y * dst_pitch);
-            
-            for (int dst_x = 0; dst_x < dst_width; dst_x++) {
-                int src_x = (dst_x * src_width) / dst_width;
-                if (src_x >= src_width) src_x = src_width - 1;
-                
-                if (format == PixelFormat::BGRA) {
-                    const uint8_t* src_pixel = src_data + (src_y * src_stride) + (src_x * 4);
-                    uint8_t* dst_pixel = dst_row + (dst_x * 4);
-                    
-                    // Convert BGRA to XRGB8888
-                    dst_pixel[0] = src_pixel[0]; // B
-                    dst_pixel[1] = src_pixel[1]; // G
-                    dst_pixel[2] = src_pixel[2]; // R
-                    dst_pixel[3] = 0xFF;          // X
-                } else if (format == PixelFormat::UYVY) {
-                    int src_x_pair = (src_x / 2) * 2;
-                    // Ensure we don't read past buffer boundary
-                    if (src_x_pair * 2 + 3 >= src_stride) continue;
-                    const uint8_t* src = src_data + (src_y * src_stride) + (src_x_pair * 2);
-                    uint8_t* dst_pixel = dst_row + (dst_x * 4);
-                    
-                    uint8_t y = (src_x & 1) ? src[3] : src[1];
-                    uint8_t u = src[0];
-                    uint8_t v = src[2];
-                    
-                    // YUV to RGB conversion (BT.601)
-                    int c = y - 16;
-                    int d = u - 128;
-                    int e = v - 128;
-                    
-                    int r = (298 * c + 409 * e + 128) >> 8;
-                    int g = (298 * c - 100 * d - 208 * e + 128) >> 8;
-                    int b = (298 * c + 516 * d + 128) >> 8;
-                    
-                    dst_pixel[0] = std::min(255, std::max(0, b));
-                    dst_pixel[1] = std::min(255, std::max(0, g));
-                    dst_pixel[2] = std::min(255, std::max(0, r));
-                    dst_pixel[3] = 0xFF;
-                }
-            }
-        }
+        // Bilinear scaling with fused UYVY conversion; tables are kept
+        // per size and output rows run in bands across cores
+        scaler_.scale(src_data, src_width, src_height, src_stride,
+                      format == PixelFormat::UYVY ? FrameScaler::Format::UYVY : FrameScaler::Format::BGRA,
+                      dst_data, dst_pitch, dst_width, dst_height);
     }
     
     void cleanup() {
+        // Flip events stop before the framebuffers go
+        if (device_) {
+            device_->removeFlipHandler(this);
+        }
+        atomic_.shutdown();
+        use_atomic_ = false;
+        primary_plane_id_ = 0;
+        
         // Restore saved CRTC if exists
         if (saved_crtc_ && crtc_id_ && connector_) {
             uint32_t conn_id = connector_->connector_id;
@@ -753,7 +1035,7 @@ private:
         }
         
         // Clean up framebuffers
-        for (int i = 0; i < 2; i++) {
+        for (int i = 0; i < kBufferCount; i++) {
             // Display framebuffers
             if (fb_[i].map) {
                 munmap(fb_[i].map, fb_[i].size);
@@ -800,6 +1082,14 @@ private:
         mode_ = nullptr;
         crtc_id_ = 0;
         plane_id_ = 0;
+        yuv_plane_id_ = 0;
+        yuv_plane_active_ = false;
+        yuv_encoding_height_ = 0;
+        
+        // Connector, CRTC and planes free for the other heads
+        if (device_) {
+            device_->releaseAll(this);
+        }
     }
 };
 
@@ -3,21 +3,44 @@
 #include <vector>
 #include <atomic>
 #include <csignal>
+#include <cstdlib>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <thread>
 
 #include "ndi_receiver.h"
 #include "display_output.h"
 #include "audio_output.h"
 #include "audio_processor.h"
 #include "status_reporter.h"
+#include "../common/frame_timing.h"
+#include "../common/latency_histogram.h"
 #include "../common/logger.h"
+#include "../common/pipeline_thread_pool.h"
 #include "../common/version.h"
 
 using namespace ndi_bridge;
 using namespace ndi_bridge::display;
 
+// Latency stages reported from ndi-capture's per-frame timing metadata
+enum LatencyStage {
+    kCaptureToSend,      // V4L2 timestamp -> handed to NDI (capture host)
+    kSendToReceive,      // NDI encode, network, decode (needs synced clocks)
+    kReceiveToScanout,   // Conversion and page flip (display host)
+    kCaptureToScanout,   // Glass to glass
+    kLatencyStageCount
+};
+
+static const char* const kLatencyStageKeys[kLatencyStageCount] = {
+    "CAPTURE_TO_SEND", "SEND_TO_RECEIVE", "RECEIVE_TO_SCANOUT", "CAPTURE_TO_SCANOUT"
+};
+static const char* const kLatencyStageNames[kLatencyStageCount] = {
+    "capture->send", "send->receive", "receive->scanout", "capture->scanout"
+};
+
 // Global shutdown flag with proper memory ordering
 std::atomic<bool> g_shutdown(false);
 
@@ -33,11 +56,13 @@ void printUsage(const char* program) {
     std::cout << "Version: " << NDI_BRIDGE_VERSION << "\n\n";
     std::cout << "Usage:\n";
     std::cout << "  " << program << " <stream_name> <display_id>  # Receive and display\n";
+    std::cout << "  " << program << " multi <id>=<stream> ...     # One process for several displays\n";
     std::cout << "  " << program << " list                        # List available NDI streams\n";
     std::cout << "  " << program << " displays                    # List available displays\n";
     std::cout << "  " << program << " status                      # Show all displays status\n";
     std::cout << "\nExamples:\n";
     std::cout << "  " << program << " \"Camera 1\" 0                # Show Camera 1 on display 0\n";
+    std::cout << "  " << program << " multi 0=\"Camera 1\" 1=\"Camera 2\"  # Video wall\n";
     std::cout << "  " << program << " list\n";
 }
 
@@ -164,6 +189,8 @@ int showStatus() {
             std::string line;
             std::string stream_name, resolution, fps, bitrate;
             uint64_t frames_received = 0, frames_dropped = 0;
+            uint64_t frames_late = 0, frames_skipped = 0, frames_torn = 0;
+            std::map<std::string, std::string> latency;
             
             while (std::getline(f, line)) {
                 if (line.find("STREAM_NAME=") == 0) {
@@ -185,6 +212,15 @@ int showStatus() {
                     frames_received = std::stoull(line.substr(16));
                 } else if (line.find("FRAMES_DROPPED=") == 0) {
                     frames_dropped = std::stoull(line.substr(15));
+                } else if (line.find("FRAMES_LATE=") == 0) {
+                    frames_late = std::stoull(line.substr(12));
+                } else if (line.find("FRAMES_SKIPPED=") == 0) {
+                    frames_skipped = std::stoull(line.substr(15));
+                } else if (line.find("FRAMES_TORN=") == 0) {
+                    frames_torn = std::stoull(line.substr(12));
+                } else if (line.find("LATENCY_") == 0 && line.find('=') != std::string::npos) {
+                    size_t eq = line.find('=');
+                    latency[line.substr(8, eq - 8)] = line.substr(eq + 1);
                 }
             }
             
@@ -194,6 +230,17 @@ int showStatus() {
             std::cout << "  Bitrate: " << bitrate << " Mbps\n";
             std::cout << "  Frames: " << frames_received << " received, " 
                      << frames_dropped << " dropped\n";
+            std::cout << "  Flips: " << frames_late << " late, " << frames_skipped
+                     << " skipped, " << frames_torn << " torn\n";
+            for (int s = 0; s < kLatencyStageCount; s++) {
+                const std::string key = kLatencyStageKeys[s];
+                if (latency.count(key + "_P50")) {
+                    std::cout << "  Latency " << kLatencyStageNames[s] << ": p50 "
+                             << latency[key + "_P50"] << " / p95 " << latency[key + "_P95"]
+                             << " / p99 " << latency[key + "_P99"] << " / max "
+                             << latency[key + "_MAX"] << " ms\n";
+                }
+            }
         } else if (i == console_display) {
             std::cout << "\n  Linux Console (TTY)\n";
         } else if (i < static_cast<int>(displays.size()) && displays[i].connected) {
@@ -216,8 +263,8 @@ int showStatus() {
     return 0;
 }
 
-int receiveAndDisplay(const std::string& stream_name, int display_id) {
-    // Check if console is active on this display
+// Whether the Linux console holds a display (then it is not ours to take)
+bool consoleActive(int display_id) {
     std::string vtcon_path = "/sys/class/vtconsole/vtcon" + 
                             std::to_string(display_id) + "/bind";
     if (std::filesystem::exists(vtcon_path)) {
@@ -227,42 +274,32 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
             Logger::error("Console is active on display " + std::to_string(display_id));
             Logger::error("Run: ndi-display-config " + std::to_string(display_id) + 
                          " to configure this display");
-            return 1;
+            return true;
         }
     }
-    
-    // Initialize receiver
-    NDIReceiver receiver;
-    if (!receiver.initialize()) {
-        Logger::error("Failed to initialize NDI");
-        return 1;
-    }
+    return false;
+}
+
+// Receive one stream and present it on an open display until shutdown.
+// Multi-head runs one per display, each on its own thread; log_prefix
+// tells their log lines apart.
+int runDisplayHead(const std::string& stream_name, int display_id,
+                   NDIReceiver& receiver, DisplayOutput& display,
+                   const std::string& log_prefix = "") {
+    // Ask NDI for UYVY when the display scans it out directly; the frame
+    // then goes to a YUV plane without CPU colour conversion.
+    // NDI_DISPLAY_YUV_SCANOUT=0 keeps BGRA.
+    const char* yuv_scanout = std::getenv("NDI_DISPLAY_YUV_SCANOUT");
+    bool yuv_allowed = !(yuv_scanout && std::string(yuv_scanout) == "0");
+    receiver.setPreferUYVY(yuv_allowed && display.canScanOut(PixelFormat::UYVY));
     
     // Connect to stream
-    Logger::info("Connecting to '" + stream_name + "'...");
+    Logger::info(log_prefix + "Connecting to '" + stream_name + "'...");
     if (!receiver.connect(stream_name)) {
-        Logger::error("Failed to connect to stream: " + stream_name);
-        return 1;
-    }
-    
-    // Initialize display
-    auto display = createDisplayOutput();
-    if (!display || !display->initialize()) {
-        Logger::error("Failed to initialize display system");
-        return 1;
-    }
-    
-    // Open display
-    if (!display->openDisplay(display_id)) {
-        Logger::error("Failed to open display " + std::to_string(display_id));
+        Logger::error(log_prefix + "Failed to connect to stream: " + stream_name);
         return 1;
     }
     
-    auto disp_info = display->getCurrentDisplay();
-    Logger::info("Displaying on " + disp_info.connector + 
-                " (" + std::to_string(disp_info.width) + "x" + 
-                std::to_string(disp_info.height) + ")");
-    
     // Initialize audio output
     auto audio = createAudioOutput();
     AudioProcessor audio_processor;
@@ -271,14 +308,14 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
     if (audio && audio->initialize()) {
         if (audio->openDevice(display_id)) {
             audio_initialized = true;
-            Logger::info("Audio output initialized for display " + 
+            Logger::info(log_prefix + "Audio output initialized for display " + 
                         std::to_string(display_id));
         } else {
-            Logger::warning("Failed to open audio device for display " + 
+            Logger::warning(log_prefix + "Failed to open audio device for display " + 
                           std::to_string(display_id) + ", continuing without audio");
         }
     } else {
-        Logger::warning("Failed to initialize audio system, continuing without audio");
+        Logger::warning(log_prefix + "Failed to initialize audio system, continuing without audio");
     }
     
     // Status reporter
@@ -292,10 +329,11 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
     int audio_channels = 0;
     int audio_sample_rate = 0;
     int status_counter = 0;
+    LatencyHistogram latency[kLatencyStageCount];
     auto start_time = std::chrono::steady_clock::now();
     auto last_status_update = start_time;
     
-    Logger::info("Starting receive loop... Press Ctrl+C to stop");
+    Logger::info(log_prefix + "Starting receive loop... Press Ctrl+C to stop");
     
     // Main receive loop - single threaded for low latency
     while (!g_shutdown.load(std::memory_order_acquire)) {
@@ -306,7 +344,7 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
         // Capture with 100ms timeout
         auto recv_instance = receiver.getRecvInstance();
         if (!recv_instance) {
-            Logger::error("Receiver instance lost");
+            Logger::error(log_prefix + "Receiver instance lost");
             break;
         }
         
@@ -321,8 +359,15 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
         switch (frame_type) {
             case NDIlib_frame_type_video: {
                 frame_count++;
+                int64_t receive_ns = FrameTiming::realtimeNs();
                 
-                // Display the frame directly - no queuing for lowest latency
+                // Timing from ndi-capture, if the sender attached it
+                FrameTiming timing;
+                bool timed = FrameTiming::fromXml(video_frame.p_metadata, timing);
+                
+                // Display the frame directly - with atomic KMS it goes to the
+                // display's mailbox and scanout takes the newest one, so this
+                // never waits for vblank and NDI frames don't back up
                 // NDI typically provides BGRA/BGRX format when we request it
                 PixelFormat format = PixelFormat::BGRA;
                 
@@ -345,7 +390,7 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
                 // Validate frame data before displaying
                 bool displayed = false;
                 if (video_frame.p_data && video_frame.xres > 0 && video_frame.yres > 0) {
-                    displayed = display->displayFrame(
+                    displayed = display.displayFrame(
                         video_frame.p_data,
                         video_frame.xres,
                         video_frame.yres,
@@ -353,11 +398,19 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
                         video_frame.line_stride_in_bytes
                     );
                 } else {
-                    Logger::warning("Invalid frame data received from NDI");
+                    Logger::warning(log_prefix + "Invalid frame data received from NDI");
                 }
                 
                 if (!displayed) {
                     frames_dropped++;
+                } else if (timed) {
+                    int64_t scanout_ns = display.getLastScanoutNs();
+                    scanout_ns = scanout_ns ? FrameTiming::monotonicToRealtime(scanout_ns)
+                                            : FrameTiming::realtimeNs();
+                    latency[kCaptureToSend].add(timing.send_ns - timing.capture_ns);
+                    latency[kSendToReceive].add(receive_ns - timing.send_ns);
+                    latency[kReceiveToScanout].add(scanout_ns - receive_ns);
+                    latency[kCaptureToScanout].add(scanout_ns - timing.capture_ns);
                 }
                 
                 // Free the frame (using cached instance)
@@ -380,6 +433,7 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
                     // Estimate based on typical NDI compression (about 2-3 bits per pixel)
                     float bitrate_mbps = (pixels_per_sec * 2.5f) / 1000000.0f;
                     
+                    status.setDisplayStats(display.getStats());
                     status.update(stream_name, 
                                 video_frame.xres, video_frame.yres,
                                 fps, bitrate_mbps,
@@ -391,8 +445,23 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
                     
                     // Log every 10 seconds
                     if (++status_counter >= 10) {
-                        Logger::info("Frames: " + std::to_string(frame_count) + 
-                                   " (" + std::to_string(fps) + " fps)");
+                        DisplayStats flips = display.getStats();
+                        Logger::info(log_prefix + "Frames: " + std::to_string(frame_count) + 
+                                   " (" + std::to_string(fps) + " fps), flips: " +
+                                   std::to_string(flips.frames_late) + " late, " +
+                                   std::to_string(flips.frames_skipped) + " skipped, " +
+                                   std::to_string(flips.frames_torn) + " torn");
+                        
+                        // Latency over the window, then start a new one
+                        for (int s = 0; s < kLatencyStageCount; s++) {
+                            if (latency[s].count() == 0 && latency[s].negativeCount() == 0) {
+                                continue;
+                            }
+                            Logger::info(log_prefix + std::string("Latency ") + kLatencyStageNames[s] +
+                                       ": " + latency[s].summary());
+                            status.setLatency(kLatencyStageKeys[s], latency[s]);
+                            latency[s].reset();
+                        }
                         status_counter = 0;
                     }
                 }
@@ -426,7 +495,7 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
                 break;
                 
             case NDIlib_frame_type_error:
-                Logger::error("NDI receive error");
+                Logger::error(log_prefix + "NDI receive error");
                 frames_dropped++;
                 break;
                 
@@ -442,30 +511,148 @@ int receiveAndDisplay(const std::string& stream_name, int display_id) {
     
     // Clean shutdown
     if (g_shutdown.load(std::memory_order_acquire)) {
-        Logger::info("Shutdown requested...");
+        Logger::info(log_prefix + "Shutdown requested...");
     }
-    Logger::info("Shutting down...");
+    Logger::info(log_prefix + "Shutting down...");
     
     // Clear display before closing
-    display->clearDisplay();
+    display.clearDisplay();
     
     // Close audio if initialized
     if (audio_initialized && audio) {
         audio->closeDevice();
     }
     
-    // Destructors will handle cleanup
+    // The caller's destructors handle the rest
     // display destructor calls shutdown()
     // audio destructor calls shutdown()
     // receiver destructor calls disconnect() and shutdown()
     // status destructor removes status file
     
-    Logger::info("Total frames: " + std::to_string(frame_count) + 
+    Logger::info(log_prefix + "Total frames: " + std::to_string(frame_count) + 
                ", dropped: " + std::to_string(frames_dropped));
     
     return 0;
 }
 
+int receiveAndDisplay(const std::string& stream_name, int display_id) {
+    if (consoleActive(display_id)) {
+        return 1;
+    }
+    
+    // Initialize receiver
+    NDIReceiver receiver;
+    if (!receiver.initialize()) {
+        Logger::error("Failed to initialize NDI");
+        return 1;
+    }
+    
+    // Initialize display
+    auto display = createDisplayOutput();
+    if (!display || !display->initialize()) {
+        Logger::error("Failed to initialize display system");
+        return 1;
+    }
+    
+    // Open display
+    if (!display->openDisplay(display_id)) {
+        Logger::error("Failed to open display " + std::to_string(display_id));
+        return 1;
+    }
+    
+    auto disp_info = display->getCurrentDisplay();
+    Logger::info("Displaying on " + disp_info.connector + 
+                " (" + std::to_string(disp_info.width) + "x" + 
+                std::to_string(disp_info.height) + ")");
+    
+    return runDisplayHead(stream_name, display_id, receiver, *display);
+}
+
+// Multi-head: one process drives several displays. The DRM device (master,
+// resources, flip events) and NDI discovery are set up once and shared;
+// each display gets its own receive/present thread on its own core.
+int receiveMultiHead(const std::vector<std::pair<int, std::string>>& heads) {
+    for (const auto& head : heads) {
+        if (consoleActive(head.first)) {
+            return 1;
+        }
+    }
+    
+    // One finder for every head
+    NDIReceiver discovery;
+    if (!discovery.initialize()) {
+        Logger::error("Failed to initialize NDI");
+        return 1;
+    }
+    
+    // Outputs after the first share its DRM device
+    std::vector<std::unique_ptr<DisplayOutput>> displays;
+    for (const auto& head : heads) {
+        auto display = displays.empty() ? createDisplayOutput() : displays[0]->createSibling();
+        if (!display || !display->initialize()) {
+            Logger::error("Failed to initialize display system");
+            return 1;
+        }
+        if (!display->openDisplay(head.first)) {
+            Logger::error("Failed to open display " + std::to_string(head.first));
+            return 1;
+        }
+        auto disp_info = display->getCurrentDisplay();
+        Logger::info("Display " + std::to_string(head.first) + " on " + disp_info.connector +
+                    " (" + std::to_string(disp_info.width) + "x" +
+                    std::to_string(disp_info.height) + ")");
+        displays.push_back(std::move(display));
+    }
+    
+    // Discover once up front so every head finds its source straight away
+    discovery.findSources(2000);
+    
+    std::vector<std::unique_ptr<NDIReceiver>> receivers;
+    std::vector<int> results(heads.size(), 0);
+    std::vector<std::thread> threads;
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+    
+    for (size_t i = 0; i < heads.size(); i++) {
+        receivers.push_back(std::make_unique<NDIReceiver>());
+        NDIReceiver& receiver = *receivers.back();
+        receiver.shareFinder(&discovery);
+        if (!receiver.initialize()) {
+            Logger::error("Failed to initialize NDI");
+            g_shutdown.store(true, std::memory_order_release);
+            break;
+        }
+        
+        const int display_id = heads[i].first;
+        const std::string prefix = "[display " + std::to_string(display_id) + "] ";
+        DisplayOutput* display = displays[i].get();
+        int* result = &results[i];
+        const std::string& stream_name = heads[i].second;
+        threads.emplace_back([&receiver, display, result, &stream_name, display_id, prefix]() {
+            *result = runDisplayHead(stream_name, display_id, receiver, *display, prefix);
+        });
+        
+        // Core 0 is left to NDI's own threads while there are spare cores
+        int core = static_cast<int>(cores > static_cast<int>(heads.size()) ? i + 1 : i) % cores;
+        if (!PipelineThreadPool::setThreadAffinity(threads.back(), core)) {
+            Logger::warning(prefix + "Failed to pin to core " + std::to_string(core));
+        }
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    // Receivers before the finder they share; displays (and the device) last
+    receivers.clear();
+    discovery.shutdown();
+    
+    int result = 0;
+    for (int r : results) {
+        result = std::max(result, r);
+    }
+    return threads.size() == heads.size() ? result : 1;
+}
+
 int main(int argc, char* argv[]) {
     // Set up signal handlers
     std::signal(SIGINT, signalHandler);
@@ -494,6 +681,37 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Multi-head: multi <id>=<stream> ...
+    if (command == "multi") {
+        std::vector<std::pair<int, std::string>> heads;
+        for (int i = 2; i < argc; i++) {
+            std::string arg = argv[i];
+            size_t eq = arg.find('=');
+            int display_id = -1;
+            try {
+                display_id = eq == std::string::npos ? -1 : std::stoi(arg.substr(0, eq));
+            } catch (...) {
+            }
+            if (display_id < 0 || display_id > 2 || eq + 1 >= arg.size()) {
+                std::cerr << "Error: Expected <display_id>=<stream_name> with display 0, 1 or 2: "
+                          << arg << "\n";
+                return 1;
+            }
+            for (const auto& head : heads) {
+                if (head.first == display_id) {
+                    std::cerr << "Error: Display " << display_id << " given twice\n";
+                    return 1;
+                }
+            }
+            heads.emplace_back(display_id, arg.substr(eq + 1));
+        }
+        if (heads.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return receiveMultiHead(heads);
+    }
+    
     // Main operation: receive and display
     if (argc == 3) {
         std::string stream_name = argv[1];
@@ -74,6 +74,12 @@ void NDIReceiver::shutdown() {
 }
 
 std::vector<NDISource> NDIReceiver::findSources(int timeout_ms) {
+    NDIReceiver& owner = finderOwner();
+    std::lock_guard<std::mutex> lock(owner.find_mutex_);
+    return owner.findSourcesLocked(timeout_ms);
+}
+
+std::vector<NDISource> NDIReceiver::findSourcesLocked(int timeout_ms) {
     std::vector<NDISource> sources;
     
     if (!initialized_) {
@@ -147,20 +153,29 @@ bool NDIReceiver::connect(const std::string& source_name) {
         disconnect();
     }
     
-    // Find sources (this updates the finder)
-    findSources(2000);
-    
-    // Get current sources
-    uint32_t num_sources = 0;
-    const NDIlib_source_t* p_sources = NDIlib_find_get_current_sources(find_instance_, &num_sources);
+    // The source list stays valid until the finder's next call, so hold
+    // it until the receiver has copied the source
+    NDIReceiver& finder = finderOwner();
+    std::lock_guard<std::mutex> lock(finder.find_mutex_);
     
-    // Find the matching source
-    const NDIlib_source_t* target_source = nullptr;
-    for (uint32_t i = 0; i < num_sources; i++) {
-        if (p_sources[i].p_ndi_name && std::string(p_sources[i].p_ndi_name) == source_name) {
-            target_source = &p_sources[i];
-            break;
+    auto lookup = [&finder, &source_name]() -> const NDIlib_source_t* {
+        uint32_t num_sources = 0;
+        const NDIlib_source_t* p_sources = finder.find_instance_ ?
+            NDIlib_find_get_current_sources(finder.find_instance_, &num_sources) : nullptr;
+        for (uint32_t i = 0; i < num_sources; i++) {
+            if (p_sources[i].p_ndi_name && std::string(p_sources[i].p_ndi_name) == source_name) {
+                return &p_sources[i];
+            }
         }
+        return nullptr;
+    };
+    
+    // A shared finder may already know the source; otherwise wait for
+    // discovery (this updates the finder)
+    const NDIlib_source_t* target_source = lookup();
+    if (!target_source) {
+        finder.findSourcesLocked(2000);
+        target_source = lookup();
     }
     
     if (!target_source) {
@@ -174,7 +189,8 @@ bool NDIReceiver::connect(const std::string& source_name) {
     recv_create.p_ndi_recv_name = "NDI Display Receiver";
     recv_create.bandwidth = NDIlib_recv_bandwidth_highest;
     recv_create.allow_video_fields = false;
-    recv_create.color_format = NDIlib_recv_color_format_BGRX_BGRA;
+    recv_create.color_format = prefer_uyvy_ ? NDIlib_recv_color_format_UYVY_BGRA
+                                            : NDIlib_recv_color_format_BGRX_BGRA;
     
     recv_instance_ = NDIlib_recv_create_v3(&recv_create);
     if (!recv_instance_) {
@@ -185,7 +201,8 @@ bool NDIReceiver::connect(const std::string& source_name) {
     current_source_name_ = source_name;
     connected_ = true;
     
-    Logger::info("Connected to NDI source: " + source_name);
+    Logger::info("Connected to NDI source: " + source_name +
+                (prefer_uyvy_ ? " (UYVY)" : " (BGRA)"));
     return true;
 }
 
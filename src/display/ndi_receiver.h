@@ -4,6 +4,7 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <mutex>
 #include <Processing.NDI.Lib.h>
 
 namespace ndi_bridge {
@@ -34,6 +35,15 @@ public:
     // Find available NDI sources on the network
     std::vector<NDISource> findSources(int timeout_ms = 5000);
     
+    // Look sources up with another receiver's finder instead of creating
+    // one (multi-head: one NDI discovery for all displays). The finder's
+    // receiver must be initialized and outlive this one.
+    void shareFinder(NDIReceiver* finder) { finder_owner_ = finder; }
+    
+    // Receive UYVY (BGRA only for sources with alpha) instead of
+    // BGRX/BGRA; takes effect on the next connect
+    void setPreferUYVY(bool prefer) { prefer_uyvy_ = prefer; }
+    
     // Connect to an NDI source
     bool connect(const NDISource& source);
     bool connect(const std::string& source_name);
@@ -52,11 +62,18 @@ public:
     NDIlib_recv_instance_t getRecvInstance() const { return recv_instance_; }
     
 private:
+    // Caller holds find_mutex_ of the receiver owning the finder
+    std::vector<NDISource> findSourcesLocked(int timeout_ms);
+    NDIReceiver& finderOwner() { return finder_owner_ ? *finder_owner_ : *this; }
+    
     NDIlib_find_instance_t find_instance_ = nullptr;
+    NDIReceiver* finder_owner_ = nullptr;
+    std::mutex find_mutex_;             // Finder source lists are valid until its next call
     NDIlib_recv_instance_t recv_instance_ = nullptr;
     
     bool initialized_ = false;
     bool connected_ = false;
+    bool prefer_uyvy_ = false;
     
     std::string current_source_name_;
 };
@@ -5,7 +5,10 @@
 #include <iomanip>
 #include <chrono>
 #include <filesystem>
+#include <map>
 #include <unistd.h>
+#include "display_output.h"
+#include "../common/latency_histogram.h"
 
 namespace ndi_bridge {
 namespace display {
@@ -67,6 +70,10 @@ public:
         f << std::fixed << std::setprecision(1) << "BITRATE=" << bitrate_mbps << "\n";
         f << "FRAMES_RECEIVED=" << frames_received << "\n";
         f << "FRAMES_DROPPED=" << frames_dropped << "\n";
+        f << "FRAMES_FLIPPED=" << display_stats_.frames_flipped << "\n";
+        f << "FRAMES_LATE=" << display_stats_.frames_late << "\n";
+        f << "FRAMES_SKIPPED=" << display_stats_.frames_skipped << "\n";
+        f << "FRAMES_TORN=" << display_stats_.frames_torn << "\n";
         
         // Audio metrics
         if (audio_channels > 0) {
@@ -75,6 +82,18 @@ public:
             f << "AUDIO_FRAMES=" << audio_frames << "\n";
         }
         
+        // Latency of the last completed window, per stage
+        for (const auto& entry : latency_) {
+            const std::string key = "LATENCY_" + entry.first;
+            const LatencyHistogram& h = entry.second;
+            f << std::fixed << std::setprecision(1)
+              << key << "_P50=" << h.percentileMs(50) << "\n"
+              << key << "_P95=" << h.percentileMs(95) << "\n"
+              << key << "_P99=" << h.percentileMs(99) << "\n"
+              << key << "_MAX=" << h.maxMs() << "\n"
+              << key << "_SAMPLES=" << h.count() << "\n";
+        }
+        
         char time_buf[100];
         std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%dT%H:%M:%S", 
                      std::localtime(&time_t));
@@ -90,6 +109,16 @@ public:
         }
     }
     
+    // Presentation counters written by later updates
+    void setDisplayStats(const DisplayStats& stats) {
+        display_stats_ = stats;
+    }
+    
+    // Latency stage (e.g. "CAPTURE_TO_SCANOUT") written by later updates
+    void setLatency(const std::string& stage, const LatencyHistogram& histogram) {
+        latency_[stage] = histogram;
+    }
+    
     void clear() {
         try {
             std::filesystem::remove(status_file_);
@@ -104,6 +133,8 @@ private:
     std::string status_dir_;
     std::string status_file_;
     std::string temp_file_;
+    std::map<std::string, LatencyHistogram> latency_;
+    DisplayStats display_stats_;
 };
 
 } // namespace display
@@ -0,0 +1,442 @@
+// alsa_audio_capture.cpp
+#include "alsa_audio_capture.h"
+#include "../../common/logger.h"
+#include "../v4l2/v4l2_hotplug_monitor.h"
+#include <dirent.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+namespace ndi_bridge {
+namespace alsa {
+
+namespace {
+
+// Below the V4L2 capture thread (90): a late audio period costs less than a late frame
+constexpr int kAudioRealtimePriority = 80;
+
+// snd_pcm_wait() timeout so stop() is noticed without a wakeup
+constexpr int kWaitTimeoutMs = 100;
+
+// Same normalisation as HotplugMonitor::resolveBusPath: /sys stripped,
+// USB interface (1-2:1.3) folded into its device (1-2)
+std::string soundCardBusPath(const std::string& card) {
+    std::string link = "/sys/class/sound/" + card + "/device";
+    char resolved[PATH_MAX];
+    if (!realpath(link.c_str(), resolved)) {
+        return "";
+    }
+
+    std::string path(resolved);
+    size_t last = path.find_last_of('/');
+    if (last != std::string::npos && path.find(':', last) != std::string::npos &&
+        path.find("/usb", 0) != std::string::npos) {
+        path = path.substr(0, last);
+    }
+    if (path.compare(0, 4, "/sys") == 0) {
+        path = path.substr(4);
+    }
+    return path;
+}
+
+// Lowest capture PCM device of a card (/proc/asound/cardN/pcmXc), -1 if none
+int firstCapturePcm(int card) {
+    std::string dir_path = "/proc/asound/card" + std::to_string(card);
+    DIR* dir = opendir(dir_path.c_str());
+    if (!dir) {
+        return -1;
+    }
+
+    int best = -1;
+    while (struct dirent* entry = readdir(dir)) {
+        int device = -1;
+        char kind = 0;
+        if (sscanf(entry->d_name, "pcm%d%c", &device, &kind) == 2 && kind == 'c' &&
+            (best < 0 || device < best)) {
+            best = device;
+        }
+    }
+    closedir(dir);
+    return best;
+}
+
+int64_t timespecToNs(const snd_htimestamp_t& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // anonymous namespace
+
+AlsaAudioCapture::AlsaAudioCapture()
+    : AlsaAudioCapture(Config()) {
+}
+
+AlsaAudioCapture::AlsaAudioCapture(const Config& config)
+    : config_(config) {
+}
+
+AlsaAudioCapture::~AlsaAudioCapture() {
+    stop();
+}
+
+std::string AlsaAudioCapture::findDeviceForVideo(const std::string& video_device) {
+    std::string video_bus = v4l2::HotplugMonitor::resolveBusPath(video_device);
+    if (video_bus.empty()) {
+        return "";
+    }
+
+    DIR* dir = opendir("/sys/class/sound");
+    if (!dir) {
+        return "";
+    }
+
+    std::vector<int> cards;
+    while (struct dirent* entry = readdir(dir)) {
+        int card = -1;
+        char extra = 0;
+        if (sscanf(entry->d_name, "card%d%c", &card, &extra) == 1 &&
+            soundCardBusPath(entry->d_name) == video_bus) {
+            cards.push_back(card);
+        }
+    }
+    closedir(dir);
+
+    std::sort(cards.begin(), cards.end());
+    for (int card : cards) {
+        int device = firstCapturePcm(card);
+        if (device >= 0) {
+            return "hw:" + std::to_string(card) + "," + std::to_string(device);
+        }
+    }
+    return "";
+}
+
+bool AlsaAudioCapture::start(const std::string& video_device) {
+    if (running_) {
+        return true;
+    }
+    stop();     // Reap a capture thread that ended on an error
+
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_.clear();
+    }
+
+    if (config_.device == "auto") {
+        pcm_name_ = findDeviceForVideo(video_device);
+        if (pcm_name_.empty()) {
+            setError("No ALSA capture device on the bus of " + video_device);
+            return false;
+        }
+    } else {
+        pcm_name_ = config_.device;
+    }
+
+    if (!openDevice()) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_ = Stats();
+    }
+
+    should_stop_ = false;
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&AlsaAudioCapture::captureThread, this);
+
+    Logger::info("AlsaAudioCapture: Capturing " + pcm_name_ + " for " + video_device + ", " +
+                 std::to_string(channels_) + " ch @ " + std::to_string(sample_rate_) + " Hz, period " +
+                 std::to_string(config_.period_frames) + " frames (mmap)");
+    return true;
+}
+
+void AlsaAudioCapture::stop() {
+    if (!thread_) {
+        return;
+    }
+
+    should_stop_ = true;
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+    running_ = false;
+
+    Stats stats = getStats();
+    Logger::info("AlsaAudioCapture: Stopped " + pcm_name_ + " after " +
+                 std::to_string(stats.frames_captured) + " frames, " +
+                 std::to_string(stats.overruns) + " overruns");
+    closeDevice();
+}
+
+void AlsaAudioCapture::setAudioCallback(AudioCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    callback_ = std::move(callback);
+}
+
+void AlsaAudioCapture::setErrorCallback(ErrorCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    error_callback_ = std::move(callback);
+}
+
+std::string AlsaAudioCapture::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+AlsaAudioCapture::Stats AlsaAudioCapture::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+bool AlsaAudioCapture::openDevice() {
+    int err = snd_pcm_open(&pcm_, pcm_name_.c_str(), SND_PCM_STREAM_CAPTURE, 0);
+    if (err < 0) {
+        pcm_ = nullptr;
+        setError("Cannot open " + pcm_name_ + ": " + snd_strerror(err));
+        return false;
+    }
+
+    if (!configureHardware() || !configureSoftware()) {
+        closeDevice();
+        return false;
+    }
+
+    err = snd_pcm_start(pcm_);
+    if (err < 0) {
+        setError("Cannot start " + pcm_name_ + ": " + snd_strerror(err));
+        closeDevice();
+        return false;
+    }
+    return true;
+}
+
+bool AlsaAudioCapture::configureHardware() {
+    snd_pcm_hw_params_t* hw_params;
+    snd_pcm_hw_params_alloca(&hw_params);
+
+    int err = snd_pcm_hw_params_any(pcm_, hw_params);
+    if (err < 0) {
+        setError("Cannot read hw params: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    // Read in place from the ring buffer instead of copying through snd_pcm_readi
+    err = snd_pcm_hw_params_set_access(pcm_, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED);
+    if (err < 0) {
+        setError(pcm_name_ + " does not support mmap access: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    err = snd_pcm_hw_params_set_format(pcm_, hw_params, SND_PCM_FORMAT_S16_LE);
+    if (err < 0) {
+        setError(pcm_name_ + " does not support S16_LE: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    channels_ = config_.channels;
+    err = snd_pcm_hw_params_set_channels_near(pcm_, hw_params, &channels_);
+    if (err < 0) {
+        setError("Cannot set channels: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    sample_rate_ = config_.sample_rate;
+    err = snd_pcm_hw_params_set_rate_near(pcm_, hw_params, &sample_rate_, nullptr);
+    if (err < 0) {
+        setError("Cannot set sample rate: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    snd_pcm_uframes_t period = config_.period_frames;
+    err = snd_pcm_hw_params_set_period_size_near(pcm_, hw_params, &period, nullptr);
+    if (err < 0) {
+        setError("Cannot set period size: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    snd_pcm_uframes_t buffer = period * config_.periods;
+    err = snd_pcm_hw_params_set_buffer_size_near(pcm_, hw_params, &buffer);
+    if (err < 0) {
+        setError("Cannot set buffer size: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    err = snd_pcm_hw_params(pcm_, hw_params);
+    if (err < 0) {
+        setError("Cannot apply hw params: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    config_.period_frames = static_cast<unsigned int>(period);
+    if (sample_rate_ != config_.sample_rate || channels_ != config_.channels) {
+        Logger::info("AlsaAudioCapture: " + pcm_name_ + " runs at " + std::to_string(channels_) +
+                    " ch @ " + std::to_string(sample_rate_) + " Hz");
+    }
+    return true;
+}
+
+bool AlsaAudioCapture::configureSoftware() {
+    snd_pcm_sw_params_t* sw_params;
+    snd_pcm_sw_params_alloca(&sw_params);
+
+    int err = snd_pcm_sw_params_current(pcm_, sw_params);
+    if (err < 0) {
+        setError("Cannot read sw params: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    // Wake up once per period; timestamps on the same clock as V4L2 buffers
+    snd_pcm_sw_params_set_avail_min(pcm_, sw_params, config_.period_frames);
+    snd_pcm_sw_params_set_tstamp_mode(pcm_, sw_params, SND_PCM_TSTAMP_ENABLE);
+    err = snd_pcm_sw_params_set_tstamp_type(pcm_, sw_params, SND_PCM_TSTAMP_TYPE_MONOTONIC);
+    if (err < 0) {
+        setError("Cannot use monotonic timestamps: " + std::string(snd_strerror(err)));
+        return false;
+    }
+
+    err = snd_pcm_sw_params(pcm_, sw_params);
+    if (err < 0) {
+        setError("Cannot apply sw params: " + std::string(snd_strerror(err)));
+        return false;
+    }
+    return true;
+}
+
+void AlsaAudioCapture::closeDevice() {
+    if (pcm_) {
+        snd_pcm_drop(pcm_);
+        snd_pcm_close(pcm_);
+        pcm_ = nullptr;
+    }
+}
+
+bool AlsaAudioCapture::recover(int err) {
+    if (err == -EPIPE) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.overruns++;
+    }
+
+    err = snd_pcm_recover(pcm_, err, 1);
+    if (err < 0) {
+        setError("Cannot recover " + pcm_name_ + ": " + std::string(snd_strerror(err)));
+        return false;
+    }
+    err = snd_pcm_start(pcm_);
+    return err >= 0 || err == -EBADFD;
+}
+
+void AlsaAudioCapture::captureThread() {
+    struct sched_param param;
+    param.sched_priority = kAudioRealtimePriority;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        Logger::debug("AlsaAudioCapture: SCHED_FIFO not available, running at normal priority");
+    }
+
+    while (!should_stop_) {
+        int ready = snd_pcm_wait(pcm_, kWaitTimeoutMs);
+        if (ready == 0) {
+            continue;
+        }
+        if (ready < 0) {
+            if (!recover(ready)) {
+                break;
+            }
+            continue;
+        }
+
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm_);
+        if (avail < 0) {
+            if (!recover(static_cast<int>(avail))) {
+                break;
+            }
+            continue;
+        }
+
+        // The newest frame was captured at ts; ts_avail frames were waiting then
+        snd_pcm_uframes_t ts_avail = 0;
+        snd_htimestamp_t ts;
+        int64_t first_ns = 0;
+        if (snd_pcm_htimestamp(pcm_, &ts_avail, &ts) == 0 && (ts.tv_sec != 0 || ts.tv_nsec != 0)) {
+            first_ns = timespecToNs(ts) - static_cast<int64_t>(ts_avail) * 1000000000LL / sample_rate_;
+        } else {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            first_ns = static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec -
+                       static_cast<int64_t>(avail) * 1000000000LL / sample_rate_;
+        }
+
+        // Drain what is there; the ring may wrap, giving two contiguous chunks
+        snd_pcm_uframes_t remaining = static_cast<snd_pcm_uframes_t>(avail);
+        bool failed = false;
+        while (remaining > 0) {
+            const snd_pcm_channel_area_t* areas = nullptr;
+            snd_pcm_uframes_t offset = 0;
+            snd_pcm_uframes_t frames = remaining;
+            int err = snd_pcm_mmap_begin(pcm_, &areas, &offset, &frames);
+            if (err < 0 || frames == 0) {
+                failed = err < 0 && !recover(err);
+                break;
+            }
+
+            // Interleaved: one area layout for all channels, step = frame size in bits
+            const int16_t* samples = reinterpret_cast<const int16_t*>(
+                static_cast<const uint8_t*>(areas[0].addr) + areas[0].first / 8 + offset * (areas[0].step / 8));
+
+            {
+                std::lock_guard<std::mutex> lock(callback_mutex_);
+                if (callback_) {
+                    callback_(samples, static_cast<int>(channels_), static_cast<int>(frames),
+                              static_cast<int>(sample_rate_), first_ns);
+                }
+            }
+
+            snd_pcm_sframes_t committed = snd_pcm_mmap_commit(pcm_, offset, frames);
+            if (committed < 0 || static_cast<snd_pcm_uframes_t>(committed) != frames) {
+                failed = !recover(committed < 0 ? static_cast<int>(committed) : -EPIPE);
+                break;
+            }
+
+            first_ns += static_cast<int64_t>(frames) * 1000000000LL / sample_rate_;
+            remaining -= frames;
+
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.frames_captured += frames;
+            stats_.chunks++;
+        }
+        if (failed) {
+            break;
+        }
+    }
+
+    if (should_stop_) {
+        return;
+    }
+
+    // Unrecoverable: the error is set, tell the owner
+    running_ = false;
+    ErrorCallback error_callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        error_callback = error_callback_;
+    }
+    if (error_callback) {
+        error_callback(getLastError());
+    }
+}
+
+void AlsaAudioCapture::setError(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        last_error_ = error;
+    }
+    Logger::warning("AlsaAudioCapture: " + error);
+}
+
+} // namespace alsa
+} // namespace ndi_bridge
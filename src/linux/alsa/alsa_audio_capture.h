@@ -0,0 +1,135 @@
+// alsa_audio_capture.h
+#pragma once
+
+#include <alsa/asoundlib.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ndi_bridge {
+namespace alsa {
+
+/**
+ * @brief Captures the embedded HDMI audio of a capture stick through ALSA
+ *
+ * HDMI-USB sticks expose a USB audio interface next to the video one. With
+ * device "auto" the ALSA card on the same USB device (same sysfs bus path)
+ * as the V4L2 node is used, so the pairing survives renumbering of both
+ * /dev/videoN and the ALSA card index.
+ *
+ * The PCM is opened in MMAP_INTERLEAVED access and read in place; the
+ * callback gets a pointer into the ring buffer and must consume it before
+ * returning. Timestamps come from snd_pcm_htimestamp() on CLOCK_MONOTONIC,
+ * the same clock as the V4L2 buffer timestamps, so audio and video
+ * timecodes line up without a separate drift correction.
+ *
+ * If the PCM cannot be recovered (xrun recovery fails, device unplugged)
+ * the capture thread ends, isRunning() turns false and the error callback
+ * is called from that thread; start() can then be called again.
+ *
+ * Version: 1.1.0
+ */
+class AlsaAudioCapture {
+public:
+    struct Config {
+        std::string device = "auto";        // "auto" or an ALSA PCM name ("hw:2,0")
+        unsigned int sample_rate = 48000;
+        unsigned int channels = 2;
+        unsigned int period_frames = 240;   // 5 ms at 48 kHz
+        unsigned int periods = 4;
+    };
+
+    struct Stats {
+        uint64_t frames_captured = 0;
+        uint64_t chunks = 0;
+        uint64_t overruns = 0;
+    };
+
+    /**
+     * @brief Called with interleaved S16 samples straight from the mmap area
+     * @param samples Interleaved samples (channels * frames)
+     * @param channels Channel count
+     * @param frames Sample frames
+     * @param sample_rate Sample rate in Hz
+     * @param timestamp_ns CLOCK_MONOTONIC capture time of the first frame
+     */
+    using AudioCallback = std::function<void(const int16_t* samples, int channels, int frames,
+                                             int sample_rate, int64_t timestamp_ns)>;
+
+    using ErrorCallback = std::function<void(const std::string& error)>;
+
+    AlsaAudioCapture();
+    explicit AlsaAudioCapture(const Config& config);
+    ~AlsaAudioCapture();
+
+    AlsaAudioCapture(const AlsaAudioCapture&) = delete;
+    AlsaAudioCapture& operator=(const AlsaAudioCapture&) = delete;
+
+    /**
+     * @brief Open the PCM and start the capture thread
+     * @param video_device V4L2 node used to resolve device "auto"
+     * @return false if no device was found or it could not be configured
+     */
+    bool start(const std::string& video_device);
+
+    void stop();
+
+    bool isRunning() const { return running_; }
+
+    void setAudioCallback(AudioCallback callback);
+
+    /**
+     * @brief Called on the capture thread when capture stops on an error
+     *
+     * Must not call stop() or start(); hand the restart to another thread.
+     */
+    void setErrorCallback(ErrorCallback callback);
+
+    std::string getDeviceName() const { return pcm_name_; }
+
+    std::string getLastError() const;
+
+    Stats getStats() const;
+
+    /**
+     * @brief ALSA capture PCM on the same bus device as a V4L2 node
+     * @return "hw:CARD,DEV", empty if none
+     */
+    static std::string findDeviceForVideo(const std::string& video_device);
+
+private:
+    bool openDevice();
+    bool configureHardware();
+    bool configureSoftware();
+    void closeDevice();
+    void captureThread();
+    bool recover(int err);
+    void setError(const std::string& error);
+
+    Config config_;
+    std::string pcm_name_;
+    snd_pcm_t* pcm_ = nullptr;
+    unsigned int sample_rate_ = 0;
+    unsigned int channels_ = 0;
+
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> should_stop_{false};
+
+    std::mutex callback_mutex_;
+    AudioCallback callback_;
+    ErrorCallback error_callback_;
+
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+};
+
+} // namespace alsa
+} // namespace ndi_bridge
@@ -2,6 +2,7 @@
 #include "v4l2_capture.h"
 #include "../../common/logger.h"
 #include "../../common/version.h"
+#include "../../common/frame_timing.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
@@ -12,34 +13,36 @@
 #include <chrono>
 #include <poll.h>
 #include <algorithm>
+#include <numeric>
 #include <sched.h>
 #include <pthread.h>
 #include <sys/poll.h>
+#include <time.h>
+#include <linux/udmabuf.h>
+#include <linux/dma-buf.h>
+#include <sys/eventfd.h>
 
 namespace ndi_bridge {
 namespace v4l2 {
 
-// Format priority for NDI optimization
-const std::vector<uint32_t> V4L2Capture::kFormatPriority = {
-    V4L2_PIX_FMT_UYVY,    // NDI native - best
-    V4L2_PIX_FMT_YUYV,    // Simple byte swap to UYVY
-    V4L2_PIX_FMT_NV12,    // Requires conversion
-    V4L2_PIX_FMT_MJPEG    // Avoid - needs decompression
-};
+namespace {
 
-V4L2Capture::V4L2Capture() 
-    : fd_(-1)
+// Settings findBestFormat ranks with; a cached mode chosen under others is
+// not reused
+std::string selectionSettings(const CaptureProfile& profile) {
+    return std::string(formatPolicyToString(profile.format_policy)) + (profile.prefer_10bit ? " 10bit" : "");
+}
+
+} // anonymous namespace
+
+V4L2Capture::V4L2Capture(const CaptureProfile& profile) 
+    : profile_(profile)
+    , fd_(-1)
     , buffer_type_(V4L2_MEMORY_MMAP)
     , dmabuf_supported_(false)
     , capturing_(false)
     , should_stop_(false)
     , has_error_(false)
-    , use_multi_threading_(kUseMultiThreading)     // ALWAYS single thread
-    , zero_copy_mode_(kZeroCopyMode)               // ALWAYS zero copy
-    , realtime_scheduling_(true)                     // ALWAYS try RT
-    , realtime_priority_(kRealtimePriority)         // ALWAYS high priority
-    , low_latency_mode_(true)                        // ALWAYS low latency
-    , ultra_low_latency_mode_(true)                  // ALWAYS ultra low
     , frames_captured_(0)
     , frames_dropped_(0)
     , zero_copy_frames_(0)
@@ -47,8 +50,12 @@ V4L2Capture::V4L2Capture()
     , zero_copy_logged_(false) {
     
     Logger::info("V4L2 Optimized Low Latency Capture (v" NDI_BRIDGE_VERSION ")");
-    Logger::info("Configuration: " + std::to_string(kBufferCount) + " buffers, zero-copy, single-thread, RT priority " + std::to_string(kRealtimePriority));
-    Logger::info("Optimized for stable 60fps and 8-frame roundtrip latency");
+    Logger::info("Capture profile " + profile_.describe());
+    
+    if (!profile_.format_cache_path.empty()) {
+        format_cache_ = std::make_unique<V4L2FormatCache>(profile_.format_cache_path);
+        format_cache_->load();
+    }
     
     memset(&current_format_, 0, sizeof(current_format_));
     memset(&device_caps_, 0, sizeof(device_caps_));
@@ -101,8 +108,11 @@ bool V4L2Capture::startCapture(const std::string& device_name) {
         auto info = V4L2DeviceEnumerator::getDeviceInfo(device_path);
         device_name_ = info.name;
     } else {
-        // Search by name
-        device_path = V4L2DeviceEnumerator::findDeviceByName(device_name);
+        // Search by name - cached node first, full scan only on a miss
+        device_path = findCachedDeviceByName(device_name);
+        if (device_path.empty()) {
+            device_path = V4L2DeviceEnumerator::findDeviceByName(device_name);
+        }
         if (device_path.empty()) {
             setError("Device not found: " + device_name);
             return false;
@@ -112,15 +122,18 @@ bool V4L2Capture::startCapture(const std::string& device_name) {
     
     Logger::info("V4L2Capture: Starting capture with device: " + device_path);
     
-    // ALWAYS log our EXTREME settings
-    Logger::info("Applying EXTREME PERFORMANCE settings:");
-    Logger::info("  - Buffer count: " + std::to_string(kBufferCount) + " (absolute minimum)");
+    // Log the settings of the active profile
+    Logger::info("Applying capture profile '" + profile_.name + "':");
+    Logger::info("  - Buffer count: " + std::to_string(profile_.buffer_count));
     Logger::info("  - Zero-copy: ENABLED");
-    Logger::info("  - Threading: SINGLE");
-    Logger::info("  - Polling: PURE BUSY-WAIT (100% CPU)");
-    Logger::info("  - Real-time: SCHED_FIFO priority " + std::to_string(kRealtimePriority));
-    Logger::info("  - CPU affinity: core " + std::to_string(kCpuAffinity));
-    
+    Logger::info("  - Threading: " + std::string(profile_.pipelined ? "PIPELINED" : "SINGLE"));
+    Logger::info("  - Pacing: " + std::string(pacingPolicyToString(profile_.pacing)));
+    Logger::info("  - Real-time: SCHED_FIFO priority " + std::to_string(profile_.realtime_priority));
+    Logger::info("  - CPU affinity: " + (profile_.cpu_affinity < 0 ? std::string("none") :
+                                         "core " + std::to_string(profile_.cpu_affinity)));
+    Logger::info("  - Convert threads: " + (profile_.convert_threads == 0 ? std::string("auto") :
+                                            std::to_string(profile_.convert_threads)));
+    configureConvertThreads();
     if (!initializeDevice(device_path)) {
         return false;
     }
@@ -130,25 +143,34 @@ bool V4L2Capture::startCapture(const std::string& device_name) {
         return false;
     }
     
-    if (!findBestFormat()) {
+    enumerated_formats_.clear();
+    if (!applyCachedFormat() && !findBestFormat()) {
         shutdownDevice();
         return false;
     }
+    updateFormatCache();
     
     if (!setupBuffers()) {
         shutdownDevice();
         return false;
     }
     
+    // Resolution switches upstream are handled in place by the capture thread
+    subscribeSourceChange();
+    
     if (!startStreaming()) {
         cleanupBuffers();
         shutdownDevice();
         return false;
     }
+    stream_active_ = true;
     
     // Reset statistics
     stats_.reset();
     
+    // Recording is set up before the first frame, never in the frame path
+    startRecording();
+    
     // Clear any previous errors
     has_error_ = false;
     last_error_.clear();
@@ -157,10 +179,30 @@ bool V4L2Capture::startCapture(const std::string& device_name) {
     should_stop_ = false;
     capturing_ = true;
     
+    // Send stage first so the capture thread can hand off from frame one
+    if (profile_.pipelined && !startPipeline()) {
+        Logger::warning("V4L2Capture: Pipeline unavailable, sending from the capture thread");
+    }
+    
+    // Async send: NDI holds one buffer while the next is captured, so two
+    // buffers would leave the driver with none queued
+    async_release_ = false;
+    if (profile_.async_send) {
+        if (buffers_.size() < 3) {
+            Logger::info("V4L2Capture: Async send needs 3+ buffers, sending synchronously");
+        } else if (release_queue_ || startReleaseQueue()) {
+            async_release_ = true;
+        } else {
+            Logger::warning("V4L2Capture: Async send unavailable, sending synchronously");
+        }
+    }
+    
     Logger::info("V4L2Capture: Starting optimized capture thread");
     capture_thread_ = std::make_unique<std::thread>(&V4L2Capture::captureThreadExtreme, this);
     
-    Logger::info("V4L2Capture: Capture started successfully (optimized for 60fps)");
+    Logger::info("V4L2Capture: Capture started successfully (" +
+                 std::to_string(video_format_.fps_numerator) + "/" +
+                 std::to_string(video_format_.fps_denominator) + " fps)");
     return true;
 }
 
@@ -182,6 +224,13 @@ void V4L2Capture::stopCapture() {
     }
     capture_thread_.reset();
     
+    // Send stage must be idle and the consumer done with every buffer
+    // before the buffers are unmapped
+    stopPipeline();
+    flushConsumer();
+    stopReleaseQueue();
+    stopRecording();
+    
     capturing_ = false;
     
     // Log final statistics
@@ -190,13 +239,28 @@ void V4L2Capture::stopCapture() {
         Logger::info("V4L2Capture: Final stats - Frames: " + std::to_string(stats_.frames_captured) +
                    ", Avg latency: " + std::to_string(avg_latency) + "ms" +
                    ", Dropped: " + std::to_string(stats_.frames_dropped) + 
+                   " (driver " + std::to_string(stats_.driver_dropped) +
+                   ", userspace " + std::to_string(stats_.userspace_dropped) +
+                   ", NDI " + std::to_string(stats_.ndi_dropped) + ")" +
                    ", Zero-copy: " + std::to_string(stats_.zero_copy_frames));
         
+        if (stats_.capture_to_send_samples > 0) {
+            Logger::info("V4L2Capture: Profile '" + profile_.name + "' capture-to-send latency - Avg: " +
+                       std::to_string(stats_.avg_capture_to_send_ms) + "ms" +
+                       ", Max: " + std::to_string(stats_.max_capture_to_send_ms) + "ms");
+        }
+        
         if (stats_.e2e_samples > 0) {
             Logger::info("V4L2Capture: E2E latency - Avg: " + 
                        std::to_string(stats_.avg_e2e_latency_ms) + "ms" +
                        ", Max: " + std::to_string(stats_.max_e2e_latency_ms) + "ms");
         }
+        
+        Logger::info("V4L2Capture: Cadence jitter (interval " +
+                   std::to_string(stats_.frame_interval_us) + "µs) - Avg: " +
+                   std::to_string(stats_.avg_cadence_jitter_us) + "µs" +
+                   ", Max: " + std::to_string(stats_.max_cadence_jitter_us) + "µs" +
+                   ", Late wakeups: " + std::to_string(stats_.late_frame_wakeups));
     }
     
     // Stop streaming
@@ -223,6 +287,11 @@ void V4L2Capture::setErrorCallback(ErrorCallback callback) {
     error_callback_ = callback;
 }
 
+void V4L2Capture::setFlushCallback(FlushCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    flush_callback_ = callback;
+}
+
 bool V4L2Capture::hasError() const {
     return has_error_.load();
 }
@@ -244,14 +313,13 @@ bool V4L2Capture::initializeDevice(const std::string& device_path) {
         return false;
     }
     
-    // Small delay to ensure USB device is fully ready after reconnection
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    
     Logger::info("V4L2Capture: Opened device: " + device_path);
     return true;
 }
 
 void V4L2Capture::shutdownDevice() {
+    source_change_subscribed_ = false;
+    stream_active_ = false;
     if (fd_ >= 0) {
         close(fd_);
         fd_ = -1;
@@ -260,7 +328,7 @@ void V4L2Capture::shutdownDevice() {
 }
 
 bool V4L2Capture::setupBuffers() {
-    // Try DMABUF first for potential zero-copy
+    // Try DMABUF first for true zero-copy (buffers can be imported by DRM, encoders, ...)
     if (trySetupDMABUF()) {
         buffer_type_ = V4L2_MEMORY_DMABUF;
         Logger::info("Using DMABUF for zero-copy operation");
@@ -272,7 +340,7 @@ bool V4L2Capture::setupBuffers() {
     
     v4l2_requestbuffers reqbuf;
     memset(&reqbuf, 0, sizeof(reqbuf));
-    reqbuf.count = kBufferCount;  // ALWAYS 2 buffers (EXTREME minimum)
+    reqbuf.count = profile_.buffer_count;
     reqbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     reqbuf.memory = buffer_type_;
     
@@ -321,13 +389,16 @@ bool V4L2Capture::setupBuffers() {
         }
     }
     
+    // Still hand out dma-buf fds if the driver can export them
+    exportMMAPBuffers();
+    
     Logger::info("V4L2Capture: Setup " + std::to_string(buffers_.size()) + 
                " buffers (optimized for 8-frame latency)");
     return true;
 }
 
 bool V4L2Capture::trySetupDMABUF() {
-    // Check if device supports DMABUF
+    // Check if device supports DMABUF import
     v4l2_requestbuffers req = {};
     req.count = 1;
     req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -344,20 +415,169 @@ bool V4L2Capture::trySetupDMABUF() {
     ioctl(fd_, VIDIOC_REQBUFS, &req);
     
     dmabuf_supported_ = true;
-    Logger::info("Device supports DMABUF (future zero-copy potential)");
     
-    // TODO: Implement full DMABUF support with buffer allocation
-    // For now, return false to use MMAP
-    return false;
+    // We allocate the buffers ourselves from memfd via udmabuf
+    int udmabuf_dev = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+    if (udmabuf_dev < 0) {
+        Logger::info("Device supports DMABUF but /dev/udmabuf is unavailable (" +
+                     std::string(strerror(errno)) + ") - using MMAP with EXPBUF");
+        return false;
+    }
+    
+    // udmabuf requires page-aligned sizes
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t image_size = current_format_.fmt.pix.sizeimage;
+    if (image_size == 0) {
+        image_size = static_cast<size_t>(current_format_.fmt.pix.bytesperline) *
+                     current_format_.fmt.pix.height;
+    }
+    const size_t buffer_size = (image_size + page_size - 1) & ~(page_size - 1);
+    
+    req.count = profile_.buffer_count;
+    req.memory = V4L2_MEMORY_DMABUF;
+    if (ioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+        Logger::warning("DMABUF buffer request failed - using MMAP");
+        close(udmabuf_dev);
+        return false;
+    }
+    
+    buffers_.resize(req.count);
+    
+    bool ok = true;
+    for (unsigned int i = 0; i < req.count && ok; ++i) {
+        int memfd = memfd_create("ndi-capture-buffer", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (memfd < 0) {
+            Logger::warning("memfd_create failed: " + std::string(strerror(errno)));
+            ok = false;
+            break;
+        }
+        
+        // udmabuf refuses memfds that could shrink under it
+        if (ftruncate(memfd, buffer_size) < 0 ||
+            fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+            Logger::warning("Failed to size/seal memfd: " + std::string(strerror(errno)));
+            close(memfd);
+            ok = false;
+            break;
+        }
+        
+        udmabuf_create create = {};
+        create.memfd = memfd;
+        create.flags = UDMABUF_FLAGS_CLOEXEC;
+        create.offset = 0;
+        create.size = buffer_size;
+        
+        int dmabuf_fd = ioctl(udmabuf_dev, UDMABUF_CREATE, &create);
+        if (dmabuf_fd < 0) {
+            Logger::warning("UDMABUF_CREATE failed: " + std::string(strerror(errno)));
+            close(memfd);
+            ok = false;
+            break;
+        }
+        
+        // CPU mapping of the same pages - the mapping keeps the memfd alive
+        void* start = mmap(NULL, buffer_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        close(memfd);
+        if (start == MAP_FAILED) {
+            Logger::warning("Failed to map DMABUF buffer: " + std::string(strerror(errno)));
+            close(dmabuf_fd);
+            ok = false;
+            break;
+        }
+        
+        buffers_[i].start = start;
+        buffers_[i].length = buffer_size;
+        buffers_[i].dmabuf_fd = dmabuf_fd;
+        
+        v4l2_buffer buffer = {};
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_DMABUF;
+        buffer.index = i;
+        buffer.m.fd = dmabuf_fd;
+        buffer.length = buffer_size;
+        
+        if (ioctl(fd_, VIDIOC_QBUF, &buffer) < 0) {
+            Logger::warning("Failed to queue DMABUF buffer: " + std::string(strerror(errno)));
+            ok = false;
+        }
+    }
+    
+    close(udmabuf_dev);
+    
+    if (!ok) {
+        cleanupBuffers();
+        req.count = 0;
+        ioctl(fd_, VIDIOC_REQBUFS, &req);
+        return false;
+    }
+    
+    Logger::info("V4L2Capture: Allocated " + std::to_string(buffers_.size()) +
+                 " udmabuf buffers of " + std::to_string(buffer_size) + " bytes");
+    return true;
+}
+
+void V4L2Capture::exportMMAPBuffers() {
+    size_t exported = 0;
+    
+    for (unsigned int i = 0; i < buffers_.size(); ++i) {
+        v4l2_exportbuffer expbuf = {};
+        expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        expbuf.index = i;
+        expbuf.flags = O_RDWR | O_CLOEXEC;
+        
+        if (ioctl(fd_, VIDIOC_EXPBUF, &expbuf) < 0) {
+            Logger::debug("VIDIOC_EXPBUF not supported: " + std::string(strerror(errno)));
+            // All buffers or none: drop the fds exported so far
+            for (unsigned int j = 0; j < i; ++j) {
+                close(buffers_[j].dmabuf_fd);
+                buffers_[j].dmabuf_fd = -1;
+            }
+            return;
+        }
+        
+        buffers_[i].dmabuf_fd = expbuf.fd;
+        exported++;
+    }
+    
+    Logger::info("V4L2Capture: Exported " + std::to_string(exported) + " MMAP buffers as dma-buf");
+}
+
+void V4L2Capture::syncDMABUF(const Buffer& buffer, bool start) {
+    if (buffer_type_ != V4L2_MEMORY_DMABUF || buffer.dmabuf_fd < 0) {
+        return;
+    }
+    
+    dma_buf_sync sync = {};
+    sync.flags = (start ? DMA_BUF_SYNC_START : DMA_BUF_SYNC_END) | DMA_BUF_SYNC_RW;
+    
+    while (ioctl(buffer.dmabuf_fd, DMA_BUF_IOCTL_SYNC, &sync) < 0 && errno == EINTR) {
+    }
 }
 
 void V4L2Capture::cleanupBuffers() {
+    bool had_buffers = !buffers_.empty();
+    
     for (auto& buffer : buffers_) {
         if (buffer.start != nullptr && buffer.start != MAP_FAILED) {
             munmap(buffer.start, buffer.length);
         }
+        if (buffer.dmabuf_fd >= 0) {
+            close(buffer.dmabuf_fd);
+        }
     }
     buffers_.clear();
+    
+    // Release driver-side buffers so the queue can be set up again
+    if (had_buffers && fd_ >= 0) {
+        v4l2_requestbuffers reqbuf;
+        memset(&reqbuf, 0, sizeof(reqbuf));
+        reqbuf.count = 0;
+        reqbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        reqbuf.memory = buffer_type_;
+        if (ioctl(fd_, VIDIOC_REQBUFS, &reqbuf) < 0) {
+            Logger::debug("V4L2Capture: Releasing buffers failed: " + std::string(strerror(errno)));
+        }
+    }
 }
 
 bool V4L2Capture::startStreaming() {
@@ -367,6 +587,10 @@ bool V4L2Capture::startStreaming() {
         return false;
     }
     
+    // Sequence numbers restart at STREAMON
+    have_sequence_ = false;
+    last_sequence_ = 0;
+    
     Logger::info("V4L2Capture: Streaming started");
     return true;
 }
@@ -381,25 +605,429 @@ void V4L2Capture::stopStreaming() {
     }
 }
 
-// Optimized capture thread for stable 60fps
+bool V4L2Capture::requeueBuffer(v4l2_buffer& v4l2_buf) {
+    if (buffer_type_ == V4L2_MEMORY_DMABUF) {
+        const Buffer& buffer = buffers_[v4l2_buf.index];
+        v4l2_buf.m.fd = buffer.dmabuf_fd;
+        v4l2_buf.length = buffer.length;
+    }
+    if (ioctl(fd_, VIDIOC_QBUF, &v4l2_buf) < 0) {
+        setError("Failed to requeue buffer: " + std::string(strerror(errno)));
+        return false;
+    }
+    if (buffers_held_ > 0) {
+        buffers_held_--;
+    }
+    return true;
+}
+
+void V4L2Capture::trackSequence(const v4l2_buffer& v4l2_buf, int64_t frame_age_ns, uint32_t cadence_gap) {
+    uint32_t gap = 0;
+    
+    if (have_sequence_) {
+        if (v4l2_buf.sequence != last_sequence_) {
+            // Unsigned subtraction handles 32-bit wrap
+            gap = v4l2_buf.sequence - last_sequence_ - 1;
+        } else {
+            // Driver does not fill sequence - fall back to timestamp cadence
+            gap = cadence_gap;
+        }
+    }
+    have_sequence_ = true;
+    last_sequence_ = v4l2_buf.sequence;
+    
+    bool error = (v4l2_buf.flags & V4L2_BUF_FLAG_ERROR) != 0;
+    
+    // Sequence jump after a driver reset, not real drops
+    if (gap > 100000) {
+        Logger::warning("V4L2: Sequence jumped to " + std::to_string(v4l2_buf.sequence) + ", resyncing");
+        gap = 0;
+    }
+    
+    if (gap == 0 && !error) {
+        return;
+    }
+    
+    // The driver loses frames for lack of buffers only when every queued
+    // buffer was already filled and waiting for us. This frame waited
+    // frame_age_ns, so if that covers the rest of the queue we were late.
+    int64_t interval_ns = pacer_.getIntervalNs();
+    int64_t queued_behind = static_cast<int64_t>(buffers_.size()) - static_cast<int64_t>(buffers_held_);
+    queued_behind = std::max<int64_t>(1, queued_behind);
+    bool starved = frame_age_ns >= queued_behind * interval_ns;
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (gap > 0) {
+        stats_.frames_dropped += gap;
+        if (starved) {
+            stats_.userspace_dropped += gap;
+        } else {
+            stats_.driver_dropped += gap;
+        }
+    }
+    if (error) {
+        stats_.frames_dropped++;
+        stats_.driver_dropped++;
+        stats_.error_buffers++;
+    }
+    
+    Logger::debug("V4L2: Sequence " + std::to_string(v4l2_buf.sequence) + " lost " +
+                 std::to_string(gap) + " frame(s)" + (starved ? " (queue starved)" : "") +
+                 (error ? ", buffer error flag set" : ""));
+}
+
+void V4L2Capture::subscribeSourceChange() {
+    v4l2_event_subscription sub;
+    memset(&sub, 0, sizeof(sub));
+    sub.type = V4L2_EVENT_SOURCE_CHANGE;
+    
+    if (ioctl(fd_, VIDIOC_SUBSCRIBE_EVENT, &sub) < 0) {
+        // UVC sticks do not raise source changes; the watchdog still covers them
+        Logger::debug("V4L2Capture: Source change events not supported: " + std::string(strerror(errno)));
+        source_change_subscribed_ = false;
+        return;
+    }
+    
+    source_change_subscribed_ = true;
+    Logger::info("V4L2Capture: Subscribed to source change events");
+}
+
+bool V4L2Capture::processEvents(bool& reconfigured) {
+    reconfigured = false;
+    bool source_changed = false;
+    
+    v4l2_event event;
+    memset(&event, 0, sizeof(event));
+    while (ioctl(fd_, VIDIOC_DQEVENT, &event) == 0) {
+        if (event.type == V4L2_EVENT_SOURCE_CHANGE &&
+            (event.u.src_change.changes & V4L2_EVENT_SRC_CH_RESOLUTION)) {
+            source_changed = true;
+        }
+        if (event.pending == 0) {
+            break;
+        }
+    }
+    
+    // Several events in a burst collapse into one reconfiguration
+    if (source_changed) {
+        if (!handleSourceChange()) {
+            return false;
+        }
+        reconfigured = true;
+    }
+    return true;
+}
+
+bool V4L2Capture::handleSourceChange() {
+    auto change_start = std::chrono::steady_clock::now();
+    Logger::info("V4L2Capture: Source change detected, reconfiguring in place");
+    
+    if (stream_active_) {
+        stopStreaming();
+        stream_active_ = false;
+    }
+    
+    // Buffers held by the send stage or the consumer must come back before
+    // they are unmapped; the consumer is asked again as the send stage drains
+    if (release_queue_) {
+        auto deadline = change_start + std::chrono::seconds(1);
+        while (buffers_held_ > 0) {
+            flushConsumer();
+            uint32_t index;
+            while (release_queue_->tryPop(index) && buffers_held_ > 0) {
+                buffers_held_--;
+            }
+            if (buffers_held_ == 0) {
+                break;
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                setError("Buffers not released after source change");
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    buffers_held_ = 0;
+    cleanupBuffers();
+    
+    // A recording holds one format; the send stage is idle at this point
+    stopRecording();
+    
+    // HDMI receivers: lock onto the new signal timings before setting the format
+    uint32_t width = current_format_.fmt.pix.width;
+    uint32_t height = current_format_.fmt.pix.height;
+    uint32_t pixelformat = current_format_.fmt.pix.pixelformat;
+    
+    v4l2_dv_timings timings;
+    memset(&timings, 0, sizeof(timings));
+    if (ioctl(fd_, VIDIOC_QUERY_DV_TIMINGS, &timings) == 0) {
+        if (ioctl(fd_, VIDIOC_S_DV_TIMINGS, &timings) < 0) {
+            Logger::warning("V4L2Capture: Failed to apply new DV timings: " + std::string(strerror(errno)));
+        }
+        width = timings.bt.width;
+        height = timings.bt.height;
+        Logger::info("V4L2Capture: New source timings " + std::to_string(width) + "x" +
+                     std::to_string(height) + (timings.bt.interlaced ? "i" : "p"));
+    } else if (errno == ENOLINK || errno == ENOLCK || errno == ERANGE) {
+        // No (stable) signal yet - stay stopped until the next event or retry
+        Logger::warning("V4L2Capture: No stable signal after source change (" +
+                        std::string(strerror(errno)) + "), waiting");
+        return true;
+    }
+    
+    if (!setCaptureFormat(width, height, pixelformat) && !findBestFormat()) {
+        setError("Failed to set format after source change");
+        return false;
+    }
+    
+    if (!setupBuffers() || !startStreaming()) {
+        return false;
+    }
+    stream_active_ = true;
+    
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - change_start).count();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.source_changes++;
+        stats_.last_source_change_ms = elapsed_ms;
+        stats_.frame_interval_us = pacer_.getIntervalNs() / 1000.0;
+    }
+    
+    Logger::info("V4L2Capture: Source change handled in " + std::to_string(elapsed_ms) + "ms - now " +
+                 std::to_string(video_format_.width) + "x" + std::to_string(video_format_.height) + " " +
+                 pixelFormatToString(current_format_.fmt.pix.pixelformat) + " @ " +
+                 std::to_string(video_format_.fps_numerator) + "/" +
+                 std::to_string(video_format_.fps_denominator) + " fps");
+    return true;
+}
+
+bool V4L2Capture::startPipeline() {
+    size_t count = buffers_.size();
+    if (count < 2) {
+        return false;
+    }
+    
+    send_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (send_event_fd_ < 0 || !startReleaseQueue()) {
+        Logger::warning("V4L2Capture: eventfd failed: " + std::string(strerror(errno)));
+        stopPipeline();
+        stopReleaseQueue();
+        return false;
+    }
+    
+    // Sized for the V4L2 maximum so a source change may reallocate any count.
+    // One spare slot: the ring keeps one entry empty to tell full from empty.
+    send_queue_ = std::make_unique<FrameQueue>(VIDEO_MAX_FRAME + 1, 0);
+    
+    // Send stage next to the capture core when it is pinned
+    int send_core = -1;
+    if (profile_.cpu_affinity >= 0) {
+        send_core = (profile_.cpu_affinity + 1) % std::max(1, PipelineThreadPool::getCpuCoreCount());
+    }
+    
+    pipeline_pool_ = std::make_unique<PipelineThreadPool>();
+    send_thread_id_ = pipeline_pool_->createThread("ndi-send", [this]() { sendStageThread(); }, send_core);
+    
+    Logger::info("V4L2Capture: Pipeline started - capture -> send stage" +
+                 (send_core >= 0 ? " (core " + std::to_string(send_core) + ")" : std::string()) +
+                 ", " + std::to_string(count) + " buffers");
+    return true;
+}
+
+void V4L2Capture::stopPipeline() {
+    if (pipeline_pool_) {
+        pipeline_pool_->stopAll();
+        if (send_event_fd_ >= 0) {
+            uint64_t one = 1;
+            if (write(send_event_fd_, &one, sizeof(one)) < 0) {
+                Logger::debug("V4L2Capture: Send stage wakeup failed: " + std::string(strerror(errno)));
+            }
+        }
+        pipeline_pool_->waitAll();
+        
+        const auto* info = pipeline_pool_->getThreadInfo(send_thread_id_);
+        if (info) {
+            Logger::info("V4L2Capture: Send stage - " + std::to_string(info->iterations) +
+                         " frames, avg " + std::to_string(info->avg_processing_time_ms) + "ms");
+        }
+        pipeline_pool_.reset();
+    }
+    
+    send_queue_.reset();
+    if (send_event_fd_ >= 0) {
+        close(send_event_fd_);
+        send_event_fd_ = -1;
+    }
+}
+
+bool V4L2Capture::startReleaseQueue() {
+    release_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (release_event_fd_ < 0) {
+        return false;
+    }
+    
+    // Sized like the send queue: any buffer count, plus the ring's spare slot
+    inflight_ = std::vector<InflightBuffer>(VIDEO_MAX_FRAME);
+    std::lock_guard<std::mutex> lock(release_mutex_);
+    release_queue_ = std::make_unique<BufferIndexQueue>(VIDEO_MAX_FRAME + 1);
+    buffers_held_ = 0;
+    return true;
+}
+
+void V4L2Capture::stopReleaseQueue() {
+    // Buffers still in flight go back to the driver with STREAMOFF; a late
+    // release finds no queue and is ignored
+    {
+        std::lock_guard<std::mutex> lock(release_mutex_);
+        release_queue_.reset();
+    }
+    inflight_.clear();
+    buffers_held_ = 0;
+    async_release_ = false;
+    
+    if (release_event_fd_ >= 0) {
+        close(release_event_fd_);
+        release_event_fd_ = -1;
+    }
+}
+
+void V4L2Capture::releaseBuffer(uint32_t index) {
+    std::lock_guard<std::mutex> lock(release_mutex_);
+    if (!release_queue_ || inflight_[index].owners.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    
+    // Last owner: CPU access (send, in-place swizzle, async NDI read) ends here
+    syncDMABUF(buffers_[index], false);
+    
+    // Capacity covers every possible buffer, so this cannot fail
+    release_queue_->tryPush(index);
+    uint64_t one = 1;
+    if (write(release_event_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        Logger::debug("V4L2Capture: Release wakeup failed: " + std::string(strerror(errno)));
+    }
+}
+
+void V4L2Capture::flushConsumer() {
+    FlushCallback flush;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        flush = flush_callback_;
+    }
+    if (flush) {
+        flush();
+    }
+}
+
+bool V4L2Capture::dispatchToPipeline(const v4l2_buffer& v4l2_buf,
+                                     std::chrono::steady_clock::time_point capture_time) {
+    uint32_t index = v4l2_buf.index;
+    inflight_[index].v4l2_buf = v4l2_buf;
+    inflight_[index].capture_time = capture_time;
+    inflight_[index].owners.store(1, std::memory_order_relaxed);  // The send stage
+    
+    // Decode stage: the next frame decodes here while the send stage is
+    // still sending the previous one
+    if (current_format_.fmt.pix.pixelformat == V4L2_PIX_FMT_MJPEG) {
+        const Buffer& buffer = buffers_[index];
+        syncDMABUF(buffer, true);
+        bool decoded = decodeMjpeg(buffer, v4l2_buf, inflight_[index].decoded);
+        syncDMABUF(buffer, false);
+        if (!decoded) {
+            v4l2_buffer requeue = v4l2_buf;
+            return requeueBuffer(requeue);
+        }
+    }
+    
+    FrameQueue::Frame frame(buffers_[index].start, v4l2_buf.bytesused, 0, video_format_, index);
+    if (!send_queue_->tryPush(frame)) {
+        // Send stage is behind by a whole queue - drop here rather than stall capture
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.frames_dropped++;
+            stats_.userspace_dropped++;
+        }
+        v4l2_buffer requeue = v4l2_buf;
+        return requeueBuffer(requeue);
+    }
+    
+    uint64_t one = 1;
+    if (write(send_event_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        Logger::debug("V4L2Capture: Send stage wakeup failed: " + std::string(strerror(errno)));
+    }
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.pipeline_frames++;
+    stats_.max_buffers_in_flight = std::max(stats_.max_buffers_in_flight, buffers_held_);
+    return true;
+}
+
+bool V4L2Capture::drainReleasedBuffers() {
+    uint32_t index;
+    while (release_queue_->tryPop(index)) {
+        if (!requeueBuffer(inflight_[index].v4l2_buf)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void V4L2Capture::sendStageThread() {
+    // Runs on the pool thread; frames arrive as V4L2 buffer indices
+    struct pollfd pfd;
+    pfd.fd = send_event_fd_;
+    pfd.events = POLLIN;
+    
+    while (!pipeline_pool_->shouldStop(send_thread_id_)) {
+        int ret = poll(&pfd, 1, 100);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            Logger::error("V4L2Capture: Send stage poll error: " + std::string(strerror(errno)));
+            break;
+        }
+        if (ret > 0) {
+            uint64_t count;
+            if (read(send_event_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                Logger::debug("V4L2Capture: Send eventfd read failed: " + std::string(strerror(errno)));
+            }
+        }
+        
+        FrameQueue::Frame frame;
+        while (send_queue_->tryPop(frame)) {
+            {
+                ThreadTimer timer(*pipeline_pool_, send_thread_id_);
+                const Buffer& buffer = buffers_[frame.buffer_index];
+                const InflightBuffer& inflight = inflight_[frame.buffer_index];
+                syncDMABUF(buffer, true);
+                sendFrameExtreme(buffer, inflight.v4l2_buf, inflight.capture_time);
+            }
+            
+            // Back to the capture thread unless NDI still reads it; the last
+            // owner ends CPU access
+            releaseBuffer(frame.buffer_index);
+        }
+    }
+}
+
+// Optimized capture thread paced by the negotiated frame interval
 void V4L2Capture::captureThreadExtreme() {
-    Logger::info("V4L2 Optimized capture thread started (stable 60fps)");
+    Logger::info("V4L2 Optimized capture thread started");
     
     // Apply real-time settings
     applyExtremeRealtimeSettings();
     
-    // Frame timing for stable 60fps
-    const auto frame_duration = std::chrono::microseconds(16667); // 60fps = 16.667ms
-    auto next_frame_time = std::chrono::steady_clock::now();
+    // Frame timing from the negotiated interval (updated on source change)
+    int64_t frame_interval_ns = pacer_.getIntervalNs();
+    pacer_.reset();
     
     // Performance monitoring
     auto last_stats_time = std::chrono::steady_clock::now();
     uint64_t local_frame_count = 0;
     uint64_t total_frame_count = 0;
-    uint64_t dropped_frames = 0;
     
-    // FPS calculation
-    const int fps_window = 60;
+    // FPS calculation (about one second of frames)
+    uint64_t fps_window = std::max<int64_t>(1, (1000000000LL + frame_interval_ns / 2) / frame_interval_ns);
     std::chrono::steady_clock::time_point fps_start_time = std::chrono::steady_clock::now();
     uint64_t fps_frame_count = 0;
     
@@ -407,33 +1035,59 @@ void V4L2Capture::captureThreadExtreme() {
     std::chrono::steady_clock::time_point last_frame_time = std::chrono::steady_clock::now();
     double max_frame_gap_ms = 0.0;
     
-    // Use poll for efficient waiting
-    struct pollfd pfd;
-    pfd.fd = fd_;
-    pfd.events = POLLIN;
+    // Paced profile sleeps on the device plus a timerfd deadline that only
+    // fires when a frame is late; the other policies poll the device alone.
+    // The send stage or an async NDI send also wakes us to requeue buffers.
+    bool use_timer = (profile_.pacing == PacingPolicy::Paced) && pacer_.openTimer();
+    bool pipelined = send_queue_ != nullptr;
+    struct pollfd pfds[3];
+    nfds_t nfds = 0;
+    pfds[nfds].fd = fd_;
+    pfds[nfds].events = POLLIN | (source_change_subscribed_ ? POLLPRI : 0);
+    nfds++;
+    int timer_slot = -1;
+    if (use_timer) {
+        timer_slot = static_cast<int>(nfds);
+        pfds[nfds].fd = pacer_.getTimerFd();
+        pfds[nfds].events = POLLIN;
+        nfds++;
+    }
+    int release_slot = -1;
+    if (release_queue_) {
+        release_slot = static_cast<int>(nfds);
+        pfds[nfds].fd = release_event_fd_;
+        pfds[nfds].events = POLLIN;
+        nfds++;
+    }
+    
+    int timeout_ms = profile_.poll_timeout_ms;
+    if (profile_.pacing == PacingPolicy::BusyWait) {
+        timeout_ms = 0;
+    } else if (profile_.pacing == PacingPolicy::Paced) {
+        // At least once per frame interval, timerfd or not: the deadline is
+        // armed by frames only, and stopCapture() needs the loop to see
+        // should_stop_ when a streaming device delivers none
+        timeout_ms = static_cast<int>(std::max<int64_t>(1, frame_interval_ns / 1000000));
+    }
     
     // Pre-allocate v4l2_buffer
     v4l2_buffer v4l2_buf = {};
     v4l2_buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     v4l2_buf.memory = buffer_type_;
     
-    Logger::info("V4L2: Thread started, targeting stable 60 FPS");
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frame_interval_us = frame_interval_ns / 1000.0;
+    }
+    
+    Logger::info("V4L2: Thread started, frame interval " + std::to_string(frame_interval_ns / 1000) +
+                 "µs, pacing " + pacingPolicyToString(profile_.pacing) +
+                 (use_timer ? " (timerfd deadline)" : ""));
     
     while (!should_stop_) {
-        // Calculate time until next frame
-        auto now = std::chrono::steady_clock::now();
-        auto time_until_next = next_frame_time - now;
-        
-        // Use poll with dynamic timeout
-        int timeout_ms = 1; // Default 1ms
-        if (time_until_next > std::chrono::milliseconds(0)) {
-            timeout_ms = std::chrono::duration_cast<std::chrono::milliseconds>(time_until_next).count();
-            timeout_ms = std::max(0, std::min(timeout_ms, 16)); // Cap at frame time
-        }
-        
         // Time poll wait
         auto poll_start = std::chrono::high_resolution_clock::now();
-        int ret = poll(&pfd, 1, timeout_ms);
+        int ret = poll(pfds, nfds, timeout_ms);
         auto poll_end = std::chrono::high_resolution_clock::now();
         double poll_wait_us = std::chrono::duration<double, std::micro>(poll_end - poll_start).count();
         
@@ -443,19 +1097,62 @@ void V4L2Capture::captureThreadExtreme() {
             break;
         }
         
-        if (ret == 0) {
-            // Timeout - check if we missed a frame
-            if (now > next_frame_time + frame_duration) {
-                dropped_frames++;
-                {
-                    std::lock_guard<std::mutex> lock(stats_mutex_);
-                    stats_.frames_dropped++;  // Update the actual stats!
+        if (timer_slot >= 0 && (pfds[timer_slot].revents & POLLIN)) {
+            // Deadline passed without a frame - the sequence gap is counted on arrival
+            uint64_t late = pacer_.onTimer();
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.late_frame_wakeups += late;
+        }
+        
+        if (release_slot >= 0 && (pfds[release_slot].revents & POLLIN)) {
+            uint64_t count;
+            if (read(release_event_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                Logger::debug("V4L2: Release eventfd read failed: " + std::string(strerror(errno)));
+            }
+        }
+        
+        // Source change: new format and buffers, same thread and callback
+        if (pfds[0].revents & POLLPRI) {
+            bool reconfigured = false;
+            if (!processEvents(reconfigured)) {
+                break;
+            }
+            if (reconfigured) {
+                frame_interval_ns = pacer_.getIntervalNs();
+                fps_window = std::max<int64_t>(1, (1000000000LL + frame_interval_ns / 2) / frame_interval_ns);
+                if (profile_.pacing == PacingPolicy::Paced) {
+                    timeout_ms = static_cast<int>(std::max<int64_t>(1, frame_interval_ns / 1000000));
                 }
-                next_frame_time = now; // Reset timing
+                fps_frame_count = 0;
+                fps_start_time = std::chrono::steady_clock::now();
+                continue;
+            }
+        }
+        
+        // No signal after a source change: the device reports POLLERR while
+        // stopped, so retry the timings at a slow rate instead of spinning
+        if (!stream_active_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            v4l2_dv_timings timings;
+            memset(&timings, 0, sizeof(timings));
+            if (ioctl(fd_, VIDIOC_QUERY_DV_TIMINGS, &timings) < 0) {
+                continue;
+            }
+            if (!handleSourceChange()) {
+                break;
             }
             continue;
         }
         
+        // Give buffers finished by the send stage or NDI back to the driver first
+        if (release_queue_ && !drainReleasedBuffers()) {
+            break;
+        }
+        
+        if (ret == 0 || (pfds[0].revents & ~POLLPRI) == 0) {
+            continue;
+        }
+        
         // Data available - dequeue buffer with timing
         auto dequeue_start = std::chrono::high_resolution_clock::now();
         if (ioctl(fd_, VIDIOC_DQBUF, &v4l2_buf) < 0) {
@@ -464,16 +1161,38 @@ void V4L2Capture::captureThreadExtreme() {
             {
                 std::lock_guard<std::mutex> lock(stats_mutex_);
                 stats_.frames_dropped++;
+                stats_.driver_dropped++;
             }
-            dropped_frames++;
             setError("Failed to dequeue buffer: " + std::string(strerror(errno)));
             break;
         }
         auto dequeue_end = std::chrono::high_resolution_clock::now();
         double dequeue_us = std::chrono::duration<double, std::micro>(dequeue_end - dequeue_start).count();
+        buffers_held_++;
         
         // Frame ready - process with timing
-        now = std::chrono::steady_clock::now();
+        auto now = std::chrono::steady_clock::now();
+        
+        // Cadence from the driver timestamp (arrival time if not monotonic)
+        struct timespec dequeue_ts;
+        clock_gettime(CLOCK_MONOTONIC, &dequeue_ts);
+        int64_t dequeue_ns = dequeue_ts.tv_sec * 1000000000LL + dequeue_ts.tv_nsec;
+        int64_t frame_time_ns = dequeue_ns;
+        if ((v4l2_buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+            frame_time_ns = v4l2_buf.timestamp.tv_sec * 1000000000LL + v4l2_buf.timestamp.tv_usec * 1000LL;
+        }
+        uint32_t cadence_gap = pacer_.onFrame(frame_time_ns);
+        
+        // Drop accounting from the sequence number
+        trackSequence(v4l2_buf, dequeue_ns - frame_time_ns, cadence_gap);
+        
+        // Corrupted frame - give the buffer back without sending it
+        if (v4l2_buf.flags & V4L2_BUF_FLAG_ERROR) {
+            if (!requeueBuffer(v4l2_buf)) {
+                break;
+            }
+            continue;
+        }
         
         // Calculate frame gap
         if (total_frame_count > 0) {
@@ -484,20 +1203,44 @@ void V4L2Capture::captureThreadExtreme() {
         }
         last_frame_time = now;
         
-        // Process frame with zero-copy timing
-        auto callback_start = std::chrono::high_resolution_clock::now();
-        sendFrameExtreme(buffers_[v4l2_buf.index], v4l2_buf, now);
-        auto callback_end = std::chrono::high_resolution_clock::now();
-        double callback_us = std::chrono::duration<double, std::micro>(callback_end - callback_start).count();
+        double callback_us = 0.0;
+        double requeue_us = 0.0;
         
-        // Requeue buffer immediately with timing
-        auto requeue_start = std::chrono::high_resolution_clock::now();
-        if (ioctl(fd_, VIDIOC_QBUF, &v4l2_buf) < 0) {
-            setError("Failed to requeue buffer: " + std::string(strerror(errno)));
-            break;
+        if (pipelined) {
+            // Hand the buffer index to the send stage; it comes back through release_queue_
+            auto handoff_start = std::chrono::high_resolution_clock::now();
+            if (!dispatchToPipeline(v4l2_buf, now)) {
+                break;
+            }
+            auto handoff_end = std::chrono::high_resolution_clock::now();
+            callback_us = std::chrono::duration<double, std::micro>(handoff_end - handoff_start).count();
+        } else {
+            // Process frame with zero-copy timing
+            auto callback_start = std::chrono::high_resolution_clock::now();
+            const Buffer& buffer = buffers_[v4l2_buf.index];
+            if (async_release_) {
+                inflight_[v4l2_buf.index].v4l2_buf = v4l2_buf;
+                inflight_[v4l2_buf.index].owners.store(1, std::memory_order_relaxed);  // This thread
+            }
+            syncDMABUF(buffer, true);
+            sendFrameExtreme(buffer, v4l2_buf, now);
+            auto callback_end = std::chrono::high_resolution_clock::now();
+            callback_us = std::chrono::duration<double, std::micro>(callback_end - callback_start).count();
+            
+            // Requeue buffer immediately with timing, unless NDI still reads
+            // it - then its release ends CPU access and it comes back
+            // through release_queue_
+            if (!async_release_ ||
+                inflight_[v4l2_buf.index].owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                syncDMABUF(buffer, false);
+                auto requeue_start = std::chrono::high_resolution_clock::now();
+                if (!requeueBuffer(v4l2_buf)) {
+                    break;
+                }
+                auto requeue_end = std::chrono::high_resolution_clock::now();
+                requeue_us = std::chrono::duration<double, std::micro>(requeue_end - requeue_start).count();
+            }
         }
-        auto requeue_end = std::chrono::high_resolution_clock::now();
-        double requeue_us = std::chrono::duration<double, std::micro>(requeue_end - requeue_start).count();
         
         // Update timing statistics
         {
@@ -519,6 +1262,8 @@ void V4L2Capture::captureThreadExtreme() {
             stats_.max_dequeue_us = std::max(stats_.max_dequeue_us, dequeue_us);
             stats_.max_callback_us = std::max(stats_.max_callback_us, callback_us);
             stats_.max_requeue_us = std::max(stats_.max_requeue_us, requeue_us);
+            stats_.avg_cadence_jitter_us = pacer_.getAvgJitterUs();
+            stats_.max_cadence_jitter_us = pacer_.getMaxJitterUs();
         }
         
         // Update counters
@@ -526,15 +1271,6 @@ void V4L2Capture::captureThreadExtreme() {
         total_frame_count++;
         fps_frame_count++;
         
-        // Maintain 60fps pacing
-        next_frame_time += frame_duration;
-        
-        // If we're behind, catch up but don't accumulate delay
-        now = std::chrono::steady_clock::now();
-        if (now > next_frame_time + frame_duration * 2) {
-            next_frame_time = now;
-        }
-        
         // Calculate actual FPS over smaller window
         if (fps_frame_count >= fps_window) {
             auto fps_end_time = std::chrono::steady_clock::now();
@@ -546,7 +1282,7 @@ void V4L2Capture::captureThreadExtreme() {
                         " (measured over " + std::to_string(fps_window) + " frames)" +
                         ", max frame gap: " + std::to_string(max_frame_gap_ms) + "ms");
             
-            // Emit metrics for monitoring (every ~2 seconds at 60fps)
+            // Emit metrics for monitoring (about once per second)
             {
                 std::lock_guard<std::mutex> lock(stats_mutex_);
                 Logger::metrics(actual_fps, stats_.frames_captured, stats_.frames_dropped, stats_.avg_e2e_latency_ms);
@@ -574,12 +1310,31 @@ void V4L2Capture::captureThreadExtreme() {
             Logger::info("  - Overall FPS: " + std::to_string(overall_fps));
             Logger::info("  - Total frames: " + std::to_string(total_frame_count));
             Logger::info("  - Zero-copy frames: " + std::to_string(stats_.zero_copy_frames));
+            Logger::info("  - Dropped: " + std::to_string(stats_.frames_dropped) +
+                        " (driver " + std::to_string(stats_.driver_dropped) +
+                        ", userspace " + std::to_string(stats_.userspace_dropped) +
+                        ", NDI " + std::to_string(stats_.ndi_dropped) +
+                        ", error buffers " + std::to_string(stats_.error_buffers) + ")");
             Logger::info("  - Internal latency: " + std::to_string(stats_.avg_e2e_latency_ms) + "ms");
+            Logger::info("  - Capture-to-send (profile '" + profile_.name + "'): avg=" +
+                        std::to_string(stats_.avg_capture_to_send_ms) + "ms, max=" +
+                        std::to_string(stats_.max_capture_to_send_ms) + "ms");
             Logger::info("Detailed timing breakdown (microseconds):");
             Logger::info("  - Poll wait: avg=" + std::to_string(stats_.avg_poll_wait_us) + "µs, max=" + std::to_string(stats_.max_poll_wait_us) + "µs");
             Logger::info("  - Dequeue: avg=" + std::to_string(stats_.avg_dequeue_us) + "µs, max=" + std::to_string(stats_.max_dequeue_us) + "µs");
-            Logger::info("  - Callback (NDI send): avg=" + std::to_string(stats_.avg_callback_us) + "µs, max=" + std::to_string(stats_.max_callback_us) + "µs");
+            Logger::info(std::string(pipelined ? "  - Handoff to send stage: avg=" : "  - Callback (NDI send): avg=") +
+                        std::to_string(stats_.avg_callback_us) + "µs, max=" + std::to_string(stats_.max_callback_us) + "µs");
+            if (stats_.source_changes > 0) {
+                Logger::info("  - Source changes: " + std::to_string(stats_.source_changes) +
+                            " (last handled in " + std::to_string(stats_.last_source_change_ms) + "ms)");
+            }
+            if (pipelined) {
+                Logger::info("  - Pipeline: " + std::to_string(stats_.pipeline_frames) + " frames handed off, max " +
+                            std::to_string(stats_.max_buffers_in_flight) + " buffers in flight");
+            }
             Logger::info("  - Requeue: avg=" + std::to_string(stats_.avg_requeue_us) + "µs, max=" + std::to_string(stats_.max_requeue_us) + "µs");
+            Logger::info("  - Cadence jitter: avg=" + std::to_string(stats_.avg_cadence_jitter_us) + "µs, max=" + std::to_string(stats_.max_cadence_jitter_us) +
+                        "µs (interval " + std::to_string(stats_.frame_interval_us) + "µs), late wakeups=" + std::to_string(stats_.late_frame_wakeups));
             double total_avg_us = stats_.avg_poll_wait_us + stats_.avg_dequeue_us + stats_.avg_callback_us + stats_.avg_requeue_us;
             Logger::info("  - TOTAL: " + std::to_string(total_avg_us / 1000.0) + "ms (" + std::to_string(total_avg_us) + "µs)");
             
@@ -588,11 +1343,19 @@ void V4L2Capture::captureThreadExtreme() {
         }
     }
     
+    pacer_.closeTimer();
+    
     // Final stats logged elsewhere
     
     Logger::info("V4L2 capture thread stopped");
-    Logger::info("Final stats - Total frames: " + std::to_string(total_frame_count) +
-                ", Dropped: " + std::to_string(dropped_frames));
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        Logger::info("Final stats - Total frames: " + std::to_string(total_frame_count) +
+                    ", Dropped: " + std::to_string(stats_.frames_dropped) +
+                    " (driver " + std::to_string(stats_.driver_dropped) +
+                    ", userspace " + std::to_string(stats_.userspace_dropped) +
+                    ", NDI " + std::to_string(stats_.ndi_dropped) + ")");
+    }
 }
 
 void V4L2Capture::sendFrameExtreme(const Buffer& buffer, const v4l2_buffer& v4l2_buf,
@@ -602,6 +1365,10 @@ void V4L2Capture::sendFrameExtreme(const Buffer& buffer, const v4l2_buffer& v4l2
     std::lock_guard<std::mutex> lock(callback_mutex_);
     
     if (!frame_callback_) {
+        // Nobody to hand the frame to - lost on our side
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.frames_dropped++;
+        stats_.userspace_dropped++;
         return;
     }
     
@@ -611,17 +1378,118 @@ void V4L2Capture::sendFrameExtreme(const Buffer& buffer, const v4l2_buffer& v4l2
     
     // Update format with actual pixel format for direct pass-through
     VideoFormat format = video_format_;
-    if (current_format_.fmt.pix.pixelformat == V4L2_PIX_FMT_UYVY) {
+    format.sequence = v4l2_buf.sequence;
+    if ((v4l2_buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        format.capture_realtime_ns = FrameTiming::monotonicToRealtime(timestamp_ns);
+    }
+    format.dmabuf_fd = buffer.dmabuf_fd;
+    const void* data = buffer.start;
+    size_t data_size = v4l2_buf.bytesused;
+    bool zero_copy = true;
+    bool in_place = true;   // data is the V4L2 buffer or its pipelined MJPEG decode
+    uint32_t pixelformat = current_format_.fmt.pix.pixelformat;
+    
+    if (pixelformat == V4L2_PIX_FMT_UYVY) {
+        format.pixel_format = "UYVY";
+    } else if (pixelformat == V4L2_PIX_FMT_YUYV) {
+        if (recorder_ || static_cast<size_t>(format.stride) * format.height > buffer.length) {
+            // The recording needs the captured bytes - NDI sender converts a copy
+            format.pixel_format = "YUYV";
+        } else {
+            // Swap to UYVY where it lies; the buffer is ours until requeued
+            if (!yuyv_swizzler_) {
+                yuyv_swizzler_ = std::make_unique<YuyvSwizzler>(PixelKernels::active(),
+                                                                &StripeExecutor::shared());
+                Logger::info(std::string("V4L2Capture: Swapping YUYV to UYVY in the capture buffer (") +
+                            PixelKernels::isaName(yuyv_swizzler_->getKernelIsa()) + ")");
+            }
+            yuyv_swizzler_->swizzleInPlace(static_cast<uint8_t*>(buffer.start), format.width,
+                                           format.height, format.stride);
+            format.pixel_format = "UYVY";
+        }
+    } else if (pixelformat == V4L2_PIX_FMT_NV12 || pixelformat == V4L2_PIX_FMT_YUV420 ||
+               pixelformat == V4L2_PIX_FMT_YVU420) {
+        // Planar 4:2:0 passes through; plane layout set in convertFormat()
+    } else if (pixelformat == V4L2_PIX_FMT_MJPEG) {
+        // Pipelined: decoded by the capture stage already; otherwise here
+        std::vector<uint8_t>* decoded = &mjpeg_buffer_;
+        if (send_queue_) {
+            decoded = &inflight_[v4l2_buf.index].decoded;
+        } else if (!decodeMjpeg(buffer, v4l2_buf, mjpeg_buffer_)) {
+            return;
+        } else {
+            in_place = false;
+        }
+        data = decoded->data();
+        data_size = decoded->size();
         format.pixel_format = "UYVY";
-    } else if (current_format_.fmt.pix.pixelformat == V4L2_PIX_FMT_YUYV) {
-        format.pixel_format = "YUYV";  // Will be converted to UYVY by NDI sender
+        format.stride = format.width * 2;
+        format.dmabuf_fd = -1;
+        zero_copy = false;
+    } else if (P216Packer::isFormatSupported(pixelformat)) {
+        // 10-bit: one repack pass into NDI's 16-bit 4:2:2
+        if (!p216_packer_) {
+            p216_packer_ = std::make_unique<P216Packer>(PixelKernels::active(), &StripeExecutor::shared());
+            Logger::info("V4L2Capture: Repacking " + pixelFormatToString(pixelformat) + " to P216 (" +
+                        PixelKernels::isaName(p216_packer_->getKernelIsa(pixelformat)) + ")");
+        }
+        if (!p216_packer_->pack(buffer.start, v4l2_buf.bytesused, format.width, format.height,
+                                format.stride, pixelformat, p216_buffer_)) {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.frames_dropped++;
+            stats_.userspace_dropped++;
+            return;
+        }
+        data = p216_buffer_.data();
+        data_size = p216_buffer_.size();
+        format.pixel_format = "P216";
+        format.stride = format.width * 2;
+        format.dmabuf_fd = -1;
+        zero_copy = false;
+        in_place = false;
+    } else {
+        // NDI cannot take this format as captured - convert to BGRA
+        if (!format_converter_) {
+            format_converter_ = std::make_unique<V4L2FormatConverter>(PixelKernels::active(),
+                                                                      &StripeExecutor::shared());
+        }
+        if (!format_converter_->convertToBGRA(buffer.start, v4l2_buf.bytesused,
+                                              format.width, format.height,
+                                              pixelformat, bgra_buffer_)) {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.frames_dropped++;
+            stats_.userspace_dropped++;
+            return;
+        }
+        data = bgra_buffer_.data();
+        data_size = bgra_buffer_.size();
+        format.pixel_format = "BGRA";
+        format.stride = format.width * 4;
+        format.dmabuf_fd = -1;
+        zero_copy = false;
+        in_place = false;
     }
     
-    // Direct callback with original YUV data - NO CONVERSION!
+    // Async send: the consumer becomes an owner of the buffer and drops it
+    // through release. Conversion buffers above are reused next frame, so
+    // those frames are only valid for the callback.
+    if (async_release_ && in_place) {
+        uint32_t index = v4l2_buf.index;
+        inflight_[index].owners.fetch_add(1, std::memory_order_relaxed);
+        format.release = [this, index]() { releaseBuffer(index); };
+    }
+    
+    // Direct callback with original YUV data - NO CONVERSION for UYVY/YUYV
     auto actual_send_start = std::chrono::high_resolution_clock::now();
-    frame_callback_(buffer.start, v4l2_buf.bytesused, timestamp_ns, format);
+    bool delivered = frame_callback_(data, data_size, timestamp_ns, format);
     auto actual_send_end = std::chrono::high_resolution_clock::now();
     
+    // Recording copy only after the frame has been handed downstream
+    if (recorder_) {
+        recorder_->submit(buffer.start, v4l2_buf.bytesused, timestamp_ns,
+                          v4l2_buf.sequence, v4l2_buf.flags);
+    }
+    
     // Calculate detailed timings
     double prep_us = std::chrono::duration<double, std::micro>(actual_send_start - callback_entry).count();
     double send_us = std::chrono::duration<double, std::micro>(actual_send_end - actual_send_start).count();
@@ -630,11 +1498,26 @@ void V4L2Capture::sendFrameExtreme(const Buffer& buffer, const v4l2_buffer& v4l2
     auto send_time = std::chrono::steady_clock::now();
     double internal_latency_ms = std::chrono::duration<double, std::milli>(send_time - capture_time).count();
     
+    // Capture-to-send latency from the driver's monotonic timestamp
+    double capture_to_send_ms = -1.0;
+    if ((v4l2_buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        int64_t now_ns = ts.tv_sec * 1000000000LL + ts.tv_nsec;
+        capture_to_send_ms = (now_ns - timestamp_ns) / 1000000.0;
+    }
+    
     // Update stats
     std::lock_guard<std::mutex> stats_lock(stats_mutex_);
     stats_.frames_captured++;
-    stats_.zero_copy_frames++;
+    if (zero_copy) {
+        stats_.zero_copy_frames++;
+    }
     stats_.total_latency_ms += internal_latency_ms;
+    if (!delivered) {
+        stats_.frames_dropped++;
+        stats_.ndi_dropped++;
+    }
     
     // Track accurate internal latency
     if (internal_latency_ms > 0 && internal_latency_ms < 10) {  // Sanity check
@@ -649,10 +1532,24 @@ void V4L2Capture::sendFrameExtreme(const Buffer& buffer, const v4l2_buffer& v4l2
         stats_.e2e_samples++;
     }
     
+    if (capture_to_send_ms >= 0.0 && capture_to_send_ms < 1000.0) {  // Sanity check
+        if (stats_.capture_to_send_samples == 0) {
+            stats_.avg_capture_to_send_ms = capture_to_send_ms;
+        } else {
+            stats_.avg_capture_to_send_ms = 0.9 * stats_.avg_capture_to_send_ms + 0.1 * capture_to_send_ms;
+        }
+        stats_.max_capture_to_send_ms = std::max(stats_.max_capture_to_send_ms, capture_to_send_ms);
+        stats_.capture_to_send_samples++;
+    }
+    
     // Log once for performance tracking
     if (!zero_copy_logged_) {
         Logger::info("EXTREME zero-copy path active: " + format.pixel_format + " -> NDI (NO BGRA CONVERSION)");
         Logger::info("  Callback breakdown: prep=" + std::to_string(prep_us) + "µs, NDI send=" + std::to_string(send_us) + "µs");
+        if (format.dmabuf_fd >= 0) {
+            Logger::info("  dma-buf fd attached to frames (" +
+                         std::string(buffer_type_ == V4L2_MEMORY_DMABUF ? "DMABUF" : "MMAP+EXPBUF") + ")");
+        }
         zero_copy_logged_ = true;
     }
     
@@ -679,6 +1576,11 @@ void V4L2Capture::captureThreadSingle() {
     uint64_t local_frame_count = 0;
     
     while (!should_stop_) {
+        // Buffers NDI finished with since the last pass
+        if (release_queue_ && !drainReleasedBuffers()) {
+            break;
+        }
+        
         // Poll with timeout
         int ret = poll(&pfd, 1, 0);  // 0ms timeout
         
@@ -701,12 +1603,28 @@ void V4L2Capture::captureThreadSingle() {
             break;
         }
         
-        // Direct send (zero-copy)
-        sendFrameDirect(buffers_[v4l2_buf.index], v4l2_buf);
+        trackSequence(v4l2_buf, 0, 0);
+        buffers_held_++;
         
-        // Requeue immediately
-        if (ioctl(fd_, VIDIOC_QBUF, &v4l2_buf) < 0) {
-            setError("Failed to requeue buffer: " + std::string(strerror(errno)));
+        // Direct send (zero-copy), corrupted frames are only requeued
+        const Buffer& buffer = buffers_[v4l2_buf.index];
+        bool last_owner = true;
+        if (!(v4l2_buf.flags & V4L2_BUF_FLAG_ERROR)) {
+            if (async_release_) {
+                inflight_[v4l2_buf.index].v4l2_buf = v4l2_buf;
+                inflight_[v4l2_buf.index].owners.store(1, std::memory_order_relaxed);  // This thread
+            }
+            syncDMABUF(buffer, true);
+            sendFrameDirect(buffer, v4l2_buf);
+            last_owner = !async_release_ ||
+                         inflight_[v4l2_buf.index].owners.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            if (last_owner) {
+                syncDMABUF(buffer, false);
+            }
+        }
+        
+        // Requeue immediately, unless NDI still reads it (release_queue_)
+        if (last_owner && !requeueBuffer(v4l2_buf)) {
             break;
         }
         
@@ -728,6 +1646,37 @@ void V4L2Capture::captureThreadSingle() {
     Logger::info("V4L2 capture thread stopped");
 }
 
+bool V4L2Capture::decodeMjpeg(const Buffer& buffer, const v4l2_buffer& v4l2_buf,
+                              std::vector<uint8_t>& output) {
+    if (!mjpeg_decoder_) {
+        mjpeg_decoder_ = std::make_unique<MjpegDecoder>();
+        Logger::info("V4L2Capture: Decoding MJPEG to UYVY on " +
+                     std::to_string(mjpeg_decoder_->getThreadCount()) + " threads");
+    }
+    
+    if (!mjpeg_decoder_->decode(buffer.start, v4l2_buf.bytesused, video_format_.width,
+                                video_format_.height, output)) {
+        if (!mjpeg_error_logged_) {
+            Logger::warning("V4L2Capture: " + mjpeg_decoder_->getLastError() + " (further errors not logged)");
+            mjpeg_error_logged_ = true;
+        }
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_dropped++;
+        stats_.userspace_dropped++;
+        return false;
+    }
+    
+    if (!mjpeg_slices_logged_) {
+        int slices = mjpeg_decoder_->getLastSliceCount();
+        Logger::info(slices > 1 ? "V4L2Capture: MJPEG frames split into " + std::to_string(slices) +
+                                  " slices at restart markers"
+                                : std::string("V4L2Capture: MJPEG frames have no usable restart markers, "
+                                              "decoding whole frames"));
+        mjpeg_slices_logged_ = true;
+    }
+    return true;
+}
+
 void V4L2Capture::sendFrameDirect(const Buffer& buffer, const v4l2_buffer& v4l2_buf) {
     auto capture_time = std::chrono::steady_clock::now();
     sendFrameExtreme(buffer, v4l2_buf, capture_time);
@@ -735,13 +1684,15 @@ void V4L2Capture::sendFrameDirect(const Buffer& buffer, const v4l2_buffer& v4l2_
 
 void V4L2Capture::applyRealtimeScheduling() {
     struct sched_param param;
-    param.sched_priority = kRealtimePriority;
+    param.sched_priority = profile_.realtime_priority;
     
-    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+    if (profile_.realtime_priority <= 0) {
+        Logger::info("Real-time scheduling disabled by profile");
+    } else if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
         Logger::warning("Could not set real-time priority (need CAP_SYS_NICE)");
         Logger::warning("Run with: sudo setcap cap_sys_nice+ep ndi-capture");
     } else {
-        Logger::info("Real-time SCHED_FIFO priority " + std::to_string(kRealtimePriority) + " active");
+        Logger::info("Real-time SCHED_FIFO priority " + std::to_string(profile_.realtime_priority) + " active");
     }
     
     // Also try to lock memory
@@ -753,27 +1704,31 @@ void V4L2Capture::applyRealtimeScheduling() {
 }
 
 void V4L2Capture::applyExtremeRealtimeSettings() {
-    // Set CPU affinity
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(kCpuAffinity, &cpuset);
-    
-    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
-        Logger::warning("Could not set CPU affinity to core " + std::to_string(kCpuAffinity));
-    } else {
-        Logger::info("CPU affinity set to core " + std::to_string(kCpuAffinity));
+    // Set CPU affinity (-1 leaves the thread to the scheduler)
+    if (profile_.cpu_affinity >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(profile_.cpu_affinity, &cpuset);
+        
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+            Logger::warning("Could not set CPU affinity to core " + std::to_string(profile_.cpu_affinity));
+        } else {
+            Logger::info("CPU affinity set to core " + std::to_string(profile_.cpu_affinity));
+        }
     }
     
-    // Set maximum real-time priority
+    // Set real-time priority from profile
     struct sched_param param;
-    param.sched_priority = kRealtimePriority;
+    param.sched_priority = profile_.realtime_priority;
     
-    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
-        Logger::warning("Could not set real-time priority " + std::to_string(kRealtimePriority) + 
+    if (profile_.realtime_priority <= 0) {
+        Logger::info("Real-time scheduling disabled by profile");
+    } else if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        Logger::warning("Could not set real-time priority " + std::to_string(profile_.realtime_priority) + 
                        " (need CAP_SYS_NICE)");
         Logger::warning("Run with: sudo setcap 'cap_sys_nice,cap_ipc_lock+ep' ndi-capture");
     } else {
-        Logger::info("EXTREME real-time SCHED_FIFO priority " + std::to_string(kRealtimePriority) + " active");
+        Logger::info("EXTREME real-time SCHED_FIFO priority " + std::to_string(profile_.realtime_priority) + " active");
     }
     
     // Lock memory with MCL_ONFAULT for better performance
@@ -785,7 +1740,27 @@ void V4L2Capture::applyExtremeRealtimeSettings() {
     }
 }
 
-bool V4L2Capture::setCaptureFormat(int width, int height, uint32_t pixelformat) {
+void V4L2Capture::configureConvertThreads() {
+    StripeExecutor::Config config;
+    config.threads = profile_.convert_threads;
+    if (profile_.cpu_affinity >= 0) {
+        // Workers on the cores the capture thread and send stage leave free
+        int cores = std::max(1, PipelineThreadPool::getCpuCoreCount());
+        for (int i = 2; i < cores; i++) {
+            config.cpu_cores.push_back((profile_.cpu_affinity + i) % cores);
+        }
+        if (config.threads == 0) {
+            config.threads = std::max(1, cores - 1);
+        }
+    }
+    
+    if (!StripeExecutor::configureShared(config)) {
+        Logger::debug("V4L2Capture: Conversion threads already running, keeping them");
+    }
+}
+
+bool V4L2Capture::setCaptureFormat(int width, int height, uint32_t pixelformat,
+                                   uint32_t fps_numerator, uint32_t fps_denominator) {
     memset(&current_format_, 0, sizeof(current_format_));
     current_format_.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     current_format_.fmt.pix.width = width;
@@ -807,30 +1782,52 @@ bool V4L2Capture::setCaptureFormat(int width, int height, uint32_t pixelformat)
     
     if (ioctl(fd_, VIDIOC_G_PARM, &parm) == 0) {
         if (parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME) {
-            // Try 60fps first
-            parm.parm.capture.timeperframe.numerator = 1;
-            parm.parm.capture.timeperframe.denominator = 60;
+            // The selected mode's rate, else try 60fps first
+            if (fps_numerator == 0 || fps_denominator == 0) {
+                fps_numerator = 60;
+                fps_denominator = 1;
+            }
+            parm.parm.capture.timeperframe.numerator = fps_denominator;
+            parm.parm.capture.timeperframe.denominator = fps_numerator;
             
+            std::string requested = std::to_string(fps_numerator) +
+                                    (fps_denominator != 1 ? "/" + std::to_string(fps_denominator) : "");
             if (ioctl(fd_, VIDIOC_S_PARM, &parm) < 0) {
-                Logger::warning("Failed to set 60fps, trying 30fps");
-                // Try 30fps if 60fps fails
-                parm.parm.capture.timeperframe.denominator = 30;
-                if (ioctl(fd_, VIDIOC_S_PARM, &parm) < 0) {
-                    Logger::warning("Failed to set frame rate");
+                // 30fps as the fallback, unless that is what failed
+                if (fps_numerator == 30 * fps_denominator) {
+                    Logger::warning("Failed to set " + requested + "fps");
+                } else {
+                    Logger::warning("Failed to set " + requested + "fps, trying 30fps");
+                    parm.parm.capture.timeperframe.numerator = 1;
+                    parm.parm.capture.timeperframe.denominator = 30;
+                    if (ioctl(fd_, VIDIOC_S_PARM, &parm) < 0) {
+                        Logger::warning("Failed to set 30fps");
+                    }
                 }
             }
             
-            // Read back what we actually got
-            if (ioctl(fd_, VIDIOC_G_PARM, &parm) == 0) {
-                Logger::info("V4L2: Actual frame rate set to " + 
-                           std::to_string(parm.parm.capture.timeperframe.denominator) + "/" +
-                           std::to_string(parm.parm.capture.timeperframe.numerator) + " fps");
-            }
         } else {
             Logger::warning("Device does not support frame rate setting");
         }
     }
     
+    // Read back what we actually got and pace on it
+    v4l2_fract interval;
+    if (queryFrameInterval(interval)) {
+        video_format_.fps_numerator = interval.denominator;
+        video_format_.fps_denominator = interval.numerator;
+        pacer_.setInterval(interval.numerator, interval.denominator);
+        Logger::info("V4L2: Actual frame rate " + 
+                   std::to_string(interval.denominator) + "/" +
+                   std::to_string(interval.numerator) + " fps, frame interval " +
+                   std::to_string(pacer_.getIntervalNs() / 1000) + "µs");
+    } else {
+        pacer_.setInterval(video_format_.fps_denominator, video_format_.fps_numerator);
+        Logger::warning("V4L2: Frame interval unknown, pacing at " +
+                       std::to_string(video_format_.fps_numerator) + "/" +
+                       std::to_string(video_format_.fps_denominator) + " fps");
+    }
+    
     Logger::info("V4L2Capture: Set format to " + std::to_string(video_format_.width) + 
                "x" + std::to_string(video_format_.height) + " " + 
                pixelFormatToString(pixelformat) +
@@ -840,9 +1837,142 @@ bool V4L2Capture::setCaptureFormat(int width, int height, uint32_t pixelformat)
     return true;
 }
 
+bool V4L2Capture::applyCachedFormat() {
+    if (!format_cache_) {
+        return false;
+    }
+    
+    std::string driver = reinterpret_cast<const char*>(device_caps_.driver);
+    std::string bus_info = reinterpret_cast<const char*>(device_caps_.bus_info);
+    const V4L2FormatCache::Entry* entry = format_cache_->find(driver, bus_info);
+    if (!entry || !entry->has_mode) {
+        return false;
+    }
+    if (entry->selection != selectionSettings(profile_)) {
+        Logger::info("V4L2Capture: Cached mode was selected with '" + entry->selection +
+                     "', now '" + selectionSettings(profile_) + "', enumerating formats");
+        return false;
+    }
+    
+    const V4L2FormatCache::Mode& mode = entry->mode;
+    if (!setCaptureFormat(mode.width, mode.height, mode.pixelformat, mode.fps_numerator, mode.fps_denominator) ||
+        current_format_.fmt.pix.width != mode.width ||
+        current_format_.fmt.pix.height != mode.height ||
+        current_format_.fmt.pix.pixelformat != mode.pixelformat) {
+        Logger::info("V4L2Capture: Cached mode " + pixelFormatToString(mode.pixelformat) + " " +
+                     std::to_string(mode.width) + "x" + std::to_string(mode.height) +
+                     " rejected by driver, enumerating formats");
+        return false;
+    }
+    
+    Logger::info("V4L2Capture: Using cached mode " + pixelFormatToString(mode.pixelformat) + " " +
+                 std::to_string(mode.width) + "x" + std::to_string(mode.height) +
+                 " (" + std::to_string(entry->formats.size()) + " formats cached, enumeration skipped)");
+    return true;
+}
+
+void V4L2Capture::updateFormatCache() {
+    if (!format_cache_) {
+        return;
+    }
+    
+    V4L2FormatCache::Entry entry;
+    entry.driver = reinterpret_cast<const char*>(device_caps_.driver);
+    entry.bus_info = reinterpret_cast<const char*>(device_caps_.bus_info);
+    entry.card = reinterpret_cast<const char*>(device_caps_.card);
+    entry.device_path = device_path_;
+    
+    // Keep the previously enumerated list when this start used the cache
+    if (!enumerated_formats_.empty()) {
+        for (const auto& fmt : enumerated_formats_) {
+            V4L2FormatCache::Mode mode;
+            mode.pixelformat = fmt.pixelformat;
+            mode.width = fmt.width;
+            mode.height = fmt.height;
+            mode.fps_numerator = fmt.fps;
+            entry.formats.push_back(mode);
+        }
+    } else if (const auto* old = format_cache_->find(entry.driver, entry.bus_info)) {
+        entry.formats = old->formats;
+    }
+    
+    entry.has_mode = true;
+    entry.mode.pixelformat = current_format_.fmt.pix.pixelformat;
+    entry.mode.width = current_format_.fmt.pix.width;
+    entry.mode.height = current_format_.fmt.pix.height;
+    entry.selection = selectionSettings(profile_);
+    entry.mode.fps_numerator = video_format_.fps_denominator > 0 ? video_format_.fps_numerator : 0;
+    entry.mode.fps_denominator = video_format_.fps_denominator > 0 ? video_format_.fps_denominator : 1;
+    
+    format_cache_->update(entry);
+    format_cache_->save();
+}
+
+void V4L2Capture::startRecording() {
+    if (profile_.record_path.empty() || recorder_) {
+        return;
+    }
+    
+    // Never overwrite an earlier recording (recovery restarts capture)
+    std::string path = profile_.record_path;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        dot = path.size();
+    }
+    for (int n = 1; access(path.c_str(), F_OK) == 0; n++) {
+        path = profile_.record_path.substr(0, dot) + "-" + std::to_string(n) +
+               profile_.record_path.substr(dot);
+    }
+    
+    FrameRecorder::Format format;
+    format.width = current_format_.fmt.pix.width;
+    format.height = current_format_.fmt.pix.height;
+    format.pixelformat = current_format_.fmt.pix.pixelformat;
+    format.bytesperline = current_format_.fmt.pix.bytesperline;
+    format.max_frame_size = current_format_.fmt.pix.sizeimage;
+    format.fps_numerator = video_format_.fps_numerator;
+    format.fps_denominator = video_format_.fps_denominator;
+    
+    recorder_ = std::make_unique<FrameRecorder>();
+    if (!recorder_->start(path, format, profile_.record_frames)) {
+        Logger::warning("V4L2Capture: Recording disabled, cannot record to " + path);
+        recorder_.reset();
+    }
+}
+
+void V4L2Capture::stopRecording() {
+    if (!recorder_) {
+        return;
+    }
+    recorder_->stop();
+    recorder_.reset();
+}
+
+std::string V4L2Capture::findCachedDeviceByName(const std::string& name) {
+    if (!format_cache_) {
+        return "";
+    }
+    
+    const V4L2FormatCache::Entry* entry = format_cache_->findByName(name);
+    if (!entry) {
+        return "";
+    }
+    
+    // The node may now belong to another device - confirm with one QUERYCAP
+    V4L2DeviceInfo info = V4L2DeviceEnumerator::getDeviceInfo(entry->device_path);
+    if (info.path.empty() || info.driver != entry->driver || info.bus_info != entry->bus_info) {
+        return "";
+    }
+    
+    Logger::info("V4L2Capture: Found '" + name + "' at cached path " + entry->device_path);
+    return entry->device_path;
+}
+
 bool V4L2Capture::findBestFormat() {
     std::vector<SupportedFormat> formats;
     enumerateFormats(formats);
+    enumerated_formats_ = formats;
     
     if (formats.empty()) {
         setError("No supported formats found");
@@ -857,28 +1987,51 @@ bool V4L2Capture::findBestFormat() {
                    " @" + std::to_string(fmt.fps) + "fps");
     }
     
-    // Try formats in NDI-optimized priority order
-    for (uint32_t priority_format : kFormatPriority) {
-        for (const auto& fmt : formats) {
-            if (fmt.pixelformat == priority_format) {
-                // Found a preferred format
-                if (setCaptureFormat(fmt.width, fmt.height, fmt.pixelformat)) {
-                    Logger::info("Selected OPTIMAL format: " + pixelFormatToString(fmt.pixelformat) +
-                               " " + std::to_string(fmt.width) + "x" + std::to_string(fmt.height) +
-                               " @" + std::to_string(fmt.fps) + "fps");
-                    
-                    // Log zero-copy capability
-                    if (fmt.pixelformat == V4L2_PIX_FMT_UYVY || 
-                        fmt.pixelformat == V4L2_PIX_FMT_YUYV) {
-                        Logger::info("Zero-copy mode enabled for " + 
-                                   pixelFormatToString(fmt.pixelformat) + 
-                                   " (direct to NDI without conversion)");
-                    }
-                    
-                    return true;
-                }
-            }
+    // Rank by resolution, fps and conversion cost (profile policy)
+    std::vector<FormatCandidate> candidates;
+    candidates.reserve(formats.size());
+    for (const auto& fmt : formats) {
+        FormatCandidate candidate;
+        candidate.pixelformat = fmt.pixelformat;
+        candidate.width = fmt.width;
+        candidate.height = fmt.height;
+        candidate.fps = fmt.fps;
+        candidates.push_back(candidate);
+    }
+    
+    FormatSelector selector(profile_.format_policy, profile_.prefer_10bit);
+    std::vector<FormatCandidate> ranked = selector.rank(candidates);
+    
+    Logger::info("Format ranking (policy " + std::string(formatPolicyToString(profile_.format_policy)) + "):");
+    for (size_t i = 0; i < ranked.size() && i < 5; i++) {
+        const auto& c = ranked[i];
+        std::ostringstream line;
+        line.setf(std::ios::fixed);
+        line.precision(2);
+        line << "  #" << (i + 1) << " " << pixelFormatToString(c.pixelformat) << " "
+             << c.width << "x" << c.height << " @" << c.fps << "fps, "
+             << c.cost_ns_per_pixel << " ns/pixel, score " << (c.score / 1e6) << "M";
+        Logger::info(line.str());
+    }
+    
+    for (const auto& c : ranked) {
+        if (!setCaptureFormat(c.width, c.height, c.pixelformat, c.fps)) {
+            continue;
+        }
+        
+        Logger::info("Selected format: " + pixelFormatToString(c.pixelformat) +
+                   " " + std::to_string(c.width) + "x" + std::to_string(c.height) +
+                   " @" + std::to_string(c.fps) + "fps");
+        
+        // Log zero-copy capability
+        if (c.pixelformat == V4L2_PIX_FMT_UYVY || 
+            c.pixelformat == V4L2_PIX_FMT_YUYV) {
+            Logger::info("Zero-copy mode enabled for " + 
+                       pixelFormatToString(c.pixelformat) + 
+                       " (direct to NDI without conversion)");
         }
+        
+        return true;
     }
     
     // Fallback to first available format
@@ -980,20 +2133,31 @@ ICaptureDevice::VideoFormat V4L2Capture::convertFormat(const v4l2_format& fmt) c
     fourcc[3] = (fmt.fmt.pix.pixelformat >> 24) & 0xFF;
     format.pixel_format = std::string(fourcc);
     
-    // Get frame rate
-    v4l2_streamparm parm;
-    memset(&parm, 0, sizeof(parm));
-    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    // Single-planar 4:2:0 buffers: chroma follows bytesperline * height luma
+    // bytes; the I420/YV12 chroma pitch is half the luma pitch
+    switch (fmt.fmt.pix.pixelformat) {
+        case V4L2_PIX_FMT_NV12:
+            format.chroma_offset = format.stride * format.height;
+            format.chroma_stride = format.stride;
+            break;
+        case V4L2_PIX_FMT_YUV420:
+            format.pixel_format = "I420";
+            format.chroma_offset = format.stride * format.height;
+            format.chroma_stride = format.stride / 2;
+            break;
+        case V4L2_PIX_FMT_YVU420:
+            format.chroma_offset = format.stride * format.height;
+            format.chroma_stride = format.stride / 2;
+            break;
+        default:
+            break;
+    }
     
-    if (ioctl(fd_, VIDIOC_G_PARM, &parm) == 0) {
-        if (parm.parm.capture.timeperframe.denominator > 0 && 
-            parm.parm.capture.timeperframe.numerator > 0) {
-            format.fps_numerator = parm.parm.capture.timeperframe.denominator;
-            format.fps_denominator = parm.parm.capture.timeperframe.numerator;
-        } else {
-            format.fps_numerator = 30;
-            format.fps_denominator = 1;
-        }
+    // Get frame rate
+    v4l2_fract interval;
+    if (queryFrameInterval(interval)) {
+        format.fps_numerator = interval.denominator;
+        format.fps_denominator = interval.numerator;
     } else {
         // Default to 30 fps
         format.fps_numerator = 30;
@@ -1003,12 +2167,59 @@ ICaptureDevice::VideoFormat V4L2Capture::convertFormat(const v4l2_format& fmt) c
     return format;
 }
 
+bool V4L2Capture::queryFrameInterval(v4l2_fract& interval) const {
+    // Streaming parameters first (USB/UVC devices)
+    v4l2_streamparm parm;
+    memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    
+    if (ioctl(fd_, VIDIOC_G_PARM, &parm) == 0 &&
+        parm.parm.capture.timeperframe.numerator > 0 &&
+        parm.parm.capture.timeperframe.denominator > 0) {
+        interval = parm.parm.capture.timeperframe;
+        return true;
+    }
+    
+    // HDMI receivers report the incoming signal through DV timings
+    v4l2_dv_timings timings;
+    memset(&timings, 0, sizeof(timings));
+    if (ioctl(fd_, VIDIOC_G_DV_TIMINGS, &timings) == 0 &&
+        timings.type == V4L2_DV_BT_656_1120) {
+        const v4l2_bt_timings& bt = timings.bt;
+        uint64_t frame_size = static_cast<uint64_t>(V4L2_DV_BT_FRAME_WIDTH(&bt)) *
+                              V4L2_DV_BT_FRAME_HEIGHT(&bt);
+        if (frame_size > 0 && bt.pixelclock > 0) {
+            // Seconds per frame = frame_size / pixelclock (x1001/1000 for 59.94 etc.)
+            bool reduced = (bt.flags & V4L2_DV_FL_REDUCED_FPS) != 0;
+            uint64_t numerator = frame_size * (reduced ? 1001 : 1000);
+            uint64_t denominator = bt.pixelclock * 1000;
+            uint64_t divisor = std::gcd(numerator, denominator);
+            numerator /= divisor;
+            denominator /= divisor;
+            // Scale down to fit the 32-bit fraction
+            while (numerator > 0xFFFFFFFFULL || denominator > 0xFFFFFFFFULL) {
+                numerator /= 2;
+                denominator /= 2;
+            }
+            interval.numerator = static_cast<uint32_t>(numerator);
+            interval.denominator = static_cast<uint32_t>(denominator);
+            return interval.numerator > 0 && interval.denominator > 0;
+        }
+    }
+    
+    return false;
+}
+
 std::string V4L2Capture::pixelFormatToString(uint32_t format) const {
     switch (format) {
         case V4L2_PIX_FMT_UYVY: return "UYVY";
         case V4L2_PIX_FMT_YUYV: return "YUYV";
         case V4L2_PIX_FMT_NV12: return "NV12";
         case V4L2_PIX_FMT_YUV420: return "YUV420";
+        case V4L2_PIX_FMT_YVU420: return "YVU420";
+        case V4L2_PIX_FMT_V210: return "v210";
+        case V4L2_PIX_FMT_Y210: return "Y210";
+        case V4L2_PIX_FMT_P010: return "P010";
         case V4L2_PIX_FMT_MJPEG: return "MJPEG";
         case V4L2_PIX_FMT_H264: return "H264";
         case V4L2_PIX_FMT_RGB24: return "RGB24";
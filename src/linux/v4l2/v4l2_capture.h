@@ -2,8 +2,18 @@
 #pragma once
 
 #include "../../common/capture_interface.h"
+#include "../../common/frame_queue.h"
+#include "../../common/pipeline_thread_pool.h"
+#include "../../common/frame_recording.h"
 #include "v4l2_device_enumerator.h"
 #include "v4l2_format_converter.h"
+#include "v4l2_p216_packer.h"
+#include "v4l2_yuyv_swizzler.h"
+#include "v4l2_mjpeg_decoder.h"
+#include "v4l2_capture_profile.h"
+#include "v4l2_frame_pacer.h"
+#include "v4l2_format_cache.h"
+#include "v4l2_format_selector.h"
 #include <memory>
 #include <string>
 #include <atomic>
@@ -20,21 +30,58 @@ namespace v4l2 {
 /**
  * @brief V4L2 implementation of ICaptureDevice - EXTREME LOW LATENCY VERSION
  * 
- * Version: 2.1.0 - Extreme low latency with busy-wait and CPU affinity
- * - ALWAYS 2 buffers (absolute minimum)
+ * Version: 2.14.2 - dma-buf CPU access ends with the last buffer owner
+ * - DMA_BUF_SYNC_END waits for the async NDI release instead of following
+ *   the send call
+ * 
+ * Version: 2.14.1 - Paced timerfd mode keeps a bounded poll timeout
+ * - A streaming device that delivers no frame no longer blocks stopCapture()
+ * 
+ * Version: 2.14.0 - YUYV swapped to UYVY inside the capture buffer
+ * - NDI reads YUYV captures in place as UYVY; no separate output frame.
+ *   Frames being recorded keep their bytes and go through the sender's copy
+ * 
+ * Version: 2.13.0 - Asynchronous NDI send with deferred buffer release
+ * - Frames read in place carry a release (profile.async_send, 3+ buffers);
+ *   the buffer is requeued once NDI's async send is done with it, so the
+ *   next frame is dequeued while NDI still compresses the current one
+ * 
+ * Version: 2.12.0 - MJPEG capture decoded to UYVY
+ * - MJPEG is decoded with libjpeg-turbo straight to UYVY, sliced at
+ *   restart markers across cores; in pipelined mode the capture thread
+ *   decodes the next frame while the send stage sends the previous one
+ * 
+ * Version: 2.11.0 - 10-bit capture (v210, Y210, P010 -> NDI P216)
+ * - 10-bit formats keep their precision: repacked to P216 with AVX2
+ *   kernels instead of being truncated through BGRA
+ * - NV12 / YUV420 / YVU420 reach NDI as captured with their plane layout
+ *   in VideoFormat; no BGRA conversion
+ * - Buffer count, pacing, RT priority and CPU affinity come from a
+ *   CaptureProfile ("ultra-low-latency", "balanced", "4K-throughput")
+ * - Pacing follows the negotiated frame interval (G_PARM / DV timings)
+ *   with a timerfd deadline instead of a fixed 60 fps clock
+ * - Drops counted from v4l2_buffer.sequence gaps and V4L2_BUF_FLAG_ERROR,
+ *   split into driver, userspace and NDI counters
+ * - Optional pipeline (profile.pipelined): the capture thread hands buffer
+ *   indices to a send stage on another core and requeues them when they
+ *   come back through a BufferIndexQueue - no frame copy
+ * - V4L2_EVENT_SOURCE_CHANGE reconfigures format and buffers in place;
+ *   the capture thread and the frame callback keep running
+ * - Formats and the chosen mode are cached per driver/bus_info; the cached
+ *   mode is tried before full enumeration
+ * - Modes ranked by resolution x fps against measured conversion cost
+ *   (profile.format_policy); non-YUV formats are converted to BGRA
+ * - Optional raw recording of the mmap buffers with timestamps and
+ *   sequence numbers (profile.record_path), written off the live path
  * - ALWAYS zero-copy for YUV formats
- * - ALWAYS single-threaded
- * - ALWAYS real-time priority 90
- * - ALWAYS busy-wait (no poll)
- * - ALWAYS CPU affinity
- * - NO configuration options
- * - NO compromise on latency
+ * - DMABUF (udmabuf-backed) buffers when available, dma-buf fd passed with each frame
+ * - Capture-to-send latency measured from the V4L2 kernel timestamp
  * 
  * This is an APPLIANCE, not an application.
  */
 class V4L2Capture : public ICaptureDevice {
 public:
-    V4L2Capture();
+    explicit V4L2Capture(const CaptureProfile& profile = CaptureProfile());
     ~V4L2Capture() override;
     
     // ICaptureDevice implementation ONLY
@@ -44,15 +91,21 @@ public:
     bool isCapturing() const override;
     void setFrameCallback(FrameCallback callback) override;
     void setErrorCallback(ErrorCallback callback) override;
+    void setFlushCallback(FlushCallback callback) override;
     bool hasError() const override;
     std::string getLastError() const override;
     
-    // NO PUBLIC CONFIGURATION METHODS!
+    // Configuration is fixed at construction through the CaptureProfile
+    const CaptureProfile& getProfile() const { return profile_; }
     
     // Statistics structure
     struct CaptureStats {
         uint64_t frames_captured = 0;
-        uint64_t frames_dropped = 0;
+        uint64_t frames_dropped = 0;        // Sum of the three counters below
+        uint64_t driver_dropped = 0;        // Sequence gaps / error buffers while the driver had buffers
+        uint64_t userspace_dropped = 0;     // Sequence gaps caused by our thread starving the queue
+        uint64_t ndi_dropped = 0;           // Frames the frame callback (NDI send) rejected
+        uint64_t error_buffers = 0;         // Buffers returned with V4L2_BUF_FLAG_ERROR (in driver_dropped)
         uint64_t zero_copy_frames = 0;
         double total_latency_ms = 0.0;
         double avg_e2e_latency_ms = 0.0;
@@ -69,9 +122,32 @@ public:
         double max_callback_us = 0.0;
         double max_requeue_us = 0.0;
         
+        // Capture-to-send latency: V4L2 kernel timestamp -> NDI send returned
+        double avg_capture_to_send_ms = 0.0;
+        double max_capture_to_send_ms = 0.0;
+        uint64_t capture_to_send_samples = 0;
+        
+        // Cadence: negotiated interval and deviation of V4L2 timestamps from it
+        double frame_interval_us = 0.0;
+        double avg_cadence_jitter_us = 0.0;
+        double max_cadence_jitter_us = 0.0;
+        uint64_t late_frame_wakeups = 0;
+        
+        // Pipelined mode: buffers handed to the send stage
+        uint64_t pipeline_frames = 0;
+        uint32_t max_buffers_in_flight = 0;
+        
+        // Source changes handled in place
+        uint64_t source_changes = 0;
+        double last_source_change_ms = 0.0;
+        
         void reset() {
             frames_captured = 0;
             frames_dropped = 0;
+            driver_dropped = 0;
+            userspace_dropped = 0;
+            ndi_dropped = 0;
+            error_buffers = 0;
             zero_copy_frames = 0;
             total_latency_ms = 0.0;
             avg_e2e_latency_ms = 0.0;
@@ -85,6 +161,17 @@ public:
             max_dequeue_us = 0.0;
             max_callback_us = 0.0;
             max_requeue_us = 0.0;
+            avg_capture_to_send_ms = 0.0;
+            max_capture_to_send_ms = 0.0;
+            capture_to_send_samples = 0;
+            frame_interval_us = 0.0;
+            avg_cadence_jitter_us = 0.0;
+            max_cadence_jitter_us = 0.0;
+            late_frame_wakeups = 0;
+            pipeline_frames = 0;
+            max_buffers_in_flight = 0;
+            source_changes = 0;
+            last_source_change_ms = 0.0;
         }
     };
     
@@ -92,18 +179,14 @@ public:
     CaptureStats getStats() const;
     
 private:
-    // HARDCODED OPTIMAL SETTINGS
-    static constexpr unsigned int kBufferCount = 4;          // Reduced for 8-frame latency
-    static constexpr int kPollTimeout = 1;                  // 1ms timeout
-    static constexpr bool kUseMultiThreading = false;        // Single thread only
+    // Settings that are not part of the profile
     static constexpr bool kZeroCopyMode = true;              // Always zero-copy
-    static constexpr int kRealtimePriority = 90;             // Maximum RT priority
-    static constexpr int kCpuAffinity = -1;                   // Disabled for testing
     
     // Buffer structure
     struct Buffer {
         void* start = nullptr;
         size_t length = 0;
+        int dmabuf_fd = -1;   // Exported (MMAP) or allocated (DMABUF) dma-buf
     };
     
     // Supported format info
@@ -123,9 +206,15 @@ private:
     // Setup buffers
     bool setupBuffers();
     
-    // Try to setup DMABUF
+    // Try to setup DMABUF (udmabuf-backed buffers queued as V4L2_MEMORY_DMABUF)
     bool trySetupDMABUF();
     
+    // Export MMAP buffers as dma-buf fds (VIDIOC_EXPBUF)
+    void exportMMAPBuffers();
+    
+    // Bracket CPU access to a DMABUF buffer (DMA_BUF_IOCTL_SYNC)
+    void syncDMABUF(const Buffer& buffer, bool start);
+    
     // Cleanup buffers
     void cleanupBuffers();
     
@@ -135,12 +224,55 @@ private:
     // Stop streaming
     void stopStreaming();
     
+    // Return a dequeued buffer to the driver
+    bool requeueBuffer(v4l2_buffer& v4l2_buf);
+    
+    // Account frames lost before this buffer (sequence gap, error flag)
+    void trackSequence(const v4l2_buffer& v4l2_buf, int64_t frame_age_ns, uint32_t cadence_gap);
+    
     // Main capture thread - single-threaded ultra-low latency
     void captureThreadSingle();
     
     // EXTREME capture thread - busy-wait with CPU affinity
     void captureThreadExtreme();
     
+    // Subscribe to V4L2_EVENT_SOURCE_CHANGE (HDMI receivers)
+    void subscribeSourceChange();
+    
+    // Dequeue pending V4L2 events; sets reconfigured after a source change
+    bool processEvents(bool& reconfigured);
+    
+    // Stop streaming, re-run format setup and reallocate buffers only
+    bool handleSourceChange();
+    
+    // Pipelined mode: start/stop the send stage
+    bool startPipeline();
+    void stopPipeline();
+    
+    // Release path for buffers finished off the capture thread (send stage, async NDI send)
+    bool startReleaseQueue();
+    void stopReleaseQueue();
+    
+    // Drop one owner of a dequeued buffer; the last one queues it for requeue (any thread)
+    void releaseBuffer(uint32_t index);
+    
+    // Ask the frame consumer to release every buffer it still holds
+    void flushConsumer();
+    
+    // Pipelined mode: send stage thread (NDI send off the capture core)
+    void sendStageThread();
+    
+    // Pipelined mode: hand a dequeued buffer to the send stage
+    bool dispatchToPipeline(const v4l2_buffer& v4l2_buf,
+                            std::chrono::steady_clock::time_point capture_time);
+    
+    // Requeue buffers returned through release_queue_
+    bool drainReleasedBuffers();
+    
+    // MJPEG frame to UYVY; false (and counted as dropped) if it does not decode
+    bool decodeMjpeg(const Buffer& buffer, const v4l2_buffer& v4l2_buf,
+                     std::vector<uint8_t>& output);
+    
     // Direct send without conversion (zero-copy path)
     void sendFrameDirect(const Buffer& buffer, const v4l2_buffer& v4l2_buf);
     
@@ -152,12 +284,30 @@ private:
     void processFrame(const Buffer& buffer, const v4l2_buffer& v4l2_buf, 
                       std::vector<uint8_t>& bgra_buffer);
     
-    // Set capture format
-    bool setCaptureFormat(int width, int height, uint32_t pixelformat);
+    // Read the negotiated frame interval (seconds per frame)
+    bool queryFrameInterval(v4l2_fract& interval) const;
+    
+    // Set capture format at fps_numerator/fps_denominator frames per second
+    // (0 = highest of 60/30 the driver accepts)
+    bool setCaptureFormat(int width, int height, uint32_t pixelformat,
+                          uint32_t fps_numerator = 0, uint32_t fps_denominator = 1);
     
     // Find best format
     bool findBestFormat();
     
+    // Apply the mode cached for this device; false if absent or rejected
+    bool applyCachedFormat();
+    
+    // Record formats, chosen mode and path for the next start
+    void updateFormatCache();
+    
+    // Raw frame recording (profile.record_path)
+    void startRecording();
+    void stopRecording();
+    
+    // Resolve a device name through the cache (opens one node, not all)
+    std::string findCachedDeviceByName(const std::string& name);
+    
     // Enumerate formats
     void enumerateFormats(std::vector<SupportedFormat>& formats);
     
@@ -173,6 +323,9 @@ private:
     // Apply EXTREME real-time settings
     void applyExtremeRealtimeSettings();
     
+    // Size the shared StripeExecutor from the profile (before its first use)
+    void configureConvertThreads();
+    
     // Convert pixel format to string
     std::string pixelFormatToString(uint32_t format) const;
     
@@ -180,6 +333,9 @@ private:
     void setError(const std::string& error);
     
 private:
+    // Active latency/throughput profile
+    CaptureProfile profile_;
+    
     // Device file descriptor
     int fd_;
     
@@ -192,7 +348,7 @@ private:
     // Memory-mapped buffers
     std::vector<Buffer> buffers_;
     
-    // Buffer type (MMAP or DMABUF)
+    // Buffer memory type (V4L2_MEMORY_MMAP or V4L2_MEMORY_DMABUF)
     uint32_t buffer_type_;
     
     // DMABUF support flag
@@ -202,8 +358,20 @@ private:
     v4l2_format current_format_;
     VideoFormat video_format_;
     
-    // Format converter
+    // Format converter for modes NDI cannot take as captured (send path only)
     std::unique_ptr<V4L2FormatConverter> format_converter_;
+    std::vector<uint8_t> bgra_buffer_;
+    
+    // 10-bit formats are repacked to NDI P216 instead
+    std::unique_ptr<P216Packer> p216_packer_;
+    std::unique_ptr<YuyvSwizzler> yuyv_swizzler_;
+    std::vector<uint8_t> p216_buffer_;
+    
+    // MJPEG is decoded to UYVY (per in-flight buffer when pipelined)
+    std::unique_ptr<MjpegDecoder> mjpeg_decoder_;
+    std::vector<uint8_t> mjpeg_buffer_;
+    bool mjpeg_error_logged_ = false;
+    bool mjpeg_slices_logged_ = false;
     
     // Single capture thread
     std::unique_ptr<std::thread> capture_thread_;
@@ -219,6 +387,7 @@ private:
     mutable std::mutex callback_mutex_;
     FrameCallback frame_callback_;
     ErrorCallback error_callback_;
+    FlushCallback flush_callback_;
     
     // Device capabilities
     v4l2_capability device_caps_;
@@ -230,15 +399,6 @@ private:
     mutable std::mutex stats_mutex_;
     CaptureStats stats_;
     
-    // These member variables are used in constructor but not needed in header
-    // They are replaced by static constexpr values
-    bool use_multi_threading_;
-    bool zero_copy_mode_;
-    bool realtime_scheduling_;
-    int realtime_priority_;
-    bool low_latency_mode_;
-    bool ultra_low_latency_mode_;
-    
     // Statistics (minimal) - kept for compatibility
     std::atomic<uint64_t> frames_captured_{0};
     std::atomic<uint64_t> frames_dropped_{0};
@@ -247,18 +407,55 @@ private:
     // Disconnect detection
     uint32_t timeout_count_ = 0;
     
+    // Cadence tracking against the negotiated frame interval
+    FramePacer pacer_;
+    
+    // Last v4l2_buffer.sequence seen since STREAMON
+    uint32_t last_sequence_ = 0;
+    bool have_sequence_ = false;
+    
+    // Dequeued buffer state, indexed by V4L2 buffer index. Written by the
+    // capture thread before the index is pushed, read by the send stage
+    // after it is popped (queue atomics order the access). A buffer goes
+    // back to the capture thread when its last owner (send stage or capture
+    // thread, plus the consumer while it holds a release) drops it.
+    struct InflightBuffer {
+        v4l2_buffer v4l2_buf;
+        std::chrono::steady_clock::time_point capture_time;
+        std::vector<uint8_t> decoded;   // MJPEG decoded by the capture stage
+        std::atomic<int> owners{0};
+    };
+    std::vector<InflightBuffer> inflight_;
+    std::unique_ptr<FrameQueue> send_queue_;           // capture -> send (reference queue)
+    std::unique_ptr<BufferIndexQueue> release_queue_;  // owners -> capture (release_mutex_ for pushes)
+    std::mutex release_mutex_;
+    bool async_release_ = false;  // Frames read in place carry a release
+    std::unique_ptr<PipelineThreadPool> pipeline_pool_;
+    size_t send_thread_id_ = 0;
+    int send_event_fd_ = -1;      // Wakes the send stage
+    int release_event_fd_ = -1;   // Wakes the capture thread
+    uint32_t buffers_held_ = 0;   // Dequeued and not yet requeued (capture thread only)
+    
+    // Source change handling (capture thread only once running)
+    bool source_change_subscribed_ = false;
+    bool stream_active_ = false;  // false while waiting for a signal after a change
+    
     // Zero-copy state
     bool zero_copy_logged_{false};
     
-    // Format priority for NDI optimization
-    static const std::vector<uint32_t> kFormatPriority;
+    // Per-device format cache (nullptr when disabled)
+    std::unique_ptr<V4L2FormatCache> format_cache_;
+    std::vector<SupportedFormat> enumerated_formats_;  // From the last full enumeration
+    
+    // Raw frame recorder (nullptr when not recording)
+    std::unique_ptr<FrameRecorder> recorder_;
     
-    // ALWAYS use these values
-    unsigned int getBufferCount() const { return kBufferCount; }
-    int getPollTimeout() const { return kPollTimeout; }
-    bool isMultiThreadingEnabled() const { return kUseMultiThreading; }
+    // Profile accessors
+    unsigned int getBufferCount() const { return profile_.buffer_count; }
+    int getPollTimeout() const { return profile_.poll_timeout_ms; }
+    bool isMultiThreadingEnabled() const { return profile_.pipelined; }
     bool isZeroCopyMode() const { return kZeroCopyMode; }
-    int getRealtimePriority() const { return kRealtimePriority; }
+    int getRealtimePriority() const { return profile_.realtime_priority; }
 };
 
 } // namespace v4l2
@@ -0,0 +1,271 @@
+// v4l2_capture_profile.cpp
+#include "v4l2_capture_profile.h"
+#include "../../common/logger.h"
+#include "../../common/stripe_executor.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+
+std::string trim(const std::string& value) {
+    const char* whitespace = " \t\r\n";
+    size_t start = value.find_first_not_of(whitespace);
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(whitespace);
+    return value.substr(start, end - start + 1);
+}
+
+std::string unquote(const std::string& value) {
+    if (value.size() >= 2 &&
+        ((value.front() == '"' && value.back() == '"') ||
+         (value.front() == '\'' && value.back() == '\''))) {
+        return value.substr(1, value.size() - 2);
+    }
+    return value;
+}
+
+bool parseInt(const std::string& value, int& out) {
+    try {
+        size_t pos = 0;
+        int parsed = std::stoi(value, &pos);
+        if (pos != value.size()) {
+            return false;
+        }
+        out = parsed;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool parseBool(const std::string& value, bool& out) {
+    std::string lower = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "1" || lower == "true" || lower == "yes" || lower == "on") {
+        out = true;
+        return true;
+    }
+    if (lower == "0" || lower == "false" || lower == "no" || lower == "off") {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+bool CaptureProfile::fromName(const std::string& name, CaptureProfile& profile) {
+    CaptureProfile p;
+    p.format_cache_path = profile.format_cache_path;  // Not part of the latency profile
+    p.format_policy = profile.format_policy;
+    p.prefer_10bit = profile.prefer_10bit;
+    p.record_path = profile.record_path;
+    p.record_frames = profile.record_frames;
+    p.audio_device = profile.audio_device;
+    p.timing_metadata = profile.timing_metadata;
+
+    if (name == "ultra-low-latency") {
+        // 1080p60: fewest buffers the driver accepts, spin on the device
+        p.name = name;
+        p.buffer_count = 2;
+        p.pacing = PacingPolicy::BusyWait;
+        p.poll_timeout_ms = 0;
+        p.realtime_priority = 90;
+        p.cpu_affinity = 1;
+        p.pipelined = false;
+        p.async_send = false;   // NDI holding one of two buffers would starve the driver
+    } else if (name == "balanced") {
+        // Buffer count, poll timeout and RT priority of the old fixed
+        // settings; sends are asynchronous and the format policy applies
+        // (it used to be synchronous, UYVY > YUYV > NV12 > MJPEG)
+        p.name = name;
+        p.buffer_count = 4;
+        p.pacing = PacingPolicy::Paced;
+        p.poll_timeout_ms = 1;
+        p.realtime_priority = 90;
+        p.cpu_affinity = -1;
+        p.pipelined = false;
+        p.async_send = true;
+    } else if (name == "4K-throughput") {
+        // 4K30: deeper queue so a slow NDI send does not underrun the driver
+        p.name = name;
+        p.buffer_count = 6;
+        p.pacing = PacingPolicy::Blocking;
+        p.poll_timeout_ms = 100;
+        p.realtime_priority = 80;
+        p.cpu_affinity = -1;
+        p.pipelined = true;
+        p.async_send = true;
+    } else {
+        return false;
+    }
+
+    profile = p;
+    return true;
+}
+
+bool CaptureProfile::loadFromFile(const std::string& path, CaptureProfile& profile) {
+    std::ifstream file(path);
+    if (!file) {
+        Logger::error("CaptureProfile: Cannot open config file " + path);
+        return false;
+    }
+
+    bool valid = true;
+    std::vector<std::pair<std::string, std::string>> overrides;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+
+        std::string key = trim(line.substr(0, eq));
+        std::string value = unquote(trim(line.substr(eq + 1)));
+
+        if (key == "CAPTURE_PROFILE") {
+            // Base profile first so field overrides apply on top of it
+            if (!fromName(value, profile)) {
+                Logger::error("CaptureProfile: Unknown profile '" + value + "' in " + path);
+                valid = false;
+            }
+        } else if (key.compare(0, 8, "CAPTURE_") == 0) {
+            overrides.emplace_back(key, value);
+        }
+    }
+
+    for (const auto& kv : overrides) {
+        const std::string& key = kv.first;
+        const std::string& value = kv.second;
+        int number = 0;
+        bool ok = true;
+
+        if (key == "CAPTURE_BUFFERS") {
+            ok = parseInt(value, number) && number >= 2 && number <= 32;
+            if (ok) profile.buffer_count = static_cast<unsigned int>(number);
+        } else if (key == "CAPTURE_PACING") {
+            ok = pacingPolicyFromString(value, profile.pacing);
+        } else if (key == "CAPTURE_POLL_TIMEOUT_MS") {
+            ok = parseInt(value, number) && number >= 0;
+            if (ok) profile.poll_timeout_ms = number;
+        } else if (key == "CAPTURE_RT_PRIORITY") {
+            ok = parseInt(value, number) && number >= 0 && number <= 99;
+            if (ok) profile.realtime_priority = number;
+        } else if (key == "CAPTURE_CPU_AFFINITY") {
+            ok = parseInt(value, number) && number >= -1;
+            if (ok) profile.cpu_affinity = number;
+        } else if (key == "CAPTURE_PIPELINE") {
+            ok = parseBool(value, profile.pipelined);
+        } else if (key == "CAPTURE_ASYNC_SEND") {
+            ok = parseBool(value, profile.async_send);
+        } else if (key == "CAPTURE_CONVERT_THREADS") {
+            ok = parseInt(value, number) && number >= 0 && number <= StripeExecutor::kMaxThreads;
+            if (ok) profile.convert_threads = number;
+        } else if (key == "CAPTURE_FORMAT_CACHE") {
+            // Storage location, does not make the profile custom
+            profile.format_cache_path = value;
+            continue;
+        } else if (key == "CAPTURE_FORMAT_POLICY") {
+            // Mode selection, not a latency setting either
+            if (!formatPolicyFromString(value, profile.format_policy)) {
+                Logger::error("CaptureProfile: Invalid value for " + key + ": '" + value + "'");
+                valid = false;
+            }
+            continue;
+        } else if (key == "CAPTURE_10BIT") {
+            if (!parseBool(value, profile.prefer_10bit)) {
+                Logger::error("CaptureProfile: Invalid value for " + key + ": '" + value + "'");
+                valid = false;
+            }
+            continue;
+        } else if (key == "CAPTURE_RECORD") {
+            profile.record_path = value;
+            continue;
+        } else if (key == "CAPTURE_AUDIO") {
+            profile.audio_device = (value == "none" || value == "off") ? "" : value;
+            continue;
+        } else if (key == "CAPTURE_TIMING_METADATA") {
+            if (!parseBool(value, profile.timing_metadata)) {
+                Logger::error("CaptureProfile: Invalid value for " + key + ": '" + value + "'");
+                valid = false;
+            }
+            continue;
+        } else if (key == "CAPTURE_RECORD_FRAMES") {
+            if (parseInt(value, number) && number > 0) {
+                profile.record_frames = static_cast<unsigned int>(number);
+            } else {
+                Logger::error("CaptureProfile: Invalid value for " + key + ": '" + value + "'");
+                valid = false;
+            }
+            continue;
+        } else {
+            // Other CAPTURE_* keys belong to other components
+            continue;
+        }
+
+        if (!ok) {
+            Logger::error("CaptureProfile: Invalid value for " + key + ": '" + value + "'");
+            valid = false;
+        } else if (profile.name.find(" (custom)") == std::string::npos) {
+            profile.name += " (custom)";
+        }
+    }
+
+    return valid;
+}
+
+std::vector<std::string> CaptureProfile::builtinNames() {
+    return {"ultra-low-latency", "balanced", "4K-throughput"};
+}
+
+std::string CaptureProfile::describe() const {
+    std::ostringstream ss;
+    ss << "'" << name << "': " << buffer_count << " buffers, pacing="
+       << pacingPolicyToString(pacing) << ", poll timeout " << poll_timeout_ms << "ms"
+       << ", RT priority " << realtime_priority
+       << ", CPU affinity " << (cpu_affinity < 0 ? std::string("none") : std::to_string(cpu_affinity))
+       << ", pipeline " << (pipelined ? "on" : "off")
+       << ", async send " << (async_send ? "on" : "off")
+       << ", convert threads " << (convert_threads == 0 ? std::string("auto") : std::to_string(convert_threads))
+       << ", format policy " << formatPolicyToString(format_policy)
+       << (prefer_10bit ? " (10-bit preferred)" : "")
+       << ", audio " << (audio_device.empty() ? std::string("off") : audio_device);
+    return ss.str();
+}
+
+const char* pacingPolicyToString(PacingPolicy pacing) {
+    switch (pacing) {
+        case PacingPolicy::Paced: return "paced";
+        case PacingPolicy::Blocking: return "blocking";
+        case PacingPolicy::BusyWait: return "busy-wait";
+    }
+    return "paced";
+}
+
+bool pacingPolicyFromString(const std::string& value, PacingPolicy& pacing) {
+    if (value == "paced") {
+        pacing = PacingPolicy::Paced;
+    } else if (value == "blocking") {
+        pacing = PacingPolicy::Blocking;
+    } else if (value == "busy-wait" || value == "busy") {
+        pacing = PacingPolicy::BusyWait;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,95 @@
+// v4l2_capture_profile.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include "v4l2_format_selector.h"
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief How the capture thread waits for the next frame
+ */
+enum class PacingPolicy {
+    Paced,      // Sleep until the frame or a timerfd deadline from the frame interval
+    Blocking,   // poll() until the driver signals a frame (lowest CPU)
+    BusyWait    // poll() with zero timeout (lowest wake-up latency, 100% core)
+};
+
+/**
+ * @brief Named latency/throughput profile for V4L2Capture
+ *
+ * Replaces the former compile-time constants so a box can be tuned per
+ * venue without rebuilding. Profiles are selected with --profile or from a
+ * KEY=VALUE config file (the same format as /etc/media-bridge/config).
+ *
+ * Version: 1.2.0
+ */
+struct CaptureProfile {
+    std::string name = "balanced";
+    unsigned int buffer_count = 4;              // V4L2 buffers requested
+    PacingPolicy pacing = PacingPolicy::Paced;
+    int poll_timeout_ms = 1;                    // Default poll() timeout
+    int realtime_priority = 90;                 // SCHED_FIFO priority (0 disables)
+    int cpu_affinity = -1;                      // Capture thread core (-1 = no affinity)
+    bool pipelined = false;                     // Hand frames to a separate send stage
+    bool async_send = true;                     // Buffers stay with NDI until its async send is done
+    int convert_threads = 0;                    // Striped conversion threads (0 = auto, 1 = off)
+    std::string format_cache_path =             // Per-device format cache ("" disables)
+        "/var/lib/media-bridge/v4l2-format-cache";
+    FormatPolicy format_policy = FormatPolicy::Score;  // How findBestFormat ranks modes
+    bool prefer_10bit = false;                  // Rank 10-bit formats ahead of 8-bit ones
+    std::string record_path;                    // Raw frame recording (.mbrec, "" disables)
+    std::string audio_device = "auto";          // Embedded audio: "auto", ALSA PCM, "" disables
+    unsigned int record_frames = 1800;          // Recording length limit in frames
+    bool timing_metadata = true;                // Capture/send timestamps in NDI frame metadata
+
+    /**
+     * @brief Look up a built-in profile
+     * @param name "ultra-low-latency", "balanced" or "4K-throughput"
+     * @param profile Output profile
+     * @return true if the name is known
+     */
+    static bool fromName(const std::string& name, CaptureProfile& profile);
+
+    /**
+     * @brief Apply CAPTURE_* keys from a KEY=VALUE config file
+     *
+     * CAPTURE_PROFILE selects the base profile; CAPTURE_BUFFERS,
+     * CAPTURE_PACING, CAPTURE_POLL_TIMEOUT_MS, CAPTURE_RT_PRIORITY,
+     * CAPTURE_CPU_AFFINITY, CAPTURE_PIPELINE, CAPTURE_ASYNC_SEND and
+     * CAPTURE_CONVERT_THREADS override single fields.
+     * CAPTURE_FORMAT_CACHE sets the format cache file (empty disables it)
+     * and CAPTURE_FORMAT_POLICY the mode selection (score, native, priority);
+     * CAPTURE_10BIT prefers 10-bit formats (HDR sources).
+     * CAPTURE_RECORD and CAPTURE_RECORD_FRAMES record raw frames to a file.
+     * CAPTURE_AUDIO selects the audio input ("auto", an ALSA PCM, or "none").
+     * CAPTURE_TIMING_METADATA (1/0) attaches per-frame timestamps for
+     * end-to-end latency measurement.
+     *
+     * @param path Config file path
+     * @param profile Profile to update in place
+     * @return true if the file was read and all keys were valid
+     */
+    static bool loadFromFile(const std::string& path, CaptureProfile& profile);
+
+    /**
+     * @brief Names of the built-in profiles
+     */
+    static std::vector<std::string> builtinNames();
+
+    /**
+     * @brief One-line human readable summary for logging
+     */
+    std::string describe() const;
+};
+
+/**
+ * @brief Convert pacing policy to/from its config string
+ */
+const char* pacingPolicyToString(PacingPolicy pacing);
+bool pacingPolicyFromString(const std::string& value, PacingPolicy& pacing);
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,378 @@
+// v4l2_format_benchmark.cpp
+#include "v4l2_format_benchmark.h"
+#include "v4l2_format_converter.h"
+#include "v4l2_p216_packer.h"
+#include "v4l2_mjpeg_decoder.h"
+#include "v4l2_yuyv_swizzler.h"
+#include "../../common/frame_scaler.h"
+#include "../../common/pixel_kernels.h"
+#include "../../common/stripe_executor.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+
+// Share of the frame interval a conversion may take (FormatSelector's budget)
+constexpr double kBudgetFraction = 0.5;
+
+// Untimed runs so page faults and frequency ramp-up stay out of the numbers
+constexpr int kWarmupFrames = 10;
+
+// Monitor the display fallback scales to
+constexpr int kDisplayWidth = 3840;
+constexpr int kDisplayHeight = 2160;
+
+// Deterministic noise so no kernel sees a trivially constant frame
+std::vector<uint8_t> makeInput(size_t size) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = 0x12345678u;
+    for (auto& byte : data) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    return data;
+}
+
+// Capture-card-like MJPEG: smooth gradients with light noise, 4:2:2,
+// a restart marker on every MCU row
+std::vector<uint8_t> makeMjpegInput(int width, int height) {
+    std::vector<uint8_t> uyvy(MjpegDecoder::calculateUYVYSize(width, height));
+    uint32_t state = 0x12345678u;
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = uyvy.data() + static_cast<size_t>(y) * width * 2;
+        for (int x = 0; x < width; x++) {
+            state = state * 1664525u + 1013904223u;
+            int noise = static_cast<int>(state >> 29) - 4;
+            int luma = 16 + ((x + y) * 219) / (width + height) + noise;
+            row[x * 2] = static_cast<uint8_t>((x & 1) ? 128 + (y * 64) / height : 96 + (x * 64) / width);
+            row[x * 2 + 1] = static_cast<uint8_t>(std::min(235, std::max(16, luma)));
+        }
+    }
+    std::vector<uint8_t> jpeg;
+    MjpegDecoder::encodeUYVY(uyvy.data(), width, height, 85, 1, jpeg);
+    return jpeg;
+}
+
+// Kernel sets from the selected tier down to scalar, highest first
+std::vector<PixelKernels> tiersFromActive() {
+    std::vector<PixelKernels> tiers;
+    for (int isa = static_cast<int>(PixelKernels::active().isa); isa >= 0; isa--) {
+        tiers.push_back(PixelKernels::forIsa(static_cast<CpuIsa>(isa)));
+    }
+    return tiers;
+}
+
+std::string withIsa(const std::string& name, CpuIsa isa, int threads = 1) {
+    std::string label = name + " (" + PixelKernels::isaName(isa);
+    if (threads > 1) {
+        label += ", " + std::to_string(threads) + " threads";
+    }
+    return label + ")";
+}
+
+bool parseNumber(const std::string& text, int& value) {
+    if (text.empty() || text.size() > 6 ||
+        !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    value = std::stoi(text);
+    return true;
+}
+
+} // anonymous namespace
+
+FormatBenchmark::FormatBenchmark(const Config& config)
+    : config_(config) {
+}
+
+bool FormatBenchmark::parseSpec(const std::string& spec, Config& config) {
+    size_t x_pos = spec.find('x');
+    size_t at_pos = spec.find('@');
+    if (x_pos == std::string::npos || (at_pos != std::string::npos && at_pos < x_pos)) {
+        return false;
+    }
+
+    int width = 0;
+    int height = 0;
+    int fps = static_cast<int>(config.fps);
+    if (!parseNumber(spec.substr(0, x_pos), width) ||
+        !parseNumber(spec.substr(x_pos + 1, at_pos == std::string::npos ? std::string::npos : at_pos - x_pos - 1),
+                     height) ||
+        (at_pos != std::string::npos && !parseNumber(spec.substr(at_pos + 1), fps))) {
+        return false;
+    }
+    if (width < 16 || height < 16 || (width & 1) || fps <= 0 || fps > 240) {
+        return false;
+    }
+
+    config.width = width;
+    config.height = height;
+    config.fps = static_cast<uint32_t>(fps);
+    return true;
+}
+
+bool FormatBenchmark::parseCases(const std::string& list, Config& config) {
+    std::vector<std::string> cases;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) {
+            return false;
+        }
+        cases.push_back(item);
+    }
+    if (cases.empty()) {
+        return false;
+    }
+    config.cases = cases;
+    return true;
+}
+
+bool FormatBenchmark::parseFrames(const std::string& text, Config& config) {
+    int frames = 0;
+    if (!parseNumber(text, frames) || frames <= 0 || frames > 100000) {
+        return false;
+    }
+    config.frames = frames;
+    return true;
+}
+
+bool FormatBenchmark::isSelected(const Case& test_case) const {
+    if (config_.cases.empty()) {
+        return true;
+    }
+    return std::any_of(config_.cases.begin(), config_.cases.end(), [&test_case](const std::string& part) {
+        return test_case.name.find(part) != std::string::npos;
+    });
+}
+
+std::vector<FormatBenchmark::Case> FormatBenchmark::buildCases() {
+    std::vector<Case> cases;
+    const int width = config_.width;
+    const int height = config_.height;
+
+    // SIMD kernels: one case per tier that has its own variant. The
+    // selected tier striped across the conversion threads decides (single
+    // threaded when there is only one); the rest are references.
+    const std::vector<PixelKernels> tiers = tiersFromActive();
+    StripeExecutor* stripes = &StripeExecutor::shared();
+    const int stripe_threads = stripes->getThreadCount();
+    auto add_tiers = [&cases, &tiers, stripes, stripe_threads](const std::string& name, auto kernel_isa,
+                                                               auto make_run) {
+        bool selected = true;
+        for (const auto& kernels : tiers) {
+            CpuIsa isa = kernel_isa(kernels);
+            if (isa != kernels.isa) {
+                continue;   // No variant at this tier; listed with the lower one
+            }
+            if (selected && stripe_threads > 1) {
+                cases.push_back({withIsa(name, isa, stripe_threads), false, make_run(kernels, stripes)});
+                selected = false;
+            }
+            cases.push_back({withIsa(name, isa), !selected, make_run(kernels, nullptr)});
+            selected = false;
+        }
+    };
+
+    // 10-bit capture formats -> NDI P216
+    struct TenBitFormat {
+        uint32_t pixelformat;
+        const char* name;
+    };
+    const TenBitFormat ten_bit[] = {
+        {V4L2_PIX_FMT_V210, "v210 -> P216"},
+        {V4L2_PIX_FMT_Y210, "Y210 -> P216"},
+        {V4L2_PIX_FMT_P010, "P010 -> P216"},
+    };
+
+    for (const auto& format : ten_bit) {
+        const uint32_t pixelformat = format.pixelformat;
+        const int bytesperline = P216Packer::minimumBytesPerLine(pixelformat, width);
+        inputs_.push_back(makeInput(P216Packer::inputFrameSize(pixelformat, bytesperline, height)));
+        const size_t input_index = inputs_.size() - 1;
+
+        auto make_run = [this, input_index, width, height, bytesperline, pixelformat](
+                            const PixelKernels& kernels, StripeExecutor* stripes) -> std::function<bool()> {
+            auto packer = std::make_shared<P216Packer>(kernels, stripes);
+            return [this, input_index, width, height, bytesperline, pixelformat, packer]() {
+                const std::vector<uint8_t>& input = inputs_[input_index];
+                return packer->pack(input.data(), input.size(), width, height,
+                                    bytesperline, pixelformat, output_);
+            };
+        };
+
+        if (pixelformat == V4L2_PIX_FMT_P010) {
+            // Line copies either way
+            cases.push_back({std::string(format.name) + " (memcpy)", false,
+                             make_run(PixelKernels::active(), nullptr)});
+        } else {
+            add_tiers(format.name, [pixelformat](const PixelKernels& kernels) {
+                return P216Packer(kernels).getKernelIsa(pixelformat);
+            }, make_run);
+        }
+    }
+
+    // YUYV -> UYVY in place; the frame flips between the two byte orders,
+    // which costs the same either way
+    inputs_.push_back(makeInput(static_cast<size_t>(width) * height * 2));
+    const size_t yuyv_index = inputs_.size() - 1;
+
+    add_tiers("YUYV -> UYVY in place",
+              [](const PixelKernels& kernels) { return kernels.swap_pairs.isa; },
+              [this, yuyv_index, width, height](const PixelKernels& kernels,
+                                                StripeExecutor* stripes) -> std::function<bool()> {
+                  auto swizzler = std::make_shared<YuyvSwizzler>(kernels, stripes);
+                  return [this, yuyv_index, width, height, swizzler]() {
+                      swizzler->swizzleInPlace(inputs_[yuyv_index].data(), width, height, width * 2);
+                      return true;
+                  };
+              });
+
+    // UYVY -> BGRA, the converter path for consumers that need RGB
+    inputs_.push_back(makeInput(static_cast<size_t>(width) * height * 2));
+    const size_t uyvy_index = inputs_.size() - 1;
+
+    add_tiers("UYVY -> BGRA",
+              [](const PixelKernels& kernels) { return kernels.uyvy_to_bgra.isa; },
+              [this, uyvy_index, width, height](const PixelKernels& kernels,
+                                                StripeExecutor* stripes) -> std::function<bool()> {
+                  auto converter = std::make_shared<V4L2FormatConverter>(kernels, stripes);
+                  return [this, uyvy_index, width, height, converter]() {
+                      const std::vector<uint8_t>& input = inputs_[uyvy_index];
+                      return converter->convertToBGRA(input.data(), input.size(), width, height,
+                                                      V4L2_PIX_FMT_UYVY, output_);
+                  };
+              });
+
+    // Display fallback without a scaling plane: UYVY bilinear-scaled to a
+    // 4K monitor with the XRGB conversion fused in, striped as ndi-display
+    // runs it. Informational only; the display is not bound by the
+    // capture budget.
+    auto scaled = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(kDisplayWidth) * kDisplayHeight * 4);
+    const std::string scale_name = "UYVY -> XRGB " + std::to_string(kDisplayWidth) + "x" +
+                                   std::to_string(kDisplayHeight) + " bilinear";
+    for (const auto& kernels : tiers) {
+        if (kernels.scale_bgra.isa != kernels.isa) {
+            continue;
+        }
+        auto scaler = std::make_shared<FrameScaler>(kernels, stripe_threads > 1 ? stripes : nullptr);
+        cases.push_back({withIsa(scale_name, kernels.isa, stripe_threads), true,
+                         [this, uyvy_index, width, height, scaler, scaled]() {
+                             return scaler->scale(inputs_[uyvy_index].data(), width, height, width * 2,
+                                                  FrameScaler::Format::UYVY, scaled->data(),
+                                                  kDisplayWidth * 4, kDisplayWidth, kDisplayHeight);
+                         }});
+    }
+
+    // MJPEG -> UYVY, sliced at restart markers
+    inputs_.push_back(makeMjpegInput(width, height));
+    const size_t mjpeg_index = inputs_.size() - 1;
+    auto sliced_decoder = std::make_shared<MjpegDecoder>();
+    auto single_decoder = std::make_shared<MjpegDecoder>(1);
+
+    auto make_decode = [this, mjpeg_index, width, height](std::shared_ptr<MjpegDecoder> decoder) {
+        return [this, mjpeg_index, width, height, decoder]() {
+            const std::vector<uint8_t>& input = inputs_[mjpeg_index];
+            return decoder->decode(input.data(), input.size(), width, height, output_);
+        };
+    };
+
+    const int threads = sliced_decoder->getThreadCount();
+    if (threads > 1) {
+        cases.push_back({"MJPEG -> UYVY (" + std::to_string(threads) + " threads)", false,
+                         make_decode(sliced_decoder)});
+        cases.push_back({"MJPEG -> UYVY (1 thread)", true, make_decode(single_decoder)});
+    } else {
+        cases.push_back({"MJPEG -> UYVY (1 thread)", false, make_decode(single_decoder)});
+    }
+
+    return cases;
+}
+
+FormatBenchmark::Result FormatBenchmark::measure(const Case& test_case) const {
+    Result result;
+    result.name = test_case.name;
+    result.reference = test_case.reference;
+    result.budget_us = 1e6 / config_.fps * kBudgetFraction;
+
+    for (int i = 0; i < kWarmupFrames; i++) {
+        if (!test_case.run_once()) {
+            return result;
+        }
+    }
+
+    std::vector<double> times;
+    times.reserve(config_.frames);
+    for (int i = 0; i < config_.frames; i++) {
+        auto start = std::chrono::steady_clock::now();
+        bool ok = test_case.run_once();
+        auto end = std::chrono::steady_clock::now();
+        if (!ok) {
+            return result;
+        }
+        times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    double total = 0.0;
+    for (double t : times) {
+        total += t;
+    }
+    std::sort(times.begin(), times.end());
+    result.avg_us = total / times.size();
+    result.p99_us = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+    result.max_us = times.back();
+    result.fits = result.p99_us <= result.budget_us;
+    return result;
+}
+
+std::vector<FormatBenchmark::Result> FormatBenchmark::run() {
+    std::vector<Result> results;
+    if (config_.frames <= 0) {
+        return results;
+    }
+
+    std::vector<Case> cases = buildCases();
+    for (const auto& test_case : cases) {
+        if (isSelected(test_case)) {
+            results.push_back(measure(test_case));
+        }
+    }
+    return results;
+}
+
+bool FormatBenchmark::printReport(const std::vector<Result>& results) const {
+    double interval_us = 1e6 / config_.fps;
+    std::cout << "Format kernel benchmark: " << config_.width << "x" << config_.height << " @"
+              << config_.fps << "fps, " << config_.frames << " frames per kernel" << std::endl;
+    std::cout << "Frame interval " << std::fixed << std::setprecision(0) << interval_us
+              << "us, conversion budget " << interval_us * kBudgetFraction << "us (p99)" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(44) << "Kernel" << std::right
+              << std::setw(10) << "avg us" << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+              << std::setw(8) << "fits" << std::endl;
+
+    bool all_fit = !results.empty();
+    for (const auto& r : results) {
+        std::ostringstream line;
+        line << std::left << std::setw(44) << r.name << std::right << std::fixed << std::setprecision(1)
+             << std::setw(10) << r.avg_us << std::setw(10) << r.p99_us << std::setw(10) << r.max_us
+             << std::setw(8) << (r.fits ? "yes" : (r.reference ? "(no)" : "NO"));
+        std::cout << line.str() << std::endl;
+        if (!r.reference && !r.fits) {
+            all_fit = false;
+        }
+    }
+
+    std::cout << std::endl << (all_fit ? "PASS" : "FAIL") << std::endl;
+    return all_fit;
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
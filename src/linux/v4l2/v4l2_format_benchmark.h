@@ -0,0 +1,104 @@
+// v4l2_format_benchmark.h
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief Times the capture-side format kernels against the frame budget
+ *
+ * `ndi-capture --benchmark [WIDTHxHEIGHT[@FPS]]` runs every kernel the send
+ * path may use on a synthetic frame of that size and reports the average,
+ * 99th percentile and worst time per frame. A kernel fits when its p99
+ * stays within the conversion budget: half the frame interval, the same
+ * share of a core FormatSelector lets a conversion take. SIMD kernels run
+ * at the tier PixelKernels selected (--isa / NDI_BRIDGE_ISA cap it),
+ * striped across the StripeExecutor threads when there are several, as
+ * the capture path runs them. The same tier on one thread and every lower
+ * tier are listed for comparison; only the striped (or, on one core, the
+ * selected) kernels and the threaded decoder decide the result.
+ *
+ * MJPEG is timed on a synthetic capture-card frame (4:2:2, restart marker
+ * per MCU row), decoded in slices on the decoder's threads and, for
+ * comparison, on one thread. YUYV is swapped to UYVY in place, as the
+ * capture path does in the mmap buffer. UYVY -> BGRA covers the
+ * converter fallback. The frame scaled to a 4K monitor by FrameScaler
+ * (ndi-display without a scaling plane) is listed for reference.
+ *
+ * --cases limits the run to kernels whose name contains one of the given
+ * substrings and --frames sets the timed iterations, so a check of one
+ * kernel does not pay for the whole table.
+ *
+ * Version: 1.6.0
+ */
+class FormatBenchmark {
+public:
+    struct Config {
+        int width = 1920;
+        int height = 1080;
+        uint32_t fps = 60;
+        int frames = 300;       // Timed iterations per kernel
+        std::vector<std::string> cases; // Name substrings to run, empty = all
+    };
+
+    struct Result {
+        std::string name;
+        double avg_us = 0.0;
+        double p99_us = 0.0;
+        double max_us = 0.0;
+        double budget_us = 0.0;
+        bool fits = false;
+        bool reference = false; // Lower tier / single-thread fallback, informational
+    };
+
+    explicit FormatBenchmark(const Config& config);
+
+    /**
+     * @brief Parse "WIDTHxHEIGHT[@FPS]" (e.g. "1920x1080@60")
+     */
+    static bool parseSpec(const std::string& spec, Config& config);
+
+    /**
+     * @brief Parse a comma-separated list of case name substrings
+     */
+    static bool parseCases(const std::string& list, Config& config);
+
+    /**
+     * @brief Parse the timed iteration count (1-100000)
+     */
+    static bool parseFrames(const std::string& text, Config& config);
+
+    /**
+     * @brief Run the kernels available on this CPU (those selected by cases)
+     */
+    std::vector<Result> run();
+
+    /**
+     * @brief Print a result table to stdout
+     * @return true if every non-reference kernel fits the budget
+     */
+    bool printReport(const std::vector<Result>& results) const;
+
+private:
+    struct Case {
+        std::string name;
+        bool reference;
+        std::function<bool()> run_once;
+    };
+
+    std::vector<Case> buildCases();
+    bool isSelected(const Case& test_case) const;
+    Result measure(const Case& test_case) const;
+
+    Config config_;
+    std::vector<std::vector<uint8_t>> inputs_;
+    std::vector<uint8_t> output_;
+};
+
+} // namespace v4l2
+} // namespace ndi_bridge
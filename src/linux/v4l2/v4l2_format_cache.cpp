@@ -0,0 +1,228 @@
+// v4l2_format_cache.cpp
+#include "v4l2_format_cache.h"
+#include "../../common/logger.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+
+const char* kCacheHeader = "# media-bridge V4L2 format cache v1";
+
+bool parseMode(const std::string& value, V4L2FormatCache::Mode& mode) {
+    std::istringstream ss(value);
+    ss >> std::hex >> mode.pixelformat >> std::dec >> mode.width >> mode.height >> mode.fps_numerator;
+    mode.fps_denominator = 1;
+    if (!ss.fail() && ss.peek() == '/') {
+        ss.get();
+        ss >> mode.fps_denominator;
+    }
+    return !ss.fail() && mode.width > 0 && mode.height > 0 && mode.fps_denominator > 0;
+}
+
+std::string formatMode(const V4L2FormatCache::Mode& mode) {
+    std::ostringstream ss;
+    ss << "0x" << std::hex << mode.pixelformat << std::dec << " "
+       << mode.width << " " << mode.height << " " << mode.fps_numerator;
+    if (mode.fps_denominator != 1) {
+        ss << "/" << mode.fps_denominator;
+    }
+    return ss.str();
+}
+
+bool makeParentDirs(const std::string& path) {
+    size_t pos = 0;
+    while ((pos = path.find('/', pos + 1)) != std::string::npos) {
+        std::string dir = path.substr(0, pos);
+        if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string toLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return value;
+}
+
+} // anonymous namespace
+
+V4L2FormatCache::V4L2FormatCache(const std::string& path)
+    : path_(path)
+    , dirty_(false) {
+}
+
+std::string V4L2FormatCache::makeKey(const std::string& driver, const std::string& bus_info) {
+    return driver + "|" + bus_info;
+}
+
+bool V4L2FormatCache::load() {
+    entries_.clear();
+    dirty_ = false;
+
+    std::ifstream file(path_);
+    if (!file) {
+        return true;  // No cache yet
+    }
+
+    Entry* current = nullptr;
+    std::string line;
+    bool valid = true;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            valid = false;
+            continue;
+        }
+
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+
+        if (key == "device") {
+            size_t bar = value.find('|');
+            if (bar == std::string::npos) {
+                valid = false;
+                current = nullptr;
+                continue;
+            }
+            Entry entry;
+            entry.driver = value.substr(0, bar);
+            entry.bus_info = value.substr(bar + 1);
+            current = &entries_[makeKey(entry.driver, entry.bus_info)];
+            *current = entry;
+        } else if (!current) {
+            valid = false;
+        } else if (key == "card") {
+            current->card = value;
+        } else if (key == "path") {
+            current->device_path = value;
+        } else if (key == "mode") {
+            current->has_mode = parseMode(value, current->mode);
+            valid = valid && current->has_mode;
+        } else if (key == "selection") {
+            current->selection = value;
+        } else if (key == "format") {
+            Mode mode;
+            if (parseMode(value, mode)) {
+                current->formats.push_back(mode);
+            } else {
+                valid = false;
+            }
+        }
+    }
+
+    if (!valid) {
+        Logger::warning("V4L2FormatCache: Ignoring malformed lines in " + path_);
+    }
+    Logger::debug("V4L2FormatCache: Loaded " + std::to_string(entries_.size()) + " device(s) from " + path_);
+    return valid;
+}
+
+bool V4L2FormatCache::save() {
+    if (!dirty_) {
+        return true;
+    }
+
+    if (!makeParentDirs(path_)) {
+        Logger::warning("V4L2FormatCache: Cannot create directory for " + path_ + ": " + strerror(errno));
+        return false;
+    }
+
+    std::string tmp_path = path_ + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        if (!file) {
+            Logger::warning("V4L2FormatCache: Cannot write " + tmp_path);
+            return false;
+        }
+
+        file << kCacheHeader << "\n";
+        for (const auto& kv : entries_) {
+            const Entry& entry = kv.second;
+            file << "device=" << entry.driver << "|" << entry.bus_info << "\n";
+            file << "card=" << entry.card << "\n";
+            file << "path=" << entry.device_path << "\n";
+            if (entry.has_mode) {
+                file << "mode=" << formatMode(entry.mode) << "\n";
+                file << "selection=" << entry.selection << "\n";
+            }
+            for (const auto& mode : entry.formats) {
+                file << "format=" << formatMode(mode) << "\n";
+            }
+            file << "\n";
+        }
+
+        if (!file.good()) {
+            Logger::warning("V4L2FormatCache: Write failed for " + tmp_path);
+            return false;
+        }
+    }
+
+    if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+        Logger::warning("V4L2FormatCache: Cannot replace " + path_ + ": " + strerror(errno));
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+
+    dirty_ = false;
+    Logger::debug("V4L2FormatCache: Saved " + std::to_string(entries_.size()) + " device(s) to " + path_);
+    return true;
+}
+
+const V4L2FormatCache::Entry* V4L2FormatCache::find(const std::string& driver,
+                                                    const std::string& bus_info) const {
+    auto it = entries_.find(makeKey(driver, bus_info));
+    return it == entries_.end() ? nullptr : &it->second;
+}
+
+const V4L2FormatCache::Entry* V4L2FormatCache::findByName(const std::string& name) const {
+    std::string search_name = toLower(name);
+
+    for (const auto& kv : entries_) {
+        const Entry& entry = kv.second;
+        if (entry.device_path.empty()) {
+            continue;
+        }
+        if (toLower(entry.card).find(search_name) != std::string::npos ||
+            toLower(entry.bus_info).find(search_name) != std::string::npos) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void V4L2FormatCache::update(const Entry& entry) {
+    std::string key = makeKey(entry.driver, entry.bus_info);
+    auto it = entries_.find(key);
+
+    if (it != entries_.end()) {
+        const Entry& old = it->second;
+        bool same = old.card == entry.card && old.device_path == entry.device_path &&
+                    old.has_mode == entry.has_mode &&
+                    (!entry.has_mode || (old.mode == entry.mode && old.selection == entry.selection)) &&
+                    old.formats.size() == entry.formats.size() &&
+                    std::equal(old.formats.begin(), old.formats.end(), entry.formats.begin());
+        if (same) {
+            return;
+        }
+    }
+
+    entries_[key] = entry;
+    dirty_ = true;
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,101 @@
+// v4l2_format_cache.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief Persistent per-device cache of V4L2 formats and the chosen mode
+ *
+ * Entries are keyed by driver + bus_info, which stay stable across reboots
+ * and USB replugs into the same port (unlike /dev/videoN). On startup the
+ * cached mode is applied directly; full ENUM_FMT/FRAMESIZES/FRAMEINTERVALS
+ * enumeration only runs when the driver rejects it, or when the mode was
+ * chosen under other selection settings (format policy, 10-bit preference).
+ *
+ * File format (text, one key per line):
+ *   device=<driver>|<bus_info>
+ *   card=<card name>
+ *   path=/dev/videoN
+ *   mode=<fourcc hex> <width> <height> <fps>[/<denominator>]
+ *   selection=<policy>[ 10bit]                    (settings the mode was chosen with)
+ *   format=<fourcc hex> <width> <height> <fps>[/<denominator>]   (repeated)
+ *
+ * Version: 1.2.0
+ */
+class V4L2FormatCache {
+public:
+    struct Mode {
+        uint32_t pixelformat = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t fps_numerator = 0;     // 60000/1001 for 59.94
+        uint32_t fps_denominator = 1;
+
+        bool operator==(const Mode& other) const {
+            return pixelformat == other.pixelformat && width == other.width &&
+                   height == other.height && fps_numerator == other.fps_numerator &&
+                   fps_denominator == other.fps_denominator;
+        }
+    };
+
+    struct Entry {
+        std::string driver;
+        std::string bus_info;
+        std::string card;
+        std::string device_path;
+        std::vector<Mode> formats;
+        bool has_mode = false;
+        Mode mode;
+        std::string selection;      // Selection settings of mode, see V4L2Capture
+    };
+
+    explicit V4L2FormatCache(const std::string& path);
+
+    /**
+     * @brief Load the cache file (a missing file is an empty cache)
+     * @return false only if the file exists but could not be parsed
+     */
+    bool load();
+
+    /**
+     * @brief Write the cache if it changed (atomic rename)
+     */
+    bool save();
+
+    /**
+     * @brief Look up a device by driver and bus_info
+     * @return Entry or nullptr
+     */
+    const Entry* find(const std::string& driver, const std::string& bus_info) const;
+
+    /**
+     * @brief Look up a device by card name or bus_info substring
+     *
+     * Same matching rules as V4L2DeviceEnumerator::findDeviceByName, so a
+     * name lookup can open the cached node instead of every /dev/video*.
+     */
+    const Entry* findByName(const std::string& name) const;
+
+    /**
+     * @brief Insert or replace an entry
+     */
+    void update(const Entry& entry);
+
+    const std::string& getPath() const { return path_; }
+
+private:
+    static std::string makeKey(const std::string& driver, const std::string& bus_info);
+
+    std::string path_;
+    std::map<std::string, Entry> entries_;
+    bool dirty_;
+};
+
+} // namespace v4l2
+} // namespace ndi_bridge
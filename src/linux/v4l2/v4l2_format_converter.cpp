@@ -1,28 +1,15 @@
 // v4l2_format_converter.cpp
 #include "v4l2_format_converter.h"
+#include "v4l2_mjpeg_decoder.h"
 #include "../../common/logger.h"
 #include <cstring>
 #include <algorithm>
 
-#ifdef __AVX2__
-#include "v4l2_format_converter_avx2.h"
-#endif
-
 namespace ndi_bridge {
 namespace v4l2 {
 
-V4L2FormatConverter::V4L2FormatConverter() 
-    : use_avx2_(false), avx2_logged_(false) {
-#ifdef __AVX2__
-    use_avx2_ = V4L2FormatConverterAVX2::isAVX2Available();
-    if (use_avx2_) {
-        Logger::info("V4L2FormatConverter: AVX2 optimization AVAILABLE for Intel N100");
-    } else {
-        Logger::info("V4L2FormatConverter: AVX2 not available at runtime - using scalar code");
-    }
-#else
-    Logger::info("V4L2FormatConverter: AVX2 support not compiled in - using scalar code");
-#endif
+V4L2FormatConverter::V4L2FormatConverter(const PixelKernels& kernels, StripeExecutor* stripes)
+    : kernels_(kernels), stripes_(stripes) {
 }
 
 V4L2FormatConverter::~V4L2FormatConverter() {
@@ -42,52 +29,24 @@ bool V4L2FormatConverter::convertToBGRA(const void* input, size_t input_size,
     const uint8_t* input_data = static_cast<const uint8_t*>(input);
     uint8_t* output_data = output.data();
     
+    if (pixelformat != cost_format_) {
+        row_cost_ = StripeExecutor::RowCost();
+        cost_format_ = pixelformat;
+    }
+    
     bool result = false;
     
     switch (pixelformat) {
         case V4L2_PIX_FMT_YUYV:
-#ifdef __AVX2__
-            if (use_avx2_) {
-                if (!avx2_logged_) {
-                    Logger::info("V4L2FormatConverter: Using AVX2 accelerated YUYV->BGRA conversion");
-                    avx2_logged_ = true;
-                }
-                result = V4L2FormatConverterAVX2::convertYUYVtoBGRA_AVX2(input_data, width, height, output_data);
-            } else
-#endif
-            {
-                result = convertYUYVtoBGRA(input_data, width, height, output_data);
-            }
+            result = convertYUYVtoBGRA(input_data, width, height, output_data);
             break;
             
         case V4L2_PIX_FMT_UYVY:
-#ifdef __AVX2__
-            if (use_avx2_) {
-                if (!avx2_logged_) {
-                    Logger::info("V4L2FormatConverter: Using AVX2 accelerated UYVY->BGRA conversion");
-                    avx2_logged_ = true;
-                }
-                result = V4L2FormatConverterAVX2::convertUYVYtoBGRA_AVX2(input_data, width, height, output_data);
-            } else
-#endif
-            {
-                result = convertUYVYtoBGRA(input_data, width, height, output_data);
-            }
+            result = convertUYVYtoBGRA(input_data, width, height, output_data);
             break;
             
         case V4L2_PIX_FMT_NV12:
-#ifdef __AVX2__
-            if (use_avx2_) {
-                if (!avx2_logged_) {
-                    Logger::info("V4L2FormatConverter: Using AVX2 accelerated NV12->BGRA conversion");
-                    avx2_logged_ = true;
-                }
-                result = V4L2FormatConverterAVX2::convertNV12toBGRA_AVX2(input_data, width, height, output_data);
-            } else
-#endif
-            {
-                result = convertNV12toBGRA(input_data, width, height, output_data);
-            }
+            result = convertNV12toBGRA(input_data, width, height, output_data);
             break;
             
         case V4L2_PIX_FMT_RGB24:
@@ -158,79 +117,36 @@ size_t V4L2FormatConverter::calculateBGRASize(int width, int height) {
     return width * height * 4; // 4 bytes per pixel
 }
 
+void V4L2FormatConverter::forRows(int height, size_t row_bytes,
+                                  const StripeExecutor::RowFunc& fn) {
+    if (stripes_) {
+        stripes_->run(row_cost_, height, row_bytes, fn);
+    } else {
+        fn(0, height);
+    }
+}
+
 bool V4L2FormatConverter::convertYUYVtoBGRA(const uint8_t* input, int width, int height,
                                             uint8_t* output) {
     // YUYV format: Y0 U0 Y1 V0 | Y2 U2 Y3 V2
-    // Two pixels are encoded in 4 bytes
-    
-    for (int y = 0; y < height; y++) {
-        const uint8_t* src_row = input + y * width * 2; // 2 bytes per pixel
-        uint8_t* dst_row = output + y * width * 4;      // 4 bytes per pixel
-        
-        for (int x = 0; x < width; x += 2) {
-            uint8_t y0 = src_row[0];
-            uint8_t u  = src_row[1];
-            uint8_t y1 = src_row[2];
-            uint8_t v  = src_row[3];
-            
-            uint8_t r0, g0, b0, r1, g1, b1;
-            yuvToRgb(y0, u, v, r0, g0, b0);
-            yuvToRgb(y1, u, v, r1, g1, b1);
-            
-            // Write BGRA pixels
-            dst_row[0] = b0;
-            dst_row[1] = g0;
-            dst_row[2] = r0;
-            dst_row[3] = 255; // Alpha
-            
-            dst_row[4] = b1;
-            dst_row[5] = g1;
-            dst_row[6] = r1;
-            dst_row[7] = 255; // Alpha
-            
-            src_row += 4;
-            dst_row += 8;
+    forRows(height, static_cast<size_t>(width) * 6, [&](int row_begin, int row_end) {
+        for (int y = row_begin; y < row_end; y++) {
+            kernels_.yuyv_to_bgra.fn(input + static_cast<size_t>(y) * width * 2,
+                                     output + static_cast<size_t>(y) * width * 4, width);
         }
-    }
-    
+    });
     return true;
 }
 
 bool V4L2FormatConverter::convertUYVYtoBGRA(const uint8_t* input, int width, int height,
                                             uint8_t* output) {
     // UYVY format: U0 Y0 V0 Y1 | U2 Y2 V2 Y3
-    // Two pixels are encoded in 4 bytes
-    
-    for (int y = 0; y < height; y++) {
-        const uint8_t* src_row = input + y * width * 2; // 2 bytes per pixel
-        uint8_t* dst_row = output + y * width * 4;      // 4 bytes per pixel
-        
-        for (int x = 0; x < width; x += 2) {
-            uint8_t u  = src_row[0];
-            uint8_t y0 = src_row[1];
-            uint8_t v  = src_row[2];
-            uint8_t y1 = src_row[3];
-            
-            uint8_t r0, g0, b0, r1, g1, b1;
-            yuvToRgb(y0, u, v, r0, g0, b0);
-            yuvToRgb(y1, u, v, r1, g1, b1);
-            
-            // Write BGRA pixels
-            dst_row[0] = b0;
-            dst_row[1] = g0;
-            dst_row[2] = r0;
-            dst_row[3] = 255; // Alpha
-            
-            dst_row[4] = b1;
-            dst_row[5] = g1;
-            dst_row[6] = r1;
-            dst_row[7] = 255; // Alpha
-            
-            src_row += 4;
-            dst_row += 8;
+    forRows(height, static_cast<size_t>(width) * 6, [&](int row_begin, int row_end) {
+        for (int y = row_begin; y < row_end; y++) {
+            kernels_.uyvy_to_bgra.fn(input + static_cast<size_t>(y) * width * 2,
+                                     output + static_cast<size_t>(y) * width * 4, width);
         }
-    }
-    
+    });
     return true;
 }
 
@@ -238,87 +154,66 @@ bool V4L2FormatConverter::convertNV12toBGRA(const uint8_t* input, int width, int
                                             uint8_t* output) {
     // NV12 format: Y plane followed by interleaved UV plane
     const uint8_t* y_plane = input;
-    const uint8_t* uv_plane = input + width * height;
+    const uint8_t* uv_plane = input + static_cast<size_t>(width) * height;
     
-    for (int y = 0; y < height; y++) {
-        const uint8_t* y_row = y_plane + y * width;
-        const uint8_t* uv_row = uv_plane + (y / 2) * width;
-        uint8_t* dst_row = output + y * width * 4;
-        
-        for (int x = 0; x < width; x++) {
-            uint8_t y_val = y_row[x];
-            uint8_t u = uv_row[(x / 2) * 2];
-            uint8_t v = uv_row[(x / 2) * 2 + 1];
-            
-            uint8_t r, g, b;
-            yuvToRgb(y_val, u, v, r, g, b);
-            
-            dst_row[x * 4 + 0] = b;
-            dst_row[x * 4 + 1] = g;
-            dst_row[x * 4 + 2] = r;
-            dst_row[x * 4 + 3] = 255; // Alpha
+    forRows(height, static_cast<size_t>(width) * 6, [&](int row_begin, int row_end) {
+        for (int y = row_begin; y < row_end; y++) {
+            kernels_.nv12_to_bgra.fn(y_plane + static_cast<size_t>(y) * width,
+                                     uv_plane + static_cast<size_t>(y / 2) * width,
+                                     output + static_cast<size_t>(y) * width * 4, width);
         }
-    }
-    
+    });
     return true;
 }
 
 bool V4L2FormatConverter::convertRGB24toBGRA(const uint8_t* input, int width, int height,
                                               uint8_t* output) {
-    for (int y = 0; y < height; y++) {
-        const uint8_t* src_row = input + y * width * 3;
-        uint8_t* dst_row = output + y * width * 4;
-        
-        for (int x = 0; x < width; x++) {
-            dst_row[x * 4 + 0] = src_row[x * 3 + 2]; // B
-            dst_row[x * 4 + 1] = src_row[x * 3 + 1]; // G
-            dst_row[x * 4 + 2] = src_row[x * 3 + 0]; // R
-            dst_row[x * 4 + 3] = 255;                // A
+    forRows(height, static_cast<size_t>(width) * 7, [&](int row_begin, int row_end) {
+        for (int y = row_begin; y < row_end; y++) {
+            const uint8_t* src_row = input + static_cast<size_t>(y) * width * 3;
+            uint8_t* dst_row = output + static_cast<size_t>(y) * width * 4;
+            
+            for (int x = 0; x < width; x++) {
+                dst_row[x * 4 + 0] = src_row[x * 3 + 2]; // B
+                dst_row[x * 4 + 1] = src_row[x * 3 + 1]; // G
+                dst_row[x * 4 + 2] = src_row[x * 3 + 0]; // R
+                dst_row[x * 4 + 3] = 255;                // A
+            }
         }
-    }
+    });
     
     return true;
 }
 
 bool V4L2FormatConverter::convertBGR24toBGRA(const uint8_t* input, int width, int height,
                                               uint8_t* output) {
-    for (int y = 0; y < height; y++) {
-        const uint8_t* src_row = input + y * width * 3;
-        uint8_t* dst_row = output + y * width * 4;
-        
-        for (int x = 0; x < width; x++) {
-            dst_row[x * 4 + 0] = src_row[x * 3 + 0]; // B
-            dst_row[x * 4 + 1] = src_row[x * 3 + 1]; // G
-            dst_row[x * 4 + 2] = src_row[x * 3 + 2]; // R
-            dst_row[x * 4 + 3] = 255;                // A
+    forRows(height, static_cast<size_t>(width) * 7, [&](int row_begin, int row_end) {
+        for (int y = row_begin; y < row_end; y++) {
+            const uint8_t* src_row = input + static_cast<size_t>(y) * width * 3;
+            uint8_t* dst_row = output + static_cast<size_t>(y) * width * 4;
+            
+            for (int x = 0; x < width; x++) {
+                dst_row[x * 4 + 0] = src_row[x * 3 + 0]; // B
+                dst_row[x * 4 + 1] = src_row[x * 3 + 1]; // G
+                dst_row[x * 4 + 2] = src_row[x * 3 + 2]; // R
+                dst_row[x * 4 + 3] = 255;                // A
+            }
         }
-    }
+    });
     
     return true;
 }
 
 bool V4L2FormatConverter::decompressMJPEGtoBGRA(const uint8_t* input, size_t input_size,
                                                  int width, int height, uint8_t* output) {
-    // For now, we don't support MJPEG without libjpeg
-    // This would require linking with libjpeg or libjpeg-turbo
-    Logger::warning("V4L2FormatConverter: MJPEG decompression not implemented (requires libjpeg)");
-    return false;
-}
-
-void V4L2FormatConverter::yuvToRgb(uint8_t y, uint8_t u, uint8_t v,
-                                   uint8_t& r, uint8_t& g, uint8_t& b) {
-    // ITU-R BT.601 conversion
-    int c = y - 16;
-    int d = u - 128;
-    int e = v - 128;
-    
-    int r_val = (298 * c + 409 * e + 128) >> 8;
-    int g_val = (298 * c - 100 * d - 208 * e + 128) >> 8;
-    int b_val = (298 * c + 516 * d + 128) >> 8;
-    
-    r = clamp(r_val);
-    g = clamp(g_val);
-    b = clamp(b_val);
+    if (!mjpeg_decoder_) {
+        mjpeg_decoder_ = std::make_unique<MjpegDecoder>(1);
+    }
+    if (!mjpeg_decoder_->decode(input, input_size, width, height, mjpeg_uyvy_)) {
+        Logger::warning("V4L2FormatConverter: " + mjpeg_decoder_->getLastError());
+        return false;
+    }
+    return convertUYVYtoBGRA(mjpeg_uyvy_.data(), width, height, output);
 }
 
 } // namespace v4l2
@@ -1,23 +1,36 @@
 // v4l2_format_converter.h
 #pragma once
 
+#include "../../common/pixel_kernels.h"
+#include "../../common/stripe_executor.h"
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <linux/videodev2.h>
 
 namespace ndi_bridge {
 namespace v4l2 {
 
+class MjpegDecoder;
+
 /**
  * @brief YUV format converter for V4L2 capture
  * 
  * Handles conversion from various YUV formats to BGRA for NDI output.
  * Supports common USB capture card formats and webcam formats.
+ * YUYV, UYVY and NV12 lines go through the PixelKernels selected at
+ * startup. With a StripeExecutor the rows are split into bands across
+ * cores; without one the whole frame runs on the calling thread.
  */
 class V4L2FormatConverter {
 public:
-    V4L2FormatConverter();
+    /**
+     * @param kernels Line kernels (benchmarks pass a capped set)
+     * @param stripes Executor for row bands (nullptr = single thread)
+     */
+    explicit V4L2FormatConverter(const PixelKernels& kernels = PixelKernels::active(),
+                                 StripeExecutor* stripes = nullptr);
     ~V4L2FormatConverter();
     
     /**
@@ -51,7 +64,10 @@ public:
     static size_t calculateBGRASize(int width, int height);
     
 private:
-    // Scalar conversion functions
+    // Runs fn over all rows, in bands when an executor is set
+    void forRows(int height, size_t row_bytes, const StripeExecutor::RowFunc& fn);
+    
+    // Row loops; the YUV ones call the line kernels
     bool convertYUYVtoBGRA(const uint8_t* input, int width, int height, uint8_t* output);
     bool convertUYVYtoBGRA(const uint8_t* input, int width, int height, uint8_t* output);
     bool convertNV12toBGRA(const uint8_t* input, int width, int height, uint8_t* output);
@@ -60,20 +76,14 @@ private:
     bool decompressMJPEGtoBGRA(const uint8_t* input, size_t input_size, 
                                int width, int height, uint8_t* output);
     
-    // YUV to RGB conversion helper
-    static inline void yuvToRgb(uint8_t y, uint8_t u, uint8_t v, 
-                                uint8_t& r, uint8_t& g, uint8_t& b);
-    
-    // Clamp value to [0, 255]
-    static inline uint8_t clamp(int value) {
-        return (value < 0) ? 0 : (value > 255) ? 255 : static_cast<uint8_t>(value);
-    }
-    
-    // AVX2 optimization flag
-    bool use_avx2_;
+    // MJPEG goes through UYVY (single-threaded; the send path uses its own decoder)
+    std::unique_ptr<MjpegDecoder> mjpeg_decoder_;
+    std::vector<uint8_t> mjpeg_uyvy_;
     
-    // Flag to track if AVX2 usage has been logged
-    mutable bool avx2_logged_;
+    PixelKernels kernels_;
+    StripeExecutor* stripes_;
+    StripeExecutor::RowCost row_cost_;
+    uint32_t cost_format_ = 0;   // Format row_cost_ was measured for
 };
 
 } // namespace v4l2
@@ -0,0 +1,288 @@
+// v4l2_format_selector.cpp
+#include "v4l2_format_selector.h"
+#include "v4l2_format_converter.h"
+#include "v4l2_p216_packer.h"
+#include "v4l2_mjpeg_decoder.h"
+#include "../../common/logger.h"
+#include <linux/videodev2.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+
+// NDI-native first, then by how cheaply the sender can deliver it
+const uint32_t kFormatPriority[] = {
+    V4L2_PIX_FMT_UYVY,   // Best - NDI native format, zero conversion
+    V4L2_PIX_FMT_YUYV,   // Good - byte swap to UYVY in the capture buffer
+    V4L2_PIX_FMT_NV12,   // Good - passed through, 4:2:0 chroma
+    V4L2_PIX_FMT_YUV420, // Good - passed through as I420
+    V4L2_PIX_FMT_YVU420, // Good - passed through as YV12
+    V4L2_PIX_FMT_V210,   // 10-bit 4:2:2 - unpacked to P216
+    V4L2_PIX_FMT_Y210,   // 10-bit 4:2:2 - deinterleaved to P216
+    V4L2_PIX_FMT_P010,   // 10-bit 4:2:0 - chroma lines doubled to P216
+    V4L2_PIX_FMT_MJPEG   // Last resort - decoded to UYVY
+};
+
+// YUYV -> UYVY is a SIMD byte swap in place in the capture buffer
+constexpr double kSwizzleCostNsPerPixel = 0.1;
+
+// Fraction of one core the conversion may use before the score is derated
+constexpr double kConversionBudget = 0.5;
+
+// NDI receivers do not benefit from more than 60 fps
+constexpr uint32_t kMaxUsefulFps = 60;
+
+// Synthetic frame used to time the converter
+constexpr int kMeasureWidth = 320;
+constexpr int kMeasureHeight = 240;
+constexpr int kMeasureRuns = 3;
+
+std::mutex g_cost_mutex;
+std::map<uint32_t, double> g_cost_cache;
+
+} // anonymous namespace
+
+FormatSelector::FormatSelector(FormatPolicy policy, bool prefer_10bit)
+    : policy_(policy)
+    , prefer_10bit_(prefer_10bit) {
+}
+
+int FormatSelector::priorityIndex(uint32_t pixelformat) const {
+    const int count = static_cast<int>(sizeof(kFormatPriority) / sizeof(kFormatPriority[0]));
+    for (int i = 0; i < count; i++) {
+        if (kFormatPriority[i] == pixelformat) {
+            // Ahead of every 8-bit format, keeping their own order
+            if (prefer_10bit_ && P216Packer::isFormatSupported(pixelformat)) {
+                return i - count;
+            }
+            return i;
+        }
+    }
+    return count;
+}
+
+double FormatSelector::formatCost(uint32_t pixelformat) {
+    switch (pixelformat) {
+        case V4L2_PIX_FMT_UYVY:
+            return 0.0;
+        case V4L2_PIX_FMT_YUYV:
+            return kSwizzleCostNsPerPixel;
+        case V4L2_PIX_FMT_NV12:
+        case V4L2_PIX_FMT_YUV420:
+        case V4L2_PIX_FMT_YVU420:
+            // Planar 4:2:0 goes to NDI as captured
+            return 0.0;
+        default:
+            break;
+    }
+
+    if (!V4L2FormatConverter::isFormatSupported(pixelformat) &&
+        !P216Packer::isFormatSupported(pixelformat)) {
+        return -1.0;
+    }
+
+    std::lock_guard<std::mutex> lock(g_cost_mutex);
+    auto it = g_cost_cache.find(pixelformat);
+    if (it != g_cost_cache.end()) {
+        return it->second;
+    }
+
+    double cost = measureConverterCost(pixelformat);
+    g_cost_cache[pixelformat] = cost;
+    return cost;
+}
+
+double FormatSelector::measureConverterCost(uint32_t pixelformat) {
+    size_t pixels = static_cast<size_t>(kMeasureWidth) * kMeasureHeight;
+    std::vector<uint8_t> output;
+    double best_ns = -1.0;
+
+    if (pixelformat == V4L2_PIX_FMT_MJPEG) {
+        best_ns = measureMJPEGCost(output);
+    } else if (P216Packer::isFormatSupported(pixelformat)) {
+        int bytesperline = P216Packer::minimumBytesPerLine(pixelformat, kMeasureWidth);
+        std::vector<uint8_t> input(P216Packer::inputFrameSize(pixelformat, bytesperline, kMeasureHeight));
+        for (size_t i = 0; i < input.size(); i++) {
+            input[i] = static_cast<uint8_t>(64 + (i & 127));
+        }
+
+        P216Packer packer;
+        best_ns = measureTiming([&]() {
+            return packer.pack(input.data(), input.size(), kMeasureWidth, kMeasureHeight,
+                               bytesperline, pixelformat, output);
+        });
+    } else {
+        best_ns = measureBGRACost(pixelformat, output);
+    }
+    if (best_ns < 0.0) {
+        return -1.0;
+    }
+
+    double cost = best_ns / static_cast<double>(pixels);
+    Logger::debug("FormatSelector: " + V4L2FormatConverter::getFormatName(pixelformat) +
+                  " conversion measured at " + std::to_string(cost) + " ns/pixel");
+    return cost;
+}
+
+double FormatSelector::measureBGRACost(uint32_t pixelformat, std::vector<uint8_t>& output) {
+    size_t pixels = static_cast<size_t>(kMeasureWidth) * kMeasureHeight;
+    size_t input_size = 0;
+    switch (pixelformat) {
+        case V4L2_PIX_FMT_NV12:
+            input_size = pixels * 3 / 2;
+            break;
+        case V4L2_PIX_FMT_RGB24:
+        case V4L2_PIX_FMT_BGR24:
+            input_size = pixels * 3;
+            break;
+        default:
+            input_size = pixels * 2;
+            break;
+    }
+
+    // Mid-grey with a ramp so nothing is trivially constant
+    std::vector<uint8_t> input(input_size);
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = static_cast<uint8_t>(64 + (i & 127));
+    }
+
+    V4L2FormatConverter converter;
+    return measureTiming([&]() {
+        return converter.convertToBGRA(input.data(), input.size(), kMeasureWidth, kMeasureHeight,
+                                       pixelformat, output);
+    });
+}
+
+double FormatSelector::measureMJPEGCost(std::vector<uint8_t>& output) {
+    // Smooth test frame with restart markers on every MCU row, like a
+    // capture card's; one thread, since not every source can be sliced
+    std::vector<uint8_t> uyvy(MjpegDecoder::calculateUYVYSize(kMeasureWidth, kMeasureHeight));
+    for (int y = 0; y < kMeasureHeight; y++) {
+        uint8_t* row = uyvy.data() + static_cast<size_t>(y) * kMeasureWidth * 2;
+        for (int x = 0; x < kMeasureWidth; x++) {
+            row[x * 2] = static_cast<uint8_t>((x & 1) ? 128 + y / 4 : 128 + x / 4);
+            row[x * 2 + 1] = static_cast<uint8_t>(16 + ((x + y) * 219) / (kMeasureWidth + kMeasureHeight));
+        }
+    }
+    std::vector<uint8_t> jpeg;
+    if (!MjpegDecoder::encodeUYVY(uyvy.data(), kMeasureWidth, kMeasureHeight, 90, 1, jpeg)) {
+        return -1.0;
+    }
+
+    MjpegDecoder decoder(1);
+    return measureTiming([&]() {
+        return decoder.decode(jpeg.data(), jpeg.size(), kMeasureWidth, kMeasureHeight, output);
+    });
+}
+
+double FormatSelector::measureTiming(const std::function<bool()>& convert) {
+    double best_ns = -1.0;
+    for (int run = 0; run < kMeasureRuns; run++) {
+        auto start = std::chrono::steady_clock::now();
+        if (!convert()) {
+            return -1.0;
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (best_ns < 0.0 || ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+    return best_ns;
+}
+
+double FormatSelector::score(const FormatCandidate& candidate) const {
+    double pixels = static_cast<double>(candidate.width) * candidate.height;
+    double fps = std::min(candidate.fps, kMaxUsefulFps);
+    double rate = pixels * fps;
+
+    // Fraction of a core spent converting this pixel rate
+    double load = candidate.cost_ns_per_pixel * rate / 1e9;
+    if (load > kConversionBudget) {
+        return rate * kConversionBudget / load;
+    }
+    return rate;
+}
+
+std::vector<FormatCandidate> FormatSelector::rank(std::vector<FormatCandidate> candidates) const {
+    std::vector<FormatCandidate> ranked;
+    ranked.reserve(candidates.size());
+
+    for (auto& candidate : candidates) {
+        candidate.cost_ns_per_pixel = formatCost(candidate.pixelformat);
+        if (candidate.cost_ns_per_pixel < 0.0) {
+            continue;
+        }
+        candidate.score = score(candidate);
+        ranked.push_back(candidate);
+    }
+
+    // Stable so equal modes keep the driver's enumeration order
+    switch (policy_) {
+        case FormatPolicy::Score:
+            std::stable_sort(ranked.begin(), ranked.end(),
+                             [this](const FormatCandidate& a, const FormatCandidate& b) {
+                if (a.score != b.score) return a.score > b.score;
+                // Same rate: 4:2:2 before 4:2:0 even when the latter is cheaper
+                int ia = priorityIndex(a.pixelformat);
+                int ib = priorityIndex(b.pixelformat);
+                if (ia != ib) return ia < ib;
+                return a.cost_ns_per_pixel < b.cost_ns_per_pixel;
+            });
+            break;
+        case FormatPolicy::Native:
+            std::stable_sort(ranked.begin(), ranked.end(),
+                             [this](const FormatCandidate& a, const FormatCandidate& b) {
+                uint64_t pa = static_cast<uint64_t>(a.width) * a.height;
+                uint64_t pb = static_cast<uint64_t>(b.width) * b.height;
+                if (pa != pb) return pa > pb;
+                if (a.fps != b.fps) return a.fps > b.fps;
+                if (prefer_10bit_) {
+                    // Preferred 10-bit formats have negative priority indices
+                    bool a10 = priorityIndex(a.pixelformat) < 0;
+                    bool b10 = priorityIndex(b.pixelformat) < 0;
+                    if (a10 != b10) return a10;
+                }
+                return a.cost_ns_per_pixel < b.cost_ns_per_pixel;
+            });
+            break;
+        case FormatPolicy::Priority:
+            std::stable_sort(ranked.begin(), ranked.end(),
+                             [this](const FormatCandidate& a, const FormatCandidate& b) {
+                return priorityIndex(a.pixelformat) < priorityIndex(b.pixelformat);
+            });
+            break;
+    }
+
+    return ranked;
+}
+
+const char* formatPolicyToString(FormatPolicy policy) {
+    switch (policy) {
+        case FormatPolicy::Score: return "score";
+        case FormatPolicy::Native: return "native";
+        case FormatPolicy::Priority: return "priority";
+    }
+    return "score";
+}
+
+bool formatPolicyFromString(const std::string& value, FormatPolicy& policy) {
+    if (value == "score") {
+        policy = FormatPolicy::Score;
+    } else if (value == "native") {
+        policy = FormatPolicy::Native;
+    } else if (value == "priority") {
+        policy = FormatPolicy::Priority;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
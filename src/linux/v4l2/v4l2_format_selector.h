@@ -0,0 +1,97 @@
+// v4l2_format_selector.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief How V4L2Capture chooses among the enumerated modes
+ */
+enum class FormatPolicy {
+    Score,      // Resolution x fps the CPU can sustain after conversion cost
+    Native,     // Largest resolution, then highest fps, then cheapest format
+    Priority    // First size of the highest-priority pixel format (legacy)
+};
+
+/**
+ * @brief One enumerated capture mode with its selection cost and score
+ */
+struct FormatCandidate {
+    uint32_t pixelformat = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t fps = 0;
+    double cost_ns_per_pixel = 0.0;  // CPU time on the send path (<0 = unusable)
+    double score = 0.0;
+};
+
+/**
+ * @brief Ranks capture modes by resolution, frame rate and pixel format cost
+ *
+ * The cost of a pixel format is the CPU time per pixel it needs before the
+ * frame can go to NDI: zero for UYVY (sent as captured), a byte shuffle for
+ * YUYV, and the measured time of V4L2FormatConverter::convertToBGRA (or
+ * P216Packer for 10-bit formats) for everything else. Converter costs are
+ * measured once per process on a small synthetic frame, so they reflect the
+ * CPU the bridge is running on.
+ *
+ * Score policy: score = width * height * min(fps, 60), scaled down by
+ * budget / load when converting that pixel rate would need more than the
+ * conversion budget (a fraction of one core). 1080p60 YUYV therefore beats
+ * 640x480 UYVY, while a mode the CPU cannot convert in real time loses to a
+ * smaller one it can.
+ *
+ * 10-bit formats (v210, Y210, P010) rank after the 8-bit ones at equal
+ * score unless prefer_10bit is set, which moves them to the front of the
+ * priority order so HDR sources keep their precision.
+ *
+ * MJPEG is costed by decoding a synthetic frame on one thread; sources
+ * whose restart markers allow sliced decoding come out cheaper in practice.
+ *
+ * Version: 1.2.0
+ */
+class FormatSelector {
+public:
+    explicit FormatSelector(FormatPolicy policy, bool prefer_10bit = false);
+
+    /**
+     * @brief Rank candidates best first
+     *
+     * Formats without a send path (negative cost) are left out; the caller
+     * keeps its own last-resort fallback.
+     */
+    std::vector<FormatCandidate> rank(std::vector<FormatCandidate> candidates) const;
+
+    /**
+     * @brief CPU cost of a pixel format on the send path
+     * @return Nanoseconds per pixel, negative if the format cannot be sent
+     */
+    static double formatCost(uint32_t pixelformat);
+
+    FormatPolicy getPolicy() const { return policy_; }
+
+private:
+    double score(const FormatCandidate& candidate) const;
+    static double measureConverterCost(uint32_t pixelformat);
+    static double measureBGRACost(uint32_t pixelformat, std::vector<uint8_t>& output);
+    static double measureMJPEGCost(std::vector<uint8_t>& output);
+    static double measureTiming(const std::function<bool()>& convert);
+    int priorityIndex(uint32_t pixelformat) const;
+
+    FormatPolicy policy_;
+    bool prefer_10bit_;
+};
+
+/**
+ * @brief Convert format policy to/from its config string
+ */
+const char* formatPolicyToString(FormatPolicy policy);
+bool formatPolicyFromString(const std::string& value, FormatPolicy& policy);
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,135 @@
+// v4l2_frame_pacer.cpp
+#include "v4l2_frame_pacer.h"
+#include "../../common/logger.h"
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+constexpr int64_t kNsPerSec = 1000000000LL;
+constexpr int64_t kDefaultIntervalNs = kNsPerSec / 60;
+}
+
+FramePacer::FramePacer()
+    : timer_fd_(-1)
+    , interval_ns_(kDefaultIntervalNs)
+    , last_timestamp_ns_(0)
+    , avg_jitter_us_(0.0)
+    , max_jitter_us_(0.0)
+    , samples_(0) {
+}
+
+FramePacer::~FramePacer() {
+    closeTimer();
+}
+
+bool FramePacer::setInterval(uint32_t numerator, uint32_t denominator) {
+    if (numerator == 0 || denominator == 0) {
+        return false;
+    }
+
+    interval_ns_ = static_cast<int64_t>(numerator) * kNsPerSec / denominator;
+    reset();
+    return true;
+}
+
+bool FramePacer::openTimer() {
+    if (timer_fd_ >= 0) {
+        return true;
+    }
+
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ < 0) {
+        Logger::warning("FramePacer: timerfd_create failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+void FramePacer::closeTimer() {
+    if (timer_fd_ >= 0) {
+        close(timer_fd_);
+        timer_fd_ = -1;
+    }
+}
+
+uint32_t FramePacer::onFrame(int64_t timestamp_ns) {
+    uint32_t skipped = 0;
+
+    if (last_timestamp_ns_ > 0 && timestamp_ns > last_timestamp_ns_) {
+        int64_t delta_ns = timestamp_ns - last_timestamp_ns_;
+
+        // Slots elapsed, rounded to the nearest whole frame
+        int64_t slots = (delta_ns + interval_ns_ / 2) / interval_ns_;
+        if (slots > 1) {
+            skipped = static_cast<uint32_t>(slots - 1);
+        } else {
+            // Jitter only makes sense between adjacent frames
+            double jitter_us = std::fabs(static_cast<double>(delta_ns - interval_ns_)) / 1000.0;
+            if (samples_ == 0) {
+                avg_jitter_us_ = jitter_us;
+            } else {
+                avg_jitter_us_ = 0.95 * avg_jitter_us_ + 0.05 * jitter_us;
+            }
+            if (jitter_us > max_jitter_us_) {
+                max_jitter_us_ = jitter_us;
+            }
+            samples_++;
+        }
+    }
+
+    last_timestamp_ns_ = timestamp_ns;
+    armDeadline(timestamp_ns);
+    return skipped;
+}
+
+uint64_t FramePacer::onTimer() {
+    if (timer_fd_ < 0) {
+        return 0;
+    }
+
+    uint64_t expirations = 0;
+    if (read(timer_fd_, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return 0;
+    }
+    return expirations;
+}
+
+void FramePacer::reset() {
+    last_timestamp_ns_ = 0;
+    avg_jitter_us_ = 0.0;
+    max_jitter_us_ = 0.0;
+    samples_ = 0;
+
+    if (timer_fd_ >= 0) {
+        struct itimerspec disarm;
+        memset(&disarm, 0, sizeof(disarm));
+        timerfd_settime(timer_fd_, 0, &disarm, nullptr);
+    }
+}
+
+void FramePacer::armDeadline(int64_t frame_time_ns) {
+    if (timer_fd_ < 0) {
+        return;
+    }
+
+    // First expiry half a frame after the next expected frame, then once per slot
+    int64_t deadline_ns = frame_time_ns + interval_ns_ + interval_ns_ / 2;
+
+    struct itimerspec spec;
+    spec.it_value.tv_sec = deadline_ns / kNsPerSec;
+    spec.it_value.tv_nsec = deadline_ns % kNsPerSec;
+    spec.it_interval.tv_sec = interval_ns_ / kNsPerSec;
+    spec.it_interval.tv_nsec = interval_ns_ % kNsPerSec;
+
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,82 @@
+// v4l2_frame_pacer.h
+#pragma once
+
+#include <cstdint>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief Frame cadence tracker driven by the negotiated frame interval
+ *
+ * The interval comes from VIDIOC_G_PARM timeperframe (or DV timings), so
+ * 50 Hz, 59.94 Hz and 30 fps sources are paced at their real rate instead
+ * of an assumed 60 fps. A CLOCK_MONOTONIC timerfd is armed one and a half
+ * intervals after the last frame; it only fires when a frame is late, so
+ * the capture thread does not wake up on a millisecond poll timeout.
+ *
+ * Cadence jitter is the deviation of consecutive V4L2 buffer timestamps
+ * from the nominal interval.
+ *
+ * Version: 1.0.0
+ */
+class FramePacer {
+public:
+    FramePacer();
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /**
+     * @brief Set the nominal frame interval (seconds per frame as a fraction)
+     * @return false if the fraction is invalid
+     */
+    bool setInterval(uint32_t numerator, uint32_t denominator);
+
+    int64_t getIntervalNs() const { return interval_ns_; }
+
+    /**
+     * @brief Create the timerfd (non-blocking, close-on-exec)
+     * @return false if timerfd_create failed
+     */
+    bool openTimer();
+    void closeTimer();
+    int getTimerFd() const { return timer_fd_; }
+
+    /**
+     * @brief Register a captured frame
+     * @param timestamp_ns V4L2 buffer timestamp (CLOCK_MONOTONIC)
+     * @return Number of cadence slots skipped since the previous frame
+     */
+    uint32_t onFrame(int64_t timestamp_ns);
+
+    /**
+     * @brief Consume a timer expiration (frame is late)
+     * @return Number of expirations read from the timerfd
+     */
+    uint64_t onTimer();
+
+    /**
+     * @brief Forget the previous frame (after stream restart)
+     */
+    void reset();
+
+    // Cadence jitter statistics (microseconds)
+    double getAvgJitterUs() const { return avg_jitter_us_; }
+    double getMaxJitterUs() const { return max_jitter_us_; }
+    void resetMaxJitter() { max_jitter_us_ = 0.0; }
+
+private:
+    void armDeadline(int64_t frame_time_ns);
+
+    int timer_fd_;
+    int64_t interval_ns_;
+    int64_t last_timestamp_ns_;
+    double avg_jitter_us_;
+    double max_jitter_us_;
+    uint64_t samples_;
+};
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,272 @@
+// v4l2_hotplug_monitor.cpp
+#include "v4l2_hotplug_monitor.h"
+#include "../../common/logger.h"
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <cstring>
+#include <chrono>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+// Kernel uevents (not the udevd re-broadcast group)
+constexpr unsigned int kUeventGroupKernel = 1;
+constexpr size_t kUeventBufferSize = 8192;
+}
+
+HotplugMonitor::HotplugMonitor()
+    : socket_fd_(-1)
+    , wake_fd_(-1)
+    , present_(true) {
+}
+
+HotplugMonitor::~HotplugMonitor() {
+    stop();
+}
+
+std::string HotplugMonitor::resolveBusPath(const std::string& device_path) {
+    // /dev/video0 -> /sys/class/video4linux/video0/device
+    size_t slash = device_path.find_last_of('/');
+    std::string node = (slash == std::string::npos) ? device_path : device_path.substr(slash + 1);
+    std::string link = "/sys/class/video4linux/" + node + "/device";
+
+    char resolved[PATH_MAX];
+    if (!realpath(link.c_str(), resolved)) {
+        return "";
+    }
+
+    std::string path(resolved);
+
+    // USB capture sticks: watch the USB device (1-2), not the interface (1-2:1.0)
+    size_t last = path.find_last_of('/');
+    if (last != std::string::npos && path.find(':', last) != std::string::npos &&
+        path.find("/usb", 0) != std::string::npos) {
+        path = path.substr(0, last);
+    }
+
+    // uevent DEVPATH values are relative to /sys
+    if (path.compare(0, 4, "/sys") == 0) {
+        path = path.substr(4);
+    }
+    return path;
+}
+
+bool HotplugMonitor::start(const std::string& device_path) {
+    if (running_) {
+        return true;
+    }
+
+    bus_path_ = resolveBusPath(device_path);
+    if (bus_path_.empty()) {
+        Logger::warning("HotplugMonitor: Cannot resolve bus path for " + device_path);
+        return false;
+    }
+
+    socket_fd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (socket_fd_ < 0) {
+        Logger::warning("HotplugMonitor: Cannot open uevent socket: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_pid = 0;  // Let the kernel assign
+    addr.nl_groups = kUeventGroupKernel;
+
+    if (bind(socket_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        Logger::warning("HotplugMonitor: Cannot bind uevent socket: " + std::string(strerror(errno)));
+        close(socket_fd_);
+        socket_fd_ = -1;
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        close(socket_fd_);
+        socket_fd_ = -1;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        present_ = true;
+        device_node_ = device_path;
+    }
+
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&HotplugMonitor::monitorThread, this);
+
+    Logger::info("HotplugMonitor: Watching " + device_path + " at " + bus_path_);
+    return true;
+}
+
+void HotplugMonitor::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        Logger::debug("HotplugMonitor: Wakeup failed: " + std::string(strerror(errno)));
+    }
+
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+
+    close(socket_fd_);
+    socket_fd_ = -1;
+    close(wake_fd_);
+    wake_fd_ = -1;
+
+    // Release any waiter
+    cv_.notify_all();
+}
+
+void HotplugMonitor::setRemovedCallback(RemovedCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    removed_callback_ = std::move(callback);
+}
+
+bool HotplugMonitor::isPresent() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return present_;
+}
+
+std::string HotplugMonitor::getDeviceNode() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return device_node_;
+}
+
+std::string HotplugMonitor::getBusPath() const {
+    return bus_path_;
+}
+
+bool HotplugMonitor::waitForDevice(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                 [this] { return present_ || !running_; });
+    return present_;
+}
+
+void HotplugMonitor::monitorThread() {
+    struct pollfd pfds[2];
+    pfds[0].fd = socket_fd_;
+    pfds[0].events = POLLIN;
+    pfds[1].fd = wake_fd_;
+    pfds[1].events = POLLIN;
+
+    char buffer[kUeventBufferSize];
+
+    while (running_) {
+        int ret = poll(pfds, 2, -1);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            Logger::error("HotplugMonitor: poll failed: " + std::string(strerror(errno)));
+            break;
+        }
+
+        if (pfds[1].revents & POLLIN) {
+            break;
+        }
+
+        if (!(pfds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        // Drain all queued uevents
+        while (true) {
+            ssize_t len = recv(socket_fd_, buffer, sizeof(buffer) - 1, 0);
+            if (len <= 0) {
+                if (len < 0 && errno == ENOBUFS) {
+                    Logger::warning("HotplugMonitor: uevent socket overrun, events lost");
+                    continue;
+                }
+                break;
+            }
+            buffer[len] = '\0';
+            handleUevent(buffer, static_cast<size_t>(len));
+        }
+    }
+}
+
+void HotplugMonitor::handleUevent(const char* buffer, size_t length) {
+    // Kernel format: "ACTION@DEVPATH\0KEY=VALUE\0KEY=VALUE\0..."
+    std::string action;
+    std::string devpath;
+    std::string subsystem;
+    std::string devname;
+
+    size_t pos = strlen(buffer) + 1;  // Skip the header line
+    while (pos < length) {
+        const char* entry = buffer + pos;
+        size_t entry_len = strlen(entry);
+        if (strncmp(entry, "ACTION=", 7) == 0) {
+            action = entry + 7;
+        } else if (strncmp(entry, "DEVPATH=", 8) == 0) {
+            devpath = entry + 8;
+        } else if (strncmp(entry, "SUBSYSTEM=", 10) == 0) {
+            subsystem = entry + 10;
+        } else if (strncmp(entry, "DEVNAME=", 8) == 0) {
+            devname = entry + 8;
+        }
+        pos += entry_len + 1;
+    }
+
+    if (subsystem != "video4linux") {
+        return;
+    }
+
+    // Only nodes below the watched port/slot
+    if (devpath.compare(0, bus_path_.size(), bus_path_) != 0 ||
+        (devpath.size() > bus_path_.size() && devpath[bus_path_.size()] != '/')) {
+        return;
+    }
+
+    std::string node = devname.empty() ? std::string() :
+                       (devname[0] == '/' ? devname : "/dev/" + devname);
+
+    RemovedCallback removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (action == "remove") {
+            // Multi-node devices (video0 + video1 metadata) remove more than one node
+            if (!present_ || (!node.empty() && node != device_node_)) {
+                return;
+            }
+            present_ = false;
+            removed = removed_callback_;
+            Logger::warning("HotplugMonitor: Device removed (" + device_node_ + ")");
+        } else if (action == "add") {
+            if (present_) {
+                return;
+            }
+            // The first node registered by the device is the capture node
+            present_ = true;
+            if (!node.empty()) {
+                device_node_ = node;
+            }
+            Logger::info("HotplugMonitor: Device reappeared as " + device_node_);
+        } else {
+            return;
+        }
+    }
+
+    cv_.notify_all();
+    if (removed) {
+        removed();
+    }
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,101 @@
+// v4l2_hotplug_monitor.h
+#pragma once
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief Watches a capture device by bus path through kernel uevents
+ *
+ * Listens on a NETLINK_KOBJECT_UEVENT socket for video4linux add/remove
+ * events below the sysfs bus path of the watched device (the USB port or
+ * PCI slot, not the /dev/videoN number). An unplug is reported the moment
+ * the kernel removes the node, and a waiter is released as soon as the
+ * device registers again - no fixed retry sleep.
+ *
+ * Version: 1.0.0
+ */
+class HotplugMonitor {
+public:
+    using RemovedCallback = std::function<void()>;
+
+    HotplugMonitor();
+    ~HotplugMonitor();
+
+    HotplugMonitor(const HotplugMonitor&) = delete;
+    HotplugMonitor& operator=(const HotplugMonitor&) = delete;
+
+    /**
+     * @brief Start watching the device behind a /dev/videoN node
+     * @param device_path Device node of the currently present device
+     * @return false if the bus path or the netlink socket is unavailable
+     */
+    bool start(const std::string& device_path);
+
+    /**
+     * @brief Stop the monitor thread
+     */
+    void stop();
+
+    bool isWatching() const { return running_.load(); }
+
+    /**
+     * @brief Called from the monitor thread when the device is removed
+     */
+    void setRemovedCallback(RemovedCallback callback);
+
+    /**
+     * @brief Whether the watched device is currently registered
+     */
+    bool isPresent() const;
+
+    /**
+     * @brief Current /dev node of the watched device (may change on replug)
+     */
+    std::string getDeviceNode() const;
+
+    /**
+     * @brief Sysfs bus path being watched (e.g. /devices/pci0000:00/.../1-2)
+     */
+    std::string getBusPath() const;
+
+    /**
+     * @brief Block until the device is present
+     * @param timeout_ms Maximum wait
+     * @return true if the device is present
+     */
+    bool waitForDevice(int timeout_ms);
+
+    /**
+     * @brief Resolve the bus path of a /dev/videoN node from sysfs
+     * @return DEVPATH-style path without the /sys prefix, empty on failure
+     */
+    static std::string resolveBusPath(const std::string& device_path);
+
+private:
+    void monitorThread();
+    void handleUevent(const char* buffer, size_t length);
+
+    int socket_fd_;
+    int wake_fd_;
+    std::string bus_path_;
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool present_;
+    std::string device_node_;
+    RemovedCallback removed_callback_;
+};
+
+} // namespace v4l2
+} // namespace ndi_bridge
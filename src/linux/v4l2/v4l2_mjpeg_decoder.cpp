@@ -0,0 +1,521 @@
+// v4l2_mjpeg_decoder.cpp
+#include "v4l2_mjpeg_decoder.h"
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <jpeglib.h>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+
+// libjpeg reports fatal errors through error_exit, which must not return
+struct ErrorManager {
+    jpeg_error_mgr pub;   // First member: libjpeg sees only this part
+    jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void onJpegError(j_common_ptr cinfo) {
+    ErrorManager* error = reinterpret_cast<ErrorManager*>(cinfo->err);
+    (*cinfo->err->format_message)(cinfo, error->message);
+    longjmp(error->jump, 1);
+}
+
+void onJpegMessage(j_common_ptr cinfo, int msg_level) {
+    // Corrupt-data warnings are routine on USB MJPEG; libjpeg conceals the
+    // damaged blocks and the frame is still worth sending
+}
+
+inline int readBE16(const uint8_t* p) {
+    return (p[0] << 8) | p[1];
+}
+
+int gcd(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// One output line from raw planes; full_chroma = 4:4:4 input
+void packRow(const uint8_t* y, const uint8_t* cb, const uint8_t* cr,
+             bool full_chroma, int width, uint8_t* out) {
+    const int pairs = width / 2;
+    if (full_chroma) {
+        for (int i = 0; i < pairs; i++) {
+            out[4 * i + 0] = static_cast<uint8_t>((cb[2 * i] + cb[2 * i + 1] + 1) >> 1);
+            out[4 * i + 1] = y[2 * i];
+            out[4 * i + 2] = static_cast<uint8_t>((cr[2 * i] + cr[2 * i + 1] + 1) >> 1);
+            out[4 * i + 3] = y[2 * i + 1];
+        }
+    } else {
+        for (int i = 0; i < pairs; i++) {
+            out[4 * i + 0] = cb[i];
+            out[4 * i + 1] = y[2 * i];
+            out[4 * i + 2] = cr[i];
+            out[4 * i + 3] = y[2 * i + 1];
+        }
+    }
+}
+
+} // anonymous namespace
+
+struct MjpegDecoder::DecodeContext {
+    jpeg_decompress_struct cinfo;
+    ErrorManager error;
+    std::vector<uint8_t> planes[3];    // One iMCU row per component
+    std::vector<JSAMPROW> rows[3];
+    std::vector<uint8_t> gray_chroma;  // Neutral chroma for grayscale frames
+
+    DecodeContext() {
+        cinfo.err = jpeg_std_error(&error.pub);
+        error.pub.error_exit = onJpegError;
+        error.pub.emit_message = onJpegMessage;
+        error.message[0] = '\0';
+        jpeg_create_decompress(&cinfo);
+    }
+
+    ~DecodeContext() {
+        jpeg_destroy_decompress(&cinfo);
+    }
+};
+
+MjpegDecoder::MjpegDecoder(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    thread_count_ = std::max(1, std::min(threads, kMaxThreads));
+
+    for (int i = 0; i < thread_count_; i++) {
+        contexts_.push_back(std::make_unique<DecodeContext>());
+    }
+    for (int i = 1; i < thread_count_; i++) {
+        workers_.emplace_back(&MjpegDecoder::workerThread, this, i);
+    }
+}
+
+MjpegDecoder::~MjpegDecoder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t MjpegDecoder::calculateUYVYSize(int width, int height) {
+    return static_cast<size_t>(width) * height * 2;
+}
+
+bool MjpegDecoder::decode(const void* input, size_t input_size, int width, int height,
+                          std::vector<uint8_t>& output) {
+    if (!input || input_size < 4 || width <= 0 || height <= 0 || (width & 1)) {
+        setError("Invalid MJPEG frame parameters");
+        return false;
+    }
+
+    output.resize(calculateUYVYSize(width, height));
+    output_ = output.data();
+    output_width_ = width;
+
+    const uint8_t* data = static_cast<const uint8_t*>(input);
+    if (thread_count_ < 2 || !planSlices(data, input_size, width, height)) {
+        // Whole frame on this thread
+        if (slices_.empty()) {
+            slices_.resize(1);
+        }
+        Slice& slice = slices_[0];
+        slice.data = data;
+        slice.size = input_size;
+        slice.first_row = 0;
+        slice.rows = height;
+        slice_count_ = 1;
+    }
+
+    runSlices();
+    last_slice_count_ = slice_count_;
+
+    for (int i = 0; i < slice_count_; i++) {
+        if (!slices_[i].ok) {
+            setError(slices_[i].error);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MjpegDecoder::planSlices(const uint8_t* data, size_t size, int width, int height) {
+    if (data[0] != 0xFF || data[1] != 0xD8) {
+        return false;
+    }
+
+    // Header: frame geometry, restart interval, start of entropy data
+    size_t pos = 2;
+    size_t sof_pos = 0;
+    size_t scan_start = 0;
+    int restart_interval = 0;
+    int components = 0;
+    int max_h = 1;
+    int max_v = 1;
+    while (pos + 4 <= size && scan_start == 0) {
+        if (data[pos] != 0xFF) {
+            return false;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            pos++;   // Fill byte
+            continue;
+        }
+        int length = readBE16(data + pos + 2);
+        if (length < 2 || pos + 2 + length > size) {
+            return false;
+        }
+        const uint8_t* segment = data + pos + 4;
+        switch (marker) {
+            case 0xC0:   // Baseline
+            case 0xC1:   // Extended sequential, Huffman
+                if (length < 8) {
+                    return false;
+                }
+                sof_pos = pos;
+                if (readBE16(segment + 1) != height || readBE16(segment + 3) != width) {
+                    return false;
+                }
+                components = segment[5];
+                if (length < 8 + 3 * components) {
+                    return false;
+                }
+                for (int c = 0; c < components; c++) {
+                    max_h = std::max(max_h, segment[7 + 3 * c] >> 4);
+                    max_v = std::max(max_v, segment[7 + 3 * c] & 0x0F);
+                }
+                break;
+            case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+            case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+                // Progressive, lossless, arithmetic: no restart slicing
+                return false;
+            case 0xDD:
+                if (length < 4) {
+                    return false;
+                }
+                restart_interval = readBE16(segment);
+                break;
+            case 0xDA:
+                // All components in one scan, or the MCU layout below is wrong
+                if (segment[0] != components) {
+                    return false;
+                }
+                scan_start = pos + 2 + length;
+                break;
+            default:
+                break;
+        }
+        pos += 2 + length;
+    }
+    if (sof_pos == 0 || scan_start == 0 || restart_interval == 0 ||
+        (components != 1 && components != 3)) {
+        return false;
+    }
+
+    // Single-component scans use one 8x8 block per MCU
+    const int mcu_width = components == 1 ? 8 : 8 * max_h;
+    const int mcu_height = components == 1 ? 8 : 8 * max_v;
+    const int mcus_per_row = (width + mcu_width - 1) / mcu_width;
+    const int mcu_rows = (height + mcu_height - 1) / mcu_height;
+    const long total_mcus = static_cast<long>(mcus_per_row) * mcu_rows;
+    const int segments = static_cast<int>((total_mcus + restart_interval - 1) / restart_interval);
+
+    // Restart markers in the entropy data (0xFF00 is a stuffed byte)
+    restart_positions_.clear();
+    size_t end = size;
+    const uint8_t* p = data + scan_start;
+    const uint8_t* limit = data + size - 1;
+    while (p < limit) {
+        p = static_cast<const uint8_t*>(memchr(p, 0xFF, limit - p));
+        if (!p) {
+            break;
+        }
+        uint8_t marker = p[1];
+        if (marker >= 0xD0 && marker <= 0xD7) {
+            restart_positions_.push_back(static_cast<size_t>(p - data));
+        } else if (marker == 0xD9) {
+            end = static_cast<size_t>(p - data);
+            break;
+        } else if (marker != 0x00 && marker != 0xFF) {
+            return false;   // Another scan or a marker we do not handle
+        }
+        p += (marker == 0xFF) ? 1 : 2;
+    }
+    if (static_cast<int>(restart_positions_.size()) + 1 != segments) {
+        return false;
+    }
+
+    // Cut points: restart segments that begin at the start of an MCU row
+    const int lcm = restart_interval / gcd(restart_interval, mcus_per_row) * mcus_per_row;
+    const int rows_per_unit = lcm / mcus_per_row;
+    const int segments_per_unit = lcm / restart_interval;
+    const int units = (mcu_rows + rows_per_unit - 1) / rows_per_unit;
+    if (units < 2) {
+        return false;
+    }
+
+    // Two bands per thread evens out bands that are cheaper to decode
+    const int count = std::min(units, thread_count_ * 2);
+    if (static_cast<int>(slices_.size()) < count) {
+        slices_.resize(count);
+    }
+
+    const size_t header_size = scan_start;
+    for (int k = 0; k < count; k++) {
+        const int unit_begin = k * units / count;
+        const int unit_end = (k + 1) * units / count;
+        const int seg_begin = unit_begin * segments_per_unit;
+        const int seg_end = std::min(unit_end * segments_per_unit, segments);
+
+        Slice& slice = slices_[k];
+        slice.first_row = unit_begin * rows_per_unit * mcu_height;
+        slice.rows = std::min(height, unit_end * rows_per_unit * mcu_height) - slice.first_row;
+
+        size_t body_begin = seg_begin == 0 ? scan_start : restart_positions_[seg_begin - 1] + 2;
+        size_t body_end = seg_end == segments ? end : restart_positions_[seg_end - 1];
+
+        // Header with this band's height, the band's segments, EOI
+        std::vector<uint8_t>& jpeg = slice.jpeg;
+        jpeg.resize(header_size + (body_end - body_begin) + 2);
+        memcpy(jpeg.data(), data, header_size);
+        jpeg[sof_pos + 5] = static_cast<uint8_t>(slice.rows >> 8);
+        jpeg[sof_pos + 6] = static_cast<uint8_t>(slice.rows & 0xFF);
+        memcpy(jpeg.data() + header_size, data + body_begin, body_end - body_begin);
+        jpeg[jpeg.size() - 2] = 0xFF;
+        jpeg[jpeg.size() - 1] = 0xD9;
+
+        // A standalone JPEG starts counting restart markers at RST0
+        for (int s = seg_begin; s < seg_end - 1; s++) {
+            size_t offset = header_size + (restart_positions_[s] - body_begin);
+            jpeg[offset + 1] = static_cast<uint8_t>(0xD0 + ((s - seg_begin) & 7));
+        }
+
+        slice.data = jpeg.data();
+        slice.size = jpeg.size();
+    }
+
+    slice_count_ = count;
+    return true;
+}
+
+bool MjpegDecoder::decodeSlice(DecodeContext& context, Slice& slice) {
+    jpeg_decompress_struct& cinfo = context.cinfo;
+
+    if (setjmp(context.error.jump)) {
+        jpeg_abort_decompress(&cinfo);
+        slice.error = std::string("MJPEG decode failed: ") + context.error.message;
+        return false;
+    }
+
+    jpeg_mem_src(&cinfo, slice.data, static_cast<unsigned long>(slice.size));
+    jpeg_read_header(&cinfo, TRUE);
+
+    if (static_cast<int>(cinfo.image_width) != output_width_ ||
+        static_cast<int>(cinfo.image_height) < slice.rows) {
+        slice.error = "MJPEG frame is " + std::to_string(cinfo.image_width) + "x" +
+                      std::to_string(cinfo.image_height) + ", expected " +
+                      std::to_string(output_width_) + "x" + std::to_string(slice.rows);
+        jpeg_abort_decompress(&cinfo);
+        return false;
+    }
+
+    // Luma up to 2x2, chroma 1x1: 4:4:4, 4:2:2, 4:4:0 or 4:2:0
+    const bool gray = cinfo.num_components == 1 && cinfo.jpeg_color_space == JCS_GRAYSCALE;
+    const jpeg_component_info* comp = cinfo.comp_info;
+    if (!gray && (cinfo.num_components != 3 || cinfo.jpeg_color_space != JCS_YCbCr ||
+                  comp[0].h_samp_factor > 2 || comp[0].v_samp_factor > 2 ||
+                  comp[1].h_samp_factor != 1 || comp[1].v_samp_factor != 1 ||
+                  comp[2].h_samp_factor != 1 || comp[2].v_samp_factor != 1)) {
+        slice.error = "Unsupported MJPEG sampling";
+        jpeg_abort_decompress(&cinfo);
+        return false;
+    }
+
+    cinfo.raw_data_out = TRUE;
+    jpeg_start_decompress(&cinfo);
+
+    // One iMCU row of raw planes per jpeg_read_raw_data call
+    JSAMPARRAY arrays[3];
+    for (int c = 0; c < cinfo.num_components; c++) {
+        size_t stride = comp[c].width_in_blocks * DCTSIZE;
+        size_t lines = comp[c].v_samp_factor * DCTSIZE;
+        context.planes[c].resize(stride * lines);
+        context.rows[c].resize(lines);
+        for (size_t line = 0; line < lines; line++) {
+            context.rows[c][line] = context.planes[c].data() + line * stride;
+        }
+        arrays[c] = context.rows[c].data();
+    }
+
+    const int lines_per_call = cinfo.max_v_samp_factor * DCTSIZE;
+    const size_t luma_stride = comp[0].width_in_blocks * DCTSIZE;
+    const uint8_t* cb_plane;
+    const uint8_t* cr_plane;
+    size_t chroma_stride;
+    int luma_v = 1;
+    bool full_chroma;
+    if (gray) {
+        context.gray_chroma.assign(luma_stride, 128);
+        cb_plane = cr_plane = context.gray_chroma.data();
+        chroma_stride = 0;
+        full_chroma = false;   // Every chroma read lands inside the neutral line
+    } else {
+        cb_plane = context.planes[1].data();
+        cr_plane = context.planes[2].data();
+        chroma_stride = comp[1].width_in_blocks * DCTSIZE;
+        luma_v = comp[0].v_samp_factor;
+        full_chroma = comp[0].h_samp_factor == 1;
+    }
+
+    uint8_t* band = output_ + static_cast<size_t>(slice.first_row) * output_width_ * 2;
+    while (static_cast<int>(cinfo.output_scanline) < slice.rows) {
+        int first_line = static_cast<int>(cinfo.output_scanline);
+        int got = static_cast<int>(jpeg_read_raw_data(&cinfo, arrays, lines_per_call));
+        if (got <= 0) {
+            break;
+        }
+        int lines = std::min(got, slice.rows - first_line);
+        for (int r = 0; r < lines; r++) {
+            size_t chroma_offset = static_cast<size_t>(r / luma_v) * chroma_stride;
+            packRow(context.planes[0].data() + r * luma_stride,
+                    cb_plane + chroma_offset, cr_plane + chroma_offset, full_chroma,
+                    output_width_, band + static_cast<size_t>(first_line + r) * output_width_ * 2);
+        }
+    }
+
+    bool complete = static_cast<int>(cinfo.output_scanline) >= slice.rows;
+    // Trailing data after the last needed line does not matter
+    jpeg_abort_decompress(&cinfo);
+    if (!complete) {
+        slice.error = "MJPEG frame ended early";
+    }
+    return complete;
+}
+
+void MjpegDecoder::runSlices() {
+    next_slice_ = 0;
+    if (slice_count_ == 1) {
+        slices_[0].ok = decodeSlice(*contexts_[0], slices_[0]);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_workers_ = static_cast<int>(workers_.size());
+        generation_++;
+    }
+    work_cv_.notify_all();
+
+    // The calling thread decodes bands too
+    int index;
+    while ((index = next_slice_.fetch_add(1)) < slice_count_) {
+        slices_[index].ok = decodeSlice(*contexts_[0], slices_[index]);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return busy_workers_ == 0; });
+}
+
+void MjpegDecoder::workerThread(int index) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this, seen]() { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        int slice;
+        while ((slice = next_slice_.fetch_add(1)) < slice_count_) {
+            slices_[slice].ok = decodeSlice(*contexts_[index], slices_[slice]);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_workers_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void MjpegDecoder::setError(const std::string& error) {
+    last_error_ = error;
+}
+
+bool MjpegDecoder::encodeUYVY(const uint8_t* uyvy, int width, int height, int quality,
+                              int restart_rows, std::vector<uint8_t>& output) {
+    if (!uyvy || width <= 0 || height <= 0 || (width & 1)) {
+        return false;
+    }
+
+    // Preallocated destination; libjpeg only mallocs if a frame outgrows it
+    output.resize(static_cast<size_t>(width) * height * 2 + 65536);
+    std::vector<uint8_t> line(static_cast<size_t>(width) * 3);
+    unsigned char* buffer = output.data();
+    unsigned long size = static_cast<unsigned long>(output.size());
+
+    jpeg_compress_struct cinfo;
+    ErrorManager error;
+    cinfo.err = jpeg_std_error(&error.pub);
+    error.pub.error_exit = onJpegError;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_compress(&cinfo);
+        return false;
+    }
+
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_YCbCr;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    cinfo.comp_info[0].h_samp_factor = 2;
+    cinfo.comp_info[0].v_samp_factor = 1;
+    cinfo.restart_in_rows = restart_rows;
+    jpeg_start_compress(&cinfo, TRUE);
+
+    while (cinfo.next_scanline < cinfo.image_height) {
+        const uint8_t* src = uyvy + static_cast<size_t>(cinfo.next_scanline) * width * 2;
+        for (int i = 0; i < width / 2; i++) {
+            uint8_t* px = line.data() + i * 6;
+            px[0] = src[4 * i + 1];
+            px[1] = src[4 * i + 0];
+            px[2] = src[4 * i + 2];
+            px[3] = src[4 * i + 3];
+            px[4] = src[4 * i + 0];
+            px[5] = src[4 * i + 2];
+        }
+        JSAMPROW row = line.data();
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    if (buffer != output.data()) {
+        output.assign(buffer, buffer + size);
+        free(buffer);
+    } else {
+        output.resize(size);
+    }
+    return true;
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,125 @@
+// v4l2_mjpeg_decoder.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief Decodes MJPEG capture frames straight to UYVY with libjpeg-turbo
+ *
+ * Frames are decoded in raw YCbCr mode (no color conversion) and the
+ * planes are interleaved into UYVY one iMCU row at a time, so NDI gets a
+ * 4:2:2 frame without a BGRA round trip. 4:2:2 JPEGs map 1:1; 4:2:0
+ * chroma lines are used for two output lines and 4:4:4 chroma is
+ * averaged horizontally. Grayscale frames get neutral chroma.
+ *
+ * Capture cards usually emit restart markers. When the restart interval
+ * lines up with MCU rows, the frame is cut at those markers into
+ * horizontal slices; each slice becomes a standalone JPEG (patched
+ * height, renumbered RSTn) and the slices decode in parallel on a small
+ * worker pool plus the calling thread. Frames without usable restart
+ * markers decode on the calling thread.
+ *
+ * Version: 1.0.0
+ */
+class MjpegDecoder {
+public:
+    /**
+     * @param threads Decode threads including the caller (0 = one per
+     *                core, at most kMaxThreads)
+     */
+    explicit MjpegDecoder(int threads = 0);
+    ~MjpegDecoder();
+
+    MjpegDecoder(const MjpegDecoder&) = delete;
+    MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+
+    static constexpr int kMaxThreads = 4;
+
+    /**
+     * @brief Decode one frame
+     * @param input JPEG data
+     * @param input_size Bytes in input
+     * @param width Expected frame width (even)
+     * @param height Expected frame height
+     * @param output UYVY frame, stride width * 2 (resized)
+     * @return false if the data is not a decodable JPEG of that size
+     */
+    bool decode(const void* input, size_t input_size, int width, int height,
+                std::vector<uint8_t>& output);
+
+    int getThreadCount() const { return thread_count_; }
+
+    /**
+     * @brief Slices the last frame was decoded in (1 = not sliced)
+     */
+    int getLastSliceCount() const { return last_slice_count_; }
+
+    std::string getLastError() const { return last_error_; }
+
+    static size_t calculateUYVYSize(int width, int height);
+
+    /**
+     * @brief Encode a UYVY frame as a 4:2:2 JPEG with restart markers
+     *
+     * Produces frames shaped like a capture card's MJPEG for cost
+     * measurement and the benchmark.
+     *
+     * @param restart_rows Restart interval in MCU rows (0 = none)
+     */
+    static bool encodeUYVY(const uint8_t* uyvy, int width, int height, int quality,
+                           int restart_rows, std::vector<uint8_t>& output);
+
+private:
+    struct DecodeContext;
+
+    struct Slice {
+        std::vector<uint8_t> jpeg;   // Standalone JPEG for this band (sliced frames)
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        int first_row = 0;
+        int rows = 0;
+        bool ok = false;
+        std::string error;
+    };
+
+    bool planSlices(const uint8_t* data, size_t size, int width, int height);
+    bool decodeSlice(DecodeContext& context, Slice& slice);
+    void runSlices();
+    void workerThread(int index);
+    void setError(const std::string& error);
+
+    int thread_count_;
+    std::vector<std::unique_ptr<DecodeContext>> contexts_;  // One per thread, [0] = caller
+    std::vector<Slice> slices_;
+    std::vector<size_t> restart_positions_;
+    int slice_count_ = 0;
+    int last_slice_count_ = 0;
+    std::string last_error_;
+
+    // Current frame, set before the workers are woken
+    uint8_t* output_ = nullptr;
+    int output_width_ = 0;
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    int busy_workers_ = 0;
+    bool stopping_ = false;
+    std::atomic<int> next_slice_{0};
+};
+
+} // namespace v4l2
+} // namespace ndi_bridge
@@ -0,0 +1,138 @@
+// v4l2_p216_packer.cpp
+#include "v4l2_p216_packer.h"
+#include "../../common/logger.h"
+#include <cstring>
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+namespace {
+
+// v210 lines are padded to 48 pixels (128 bytes)
+constexpr int kV210LineAlignPixels = 48;
+constexpr int kV210LineAlignBytes = 128;
+
+} // anonymous namespace
+
+P216Packer::P216Packer(const PixelKernels& kernels, StripeExecutor* stripes)
+    : kernels_(kernels), stripes_(stripes) {
+}
+
+CpuIsa P216Packer::getKernelIsa(uint32_t pixelformat) const {
+    switch (pixelformat) {
+        case V4L2_PIX_FMT_V210:
+            return kernels_.v210_to_p216.isa;
+        case V4L2_PIX_FMT_Y210:
+            return kernels_.y210_to_p216.isa;
+        default:
+            return CpuIsa::Scalar;
+    }
+}
+
+bool P216Packer::isFormatSupported(uint32_t pixelformat) {
+    switch (pixelformat) {
+        case V4L2_PIX_FMT_V210:
+        case V4L2_PIX_FMT_Y210:
+        case V4L2_PIX_FMT_P010:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int P216Packer::minimumBytesPerLine(uint32_t pixelformat, int width) {
+    switch (pixelformat) {
+        case V4L2_PIX_FMT_V210:
+            return (width + kV210LineAlignPixels - 1) / kV210LineAlignPixels * kV210LineAlignBytes;
+        case V4L2_PIX_FMT_Y210:
+            return width * 4;
+        case V4L2_PIX_FMT_P010:
+            return width * 2;
+        default:
+            return 0;
+    }
+}
+
+size_t P216Packer::inputFrameSize(uint32_t pixelformat, int bytesperline, int height) {
+    size_t luma = static_cast<size_t>(bytesperline) * height;
+    if (pixelformat == V4L2_PIX_FMT_P010) {
+        return luma + static_cast<size_t>(bytesperline) * ((height + 1) / 2);
+    }
+    return luma;
+}
+
+size_t P216Packer::calculateP216Size(int width, int height) {
+    // Y plane + CbCr plane, 2 bytes per sample each
+    return static_cast<size_t>(width) * height * 2 * 2;
+}
+
+bool P216Packer::pack(const void* input, size_t input_size, int width, int height,
+                      int bytesperline, uint32_t pixelformat, std::vector<uint8_t>& output) {
+    if (!input || width <= 0 || height <= 0 || (width & 1) || !isFormatSupported(pixelformat)) {
+        return false;
+    }
+    if (bytesperline < minimumBytesPerLine(pixelformat, width) ||
+        input_size < inputFrameSize(pixelformat, bytesperline, height)) {
+        Logger::error("P216Packer: Short frame (" + std::to_string(input_size) + " bytes, stride " +
+                     std::to_string(bytesperline) + ")");
+        return false;
+    }
+
+    output.resize(calculateP216Size(width, height));
+
+    const uint8_t* src = static_cast<const uint8_t*>(input);
+    uint16_t* y_plane = reinterpret_cast<uint16_t*>(output.data());
+    uint16_t* uv_plane = y_plane + static_cast<size_t>(width) * height;
+    const size_t line_bytes = static_cast<size_t>(width) * 2;
+
+    // Converts rows [row_begin, row_end); bands of a frame run in parallel
+    auto pack_rows = [&](int row_begin, int row_end) {
+        switch (pixelformat) {
+            case V4L2_PIX_FMT_V210:
+                for (int row = row_begin; row < row_end; row++) {
+                    const uint8_t* line = src + static_cast<size_t>(row) * bytesperline;
+                    uint16_t* y = y_plane + static_cast<size_t>(row) * width;
+                    uint16_t* uv = uv_plane + static_cast<size_t>(row) * width;
+                    kernels_.v210_to_p216.fn(line, y, uv, width);
+                }
+                break;
+
+            case V4L2_PIX_FMT_Y210:
+                for (int row = row_begin; row < row_end; row++) {
+                    const uint8_t* line = src + static_cast<size_t>(row) * bytesperline;
+                    uint16_t* y = y_plane + static_cast<size_t>(row) * width;
+                    uint16_t* uv = uv_plane + static_cast<size_t>(row) * width;
+                    kernels_.y210_to_p216.fn(line, y, uv, width);
+                }
+                break;
+
+            case V4L2_PIX_FMT_P010: {
+                // Same sample layout as P216; 4:2:0 chroma lines serve two lines
+                const uint8_t* chroma = src + static_cast<size_t>(bytesperline) * height;
+                for (int row = row_begin; row < row_end; row++) {
+                    std::memcpy(y_plane + static_cast<size_t>(row) * width,
+                                src + static_cast<size_t>(row) * bytesperline, line_bytes);
+                    std::memcpy(uv_plane + static_cast<size_t>(row) * width,
+                                chroma + static_cast<size_t>(row / 2) * bytesperline, line_bytes);
+                }
+                break;
+            }
+        }
+    };
+
+    if (stripes_) {
+        if (pixelformat != cost_format_) {
+            row_cost_ = StripeExecutor::RowCost();
+            cost_format_ = pixelformat;
+        }
+        // Read one input line, write a luma and a chroma line
+        stripes_->run(row_cost_, height, static_cast<size_t>(bytesperline) + line_bytes * 2, pack_rows);
+    } else {
+        pack_rows(0, height);
+    }
+
+    return true;
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
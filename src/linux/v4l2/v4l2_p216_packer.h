@@ -0,0 +1,95 @@
+// v4l2_p216_packer.h
+#pragma once
+
+#include "../../common/pixel_kernels.h"
+#include "../../common/stripe_executor.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <linux/videodev2.h>
+
+// Older kernel headers lack some of the 10-bit formats
+#ifndef V4L2_PIX_FMT_P010
+#define V4L2_PIX_FMT_P010 v4l2_fourcc('P', '0', '1', '0')
+#endif
+#ifndef V4L2_PIX_FMT_Y210
+#define V4L2_PIX_FMT_Y210 v4l2_fourcc('Y', '2', '1', '0')
+#endif
+#ifndef V4L2_PIX_FMT_V210
+#define V4L2_PIX_FMT_V210 v4l2_fourcc('v', '2', '1', '0')
+#endif
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+/**
+ * @brief Repacks 10-bit V4L2 capture formats into NDI's P216
+ *
+ * P216 is 16-bit semi-planar 4:2:2: a Y plane of width samples per line
+ * followed by an interleaved CbCr plane of the same size, 10-bit values
+ * in the high bits. All three inputs keep their full precision:
+ * - v210: 6 pixels in 4 little-endian 32-bit words, lines padded to 128
+ *   bytes; fields are unpacked and shifted up by 6
+ * - Y210: packed Y0 Cb Y1 Cr, 16 bits each, already MSB aligned;
+ *   deinterleaved into the two planes
+ * - P010: semi-planar 4:2:0, MSB aligned; each chroma line is used for
+ *   two output lines
+ *
+ * v210 and Y210 use the PixelKernels line kernels (SSE4/AVX2/AVX-512
+ * picked at startup); P010 is line copies. Output lines are tightly
+ * packed (stride = width * 2). Rows are split across cores when a
+ * StripeExecutor is given.
+ *
+ * Version: 1.2.0
+ */
+class P216Packer {
+public:
+    /**
+     * @param kernels Line kernels (benchmarks pass a capped set)
+     * @param stripes Executor for row bands (nullptr = single thread)
+     */
+    explicit P216Packer(const PixelKernels& kernels = PixelKernels::active(),
+                        StripeExecutor* stripes = nullptr);
+
+    /**
+     * @brief Repack one frame
+     * @param input Captured frame
+     * @param input_size Bytes in input (checked against the layout)
+     * @param width Frame width (even)
+     * @param height Frame height
+     * @param bytesperline Input line pitch (P010: luma and chroma)
+     * @param pixelformat V4L2_PIX_FMT_V210, _Y210 or _P010
+     * @param output P216 frame (resized to calculateP216Size)
+     * @return true on success
+     */
+    bool pack(const void* input, size_t input_size, int width, int height,
+              int bytesperline, uint32_t pixelformat, std::vector<uint8_t>& output);
+
+    /**
+     * @brief Tier of the kernel used for a format (P010: scalar line copies)
+     */
+    CpuIsa getKernelIsa(uint32_t pixelformat) const;
+
+    static bool isFormatSupported(uint32_t pixelformat);
+
+    /**
+     * @brief Smallest valid line pitch of an input format
+     */
+    static int minimumBytesPerLine(uint32_t pixelformat, int width);
+
+    /**
+     * @brief Input frame size for a line pitch
+     */
+    static size_t inputFrameSize(uint32_t pixelformat, int bytesperline, int height);
+
+    static size_t calculateP216Size(int width, int height);
+
+private:
+    PixelKernels kernels_;
+    StripeExecutor* stripes_;
+    StripeExecutor::RowCost row_cost_;
+    uint32_t cost_format_ = 0;   // Format row_cost_ was measured for
+};
+
+} // namespace v4l2
+} // namespace ndi_bridge
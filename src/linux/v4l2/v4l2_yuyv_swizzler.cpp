@@ -0,0 +1,29 @@
+// v4l2_yuyv_swizzler.cpp
+#include "v4l2_yuyv_swizzler.h"
+
+namespace ndi_bridge {
+namespace v4l2 {
+
+YuyvSwizzler::YuyvSwizzler(const PixelKernels& kernels, StripeExecutor* stripes)
+    : kernels_(kernels), stripes_(stripes) {
+}
+
+void YuyvSwizzler::swizzleInPlace(uint8_t* data, int width, int height, int stride) {
+    const size_t row_bytes = static_cast<size_t>(width) * 2;
+    auto swap_rows = [&](int row_begin, int row_end) {
+        for (int y = row_begin; y < row_end; ++y) {
+            uint8_t* row = data + static_cast<size_t>(y) * stride;
+            kernels_.swap_pairs.fn(row, row, row_bytes);
+        }
+    };
+
+    if (stripes_) {
+        // Each line is read and written back
+        stripes_->run(row_cost_, height, row_bytes * 2, swap_rows);
+    } else {
+        swap_rows(0, height);
+    }
+}
+
+} // namespace v4l2
+} // namespace ndi_bridge
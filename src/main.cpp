@@ -13,10 +13,14 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include "linux/v4l2/v4l2_capture.h"
+#include "linux/v4l2/v4l2_format_benchmark.h"
 
 #include "common/app_controller.h"
+#include "common/synthetic_capture.h"
+#include "common/replay_capture.h"
 #include "common/version.h"
 #include "common/logger.h"
+#include "common/pixel_kernels.h"
 
 namespace {
 
@@ -34,17 +38,43 @@ void signalHandler(int signal) {
 
 // Print usage information
 void printUsage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " [device_name] [ndi_name]" << std::endl;
+    std::cout << "Usage: " << program_name << " [options] [device_name] [ndi_name]" << std::endl;
     std::cout << std::endl;
     std::cout << "Ultra-low latency NDI bridge for Intel N100" << std::endl;
-    std::cout << "Runs with maximum performance settings always." << std::endl;
     std::cout << std::endl;
     std::cout << "Arguments:" << std::endl;
     std::cout << "  device_name   V4L2 device (default: /dev/video0)" << std::endl;
     std::cout << "  ndi_name      NDI stream name (default: 'Media Bridge')" << std::endl;
     std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --profile NAME   Capture profile (default: balanced)" << std::endl;
+    std::cout << "  --config FILE    Read CAPTURE_* settings from a KEY=VALUE file" << std::endl;
+    std::cout << "  --synthetic SPEC Test pattern instead of V4L2, SPEC = WIDTHxHEIGHT[@FPS][:FORMAT]" << std::endl;
+    std::cout << "                   (FORMAT UYVY, YUYV or NV12; default 1920x1080@60:UYVY)" << std::endl;
+    std::cout << "  --audio DEVICE   Embedded audio: auto (ALSA card of the video device), none," << std::endl;
+    std::cout << "                   or an ALSA PCM such as hw:2,0 (default: auto)" << std::endl;
+    std::cout << "  --record FILE    Record raw V4L2 frames to FILE (.mbrec)" << std::endl;
+    std::cout << "  --replay FILE    Play a recording instead of V4L2 (original timing, loops)" << std::endl;
+    std::cout << "  --replay-fast    With --replay: deliver frames as fast as possible" << std::endl;
+    std::cout << "  --benchmark [SPEC] Time the format kernels against the frame budget and exit," << std::endl;
+    std::cout << "                   SPEC = WIDTHxHEIGHT[@FPS] (default 1920x1080@60)" << std::endl;
+    std::cout << "    --cases LIST   With --benchmark: only kernels whose name contains one of" << std::endl;
+    std::cout << "                   the comma-separated substrings (e.g. \"P216,MJPEG\")" << std::endl;
+    std::cout << "    --frames N     With --benchmark: timed frames per kernel (default 300)" << std::endl;
+    std::cout << "  --isa NAME       Cap the pixel kernels at scalar, sse4, avx2 or avx512" << std::endl;
+    std::cout << "                   (default: best the CPU supports; also NDI_BRIDGE_ISA)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Profiles:" << std::endl;
+    for (const auto& name : ndi_bridge::v4l2::CaptureProfile::builtinNames()) {
+        ndi_bridge::v4l2::CaptureProfile profile;
+        ndi_bridge::v4l2::CaptureProfile::fromName(name, profile);
+        std::cout << "  " << profile.describe() << std::endl;
+    }
+    std::cout << std::endl;
     std::cout << "Example:" << std::endl;
-    std::cout << "  " << program_name << " /dev/video0 \"HDMI Input\"" << std::endl;
+    std::cout << "  " << program_name << " --profile 4K-throughput /dev/video0 \"HDMI Input\"" << std::endl;
+    std::cout << "  " << program_name << " --synthetic 3840x2160@30:UYVY \"Load Test\"" << std::endl;
+    std::cout << "  " << program_name << " --replay /tmp/field.mbrec --replay-fast \"Replay\"" << std::endl;
 }
 
 } // anonymous namespace
@@ -56,28 +86,168 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Pixel kernel cap, set before anything selects kernels; works with --benchmark too
+    std::vector<char*> args(argv, argv + argc);
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (std::string(args[i]) == "--isa") {
+            ndi_bridge::CpuIsa isa;
+            if (i + 1 >= args.size() || !ndi_bridge::PixelKernels::isaFromString(args[i + 1], isa)) {
+                std::cerr << "--isa expects scalar, sse4, avx2 or avx512" << std::endl;
+                return 1;
+            }
+            ndi_bridge::PixelKernels::setIsaOverride(isa);
+            args.erase(args.begin() + i, args.begin() + i + 2);
+            break;
+        }
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+    
+    // Kernel benchmark runs standalone, before any device or NDI setup
+    if (argc >= 2 && std::string(argv[1]) == "--benchmark") {
+        ndi_bridge::v4l2::FormatBenchmark::Config bench_config;
+        bool have_spec = false;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool ok;
+            if (arg == "--cases" && i + 1 < argc) {
+                ok = ndi_bridge::v4l2::FormatBenchmark::parseCases(argv[++i], bench_config);
+            } else if (arg == "--frames" && i + 1 < argc) {
+                ok = ndi_bridge::v4l2::FormatBenchmark::parseFrames(argv[++i], bench_config);
+            } else {
+                ok = !have_spec && ndi_bridge::v4l2::FormatBenchmark::parseSpec(arg, bench_config);
+                have_spec = true;
+            }
+            if (!ok) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        ndi_bridge::v4l2::FormatBenchmark benchmark(bench_config);
+        return benchmark.printReport(benchmark.run()) ? 0 : 2;
+    }
+    
     // Log version on startup
     ndi_bridge::Logger::logVersion(NDI_BRIDGE_VERSION);
     ndi_bridge::Logger::info("Ultra-Low Latency Media Bridge starting...");
     
-    // Simple argument parsing - NO OPTIONS
+    // Simple argument parsing - options first, then positional arguments
     std::string device_name = "/dev/video0";
     std::string ndi_name = "Media Bridge";
+    std::string profile_name;
+    std::string config_file;
+    std::string synthetic_spec;
+    bool synthetic = false;
+    std::string record_file;
+    std::string audio_device;
+    bool audio_set = false;
+    ndi_bridge::ReplayCapture::Config replay_config;
+    std::vector<std::string> positional;
     
-    if (argc > 1) {
-        device_name = argv[1];
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profile_name = argv[++i];
+        } else if (arg == "--config" && i + 1 < argc) {
+            config_file = argv[++i];
+        } else if (arg == "--audio" && i + 1 < argc) {
+            audio_device = argv[++i];
+            audio_set = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            record_file = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replay_config.path = argv[++i];
+        } else if (arg == "--replay-fast") {
+            replay_config.fast = true;
+        } else if (arg == "--synthetic") {
+            synthetic = true;
+            // SPEC is optional; a following positional argument never starts with a digit
+            if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+                synthetic_spec = argv[++i];
+            }
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
     }
-    if (argc > 2) {
-        ndi_name = argv[2];
-    }
-    if (argc > 3 || (argc > 1 && std::string(argv[1]) == "--help")) {
+    
+    if (positional.size() > 2) {
         printUsage(argv[0]);
         return 0;
     }
+    bool replay = !replay_config.path.empty();
+    if (synthetic && replay) {
+        std::cerr << "--synthetic and --replay are mutually exclusive" << std::endl;
+        return 1;
+    }
+    
+    if (synthetic || replay) {
+        // No device argument: the only positional is the NDI name
+        if (positional.size() > 1) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (positional.size() > 0) {
+            ndi_name = positional[0];
+        }
+    } else {
+        if (positional.size() > 0) {
+            device_name = positional[0];
+        }
+        if (positional.size() > 1) {
+            ndi_name = positional[1];
+        }
+    }
+    
+    ndi_bridge::SyntheticCapture::Config synthetic_config;
+    if (synthetic) {
+        if (!synthetic_spec.empty() &&
+            !ndi_bridge::SyntheticCapture::parseSpec(synthetic_spec, synthetic_config)) {
+            std::cerr << "Invalid synthetic spec: " << synthetic_spec << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        device_name = "synthetic";
+    }
+    if (replay) {
+        device_name = replay_config.path;
+    }
+    
+    // Resolve capture profile: config file first, --profile wins
+    ndi_bridge::v4l2::CaptureProfile profile;
+    if (!config_file.empty() &&
+        !ndi_bridge::v4l2::CaptureProfile::loadFromFile(config_file, profile)) {
+        ndi_bridge::Logger::warning("Invalid capture settings in " + config_file + ", check CAPTURE_* keys");
+    }
+    if (!profile_name.empty() &&
+        !ndi_bridge::v4l2::CaptureProfile::fromName(profile_name, profile)) {
+        std::cerr << "Unknown profile: " << profile_name << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    if (!record_file.empty()) {
+        profile.record_path = record_file;
+    }
+    if (audio_set) {
+        profile.audio_device = (audio_device == "none" || audio_device == "off") ? "" : audio_device;
+    }
     
     // Log configuration
     ndi_bridge::Logger::info("Device: " + device_name);
     ndi_bridge::Logger::info("NDI Name: " + ndi_name);
+    if (!synthetic && !replay) {
+        ndi_bridge::Logger::info("Capture profile: " + profile.describe());
+        if (!profile.record_path.empty()) {
+            ndi_bridge::Logger::info("Recording raw frames to " + profile.record_path);
+        }
+    }
     
     // Setup signal handlers
     std::signal(SIGINT, signalHandler);
@@ -91,12 +261,29 @@ int main(int argc, char* argv[]) {
     config.auto_retry = true;
     config.retry_delay_ms = 1000;  // Fast retry
     config.max_retries = -1;  // Never give up
+    // Synthetic and replayed video have no audio device next to them
+    config.audio_device = (synthetic || replay) ? "" : profile.audio_device;
+    config.timing_metadata = profile.timing_metadata;
     
     g_app_controller = std::make_unique<ndi_bridge::AppController>(config);
     
-    // Create V4L2 capture - NO CONFIGURATION
-    auto v4l2_capture = std::make_unique<ndi_bridge::v4l2::V4L2Capture>();
-    g_app_controller->setCaptureDevice(std::move(v4l2_capture));
+    // Create V4L2 (or synthetic/replay) capture with the selected settings (also used for recovery)
+    ndi_bridge::AppController::CaptureDeviceFactory capture_factory;
+    if (replay) {
+        capture_factory = [replay_config]() -> std::unique_ptr<ndi_bridge::ICaptureDevice> {
+            return std::make_unique<ndi_bridge::ReplayCapture>(replay_config);
+        };
+    } else if (synthetic) {
+        capture_factory = [synthetic_config]() -> std::unique_ptr<ndi_bridge::ICaptureDevice> {
+            return std::make_unique<ndi_bridge::SyntheticCapture>(synthetic_config);
+        };
+    } else {
+        capture_factory = [profile]() -> std::unique_ptr<ndi_bridge::ICaptureDevice> {
+            return std::make_unique<ndi_bridge::v4l2::V4L2Capture>(profile);
+        };
+    }
+    g_app_controller->setCaptureDevice(capture_factory());
+    g_app_controller->setCaptureDeviceFactory(capture_factory);
     
     // Start
     if (!g_app_controller->start()) {
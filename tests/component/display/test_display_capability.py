@@ -86,4 +86,30 @@ def test_display_resolution_detected(host):
     """Test that display resolution can be detected."""
     result = host.run("cat /sys/class/drm/card*/modes 2>/dev/null | head -1")
     # Resolution might not be available if no display connected
-    assert result.rc == 0, "Error checking display modes"
\ No newline at end of file
+    assert result.rc == 0, "Error checking display modes"
+
+def test_display_requests_uyvy_for_yuv_plane(host):
+    """Test that ndi-display receives UYVY when a plane scans it out."""
+    log = host.run("journalctl -u 'ndi-display@*' -b --no-pager 2>/dev/null | tail -200").stdout
+    if "scans out UYVY" not in log:
+        pytest.skip("No running display found a UYVY plane")
+    if host.run("grep -qs '^YUV_SCANOUT=false' /etc/media-bridge/display-*.conf").rc == 0:
+        pytest.skip("YUV scanout disabled in display configuration")
+    connects = [line for line in log.splitlines() if "Connected to NDI source" in line]
+    assert connects, "ndi-display found a UYVY plane but did not connect"
+    assert "(UYVY)" in connects[-1], f"Expected UYVY receive: {connects[-1]}"
+
+
+def test_ndi_display_multi_head_usage(host):
+    """Test that ndi-display offers multi-head mode and rejects a bad head spec."""
+    binary = host.file("/opt/media-bridge/ndi-display")
+    if not binary.exists:
+        pytest.skip("ndi-display not installed")
+
+    usage = host.run("/opt/media-bridge/ndi-display --help")
+    assert "multi <id>=<stream>" in usage.stdout, f"Multi-head mode missing from usage:\n{usage.stdout}"
+
+    # Rejected before any display or NDI setup
+    result = host.run("/opt/media-bridge/ndi-display multi 5=Camera")
+    assert result.rc != 0, "Display ID out of range was accepted"
+    assert "display 0, 1 or 2" in result.stderr, f"Unexpected error: {result.stderr}"
@@ -134,4 +134,32 @@ def test_display_service_cleanup_on_stop(host):
     # Check if status was cleaned up by ExecStopPost
     status_file = host.file("/var/run/ndi-display/display-1.status")
     # File should be removed by ExecStopPost
-    assert not status_file.exists, "Display status not cleaned up by ExecStopPost"
\ No newline at end of file
+    assert not status_file.exists, "Display status not cleaned up by ExecStopPost"
+
+def test_display_status_reports_latency(host):
+    """Test that a display showing a media-bridge stream publishes latency stages."""
+    result = host.run("grep -l 'MEDIA-BRIDGE' /var/run/ndi-display/display-*.status 2>/dev/null | head -1")
+    status_path = result.stdout.strip()
+    if not status_path:
+        pytest.skip("No display is showing a media-bridge capture stream")
+
+    # Latency is published after the first 10 second window
+    time.sleep(12)
+    status = host.file(status_path).content_string
+    for stage in ("CAPTURE_TO_SEND", "SEND_TO_RECEIVE", "RECEIVE_TO_SCANOUT", "CAPTURE_TO_SCANOUT"):
+        assert f"LATENCY_{stage}_P50=" in status, f"{stage} latency missing from {status_path}"
+
+    p50 = float(status.split("LATENCY_CAPTURE_TO_SCANOUT_P50=")[1].split("\n")[0])
+    assert 0 < p50 < 250, f"Implausible glass-to-glass latency: {p50} ms"
+
+
+def test_display_status_reports_flip_counters(host):
+    """Test that a running display publishes late/skipped/torn flip counters."""
+    result = host.run("ls /var/run/ndi-display/display-*.status 2>/dev/null | head -1")
+    status_path = result.stdout.strip()
+    if not status_path:
+        pytest.skip("No display is running")
+
+    status = host.file(status_path).content_string
+    for key in ("FRAMES_FLIPPED", "FRAMES_LATE", "FRAMES_SKIPPED", "FRAMES_TORN"):
+        assert f"{key}=" in status, f"{key} missing from {status_path}"
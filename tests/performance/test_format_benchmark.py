@@ -0,0 +1,105 @@
+"""
+Performance tests for the capture-side format kernels.
+
+Runs `ndi-capture --benchmark` on the device, which times each kernel on a
+synthetic frame against half the frame interval. The benchmark runs once
+per spec (and --isa cap), limited to the kernels checked here; the tests
+check rows of the parsed table.
+"""
+
+import re
+
+import pytest
+
+BINARY = "/opt/media-bridge/ndi-capture"
+
+# Timed frames per kernel: enough for a p99, short enough for the suite
+FRAMES = 100
+
+# Kernels each run times (--cases substrings)
+CASES = {
+    "1920x1080@60": "P216,YUYV -> UYVY,MJPEG,XRGB",
+    "3840x2160@30": "threads",
+}
+
+ROW = re.compile(r"^(?P<name>\S.*\S)\s+(?P<avg>[\d.]+)\s+(?P<p99>[\d.]+)\s+(?P<max>[\d.]+)\s+"
+                 r"(?P<fits>yes|\(no\)|NO)\s*$", re.MULTILINE)
+
+# The first use of a spec runs the benchmark inside that test's timeout
+pytestmark = [pytest.mark.performance, pytest.mark.slow, pytest.mark.timeout(180)]
+
+
+@pytest.fixture(scope="module")
+def cpu_count(host):
+    """Number of CPUs on the device."""
+    return int(host.run("nproc").stdout.strip() or 1)
+
+
+@pytest.fixture(scope="module")
+def benchmark(host):
+    """
+    Runs the benchmark once per (spec, isa) for the whole module.
+
+    Returns a function (spec, isa=None) -> (output, rows), rows being
+    dicts of the table columns in report order.
+    """
+    if not host.file(BINARY).exists:
+        pytest.skip("ndi-capture not installed")
+
+    runs = {}
+
+    def run(spec, isa=None):
+        if (spec, isa) not in runs:
+            command = f"nice -n -5 {BINARY} --benchmark {spec} --cases '{CASES[spec]}' --frames {FRAMES}"
+            if isa:
+                command += f" --isa {isa}"
+            result = host.run(command)
+            output = result.stdout + result.stderr
+            rows = [match.groupdict() for match in ROW.finditer(result.stdout)]
+            runs[(spec, isa)] = (output, rows)
+        return runs[(spec, isa)]
+
+    return run
+
+
+@pytest.mark.parametrize("spec,isa,kernel,striped", [
+    ("1920x1080@60", None, r"v210 -> P216", False),
+    ("1920x1080@60", None, r"Y210 -> P216", False),
+    ("1920x1080@60", None, r"P010 -> P216", False),
+    ("1920x1080@60", None, r"YUYV -> UYVY in place", False),
+    ("1920x1080@60", "sse4", r"YUYV -> UYVY in place \(SSE4", False),
+    ("1920x1080@60", "scalar", r"YUYV -> UYVY in place \(scalar", False),
+    ("1920x1080@60", None, r"MJPEG -> UYVY \(\d+ threads", True),
+    ("3840x2160@30", None, r"MJPEG -> UYVY \(\d+ threads", True),
+    ("3840x2160@30", None, r"UYVY -> BGRA \([^)]*threads", True),
+    ("3840x2160@30", None, r"YUYV -> UYVY in place \([^)]*threads", True),
+    ("3840x2160@30", None, r"v210 -> P216 \([^)]*threads", True),
+])
+def test_kernel_fits_budget(benchmark, cpu_count, spec, isa, kernel, striped):
+    """Test that a kernel the send path runs has its p99 within the frame budget."""
+    if striped and cpu_count < 2:
+        pytest.skip("Threaded kernels need more than one CPU")
+
+    output, rows = benchmark(spec, isa)
+    matching = [row for row in rows if re.match(kernel, row["name"])]
+    assert matching, f"Benchmark did not run {kernel}:\n{output}"
+    # Lower tiers and single-thread rows are references and print "(no)"
+    failed = [row["name"] for row in matching if row["fits"] == "NO"]
+    assert not failed, f"{', '.join(failed)} exceed the {spec} budget:\n{output}"
+
+
+@pytest.mark.parametrize("isa", ["sse4", "scalar"])
+def test_forced_isa_caps_kernels(benchmark, isa):
+    """Test that --isa caps the kernels (Celeron-class paths)."""
+    output, rows = benchmark("1920x1080@60", isa)
+    assert rows, f"Benchmark did not run:\n{output}"
+    assert not any("AVX" in row["name"] for row in rows), f"--isa {isa} did not cap the kernels:\n{output}"
+
+
+def test_display_fallback_scaler_reported(benchmark):
+    """Test that the benchmark times the 1080p -> 4K bilinear scaler of the display fallback."""
+    output, rows = benchmark("1920x1080@60")
+    scaler = [row for row in rows if row["name"].startswith("UYVY -> XRGB 3840x2160 bilinear")]
+    assert scaler, f"Benchmark did not run the display scaler:\n{output}"
+    # The display has the whole 60 Hz refresh for a frame; the first row is the selected tier
+    assert float(scaler[0]["p99"]) < 16667, f"Scaler p99 misses a 1080p60 -> 4K refresh:\n{output}"
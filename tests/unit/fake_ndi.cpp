@@ -0,0 +1,92 @@
+// fake_ndi.cpp
+#include "fake_ndi.h"
+
+namespace fake_ndi {
+
+std::vector<SentVideo> sent;
+std::function<void(const SentVideo&)> on_send;
+
+void reset() {
+    sent.clear();
+    on_send = nullptr;
+}
+
+} // namespace fake_ndi
+
+namespace {
+
+int instance_token;
+
+// Image bytes NDI reads for the frame's FourCC
+size_t imageSize(const NDIlib_video_frame_v2_t& frame) {
+    size_t stride = static_cast<size_t>(frame.line_stride_in_bytes);
+    size_t luma = stride * frame.yres;
+    switch (frame.FourCC) {
+        case NDIlib_FourCC_type_NV12:
+            return luma + stride * ((frame.yres + 1) / 2);
+        case NDIlib_FourCC_type_I420:
+        case NDIlib_FourCC_type_YV12:
+            return luma + 2 * (stride / 2) * ((frame.yres + 1) / 2);
+        case NDIlib_FourCC_type_P216:
+            return luma * 2;
+        default:
+            return luma;
+    }
+}
+
+void record(const NDIlib_video_frame_v2_t* frame, bool async) {
+    fake_ndi::SentVideo video;
+    video.async = async;
+    video.flush = frame == nullptr;
+    if (frame) {
+        video.frame = *frame;
+        const uint8_t* data = frame->p_data;
+        video.bytes.assign(data, data + imageSize(*frame));
+    }
+    fake_ndi::sent.push_back(video);
+    if (fake_ndi::on_send) {
+        fake_ndi::on_send(fake_ndi::sent.back());
+    }
+}
+
+} // anonymous namespace
+
+bool NDIlib_initialize() {
+    return true;
+}
+
+void NDIlib_destroy() {
+}
+
+const char* NDIlib_version() {
+    return "fake";
+}
+
+NDIlib_send_instance_t NDIlib_send_create(const NDIlib_send_create_t*) {
+    return reinterpret_cast<NDIlib_send_instance_t>(&instance_token);
+}
+
+void NDIlib_send_destroy(NDIlib_send_instance_t) {
+}
+
+void NDIlib_send_send_video_v2(NDIlib_send_instance_t, const NDIlib_video_frame_v2_t* frame) {
+    record(frame, false);
+}
+
+void NDIlib_send_send_video_async_v2(NDIlib_send_instance_t, const NDIlib_video_frame_v2_t* frame) {
+    record(frame, true);
+}
+
+void NDIlib_send_send_audio_v3(NDIlib_send_instance_t, const NDIlib_audio_frame_v3_t*) {
+}
+
+int NDIlib_send_get_no_connections(NDIlib_send_instance_t, uint32_t) {
+    return 0;
+}
+
+NDIlib_find_instance_t NDIlib_find_create_v2(const NDIlib_find_create_t*) {
+    return nullptr;
+}
+
+void NDIlib_find_destroy(NDIlib_find_instance_t) {
+}
@@ -0,0 +1,27 @@
+// fake_ndi.h
+#pragma once
+
+#include <Processing.NDI.Lib.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Stand-in for the NDI runtime in unit tests: the NDIlib_* functions
+// NdiSender calls, recording the video frames handed to them instead of
+// sending anything
+namespace fake_ndi {
+
+struct SentVideo {
+    bool async = false;
+    bool flush = false;             // NULL frame of an async flush
+    NDIlib_video_frame_v2_t frame;  // As passed; p_data may be gone by now
+    std::vector<uint8_t> bytes;     // Copy of the image at send time
+};
+
+extern std::vector<SentVideo> sent;
+// Called inside send_video / send_video_async, before the call returns
+extern std::function<void(const SentVideo&)> on_send;
+
+void reset();
+
+} // namespace fake_ndi
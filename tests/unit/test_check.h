@@ -0,0 +1,28 @@
+// test_check.h
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Minimal checks for the host-side unit tests: report the failed
+// expression with its location and exit non-zero
+#define CHECK(expr)                                                           \
+    do {                                                                      \
+        if (!(expr)) {                                                        \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: "    \
+                      << #expr << std::endl;                                  \
+            std::exit(1);                                                     \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                        \
+    do {                                                                      \
+        const auto& check_a_ = (a);                                           \
+        const auto& check_b_ = (b);                                           \
+        if (!(check_a_ == check_b_)) {                                        \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ failed: " \
+                      << #a << " (" << check_a_ << ") != " << #b << " ("      \
+                      << check_b_ << ")" << std::endl;                        \
+            std::exit(1);                                                     \
+        }                                                                     \
+    } while (0)
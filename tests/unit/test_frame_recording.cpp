@@ -0,0 +1,198 @@
+// test_frame_recording.cpp
+//
+// Records frames to a .mbrec file, reads them back with FrameRecordReader
+// and replays them through ReplayCapture; payloads, metadata and format
+// must come back unchanged.
+
+#include "common/frame_recording.h"
+#include "common/replay_capture.h"
+#include "test_check.h"
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ndi_bridge;
+
+namespace {
+
+constexpr uint32_t kFourccUYVY = 'U' | ('Y' << 8) | ('V' << 16) | ('Y' << 24);
+constexpr uint32_t kWidth = 64;
+constexpr uint32_t kHeight = 16;
+constexpr uint32_t kStride = kWidth * 2 + 32;   // Driver padding is kept
+constexpr uint32_t kFrameSize = kStride * kHeight;
+
+struct TestFrame {
+    std::vector<uint8_t> data;
+    int64_t timestamp_ns;
+    uint32_t sequence;
+    uint32_t flags;
+};
+
+std::vector<TestFrame> makeFrames(int count) {
+    std::vector<TestFrame> frames;
+    for (int i = 0; i < count; i++) {
+        TestFrame frame;
+        // Variable sizes like MJPEG, distinct content per frame
+        frame.data.resize(i % 2 ? kFrameSize : kFrameSize - 100 * i - 1);
+        for (size_t b = 0; b < frame.data.size(); b++) {
+            frame.data[b] = static_cast<uint8_t>(b * 7 + i * 31 + (b >> 8));
+        }
+        frame.timestamp_ns = 1000000000LL + i * 16683333LL;
+        frame.sequence = 100 + i * 2;           // A dropped frame between each
+        frame.flags = 0x2000 | i;
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+std::string tempPath() {
+    const char* dir = getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/test_frame_recording_" + std::to_string(getpid()) + ".mbrec";
+}
+
+FrameRecorder::Format testFormat() {
+    FrameRecorder::Format format;
+    format.width = kWidth;
+    format.height = kHeight;
+    format.pixelformat = kFourccUYVY;
+    format.bytesperline = kStride;
+    format.max_frame_size = kFrameSize;
+    format.fps_numerator = 60000;
+    format.fps_denominator = 1001;
+    return format;
+}
+
+void testRoundTrip(const std::string& path) {
+    const std::vector<TestFrame> frames = makeFrames(6);
+
+    FrameRecorder recorder;
+    // One staging slot per frame, so a slow disk cannot skip any
+    CHECK(recorder.start(path, testFormat(), 16, static_cast<uint32_t>(frames.size())));
+    for (const TestFrame& frame : frames) {
+        CHECK(recorder.submit(frame.data.data(), frame.data.size(), frame.timestamp_ns,
+                              frame.sequence, frame.flags));
+    }
+    recorder.stop();
+    CHECK_EQ(recorder.getFramesRecorded(), frames.size());
+    CHECK_EQ(recorder.getFramesSkipped(), 0u);
+
+    FrameRecordReader reader;
+    CHECK(reader.open(path));
+    const FrameRecordHeader& header = reader.getHeader();
+    CHECK(memcmp(header.magic, kFrameRecordMagic, sizeof(kFrameRecordMagic)) == 0);
+    CHECK_EQ(header.version, kFrameRecordVersion);
+    CHECK_EQ(header.width, kWidth);
+    CHECK_EQ(header.height, kHeight);
+    CHECK_EQ(header.pixelformat, kFourccUYVY);
+    CHECK_EQ(header.bytesperline, kStride);
+    CHECK_EQ(header.fps_numerator, 60000u);
+    CHECK_EQ(header.fps_denominator, 1001u);
+    CHECK_EQ(reader.getFrameCount(), frames.size());
+
+    for (uint32_t i = 0; i < frames.size(); i++) {
+        FrameRecordReader::Frame frame = reader.frame(i);
+        CHECK_EQ(frame.size, frames[i].data.size());
+        CHECK(memcmp(frame.data, frames[i].data.data(), frame.size) == 0);
+        CHECK_EQ(frame.timestamp_ns, frames[i].timestamp_ns);
+        CHECK_EQ(frame.sequence, frames[i].sequence);
+        CHECK_EQ(frame.flags, frames[i].flags);
+        CHECK(reinterpret_cast<uintptr_t>(frame.data) % 64 == 0);
+    }
+    reader.close();
+}
+
+void testIndexCapacity(const std::string& path) {
+    const std::vector<TestFrame> frames = makeFrames(6);
+
+    FrameRecorder recorder;
+    CHECK(recorder.start(path, testFormat(), 4, static_cast<uint32_t>(frames.size())));
+    for (const TestFrame& frame : frames) {
+        recorder.submit(frame.data.data(), frame.data.size(), frame.timestamp_ns,
+                        frame.sequence, frame.flags);
+    }
+    recorder.stop();
+
+    // Recording stops at the index capacity; what was kept is intact
+    FrameRecordReader reader;
+    CHECK(reader.open(path));
+    CHECK_EQ(reader.getFrameCount(), 4u);
+    for (uint32_t i = 0; i < 4; i++) {
+        FrameRecordReader::Frame frame = reader.frame(i);
+        CHECK_EQ(frame.size, frames[i].data.size());
+        CHECK(memcmp(frame.data, frames[i].data.data(), frame.size) == 0);
+        CHECK_EQ(frame.sequence, frames[i].sequence);
+    }
+    reader.close();
+}
+
+void testReplay(const std::string& path) {
+    const std::vector<TestFrame> frames = makeFrames(6);
+    const size_t wanted = frames.size() + 2;    // Past the loop back to frame 0
+
+    FrameRecorder recorder;
+    CHECK(recorder.start(path, testFormat(), 16, static_cast<uint32_t>(frames.size())));
+    for (const TestFrame& frame : frames) {
+        CHECK(recorder.submit(frame.data.data(), frame.data.size(), frame.timestamp_ns,
+                              frame.sequence, frame.flags));
+    }
+    recorder.stop();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::vector<uint8_t>> received;
+    ICaptureDevice::VideoFormat received_format;
+
+    ReplayCapture::Config config;
+    config.path = path;
+    config.fast = true;
+    ReplayCapture replay(config);
+    replay.setFrameCallback([&](const void* data, size_t size, int64_t timestamp,
+                                const ICaptureDevice::VideoFormat& format) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (received.size() < wanted) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            received.emplace_back(bytes, bytes + size);
+            received_format = format;
+            cv.notify_one();
+        }
+        return true;
+    });
+    CHECK(replay.startCapture());
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        CHECK(cv.wait_for(lock, std::chrono::seconds(10), [&] { return received.size() >= wanted; }));
+    }
+    replay.stopCapture();
+    CHECK(!replay.hasError());
+
+    CHECK_EQ(received_format.width, static_cast<int>(kWidth));
+    CHECK_EQ(received_format.height, static_cast<int>(kHeight));
+    CHECK_EQ(received_format.stride, static_cast<int>(kStride));
+    CHECK_EQ(received_format.pixel_format, std::string("UYVY"));
+    CHECK_EQ(received_format.fps_numerator, 60000u);
+    CHECK_EQ(received_format.fps_denominator, 1001u);
+
+    for (size_t i = 0; i < wanted; i++) {
+        CHECK(received[i] == frames[i % frames.size()].data);
+    }
+    CHECK(replay.getStats().loops >= 1);
+}
+
+} // namespace
+
+int main() {
+    const std::string path = tempPath();
+
+    testRoundTrip(path);
+    testIndexCapacity(path);
+    testReplay(path);
+
+    unlink(path.c_str());
+    std::cout << "test_frame_recording: OK" << std::endl;
+    return 0;
+}
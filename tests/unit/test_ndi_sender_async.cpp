@@ -0,0 +1,197 @@
+// test_ndi_sender_async.cpp
+//
+// Capture buffer release with asynchronous NDI sends: a passed-through
+// frame stays with NDI until the next send or flush() and is released
+// exactly once, after that call returned; converted or rejected frames
+// are released right away.
+
+#include "common/ndi_sender.h"
+#include "fake_ndi.h"
+#include "test_check.h"
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace ndi_bridge;
+
+namespace {
+
+constexpr uint32_t kFourccYUYV = 0x56595559;
+constexpr uint32_t kWidth = 64;
+constexpr uint32_t kHeight = 16;
+
+// Release count per capture buffer
+std::map<int, int> releases;
+
+struct Buffer {
+    int id;
+    std::vector<uint8_t> data = std::vector<uint8_t>(kWidth * kHeight * 2, 0x80);
+};
+
+NdiSender::FrameInfo frameInfo(Buffer& buffer, uint32_t fourcc, bool with_release = true) {
+    NdiSender::FrameInfo frame;
+    frame.data = buffer.data.data();
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.stride = kWidth * 2;
+    frame.fourcc = fourcc;
+    frame.timestamp_ns = 0;
+    frame.fps_numerator = 60;
+    frame.fps_denominator = 1;
+    if (with_release) {
+        int id = buffer.id;
+        frame.release = [id] { releases[id]++; };
+    }
+    return frame;
+}
+
+int released(const Buffer& buffer) {
+    auto it = releases.find(buffer.id);
+    return it == releases.end() ? 0 : it->second;
+}
+
+void testPassThroughHeldUntilNextSend(NdiSender& sender) {
+    Buffer a{1}, b{2}, c{3};
+    fake_ndi::reset();
+
+    CHECK(sender.sendFrame(frameInfo(a, NDIlib_FourCC_type_UYVY)));
+    CHECK_EQ(fake_ndi::sent.size(), 1u);
+    CHECK(fake_ndi::sent[0].async);
+    CHECK(fake_ndi::sent[0].frame.p_data == a.data.data());
+    CHECK_EQ(released(a), 0);
+
+    // NDI may read a until the next call returns
+    int a_during_send = -1;
+    fake_ndi::on_send = [&](const fake_ndi::SentVideo&) { a_during_send = released(a); };
+    CHECK(sender.sendFrame(frameInfo(b, NDIlib_FourCC_type_UYVY)));
+    CHECK_EQ(a_during_send, 0);
+    CHECK_EQ(released(a), 1);
+    CHECK_EQ(released(b), 0);
+
+    // A synchronous send finishes the async one as well
+    fake_ndi::on_send = nullptr;
+    CHECK(sender.sendFrame(frameInfo(c, NDIlib_FourCC_type_UYVY, false)));
+    CHECK(!fake_ndi::sent.back().async);
+    CHECK_EQ(released(b), 1);
+
+    // Nothing in flight: flush() does not call NDI
+    size_t calls = fake_ndi::sent.size();
+    sender.flush();
+    CHECK_EQ(fake_ndi::sent.size(), calls);
+    CHECK_EQ(released(a), 1);
+    CHECK_EQ(released(b), 1);
+}
+
+void testFlushReleasesOnce(NdiSender& sender) {
+    Buffer a{11};
+    fake_ndi::reset();
+
+    CHECK(sender.sendFrame(frameInfo(a, NDIlib_FourCC_type_UYVY)));
+    int a_during_flush = -1;
+    fake_ndi::on_send = [&](const fake_ndi::SentVideo&) { a_during_flush = released(a); };
+    sender.flush();
+    CHECK(fake_ndi::sent.back().flush);
+    CHECK_EQ(a_during_flush, 0);
+    CHECK_EQ(released(a), 1);
+
+    fake_ndi::on_send = nullptr;
+    sender.flush();
+    CHECK_EQ(released(a), 1);
+    CHECK_EQ(fake_ndi::sent.size(), 2u);
+}
+
+void testConvertedReleasedAtOnce(NdiSender& sender) {
+    Buffer a{21}, b{22};
+    fake_ndi::reset();
+
+    // YUYV goes out from the conversion buffer
+    CHECK(sender.sendFrame(frameInfo(a, kFourccYUYV)));
+    CHECK(fake_ndi::sent[0].frame.p_data != a.data.data());
+    CHECK_EQ(released(a), 1);
+
+    CHECK(sender.sendFrame(frameInfo(b, kFourccYUYV)));
+    CHECK_EQ(released(a), 1);
+    CHECK_EQ(released(b), 1);
+    sender.flush();
+    CHECK_EQ(released(a), 1);
+    CHECK_EQ(released(b), 1);
+}
+
+void testRejectedReleasedAtOnce(NdiSender& sender) {
+    Buffer a{31}, b{32}, c{33};
+    fake_ndi::reset();
+
+    CHECK(!sender.sendFrame(frameInfo(a, 0x34324752)));    // 'RG24', unsupported
+    CHECK_EQ(released(a), 1);
+
+    NdiSender::FrameInfo empty = frameInfo(b, NDIlib_FourCC_type_UYVY);
+    empty.data = nullptr;
+    CHECK(!sender.sendFrame(empty));
+    CHECK_EQ(released(b), 1);
+    CHECK(fake_ndi::sent.empty());
+
+    NdiSender uninitialized("uninitialized");
+    CHECK(!uninitialized.sendFrame(frameInfo(c, NDIlib_FourCC_type_UYVY)));
+    CHECK_EQ(released(c), 1);
+}
+
+void testShutdownReleasesInFlight() {
+    Buffer a{41};
+    fake_ndi::reset();
+
+    NdiSender sender("shutdown");
+    CHECK(sender.initialize());
+    CHECK(sender.sendFrame(frameInfo(a, NDIlib_FourCC_type_UYVY)));
+    CHECK_EQ(released(a), 0);
+    sender.shutdown();
+    CHECK_EQ(released(a), 1);
+}
+
+void testMoveFinishesInFlight() {
+    Buffer a{51}, b{52}, c{53};
+    fake_ndi::reset();
+
+    NdiSender source("move");
+    CHECK(source.initialize());
+    CHECK(source.sendFrame(frameInfo(a, NDIlib_FourCC_type_UYVY)));
+    CHECK_EQ(released(a), 0);
+
+    // The frame in flight is finished by the sender that sent it
+    NdiSender moved(std::move(source));
+    CHECK(fake_ndi::sent.back().flush);
+    CHECK_EQ(released(a), 1);
+
+    CHECK(moved.sendFrame(frameInfo(b, NDIlib_FourCC_type_UYVY)));
+    CHECK_EQ(released(b), 0);
+    CHECK(!source.sendFrame(frameInfo(c, NDIlib_FourCC_type_UYVY)));
+    CHECK_EQ(released(c), 1);
+
+    NdiSender assigned("assigned");
+    CHECK(assigned.initialize());
+    assigned = std::move(moved);
+    CHECK_EQ(released(b), 1);
+    assigned.shutdown();
+    CHECK_EQ(released(a), 1);
+    CHECK_EQ(released(b), 1);
+}
+
+} // namespace
+
+int main() {
+    NdiSender sender("test");
+    CHECK(sender.initialize());
+
+    testPassThroughHeldUntilNextSend(sender);
+    testFlushReleasesOnce(sender);
+    testConvertedReleasedAtOnce(sender);
+    testRejectedReleasedAtOnce(sender);
+    testShutdownReleasesInFlight();
+    testMoveFinishesInFlight();
+
+    sender.shutdown();
+    for (const auto& entry : releases) {
+        CHECK_EQ(entry.second, 1);
+    }
+    std::cout << "test_ndi_sender_async: OK" << std::endl;
+    return 0;
+}
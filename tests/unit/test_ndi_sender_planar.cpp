@@ -0,0 +1,190 @@
+// test_ndi_sender_planar.cpp
+//
+// Planar 4:2:0 frames through NdiSender: the layout NDI expects goes out
+// as the capture buffer, any other chroma offset or pitch is repacked to
+// the tight layout. Repacked frames are compared with a reference packing.
+
+#include "common/ndi_sender.h"
+#include "fake_ndi.h"
+#include "test_check.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ndi_bridge;
+
+namespace {
+
+struct Layout {
+    uint32_t fourcc;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t chroma_offset;     // 0 = stride * height
+    uint32_t chroma_stride;     // 0 = NDI default for the format
+};
+
+bool semiPlanar(const Layout& layout) {
+    return layout.fourcc == NDIlib_FourCC_type_NV12;
+}
+
+uint32_t chromaBytes(const Layout& layout) {
+    return semiPlanar(layout) ? layout.width : layout.width / 2;
+}
+
+uint32_t chromaStride(const Layout& layout) {
+    if (layout.chroma_stride) {
+        return layout.chroma_stride;
+    }
+    return semiPlanar(layout) ? layout.stride : layout.stride / 2;
+}
+
+uint32_t chromaOffset(const Layout& layout) {
+    return layout.chroma_offset ? layout.chroma_offset : layout.stride * layout.height;
+}
+
+uint8_t lumaValue(uint32_t x, uint32_t y) {
+    return static_cast<uint8_t>(16 + (x * 3 + y * 5) % 220);
+}
+
+uint8_t chromaValue(uint32_t plane, uint32_t x, uint32_t y) {
+    return static_cast<uint8_t>(plane * 100 + (x * 7 + y * 11) % 97);
+}
+
+// Capture buffer in the given layout, padding filled with a marker
+std::vector<uint8_t> makeSource(const Layout& layout) {
+    const uint32_t rows = (layout.height + 1) / 2;
+    const uint32_t planes = semiPlanar(layout) ? 1 : 2;
+    std::vector<uint8_t> buffer(chromaOffset(layout) + planes * chromaStride(layout) * rows, 0xEE);
+    for (uint32_t y = 0; y < layout.height; y++) {
+        for (uint32_t x = 0; x < layout.width; x++) {
+            buffer[y * layout.stride + x] = lumaValue(x, y);
+        }
+    }
+    for (uint32_t p = 0; p < planes; p++) {
+        uint8_t* plane = buffer.data() + chromaOffset(layout) + p * chromaStride(layout) * rows;
+        for (uint32_t y = 0; y < rows; y++) {
+            for (uint32_t x = 0; x < chromaBytes(layout); x++) {
+                plane[y * chromaStride(layout) + x] = chromaValue(p, x, y);
+            }
+        }
+    }
+    return buffer;
+}
+
+// What NDI has to receive after a repack: stride = width, planes back to back
+std::vector<uint8_t> makeTight(const Layout& layout) {
+    const uint32_t rows = (layout.height + 1) / 2;
+    const uint32_t planes = semiPlanar(layout) ? 1 : 2;
+    std::vector<uint8_t> buffer;
+    for (uint32_t y = 0; y < layout.height; y++) {
+        for (uint32_t x = 0; x < layout.width; x++) {
+            buffer.push_back(lumaValue(x, y));
+        }
+    }
+    for (uint32_t p = 0; p < planes; p++) {
+        for (uint32_t y = 0; y < rows; y++) {
+            for (uint32_t x = 0; x < chromaBytes(layout); x++) {
+                buffer.push_back(chromaValue(p, x, y));
+            }
+        }
+    }
+    return buffer;
+}
+
+NdiSender::FrameInfo frameInfo(const Layout& layout, const std::vector<uint8_t>& source) {
+    NdiSender::FrameInfo frame;
+    frame.data = source.data();
+    frame.width = layout.width;
+    frame.height = layout.height;
+    frame.stride = layout.stride;
+    frame.fourcc = layout.fourcc;
+    frame.timestamp_ns = 0;
+    frame.fps_numerator = 60;
+    frame.fps_denominator = 1;
+    frame.chroma_offset = layout.chroma_offset;
+    frame.chroma_stride = layout.chroma_stride;
+    return frame;
+}
+
+void checkPassThrough(NdiSender& sender, const Layout& layout) {
+    std::vector<uint8_t> source = makeSource(layout);
+    fake_ndi::reset();
+    CHECK(sender.sendFrame(frameInfo(layout, source)));
+    CHECK_EQ(fake_ndi::sent.size(), 1u);
+    const NDIlib_video_frame_v2_t& sent = fake_ndi::sent[0].frame;
+    CHECK(sent.p_data == source.data());
+    CHECK_EQ(sent.line_stride_in_bytes, static_cast<int>(layout.stride));
+    CHECK_EQ(static_cast<uint32_t>(sent.FourCC), layout.fourcc);
+}
+
+void checkRepacked(NdiSender& sender, const Layout& layout) {
+    std::vector<uint8_t> source = makeSource(layout);
+    fake_ndi::reset();
+    CHECK(sender.sendFrame(frameInfo(layout, source)));
+    CHECK_EQ(fake_ndi::sent.size(), 1u);
+    const fake_ndi::SentVideo& sent = fake_ndi::sent[0];
+    CHECK(sent.frame.p_data != source.data());
+    CHECK_EQ(sent.frame.line_stride_in_bytes, static_cast<int>(layout.width));
+    CHECK_EQ(static_cast<uint32_t>(sent.frame.FourCC), layout.fourcc);
+    CHECK_EQ(sent.frame.xres, static_cast<int>(layout.width));
+    CHECK_EQ(sent.frame.yres, static_cast<int>(layout.height));
+    CHECK(sent.bytes == makeTight(layout));
+}
+
+// A repack must not overwrite the repacked frame NDI still reads
+void checkRepackWhileInFlight(NdiSender& sender) {
+    const Layout layout{NDIlib_FourCC_type_NV12, 64, 36, 64, 64 * 40, 0};
+    std::vector<uint8_t> first = makeSource(layout);
+    std::vector<uint8_t> second = makeSource(layout);
+    for (size_t i = 0; i < layout.stride * layout.height; i++) {
+        second[i] ^= 0xFF;
+    }
+
+    fake_ndi::reset();
+    int releases = 0;
+    NdiSender::FrameInfo frame = frameInfo(layout, first);
+    frame.release = [&releases] { releases++; };
+    CHECK(sender.sendFrame(frame));
+    frame = frameInfo(layout, second);
+    frame.release = [&releases] { releases++; };
+    CHECK(sender.sendFrame(frame));
+    CHECK_EQ(releases, 2);      // Repacked: capture buffers go back right away
+
+    CHECK_EQ(fake_ndi::sent.size(), 2u);
+    const fake_ndi::SentVideo& in_flight = fake_ndi::sent[0];
+    CHECK(in_flight.async);
+    CHECK(fake_ndi::sent[1].frame.p_data != in_flight.frame.p_data);
+    CHECK(memcmp(in_flight.frame.p_data, in_flight.bytes.data(), in_flight.bytes.size()) == 0);
+    sender.flush();
+}
+
+} // namespace
+
+int main() {
+    NdiSender sender("test");
+    CHECK(sender.initialize());
+
+    // Chroma where NDI expects it (explicit or defaulted) goes out as is
+    checkPassThrough(sender, Layout{NDIlib_FourCC_type_NV12, 64, 36, 64, 0, 0});
+    checkPassThrough(sender, Layout{NDIlib_FourCC_type_NV12, 64, 36, 80, 80 * 36, 80});
+    checkPassThrough(sender, Layout{NDIlib_FourCC_type_I420, 64, 36, 64, 64 * 36, 32});
+    checkPassThrough(sender, Layout{NDIlib_FourCC_type_YV12, 64, 36, 96, 0, 0});
+
+    // Padded height (driver-aligned chroma plane)
+    checkRepacked(sender, Layout{NDIlib_FourCC_type_NV12, 64, 36, 64, 64 * 48, 0});
+    checkRepacked(sender, Layout{NDIlib_FourCC_type_I420, 64, 36, 64, 64 * 40, 0});
+    // Padded luma lines and a chroma pitch of its own
+    checkRepacked(sender, Layout{NDIlib_FourCC_type_NV12, 60, 34, 64, 64 * 34, 96});
+    checkRepacked(sender, Layout{NDIlib_FourCC_type_YV12, 64, 36, 64, 64 * 36, 48});
+    // Odd luma pitch: no chroma pitch of stride / 2 exists
+    checkRepacked(sender, Layout{NDIlib_FourCC_type_I420, 64, 36, 65, 65 * 36, 33});
+    // Odd height: the last chroma row covers one luma row
+    checkRepacked(sender, Layout{NDIlib_FourCC_type_NV12, 64, 35, 64, 64 * 40, 0});
+
+    checkRepackWhileInFlight(sender);
+
+    sender.shutdown();
+    std::cout << "test_ndi_sender_planar: OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,268 @@
+// test_synthetic_capture.cpp
+//
+// Checks SyntheticCapture frames pixel by pixel against a reference model
+// of the pattern: bars, luma ramp, bouncing box, sweep line and the frame
+// counter digits. Only the wall-clock digits are not compared.
+
+#include "common/synthetic_capture.h"
+#include "test_check.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace ndi_bridge;
+
+namespace {
+
+struct Yuv {
+    int y, u, v;
+};
+
+// BT.709 limited range, 75% bars
+const Yuv kBars[7] = {
+    {180, 128, 128}, {168, 44, 136}, {145, 147, 44}, {133, 63, 52},
+    {63, 193, 204}, {51, 109, 212}, {28, 212, 120}
+};
+const Yuv kWhite = {235, 128, 128};
+const Yuv kBlack = {16, 128, 128};
+
+// Counter glyphs, bit 2 = left column
+const uint8_t kDigits[10][5] = {
+    {7, 5, 5, 5, 7}, {2, 6, 2, 2, 7}, {7, 1, 7, 4, 7}, {7, 1, 7, 1, 7}, {5, 5, 7, 1, 1},
+    {7, 4, 7, 1, 7}, {7, 4, 7, 5, 7}, {7, 1, 1, 1, 1}, {7, 5, 7, 5, 7}, {7, 5, 7, 1, 7}
+};
+const uint8_t kHash[5] = {5, 7, 5, 7, 5};
+
+constexpr int kTextLength = 22;     // "#00000000 00:00:00.000"
+constexpr int kCounterLength = 9;   // "#00000000"
+
+struct Rect {
+    int x, y, w, h;
+};
+
+int bounce(uint64_t step, int range) {
+    if (range <= 0) {
+        return 0;
+    }
+    int pos = static_cast<int>(step % static_cast<uint64_t>(2 * range));
+    return pos > range ? 2 * range - pos : pos;
+}
+
+// Reference model of one frame, drawn areas snapped to the 2x2 chroma grid
+class Pattern {
+public:
+    Pattern(int width, int height, uint64_t frame_number)
+        : width_(width), height_(height), n_(frame_number) {
+        bars_height_ = height * 2 / 3;
+        int box = (height / 8) & ~1;
+        box_ = Rect{bounce(n_ * std::max(2, width / 240), width - box),
+                    bounce(n_ * std::max(2, height / 180), bars_height_ - box), box, box};
+        int step = std::max(2, (width / 480) & ~1);
+        sweep_ = Rect{static_cast<int>((n_ * step) % width), 0, step, height};
+        scale_ = std::max(2, (height / 108) & ~1);
+        text_x_ = scale_ * 2;
+        text_y_ = bars_height_ + scale_ * 2;
+        text_box_ = Rect{text_x_ - scale_, text_y_ - scale_, kTextLength * 4 * scale_ + scale_, 7 * scale_};
+
+        char counter[24];
+        snprintf(counter, sizeof(counter), "#%08llu", static_cast<unsigned long long>(n_));
+        counter_ = counter;
+    }
+
+    // Wall-clock digits change under the test
+    bool isClock(int x, int y) const {
+        return contains(text_box_, x, y) && x >= text_x_ + kCounterLength * 4 * scale_;
+    }
+
+    Yuv at(int x, int y) const {
+        if (contains(text_box_, x, y)) {
+            return glyphCell(x, y) ? kWhite : kBlack;
+        }
+        if (contains(sweep_, x, y) || contains(box_, x, y)) {
+            return kWhite;
+        }
+        if (y < bars_height_) {
+            for (int i = 0; i < 7; i++) {
+                if (x < ((width_ * (i + 1) / 7) & ~1)) {
+                    return kBars[i];
+                }
+            }
+        }
+        return Yuv{16 + (219 * (x & ~1)) / std::max(1, width_ - 2), 128, 128};
+    }
+
+private:
+    bool contains(const Rect& rect, int x, int y) const {
+        int x0 = std::max(0, rect.x) & ~1;
+        int y0 = std::max(0, rect.y) & ~1;
+        int x1 = std::min(width_, (rect.x + rect.w + 1) & ~1);
+        int y1 = std::min(height_, (rect.y + rect.h + 1) & ~1);
+        return x >= x0 && x < x1 && y >= y0 && y < y1;
+    }
+
+    bool glyphCell(int x, int y) const {
+        for (int i = 0; i < kCounterLength; i++) {
+            const uint8_t* rows = i == 0 ? kHash : kDigits[counter_[i] - '0'];
+            int gx = text_x_ + i * 4 * scale_;
+            for (int row = 0; row < 5; row++) {
+                for (int col = 0; col < 3; col++) {
+                    if ((rows[row] & (4 >> col)) &&
+                        contains(Rect{gx + col * scale_, text_y_ + row * scale_, scale_, scale_}, x, y)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    int width_, height_;
+    uint64_t n_;
+    int bars_height_, scale_, text_x_, text_y_;
+    Rect box_, sweep_, text_box_;
+    std::string counter_;
+};
+
+// Sample of a frame in the capture format
+Yuv sample(const std::vector<uint8_t>& frame, const std::string& format, int width, int height, int x, int y) {
+    if (format == "NV12") {
+        const uint8_t* uv = frame.data() + static_cast<size_t>(width) * height +
+                            static_cast<size_t>(y / 2) * width + (x & ~1);
+        return Yuv{frame[static_cast<size_t>(y) * width + x], uv[0], uv[1]};
+    }
+    const uint8_t* pair = frame.data() + static_cast<size_t>(y) * width * 2 + (x & ~1) * 2;
+    if (format == "YUYV") {
+        return Yuv{pair[(x & 1) * 2], pair[1], pair[3]};
+    }
+    return Yuv{pair[(x & 1) * 2 + 1], pair[0], pair[2]};
+}
+
+bool matches(const std::vector<uint8_t>& frame, const std::string& format, int width, int height,
+             uint64_t frame_number) {
+    Pattern pattern(width, height, frame_number);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (pattern.isClock(x, y)) {
+                continue;
+            }
+            Yuv expected = pattern.at(x, y);
+            Yuv actual = sample(frame, format, width, height, x, y);
+            if (actual.y != expected.y || actual.u != expected.u || actual.v != expected.v) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+struct Captured {
+    std::vector<uint8_t> data;
+    int64_t timestamp;
+    ICaptureDevice::VideoFormat format;
+};
+
+void testPattern(const std::string& spec, size_t frame_count) {
+    SyntheticCapture::Config config;
+    config.buffer_count = 3;    // Buffers are reused, so restored regions are checked too
+    CHECK(SyntheticCapture::parseSpec(spec, config));
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Captured> frames;
+
+    SyntheticCapture capture(config);
+    capture.setFrameCallback([&](const void* data, size_t size, int64_t timestamp,
+                                 const ICaptureDevice::VideoFormat& format) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frames.size() < frame_count) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            frames.push_back(Captured{std::vector<uint8_t>(bytes, bytes + size), timestamp, format});
+            cv.notify_one();
+        }
+        return true;
+    });
+    CHECK(capture.startCapture());
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        CHECK(cv.wait_for(lock, std::chrono::seconds(20), [&] { return frames.size() >= frame_count; }));
+    }
+    capture.stopCapture();
+
+    const int width = config.width;
+    const int height = config.height;
+    const bool nv12 = config.pixel_format == "NV12";
+    const int64_t interval_ns = 1000000000LL * config.fps_denominator / config.fps_numerator;
+
+    // A late frame skips frame numbers, so find each frame's number
+    // among the next few; the burned-in counter has to agree
+    uint64_t next = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        const Captured& frame = frames[i];
+        CHECK_EQ(frame.format.width, width);
+        CHECK_EQ(frame.format.height, height);
+        CHECK_EQ(frame.format.stride, nv12 ? width : width * 2);
+        CHECK_EQ(frame.format.pixel_format, config.pixel_format);
+        CHECK_EQ(frame.format.fps_numerator, config.fps_numerator);
+        CHECK_EQ(frame.format.fps_denominator, config.fps_denominator);
+        CHECK_EQ(frame.data.size(), static_cast<size_t>(width) * height * (nv12 ? 3 : 4) / 2);
+
+        uint64_t n = next;
+        while (n < next + 32 && !matches(frame.data, config.pixel_format, width, height, n)) {
+            n++;
+        }
+        if (n == next + 32) {
+            std::cerr << spec << ": frame " << i << " matches no frame number from " << next << std::endl;
+            CHECK(false);
+        }
+        CHECK(i > 0 || n == 0);
+        if (i > 0) {
+            // Stamped with the schedule slot of its frame number
+            CHECK_EQ(frame.timestamp - frames[i - 1].timestamp, static_cast<int64_t>(n - next + 1) * interval_ns);
+        }
+        next = n + 1;
+    }
+}
+
+void testParseSpec() {
+    SyntheticCapture::Config config;
+    CHECK(SyntheticCapture::parseSpec("1280x720@59.94:NV12", config));
+    CHECK_EQ(config.width, 1280);
+    CHECK_EQ(config.height, 720);
+    CHECK_EQ(config.fps_numerator, 60000u);
+    CHECK_EQ(config.fps_denominator, 1001u);
+    CHECK_EQ(config.pixel_format, std::string("NV12"));
+
+    CHECK(SyntheticCapture::parseSpec("@50", config));
+    CHECK_EQ(config.width, 1280);
+    CHECK_EQ(config.fps_numerator, 50u);
+    CHECK_EQ(config.fps_denominator, 1u);
+
+    CHECK(SyntheticCapture::parseSpec("1920x1080@29.97", config));
+    CHECK_EQ(config.fps_numerator, 30000u);
+    CHECK_EQ(config.fps_denominator, 1001u);
+
+    SyntheticCapture::Config unchanged = config;
+    CHECK(!SyntheticCapture::parseSpec("126x72", config));
+    CHECK(!SyntheticCapture::parseSpec("1281x720", config));
+    CHECK(!SyntheticCapture::parseSpec("1280x720:BGRA", config));
+    CHECK(!SyntheticCapture::parseSpec("1280x720@0", config));
+    CHECK(!SyntheticCapture::parseSpec("1280x720@60fps", config));
+    CHECK_EQ(config.width, unchanged.width);
+    CHECK_EQ(config.pixel_format, unchanged.pixel_format);
+}
+
+} // namespace
+
+int main() {
+    testParseSpec();
+    testPattern("320x180@240:UYVY", 16);
+    testPattern("330x186@240:YUYV", 16);
+    testPattern("256x144@240:NV12", 16);
+
+    std::cout << "test_synthetic_capture: OK" << std::endl;
+    return 0;
+}